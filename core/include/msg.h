@@ -272,6 +272,29 @@ int msg_send_to_self(msg_t *m);
  */
 int msg_send_int(msg_t *m, kernel_pid_t target_pid);
 
+/**
+ * @brief Send several messages at once (non-blocking).
+ *
+ * All messages are delivered under one critical section and the target
+ * thread is woken up at most once, which is considerably cheaper than
+ * calling msg_try_send() for each of them. If the target thread is waiting
+ * in msg_receive() (or msg_receive_bulk()), the first message is handed over
+ * directly, the remaining ones are put into the target's message queue.
+ * Messages that do not fit into the queue are not sent.
+ *
+ * Can be called from an interrupt/ISR, in which case ``m[i].sender_pid`` is
+ * set to @ref KERNEL_PID_ISR.
+ *
+ * @param[in] m             Array of @p num messages, must not be NULL.
+ * @param[in] num           Number of messages in @p m.
+ * @param[in] target_pid    PID of target thread.
+ *
+ * @return number of messages that were sent, i.e. the messages
+ *         ``m[0]`` to ``m[return value - 1]`` were delivered
+ * @return -1, on error (invalid PID)
+ */
+int msg_send_bulk(msg_t *m, unsigned num, kernel_pid_t target_pid);
+
 /**
  * @brief Test if the message was sent inside an ISR.
  * @see msg_send_int()
@@ -309,6 +332,23 @@ int msg_receive(msg_t *m);
  */
 int msg_try_receive(msg_t *m);
 
+/**
+ * @brief Receive several messages at once.
+ *
+ * This function blocks until at least one message was received. It then
+ * takes up to @p num messages out of the thread's message queue under one
+ * critical section. Threads that are blocked sending to the calling thread
+ * are moved into the freed queue slots and woken up with a single call to
+ * the scheduler.
+ *
+ * @param[out] m    Array of at least @p num ``msg_t`` structures, must not
+ *                  be NULL.
+ * @param[in] num   Maximum number of messages to receive, must be > 0.
+ *
+ * @return  number of messages received (at least 1).
+ */
+int msg_receive_bulk(msg_t *m, unsigned num);
+
 /**
  * @brief Send a message, block until reply received.
  *
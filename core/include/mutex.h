@@ -13,6 +13,23 @@
  * @ingroup     core
  * @{
  *
+ * Mutexes are not priority aware by default: a low priority thread holding a
+ * mutex can delay a high priority thread waiting for it for as long as any
+ * medium priority thread is runnable (priority inversion). If the
+ * pseudo-module `core_mutex_priority_inheritance` is used, the holder of a
+ * mutex temporarily inherits the priority of the highest priority thread
+ * blocked on it until it unlocks the mutex. A thread holding several mutexes
+ * keeps the highest priority of the waiters of all of them, so unlocking one
+ * of them lowers its priority only as far as the others allow. If the holder
+ * is itself blocked on another mutex, the priority is passed on to the holder
+ * of that one as well. As @ref rmutex_t and the pthread mutex are built on top
+ * of @ref mutex_t, they profit from this as well.
+ *
+ * A mutex is only owned by a thread that locked it without blocking, or that
+ * was woken up by an unlock of the previous owner. A mutex used as a signal,
+ * i.e. unlocked from an ISR or by a thread other than its owner, has no owner
+ * after the unlock, so no priority is inherited for it.
+ *
  * @file
  * @brief       RIOT synchronization API
  *
@@ -23,8 +40,10 @@
 #define MUTEX_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "list.h"
+#include "kernel_types.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -33,25 +52,48 @@
 /**
  * @brief Mutex structure. Must never be modified by the user.
  */
-typedef struct {
+typedef struct mutex {
     /**
      * @brief   The process waiting queue of the mutex. **Must never be changed
      *          by the user.**
      * @internal
      */
     list_node_t queue;
+#if defined(MODULE_CORE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
+    /**
+     * @brief   The current owner of the mutex or @ref KERNEL_PID_UNDEF
+     * @note    Only available with module `core_mutex_priority_inheritance`.
+     * @internal
+     */
+    kernel_pid_t owner;
+    /**
+     * @brief   Next mutex held by the owner, see thread_t::held_mutexes
+     * @note    Only available with module `core_mutex_priority_inheritance`.
+     * @internal
+     */
+    struct mutex *next_held;
+#endif
 } mutex_t;
 
+#if defined(MODULE_CORE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
 /**
  * @brief Static initializer for mutex_t.
  * @details This initializer is preferable to mutex_init().
  */
-#define MUTEX_INIT { { NULL } }
+#define MUTEX_INIT { { NULL }, KERNEL_PID_UNDEF, NULL }
 
 /**
  * @brief Static initializer for mutex_t with a locked mutex
+ *
+ * @note  With `core_mutex_priority_inheritance` the owner of a mutex
+ *        initialized this way is unknown, so no priority is inherited until
+ *        it is unlocked and locked again.
  */
+#define MUTEX_INIT_LOCKED { { MUTEX_LOCKED }, KERNEL_PID_UNDEF, NULL }
+#else
+#define MUTEX_INIT { { NULL } }
 #define MUTEX_INIT_LOCKED { { MUTEX_LOCKED } }
+#endif
 
 /**
  * @cond INTERNAL
@@ -72,6 +114,10 @@ typedef struct {
 static inline void mutex_init(mutex_t *mutex)
 {
     mutex->queue.next = NULL;
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    mutex->owner = KERNEL_PID_UNDEF;
+    mutex->next_held = NULL;
+#endif
 }
 
 /**
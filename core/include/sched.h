@@ -133,6 +133,26 @@ void sched_set_status(thread_t *process, unsigned int status);
  */
 void sched_switch(uint16_t other_prio);
 
+/**
+ * @brief       Change the priority of a thread
+ *
+ * @details     If @p thread is on the runqueue it is moved to the runqueue of
+ *              its new priority. If the change makes another thread more
+ *              eligible to run than the currently active one (or @p thread
+ *              is the active thread), a reschedule is triggered using the
+ *              same rules as sched_switch().
+ *
+ *              This is used by the mutex implementation to temporarily raise
+ *              the priority of a mutex holder (priority inheritance), see
+ *              `core_mutex_priority_inheritance`.
+ *
+ * @param[in]   thread      The thread to change the priority of, must not be
+ *                          NULL
+ * @param[in]   priority    The new priority, must be less than
+ *                          @ref SCHED_PRIO_LEVELS
+ */
+void sched_change_priority(thread_t *thread, uint8_t priority);
+
 /**
  * @brief   Call context switching at thread exit
  */
@@ -172,6 +172,13 @@ struct _thread {
 
     kernel_pid_t pid;               /**< thread's process id            */
 
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    uint8_t base_priority;          /**< priority without the priorities
+                                         inherited from mutex waiters   */
+    struct mutex *held_mutexes;     /**< mutexes owned by the thread    */
+    struct mutex *blocked_on;       /**< mutex the thread is waiting for */
+#endif
+
 #ifdef MODULE_CORE_THREAD_FLAGS
     thread_flags_t flags;           /**< currently set flags            */
 #endif
@@ -29,6 +29,7 @@
 #include "thread.h"
 #include "irq.h"
 #include "cib.h"
+#include "schedtrace.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -93,6 +94,8 @@ static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned sta
 
     thread_t *me = (thread_t *) sched_active_thread;
 
+    schedtrace_add(SCHEDTRACE_MSG_SEND, me->pid, target_pid);
+
     DEBUG("msg_send() %s:%i: Sending from %" PRIkernel_pid " to %" PRIkernel_pid
           ". block=%i src->state=%i target->state=%i\n", RIOT_FILE_RELATIVE,
           __LINE__, sched_active_pid, target_pid,
@@ -187,6 +190,7 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 
     m->sender_pid = KERNEL_PID_ISR;
+    schedtrace_add(SCHEDTRACE_MSG_SEND, KERNEL_PID_ISR, target_pid);
     if (target->status == STATUS_RECEIVE_BLOCKED) {
         DEBUG("msg_send_int: Direct msg copy from %" PRIkernel_pid " to %"
               PRIkernel_pid ".\n", thread_getpid(), target_pid);
@@ -206,6 +210,66 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 }
 
+int msg_send_bulk(msg_t *m, unsigned num, kernel_pid_t target_pid)
+{
+#ifdef DEVELHELP
+    if (!pid_is_valid(target_pid)) {
+        DEBUG("msg_send_bulk(): target_pid is invalid, continuing anyways\n");
+    }
+#endif /* DEVELHELP */
+
+    int in_isr = irq_is_in();
+    unsigned state = irq_disable();
+    thread_t *target = (thread_t *) sched_threads[target_pid];
+
+    if (target == NULL) {
+        DEBUG("msg_send_bulk(): target thread does not exist\n");
+        irq_restore(state);
+        return -1;
+    }
+
+    kernel_pid_t sender_pid = (in_isr) ? KERNEL_PID_ISR : sched_active_pid;
+    int woken = 0;
+    unsigned sent = 0;
+
+    if ((num > 0) && (target->status == STATUS_RECEIVE_BLOCKED)) {
+        DEBUG("msg_send_bulk: Direct msg copy to %" PRIkernel_pid ".\n",
+              target_pid);
+        m[0].sender_pid = sender_pid;
+        *((msg_t *) target->wait_data) = m[0];
+        sched_set_status(target, STATUS_PENDING);
+        woken = 1;
+        sent++;
+    }
+
+    for (; sent < num; sent++) {
+        m[sent].sender_pid = sender_pid;
+        if (!queue_msg(target, &m[sent])) {
+            break;
+        }
+    }
+
+    DEBUG("msg_send_bulk: sent %u of %u messages to %" PRIkernel_pid ".\n",
+          sent, num, target_pid);
+    for (unsigned i = 0; i < sent; i++) {
+        schedtrace_add(SCHEDTRACE_MSG_SEND, sender_pid, target_pid);
+    }
+
+    uint16_t target_prio = target->priority;
+    irq_restore(state);
+
+    if (woken) {
+        if (in_isr) {
+            sched_context_switch_request = 1;
+        }
+        else {
+            sched_switch(target_prio);
+        }
+    }
+
+    return (int)sent;
+}
+
 int msg_send_receive(msg_t *m, msg_t *reply, kernel_pid_t target_pid)
 {
     assert(sched_active_pid != target_pid);
@@ -218,7 +282,12 @@ int msg_send_receive(msg_t *m, msg_t *reply, kernel_pid_t target_pid)
      * overwritten if the target is not in RECEIVE_BLOCKED */
     *reply = *m;
     /* msg_send blocks until reply received */
-    return _msg_send(reply, target_pid, true, state);
+    int res = _msg_send(reply, target_pid, true, state);
+
+    if (res > 0) {
+        schedtrace_add(SCHEDTRACE_MSG_RECV, me->pid, target_pid);
+    }
+    return res;
 }
 
 int msg_reply(msg_t *m, msg_t *reply)
@@ -237,6 +306,7 @@ int msg_reply(msg_t *m, msg_t *reply)
 
     DEBUG("msg_reply(): %" PRIkernel_pid ": Direct msg copy.\n",
           sched_active_thread->pid);
+    schedtrace_add(SCHEDTRACE_MSG_SEND, sched_active_pid, target->pid);
     /* copy msg to target */
     msg_t *target_message = (msg_t*) target->wait_data;
     *target_message = *reply;
@@ -258,6 +328,7 @@ int msg_reply_int(msg_t *m, msg_t *reply)
         return -1;
     }
 
+    schedtrace_add(SCHEDTRACE_MSG_SEND, KERNEL_PID_ISR, target->pid);
     msg_t *target_message = (msg_t*) target->wait_data;
     *target_message = *reply;
     sched_set_status(target, STATUS_PENDING);
@@ -265,14 +336,32 @@ int msg_reply_int(msg_t *m, msg_t *reply)
     return 1;
 }
 
+/* trace hook shared by all paths that hand a message to the receiver */
+static inline void _msg_receive_trace(const msg_t *m, unsigned num)
+{
+    for (unsigned i = 0; i < num; i++) {
+        schedtrace_add(SCHEDTRACE_MSG_RECV, sched_active_pid, m[i].sender_pid);
+    }
+}
+
 int msg_try_receive(msg_t *m)
 {
-    return _msg_receive(m, 0);
+    int res = _msg_receive(m, 0);
+
+    if (res > 0) {
+        _msg_receive_trace(m, 1);
+    }
+    return res;
 }
 
 int msg_receive(msg_t *m)
 {
-    return _msg_receive(m, 1);
+    int res = _msg_receive(m, 1);
+
+    if (res > 0) {
+        _msg_receive_trace(m, 1);
+    }
+    return res;
 }
 
 static int _msg_receive(msg_t *m, int block)
@@ -361,6 +450,62 @@ static int _msg_receive(msg_t *m, int block)
     DEBUG("This should have never been reached!\n");
 }
 
+int msg_receive_bulk(msg_t *m, unsigned num)
+{
+    assert(num > 0);
+
+    unsigned state = irq_disable();
+    thread_t *me = (thread_t *) sched_active_thread;
+
+    if (!me->msg_array || (cib_avail(&(me->msg_queue)) <= 0)) {
+        /* nothing queued, fall back to the single message path */
+        irq_restore(state);
+        int res = _msg_receive(m, 1);
+
+        if (res > 0) {
+            _msg_receive_trace(m, 1);
+        }
+        return res;
+    }
+
+    unsigned received = 0;
+    int queue_index;
+
+    while ((received < num) &&
+           ((queue_index = cib_get(&(me->msg_queue))) >= 0)) {
+        m[received++] = me->msg_array[queue_index];
+    }
+
+    /* move the messages of blocked senders into the freed queue space */
+    uint16_t sender_prio = THREAD_PRIORITY_IDLE;
+    list_node_t *next;
+
+    for (unsigned i = 0; (i < received) &&
+         ((next = list_remove_head(&me->msg_waiters)) != NULL); i++) {
+        thread_t *sender = container_of((clist_node_t *)next, thread_t,
+                                        rq_entry);
+
+        me->msg_array[cib_put(&(me->msg_queue))] = *((msg_t *) sender->wait_data);
+        if (sender->status != STATUS_REPLY_BLOCKED) {
+            sender->wait_data = NULL;
+            sched_set_status(sender, STATUS_PENDING);
+            if (sender->priority < sender_prio) {
+                sender_prio = sender->priority;
+            }
+        }
+    }
+
+    DEBUG("msg_receive_bulk: %" PRIkernel_pid ": received %u messages.\n",
+          me->pid, received);
+    _msg_receive_trace(m, received);
+
+    irq_restore(state);
+    if (sender_prio < THREAD_PRIORITY_IDLE) {
+        sched_switch(sender_prio);
+    }
+    return (int)received;
+}
+
 int msg_avail(void)
 {
     DEBUG("msg_available: %" PRIkernel_pid ": msg_available.\n",
@@ -30,10 +30,139 @@
 #include "irq.h"
 #include "thread.h"
 #include "list.h"
+#include "schedtrace.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+static inline void _set_owner(mutex_t *mutex, thread_t *owner)
+{
+    mutex->owner = owner->pid;
+    mutex->next_held = owner->held_mutexes;
+    owner->held_mutexes = mutex;
+}
+
+/* A mutex is handed over to its next waiter with the ownership only if it is
+ * unlocked by its owner. Mutexes used as a signal are unlocked from an ISR or
+ * by another thread and are often allocated on the stack of the thread waiting
+ * for the signal, so they must not end up in thread_t::held_mutexes. */
+static inline int _unlocked_by_owner(mutex_t *mutex)
+{
+    return !irq_is_in() && (mutex->owner == sched_active_pid);
+}
+
+static inline void _set_blocked_on(thread_t *thread, mutex_t *mutex)
+{
+    thread->blocked_on = mutex;
+}
+
+/* must be called with interrupts disabled: the wait queue of a mutex is sorted
+ * by priority, so a waiter has to be moved when its priority changes */
+static inline void _requeue(mutex_t *mutex, thread_t *waiter)
+{
+    list_remove(&mutex->queue, (list_node_t *)&waiter->rq_entry);
+    thread_add_to_list(&mutex->queue, waiter);
+}
+
+/* must be called with interrupts disabled */
+static inline void _inherit_priority(mutex_t *mutex, thread_t *waiter)
+{
+    uint8_t prio = waiter->priority;
+    thread_t *owner = (thread_t *)thread_get(mutex->owner);
+
+    /* follow the chain of owners blocked on further mutexes */
+    while (owner && (owner->priority > prio)) {
+        DEBUG("PID[%" PRIkernel_pid "]: boosting owner %" PRIkernel_pid
+              " from prio %u to %u\n", waiter->pid, owner->pid,
+              (unsigned)owner->priority, (unsigned)prio);
+        sched_change_priority(owner, prio);
+        mutex = owner->blocked_on;
+        if (mutex == NULL) {
+            break;
+        }
+        _requeue(mutex, owner);
+        owner = (thread_t *)thread_get(mutex->owner);
+    }
+}
+
+/* must be called with interrupts disabled, returns the thread whose priority
+ * has to be restored to *prio after interrupts are enabled again */
+static inline thread_t *_release_owner(mutex_t *mutex, uint8_t *prio)
+{
+    thread_t *owner = (thread_t *)thread_get(mutex->owner);
+
+    mutex->owner = KERNEL_PID_UNDEF;
+    if (owner == NULL) {
+        return NULL;
+    }
+    for (mutex_t **held = &owner->held_mutexes; *held; held = &(*held)->next_held) {
+        if (*held == mutex) {
+            *held = mutex->next_held;
+            break;
+        }
+    }
+    mutex->next_held = NULL;
+
+    /* the owner keeps the priority of the highest priority thread waiting for
+     * any of the mutexes it still holds; the wait queues are sorted by
+     * priority, so that is the first waiter of each */
+    *prio = owner->base_priority;
+    for (mutex_t *held = owner->held_mutexes; held; held = held->next_held) {
+        if ((held->queue.next != NULL) && (held->queue.next != MUTEX_LOCKED)) {
+            thread_t *waiter = container_of((clist_node_t *)held->queue.next,
+                                            thread_t, rq_entry);
+            if (waiter->priority < *prio) {
+                *prio = waiter->priority;
+            }
+        }
+    }
+    if (owner->priority != *prio) {
+        return owner;
+    }
+    return NULL;
+}
+
+static inline void _restore_priority(thread_t *owner, uint8_t prio)
+{
+    if (owner) {
+        DEBUG("PID[%" PRIkernel_pid "]: restoring prio %u\n", owner->pid,
+              (unsigned)prio);
+        sched_change_priority(owner, prio);
+        /* the owner is only blocked if the mutex was unlocked by someone else */
+        unsigned irqstate = irq_disable();
+        if (owner->blocked_on) {
+            _requeue(owner->blocked_on, owner);
+        }
+        irq_restore(irqstate);
+    }
+}
+#else
+static inline void _set_owner(mutex_t *mutex, thread_t *owner)
+{
+    (void)mutex;
+    (void)owner;
+}
+
+static inline int _unlocked_by_owner(mutex_t *mutex)
+{
+    (void)mutex;
+    return 0;
+}
+
+static inline void _set_blocked_on(thread_t *thread, mutex_t *mutex)
+{
+    (void)thread;
+    (void)mutex;
+}
+
+static inline void _inherit_priority(mutex_t *mutex, thread_t *waiter)
+{
+    (void)mutex;
+    (void)waiter;
+}
+#endif
+
 int _mutex_lock(mutex_t *mutex, int blocking)
 {
     unsigned irqstate = irq_disable();
@@ -43,6 +172,7 @@ int _mutex_lock(mutex_t *mutex, int blocking)
     if (mutex->queue.next == NULL) {
         /* mutex is unlocked. */
         mutex->queue.next = MUTEX_LOCKED;
+        _set_owner(mutex, (thread_t *)sched_active_thread);
         DEBUG("PID[%" PRIkernel_pid "]: mutex_wait early out.\n",
               sched_active_pid);
         irq_restore(irqstate);
@@ -52,6 +182,9 @@ int _mutex_lock(mutex_t *mutex, int blocking)
         thread_t *me = (thread_t*)sched_active_thread;
         DEBUG("PID[%" PRIkernel_pid "]: Adding node to mutex queue: prio: %"
               PRIu32 "\n", sched_active_pid, (uint32_t)me->priority);
+        schedtrace_add(SCHEDTRACE_MUTEX_BLOCK, me->pid, (uintptr_t)mutex);
+        _inherit_priority(mutex, me);
+        _set_blocked_on(me, mutex);
         sched_set_status(me, STATUS_MUTEX_BLOCKED);
         if (mutex->queue.next == MUTEX_LOCKED) {
             mutex->queue.next = (list_node_t*)&me->rq_entry;
@@ -63,7 +196,8 @@ int _mutex_lock(mutex_t *mutex, int blocking)
         irq_restore(irqstate);
         thread_yield_higher();
         /* We were woken up by scheduler. Waker removed us from queue.
-         * We have the mutex now. */
+         * We have the mutex now (and the waker made us its owner if it was
+         * the owner itself). */
         return 1;
     }
     else {
@@ -85,10 +219,19 @@ void mutex_unlock(mutex_t *mutex)
         return;
     }
 
+    int by_owner = _unlocked_by_owner(mutex);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    uint8_t owner_prio;
+    thread_t *owner = _release_owner(mutex, &owner_prio);
+#endif
+
     if (mutex->queue.next == MUTEX_LOCKED) {
         mutex->queue.next = NULL;
         /* the mutex was locked and no thread was waiting for it */
         irq_restore(irqstate);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+        _restore_priority(owner, owner_prio);
+#endif
         return;
     }
 
@@ -98,7 +241,12 @@ void mutex_unlock(mutex_t *mutex)
 
     DEBUG("mutex_unlock: waking up waiting thread %" PRIkernel_pid "\n",
           process->pid);
+    schedtrace_event(SCHEDTRACE_MUTEX_UNBLOCK, process->pid);
+    _set_blocked_on(process, NULL);
     sched_set_status(process, STATUS_PENDING);
+    if (by_owner) {
+        _set_owner(mutex, process);
+    }
 
     if (!mutex->queue.next) {
         mutex->queue.next = MUTEX_LOCKED;
@@ -106,6 +254,9 @@ void mutex_unlock(mutex_t *mutex)
 
     uint16_t process_priority = process->priority;
     irq_restore(irqstate);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    _restore_priority(owner, owner_prio);
+#endif
     sched_switch(process_priority);
 }
 
@@ -114,8 +265,16 @@ void mutex_unlock_and_sleep(mutex_t *mutex)
     DEBUG("PID[%" PRIkernel_pid "]: unlocking mutex. queue.next: 0x%08x, and "
           "taking a nap\n", sched_active_pid, (unsigned)mutex->queue.next);
     unsigned irqstate = irq_disable();
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    uint8_t owner_prio = 0;
+    thread_t *owner = NULL;
+#endif
 
     if (mutex->queue.next) {
+        int by_owner = _unlocked_by_owner(mutex);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+        owner = _release_owner(mutex, &owner_prio);
+#endif
         if (mutex->queue.next == MUTEX_LOCKED) {
             mutex->queue.next = NULL;
         }
@@ -124,7 +283,12 @@ void mutex_unlock_and_sleep(mutex_t *mutex)
             thread_t *process = container_of((clist_node_t*)next, thread_t,
                                              rq_entry);
             DEBUG("PID[%" PRIkernel_pid "]: waking up waiter.\n", process->pid);
+            schedtrace_event(SCHEDTRACE_MUTEX_UNBLOCK, process->pid);
+            _set_blocked_on(process, NULL);
             sched_set_status(process, STATUS_PENDING);
+            if (by_owner) {
+                _set_owner(mutex, process);
+            }
             if (!mutex->queue.next) {
                 mutex->queue.next = MUTEX_LOCKED;
             }
@@ -134,5 +298,8 @@ void mutex_unlock_and_sleep(mutex_t *mutex)
     DEBUG("PID[%" PRIkernel_pid "]: going to sleep.\n", sched_active_pid);
     sched_set_status((thread_t*)sched_active_thread, STATUS_SLEEPING);
     irq_restore(irqstate);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    _restore_priority(owner, owner_prio);
+#endif
     thread_yield_higher();
 }
@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 
+#include "assert.h"
 #include "sched.h"
 #include "clist.h"
 #include "bitarithm.h"
@@ -28,6 +29,7 @@
 #include "thread.h"
 #include "irq.h"
 #include "log.h"
+#include "schedtrace.h"
 
 #ifdef MODULE_MPU_STACK_GUARD
 #include "mpu.h"
@@ -100,6 +102,10 @@ int __attribute__((used)) sched_run(void)
         return 0;
     }
 
+    schedtrace_add(SCHEDTRACE_SWITCH,
+                   (active_thread == NULL) ? KERNEL_PID_UNDEF : active_thread->pid,
+                   next_thread->pid);
+
 #ifdef MODULE_SCHEDSTATISTICS
     uint64_t now = _xtimer_now64();
 #endif
@@ -208,6 +214,48 @@ void sched_switch(uint16_t other_prio)
     }
 }
 
+void sched_change_priority(thread_t *thread, uint8_t priority)
+{
+    assert(thread && (priority < SCHED_PRIO_LEVELS));
+
+    if (thread->priority == priority) {
+        return;
+    }
+
+    unsigned irqstate = irq_disable();
+
+    DEBUG("sched_change_priority: thread %" PRIkernel_pid " prio %" PRIu16
+          " -> %" PRIu16 "\n", thread->pid, (uint16_t)thread->priority,
+          (uint16_t)priority);
+
+    if (thread->status >= STATUS_ON_RUNQUEUE) {
+        clist_remove(&sched_runqueues[thread->priority], &(thread->rq_entry));
+        if (!sched_runqueues[thread->priority].next) {
+            runqueue_bitcache &= ~(1 << thread->priority);
+        }
+        clist_rpush(&sched_runqueues[priority], &(thread->rq_entry));
+        runqueue_bitcache |= 1 << priority;
+    }
+    thread->priority = priority;
+
+    thread_t *active_thread = (thread_t *) sched_active_thread;
+    int resched = (active_thread == thread) ||
+                  ((active_thread != NULL) &&
+                   (thread->status >= STATUS_ON_RUNQUEUE) &&
+                   (active_thread->priority > priority));
+
+    irq_restore(irqstate);
+
+    if (resched) {
+        if (irq_is_in()) {
+            sched_context_switch_request = 1;
+        }
+        else {
+            thread_yield_higher();
+        }
+    }
+}
+
 NORETURN void sched_task_exit(void)
 {
     DEBUG("sched_task_exit: ending thread %" PRIkernel_pid "...\n", sched_active_thread->pid);
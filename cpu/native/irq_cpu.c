@@ -38,6 +38,7 @@
 #include "irq.h"
 #include "cpu.h"
 #include "periph/pm.h"
+#include "schedtrace.h"
 
 #include "native_internal.h"
 
@@ -261,7 +262,9 @@ void native_irq_handler(void)
 
         if (native_irq_handlers[sig] != NULL) {
             DEBUG("native_irq_handler: calling interrupt handler for %i\n", sig);
+            schedtrace_add(SCHEDTRACE_IRQ_ENTER, KERNEL_PID_ISR, sig);
             native_irq_handlers[sig]();
+            schedtrace_add(SCHEDTRACE_IRQ_EXIT, KERNEL_PID_ISR, sig);
         }
         else if (sig == SIGUSR1) {
             warnx("native_irq_handler: ignoring SIGUSR1");
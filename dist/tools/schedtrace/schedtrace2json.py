@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""
+Converts the output of the `schedtrace` shell command (or schedtrace_dump())
+into the Chrome trace event format, which can be opened with
+https://ui.perfetto.dev or chrome://tracing.
+
+Lines not starting with "schedtrace:" are ignored, so a complete terminal log
+can be passed in. Every thread gets a track showing when it was running.
+Messages and mutex hand-overs are drawn as arrows from the sending thread to
+the point the receiving thread was scheduled.
+"""
+
+import argparse
+import collections
+import json
+import sys
+
+PREFIX = "schedtrace:"
+
+# event types, see sys/include/schedtrace.h
+SWITCH = 0
+MSG_SEND = 1
+MSG_RECV = 2
+MUTEX_BLOCK = 3
+MUTEX_UNBLOCK = 4
+IRQ_ENTER = 5
+IRQ_EXIT = 6
+TIMER = 7
+
+KERNEL_PID_UNDEF = 0
+
+
+class Converter(object):
+    def __init__(self):
+        self.events = []
+        self.names = {}
+        self.isr_pid = None
+        self.last_time = None
+        self.time_offset = 0
+        self.running = None
+        self.flow_id = 0
+        # messages sent but not yet received, by (sender, receiver)
+        self.msgs = collections.defaultdict(collections.deque)
+        # flows to close when the thread is scheduled the next time
+        self.wakeups = collections.defaultdict(list)
+
+    def _ts(self, time):
+        # the time stamps are 32 bit microseconds
+        if (self.last_time is not None) and (time < self.last_time):
+            self.time_offset += 1 << 32
+        self.last_time = time
+        return self.time_offset + time
+
+    def _add(self, ph, name, ts, tid, **kwargs):
+        event = {"name": name, "ph": ph, "ts": ts, "pid": 0, "tid": tid}
+        event.update(kwargs)
+        self.events.append(event)
+
+    def _instant(self, name, ts, tid, **args):
+        self._add("i", name, ts, tid, s="t", args=args)
+
+    def _flow_start(self, ts, tid, name):
+        self.flow_id += 1
+        self._add("s", name, ts, tid, id=self.flow_id, cat="flow")
+        return self.flow_id
+
+    def _flow_end(self, flow_id, ts, tid, name):
+        self._add("f", name, ts, tid, id=flow_id, cat="flow", bp="e")
+
+    def _name(self, pid):
+        if pid == self.isr_pid:
+            return "ISR"
+        return self.names.get(pid, "pid %d" % pid)
+
+    def begin(self, bufsize, lost, isr_pid):
+        self.isr_pid = isr_pid
+        if lost:
+            sys.stderr.write("warning: %d events were lost, increase "
+                             "SCHEDTRACE_BUFSIZE (currently %d) or dump more "
+                             "often\n" % (lost, bufsize))
+
+    def thread(self, pid, name):
+        self.names[pid] = name
+
+    def event(self, time, type_, pid, arg):
+        ts = self._ts(time)
+
+        if type_ == SWITCH:
+            # pid is the thread switched away from, its slice was not opened
+            # if the trace starts with this switch
+            if self.running == pid and pid != KERNEL_PID_UNDEF:
+                self._add("E", "running", ts, pid)
+            self._add("B", "running", ts, arg)
+            for flow_id, name in self.wakeups.pop(arg, []):
+                self._flow_end(flow_id, ts, arg, name)
+            self.running = arg
+        elif type_ == MSG_SEND:
+            name = "msg %s -> %s" % (self._name(pid), self._name(arg))
+            self._instant(name, ts, pid, to=arg)
+            self.msgs[(pid, arg)].append(self._flow_start(ts, pid, name))
+        elif type_ == MSG_RECV:
+            name = "msg %s -> %s" % (self._name(arg), self._name(pid))
+            self._instant(name, ts, pid, sender=arg)
+            pending = self.msgs.get((arg, pid))
+            if pending:
+                self._flow_end(pending.popleft(), ts, pid, name)
+        elif type_ == MUTEX_BLOCK:
+            self._instant("mutex blocked", ts, pid, mutex="0x%08x" % arg)
+        elif type_ == MUTEX_UNBLOCK:
+            name = "mutex %s -> %s" % (self._name(pid), self._name(arg))
+            self._instant(name, ts, pid, woken=arg)
+            self.wakeups[arg].append((self._flow_start(ts, pid, name), name))
+        elif type_ == IRQ_ENTER:
+            self._add("B", "irq %d" % arg, ts, pid)
+        elif type_ == IRQ_EXIT:
+            self._add("E", "irq %d" % arg, ts, pid)
+        elif type_ == TIMER:
+            self._instant("timer 0x%08x" % arg, ts, pid, callback="0x%08x" % arg)
+        else:
+            self._instant("user %d" % type_, ts, pid, arg=arg)
+
+    def parse(self, lines):
+        for line in lines:
+            line = line.strip()
+            # strip anything a terminal program prepended
+            start = line.find(PREFIX)
+            if start < 0:
+                continue
+            fields = line[start + len(PREFIX):].split()
+            if not fields:
+                continue
+            try:
+                if fields[0] == "begin":
+                    self.begin(int(fields[1]), int(fields[2]), int(fields[3]))
+                elif fields[0] == "thread":
+                    self.thread(int(fields[1]), " ".join(fields[2:]))
+                elif fields[0] == "e":
+                    self.event(int(fields[1]), int(fields[2]), int(fields[3]),
+                               int(fields[4], 16))
+            except (IndexError, ValueError):
+                sys.stderr.write("warning: ignoring malformed line: %s\n" % line)
+
+    def trace(self):
+        meta = [{"name": "process_name", "ph": "M", "pid": 0,
+                 "args": {"name": "RIOT"}}]
+        pids = set(e["tid"] for e in self.events)
+        for pid in sorted(pids):
+            meta.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": pid,
+                         "args": {"name": self._name(pid)}})
+        return {"traceEvents": meta + self.events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin,
+                        help="terminal log with the schedtrace dump (default: stdin)")
+    parser.add_argument("-o", "--output", type=argparse.FileType("w"),
+                        default=sys.stdout,
+                        help="output file (default: stdout)")
+    args = parser.parse_args()
+
+    converter = Converter()
+    converter.parse(args.log)
+    json.dump(converter.trace(), args.output)
+    args.output.write("\n")
+
+
+if __name__ == "__main__":
+    main()
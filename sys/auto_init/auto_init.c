@@ -32,6 +32,10 @@
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_SCHEDTRACE
+#include "schedtrace.h"
+#endif
+
 #ifdef MODULE_RTC
 #include "periph/rtc.h"
 #endif
@@ -96,6 +100,10 @@ void auto_init(void)
     DEBUG("Auto init xtimer module.\n");
     xtimer_init();
 #endif
+#ifdef MODULE_SCHEDTRACE
+    DEBUG("Auto init schedtrace module.\n");
+    schedtrace_start();
+#endif
 #ifdef MODULE_RTC
     DEBUG("Auto init rtc module.\n");
     rtc_init();
@@ -22,9 +22,20 @@
  * transport.
  *
  * The implementation is based on a 2-thread model: emCute needs one thread of
- * its own, in which receiving of packets and sending of ping messages are
- * handled. All 'user space functions' have to run from (a) different (i.e.
- * user) thread(s). emCute uses thread flags to synchronize between threads.
+ * its own, in which receiving of packets, retransmissions, and sending of ping
+ * messages are handled. All 'user space functions' have to run from (a)
+ * different (i.e. user) thread(s). emCute uses thread flags to wake up its
+ * thread. With `sock_async` (provided by GNRC), it sleeps until a packet
+ * arrives or a timer fires; without it, it polls its timers at least every
+ * @ref EMCUTE_T_RETRY seconds.
+ *
+ * Messages that expect a response are kept in an in-flight table of
+ * @ref EMCUTE_INFLIGHT_MAX slots until the response arrives. Each slot has its
+ * own retransmit timer. Several threads can wait for responses at the same
+ * time, and emcute_pub_async() keeps up to @ref EMCUTE_INFLIGHT_MAX QoS 1
+ * publish messages in flight without waiting for the PUBACK of each.
+ * Likewise, emcute_reg_batch() registers several topics at once, e.g. right
+ * after connecting.
  *
  * Further know restrictions are:
  * - ASCII topic names only (no support for UTF8 names, yet)
@@ -59,6 +70,7 @@
  * - updating will message
  * - sending out periodic PINGREQ messages
  * - handling re-transmits
+ * - pipelining QoS 1 publish messages and topic registrations
  *
  * The following features are however still missing (but planned):
  * @todo        Gateway discovery (so far there is no support for handling
@@ -106,11 +118,22 @@ extern "C" {
 /**
  * @brief   Buffer size used for emCute's transmit and receive buffers
  *
- * The overall buffer size used by emCute is this value time two (Rx + Tx).
+ * The overall buffer size used by emCute is this value times
+ * (@ref EMCUTE_INFLIGHT_MAX + 1) (Rx + one Tx buffer per in-flight slot).
  */
 #define EMCUTE_BUFSIZE          (512U)
 #endif
 
+#ifndef EMCUTE_INFLIGHT_MAX
+/**
+ * @brief   Maximum number of messages waiting for their response
+ *
+ * Every slot keeps a copy of its message for retransmission, so each one costs
+ * @ref EMCUTE_BUFSIZE bytes of RAM. Set to 1 to send one message at a time.
+ */
+#define EMCUTE_INFLIGHT_MAX     (4U)
+#endif
+
 #ifndef EMCUTE_ID_MAXLEN
 /**
  * @brief   Maximum client ID length
@@ -290,6 +313,56 @@ int emcute_reg(emcute_topic_t *topic);
 int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
                unsigned flags);
 
+/**
+ * @brief   Get topic IDs for several topic names from the gateway
+ *
+ * Up to @ref EMCUTE_INFLIGHT_MAX REGISTER messages are in flight at the same
+ * time, so this takes about one round trip per @ref EMCUTE_INFLIGHT_MAX
+ * topics instead of one per topic.
+ *
+ * @param[in,out] topics    topics to register, their names **must not** be
+ *                          NULL
+ * @param[in] numof         number of entries in @p topics
+ *
+ * @return  EMCUTE_OK when all topics were registered
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if length of a topic name exceeds
+ *          @ref EMCUTE_TOPIC_MAXLEN, no topic is registered in that case
+ * @return  EMCUTE_REJECT or EMCUTE_TIMEOUT for the first topic that failed,
+ *          the IDs of the other topics are set nevertheless
+ */
+int emcute_reg_batch(emcute_topic_t *topics, size_t numof);
+
+/**
+ * @brief   Publish data on the given topic without waiting for the PUBACK
+ *
+ * Returns as soon as the message is sent. For QoS 1, the message stays in
+ * flight and is retransmitted until the gateway acknowledges it; this only
+ * blocks while @ref EMCUTE_INFLIGHT_MAX messages are in flight already. Use
+ * emcute_flush() to wait for the acknowledgments and get the result.
+ *
+ * @param[in] topic     topic to send data to, topic **must** be registered
+ *                      (topic.id **must** populated).
+ * @param[in] buf       data to publish, it is copied
+ * @param[in] len       length of @p data in bytes
+ * @param[in] flags     flags used for publication, allowed are QoS and retain
+ *
+ * @return  EMCUTE_OK when the message was sent
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if length of data exceeds @ref EMCUTE_BUFSIZE
+ * @return  EMCUTE_NOTSUP on unsupported flag values
+ */
+int emcute_pub_async(emcute_topic_t *topic, const void *buf, size_t len,
+                     unsigned flags);
+
+/**
+ * @brief   Wait until all messages of emcute_pub_async() are acknowledged
+ *
+ * @return  EMCUTE_OK if all messages since the last call were acknowledged
+ * @return  EMCUTE_REJECT or EMCUTE_TIMEOUT for the first message that failed
+ */
+int emcute_flush(void);
+
 /**
  * @brief   Subscribe to the given topic
  *
@@ -11,6 +11,16 @@
  * @ingroup     net
  * @brief       FIB implementation
  *
+ * Single hop entries are indexed by a path-compressed binary trie, so
+ * looking up the next hop for a destination takes time proportional to the
+ * address length instead of the number of entries. An exact match of the
+ * destination address is preferred, otherwise the entry with the longest
+ * matching prefix is used.
+ *
+ * Entries are expired in the background: a timer fires when the next entry
+ * expires and the expired entries are removed on the next access to the
+ * table.
+ *
  * @{
  *
  * @file
@@ -465,6 +475,23 @@ int fib_sr_get_route(fib_table_t *table, uint8_t *dst, size_t dst_size, kernel_p
  */
 int fib_get_num_used_entries(fib_table_t *table);
 
+/**
+ * @brief returns the version of the single hop entries of a table
+ *
+ * The version changes whenever an entry is added, updated or removed and
+ * as soon as an entry expires, so users can tell if lookup results they
+ * cached are still valid. It does not lock the table, so it can be called
+ * for every packet.
+ *
+ * @param[in] table         the fib instance to check
+ *
+ * @return the current version of @p table
+ */
+static inline unsigned fib_get_version(fib_table_t *table)
+{
+    return table->version;
+}
+
 /**
  * @brief Prints the kernel_pid_t for all registered RRPs
  */
@@ -24,6 +24,7 @@
 #include "kernel_types.h"
 #include "universal_address.h"
 #include "mutex.h"
+#include "xtimer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,10 +36,30 @@ extern "C" {
  */
 #define FIB_MAX_REGISTERED_RP (5)
 
+/**
+ * @brief Node of the longest prefix match index over the FIB entries
+ *
+ * The index is a path-compressed binary trie (Patricia trie). Keys are the
+ * address size in bytes followed by the address bits, so addresses of
+ * different sizes never match each other. Nodes are either holding an entry
+ * or are branching nodes with exactly two sub-trees.
+ * These nodes are managed by the FIB and must not be touched by its users.
+ */
+typedef struct fib_trie_node {
+    /** sub-trees, selected by the first key bit behind this node */
+    struct fib_trie_node *child[2];
+    /** next entry with the same prefix */
+    struct fib_trie_node *next;
+    /** number of significant key bits (including the address size) */
+    uint16_t len;
+    /** type of this node, unused, entry or branch */
+    uint8_t type;
+} fib_trie_node_t;
+
 /**
  * @brief Container descriptor for a FIB entry
  */
-typedef struct {
+typedef struct fib_entry {
     /** interface ID */
     kernel_pid_t iface_id;
     /** Lifetime of this entry (an absolute time-point is stored by the FIB) */
@@ -51,6 +72,10 @@ typedef struct {
     uint32_t next_hop_flags;
     /** Pointer to the shared generic address */
     universal_address_container_t *next_hop;
+    /** index node holding this entry */
+    fib_trie_node_t trie_node;
+    /** spare branching node for the index, every entry provides one */
+    fib_trie_node_t trie_branch;
 } fib_entry_t;
 
 /**
@@ -133,6 +158,22 @@ typedef struct {
     *   e.g. when the unreachable destination is covered by the prefix
     */
     universal_address_container_t* prefix_rp[FIB_MAX_REGISTERED_RP];
+    /** incremented on every change of the single hop entries and when the
+    *   expiry timer fires, so users can tell if lookup results they cached
+    *   are still valid. Use fib_get_version() to read it. A machine word, so
+    *   it can be read without locking the table.
+    */
+    volatile unsigned version;
+    /** root of the longest prefix match index over the single hop entries */
+    fib_trie_node_t *trie_root;
+    /** timer firing when the next single hop entry expires */
+    xtimer_t expiry_timer;
+    /** absolute time in us the expiry timer is set to, 0 if not set */
+    uint64_t next_expiry;
+    /** set by the expiry timer, expired entries are removed on the next
+    *   access to the table
+    */
+    volatile uint8_t expiry_pending;
 } fib_table_t;
 
 #ifdef __cplusplus
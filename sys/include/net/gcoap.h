@@ -20,9 +20,11 @@
  * response requires from one to three well-defined steps, depending on
  * inclusion of a payload.
  *
- * gcoap allocates a RIOT message processing thread, so a single instance can
- * serve multiple applications. This approach also means gcoap uses a single UDP
- * port, which supports RFC 6282 compression. Internally, gcoap depends on the
+ * gcoap handles its messages in the event thread of
+ * @ref net_sock_async_event, which it shares with other protocols, so a single
+ * instance can serve multiple applications without a thread of its own. This
+ * approach also means gcoap uses a single UDP port, which supports RFC 6282
+ * compression. Internally, gcoap depends on the
  * nanocoap package for base level structs and functionality.
  *
  * gcoap also supports the Observe extension (RFC 7641) for a server. gcoap
@@ -37,7 +39,9 @@
  * gcoap allows an application to specify a collection of request resource paths
  * it wants to be notified about. Create an array of resources, coap_resource_t
  * structs. Use gcoap_register_listener() at application startup to pass in
- * these resources, wrapped in a gcoap_listener_t.
+ * these resources, wrapped in a gcoap_listener_t. The resources of a listener
+ * must be sorted by path, in the order of strcmp(), since gcoap looks them up
+ * by binary search.
  *
  * gcoap itself defines a resource for `/.well-known/core` discovery, which
  * lists all of the registered paths.
@@ -165,8 +169,8 @@
  *
  * ### Waiting for a response ###
  *
- * We take advantage of RIOT's asynchronous messaging by using an xtimer to wait
- * for a response, so the gcoap thread does not block while waiting. The user is
+ * We take advantage of the event thread by using an xtimer to wait for a
+ * response, so the thread does not block while waiting. The user is
  * notified via the same callback, whether the message is received or the wait
  * times out. We track the response with an entry in the
  * `_coap_state.open_reqs` array.
@@ -183,6 +187,7 @@
 #define GCOAP_H
 
 #include "net/sock/udp.h"
+#include "net/sock/async/event.h"
 #include "nanocoap.h"
 #include "xtimer.h"
 
@@ -190,9 +195,6 @@
 extern "C" {
 #endif
 
-/** @brief Size for module message queue */
-#define GCOAP_MSG_QUEUE_SIZE    (4)
-
 /** @brief Server port; use RFC 7252 default if not defined */
 #ifndef GCOAP_PORT
 #define GCOAP_PORT              (5683)
@@ -223,8 +225,10 @@ extern "C" {
  */
 #define GCOAP_OBS_OPTIONS_BUF  (8)
 
-/** @brief Maximum number of requests awaiting a response */
+/** @brief Maximum number of requests awaiting a response; use 2 if not defined */
+#ifndef GCOAP_REQ_WAITING_MAX
 #define GCOAP_REQ_WAITING_MAX   (2)
+#endif
 
 /** @brief Maximum length in bytes for a token */
 #define GCOAP_TOKENLEN_MAX      (8)
@@ -251,9 +255,6 @@ extern "C" {
 #define GCOAP_MEMO_ERR          (4)  /**< Error processing response packet */
 /** @} */
 
-/** @brief Time in usec that the event loop waits for an incoming CoAP message */
-#define GCOAP_RECV_TIMEOUT      (1 * US_PER_SEC)
-
 /**
  *
  * @brief Default time to wait for a non-confirmable response, in usec
@@ -262,17 +263,6 @@ extern "C" {
  */
 #define GCOAP_NON_TIMEOUT       (5000000U)
 
-/** @brief Identifies waiting timed out for a response to a sent message. */
-#define GCOAP_MSG_TYPE_TIMEOUT  (0x1501)
-
-/**
- * @brief Identifies a request to interrupt listening for an incoming message
- *        on a sock.
- *
- * Allows the event loop to process IPC messages.
- */
-#define GCOAP_MSG_TYPE_INTR     (0x1502)
-
 /** @brief Maximum number of Observe clients; use 2 if not defined */
 #ifndef GCOAP_OBS_CLIENTS_MAX
 #define GCOAP_OBS_CLIENTS_MAX  (2)
@@ -341,7 +331,8 @@ extern "C" {
  */
 typedef struct gcoap_listener {
     coap_resource_t *resources;     /**< First element in the array of
-                                     *   resources; must order alphabetically */
+                                     *   resources; must be sorted by path,
+                                     *   as by strcmp() */
     size_t resources_len;           /**< Length of array */
     struct gcoap_listener *next;    /**< Next listener in list */
 } gcoap_listener_t;
@@ -363,7 +354,7 @@ typedef struct {
                                         /**< Stores a copy of the request header */
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
     xtimer_t response_timer;            /**< Limits wait for response */
-    msg_t timeout_msg;                  /**< For response timer */
+    sock_event_t timeout_event;         /**< For response timer */
 } gcoap_request_memo_t;
 
 /** @brief  Memo for Observe registration and notifications */
@@ -392,12 +383,12 @@ typedef struct {
 } gcoap_state_t;
 
 /**
- * @brief   Initializes the gcoap thread and device.
+ * @brief   Initializes gcoap and its sock.
  *
  * Must call once before first use.
  *
- * @return  PID of the gcoap thread on success.
- * @return  -EEXIST, if thread already has been created.
+ * @return  PID of the event thread handling gcoap on success.
+ * @return  -EEXIST, if gcoap already has been initialized.
  * @return  -EINVAL, if the IP port already is in use.
  */
 kernel_pid_t gcoap_init(void);
@@ -409,6 +400,20 @@ kernel_pid_t gcoap_init(void);
  */
 void gcoap_register_listener(gcoap_listener_t *listener);
 
+/**
+ * @brief   Finds the registered resource for a path and method.
+ *
+ * This is the lookup gcoap uses to dispatch requests.
+ *
+ * @param[in] path          Path of the resource
+ * @param[in] method_flag   Method of the request as flag, e.g. COAP_GET
+ *
+ * @return  The first resource of the registered listeners matching @p path
+ *          and @p method_flag
+ * @return  NULL, if no resource matches
+ */
+const coap_resource_t *gcoap_find_resource(const char *path, unsigned method_flag);
+
 /**
  * @brief  Initializes a CoAP request PDU on a buffer.
  *
@@ -94,6 +94,8 @@ extern "C" {
  *
  * @details This variable is preferred for IPv6 internal communication *only*.
  *          Please use @ref net_gnrc_netreg for external communication.
+ *          With @ref net_gnrc_single_thread this is the PID of the network
+ *          thread.
  */
 extern kernel_pid_t gnrc_ipv6_pid;
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_ipv6_dcache  IPv6 destination cache
+ * @ingroup     net_gnrc_ipv6
+ * @brief       Caches the next hop resolution for recently used destinations
+ *
+ * Without this module every packet sent by @ref net_gnrc_ipv6 looks up the
+ * neighbor cache, the FIB and the neighbor cache again to find the link layer
+ * address of the next hop. The destination cache is a small hash table
+ * mapping a destination address to the neighbor cache entry of its next hop,
+ * so packets of an established flow skip these lookups. Each entry also keeps
+ * the path MTU towards its destination, which starts at the MTU of the
+ * interface of the next hop and is lowered by ICMPv6 Packet Too Big messages.
+ *
+ * An entry is only used while
+ *  - the FIB was not changed since the next hop was determined and none of
+ *    its routes expired,
+ *  - the neighbor cache entry still holds the same next hop address and its
+ *    flags (state, type, router flag) did not change.
+ *
+ * Otherwise the full next hop determination is done and the entry replaced.
+ * Changes to the addresses or prefixes of an interface flush the cache.
+ *
+ * Use it with
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_ipv6_dcache
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief   Destination cache definitions
+ */
+#ifndef GNRC_IPV6_DCACHE_H
+#define GNRC_IPV6_DCACHE_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef GNRC_IPV6_DCACHE_SIZE
+/**
+ * @brief   Number of entries in the destination cache
+ *
+ * @note    Must be a power of 2
+ */
+#define GNRC_IPV6_DCACHE_SIZE       (8U)
+#endif
+
+/**
+ * @brief   Statistics of the destination cache
+ */
+typedef struct {
+    uint32_t hits;      /**< lookups answered by the cache */
+    uint32_t misses;    /**< lookups that needed a full next hop determination */
+} gnrc_ipv6_dcache_stats_t;
+
+/**
+ * @brief   Get the version of the routing state cached next hops depend on
+ *
+ * Read it before a full next hop determination and pass it with the result
+ * to gnrc_ipv6_dcache_add(), so a change of the FIB during the
+ * determination is noticed.
+ *
+ * @return  The version of the FIB of @ref net_gnrc_ipv6, 0 without
+ *          @ref net_fib. Reading it does not lock the FIB.
+ */
+unsigned gnrc_ipv6_dcache_get_version(void);
+
+/**
+ * @brief   Looks up the link layer address of the next hop towards @p dst
+ *
+ * @pre (l2addr != NULL) && (l2addr_len != NULL) && (dst != NULL)
+ *
+ * @param[out] l2addr       The link layer address of the next hop.
+ *                          Must be at least @ref GNRC_IPV6_NC_L2_ADDR_MAX
+ *                          bytes long.
+ * @param[out] l2addr_len   Length of @p l2addr.
+ * @param[in] iface         The interface the lookup is restricted to,
+ *                          KERNEL_PID_UNDEF for any.
+ * @param[in] dst           The destination address.
+ *
+ * @return  The interface of the next hop on a hit.
+ * @return  KERNEL_PID_UNDEF on a miss.
+ */
+kernel_pid_t gnrc_ipv6_dcache_get(uint8_t *l2addr, uint8_t *l2addr_len,
+                                  kernel_pid_t iface, const ipv6_addr_t *dst);
+
+/**
+ * @brief   Adds the result of a full next hop determination to the cache
+ *
+ * Nothing is cached if @p nc is NULL or not reachable.
+ *
+ * @param[in] iface     The interface the lookup was restricted to,
+ *                      KERNEL_PID_UNDEF for any.
+ * @param[in] dst       The destination address.
+ * @param[in] nc        The neighbor cache entry the next hop determination
+ *                      resolved @p dst to.
+ * @param[in] version   The result of gnrc_ipv6_dcache_get_version() before
+ *                      the next hop determination.
+ */
+void gnrc_ipv6_dcache_add(kernel_pid_t iface, const ipv6_addr_t *dst,
+                          gnrc_ipv6_nc_t *nc, unsigned version);
+
+/**
+ * @brief   Get the path MTU towards @p dst
+ *
+ * @pre (dst != NULL)
+ *
+ * @param[in] iface     The interface the lookup is restricted to,
+ *                      KERNEL_PID_UNDEF for any.
+ * @param[in] dst       The destination address.
+ *
+ * @return  The path MTU towards @p dst, if @p dst is cached.
+ * @return  0, if @p dst is not cached.
+ */
+uint16_t gnrc_ipv6_dcache_get_pmtu(kernel_pid_t iface, const ipv6_addr_t *dst);
+
+/**
+ * @brief   Lowers the path MTU towards @p dst
+ *
+ * To be called for received ICMPv6 Packet Too Big messages. The path MTU is
+ * never raised and never set below @ref IPV6_MIN_MTU (see
+ * <a href="https://tools.ietf.org/html/rfc8201#section-4">RFC 8201,
+ * section 4</a>). Nothing happens if @p dst is not cached.
+ *
+ * @pre (dst != NULL)
+ *
+ * @param[in] dst       The destination address of the packet that was too
+ *                      big.
+ * @param[in] mtu       The MTU reported by the Packet Too Big message.
+ */
+void gnrc_ipv6_dcache_update_pmtu(const ipv6_addr_t *dst, uint32_t mtu);
+
+/**
+ * @brief   Removes all entries from the destination cache
+ */
+void gnrc_ipv6_dcache_flush(void);
+
+/**
+ * @brief   Get the statistics of the destination cache
+ *
+ * @param[out] stats    The hit and miss counters
+ */
+void gnrc_ipv6_dcache_get_stats(gnrc_ipv6_dcache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_IPV6_DCACHE_H */
+/** @} */
@@ -10,6 +10,12 @@
  * @defgroup    net_gnrc_ipv6_nc  IPv6 neighbor cache
  * @ingroup     net_gnrc_ipv6
  * @brief       Translates IPv6 addresses to link layer addresses.
+ *
+ * Entries are found through a hash index over their IPv6 address, so
+ * looking up a neighbor does not depend on the size of the cache. If the
+ * cache is full, adding a neighbor evicts the least recently used entry
+ * that was learned by neighbor discovery and is neither a router nor a
+ * registered 6LoWPAN node.
  * @{
  *
  * @file
@@ -163,6 +169,17 @@ typedef struct {
 #endif
 
     uint8_t probes_remaining;               /**< remaining number of unanswered probes */
+    /**
+     * @brief   Generation of the entry
+     *
+     * Changes whenever the entry is added or removed. Holders of a pointer
+     * to the entry store it along with the pointer and compare it before
+     * using the pointer again, since the entry may have been evicted and
+     * reused for another neighbor in the meantime.
+     */
+    uint16_t gen;
+    uint32_t last_used;                     /**< time stamp of the last use for
+                                             *   least recently used eviction */
     /**
      * @}
      */
@@ -183,6 +200,12 @@ void gnrc_ipv6_nc_init(void);
  *                          to GNRC_IPV6_L2_ADDR_MAX. 0 if unknown.
  * @param[in] flags         Flags for the entry
  *
+ * If the neighbor cache is full, the least recently used entry that is
+ * neither unmanaged, a router nor registered is removed for the new one.
+ * This invalidates all pointers held to the evicted entry: check
+ * gnrc_ipv6_nc_t::gen before using a pointer that was stored across calls
+ * to this function.
+ *
  * @return  Pointer to new neighbor cache entry on success
  * @return  NULL, on failure
  */
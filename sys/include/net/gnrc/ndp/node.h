@@ -35,6 +35,8 @@ extern "C" {
  * @param[in] dst               An IPv6 address to search the next hop for.
  * @param[in] pkt               Packet to send to @p dst. Leave NULL if you
  *                              just want to get the addresses.
+ * @param[out] nce              The neighbor cache entry of the next hop, on
+ *                              success. May be NULL.
  *
  * @return  The PID of the interface, on success.
  * @return  -EHOSTUNREACH, if @p dst is not reachable.
@@ -43,7 +45,8 @@ extern "C" {
  */
 kernel_pid_t gnrc_ndp_node_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len,
                                            kernel_pid_t iface, ipv6_addr_t *dst,
-                                           gnrc_pktsnip_t *pkt);
+                                           gnrc_pktsnip_t *pkt,
+                                           gnrc_ipv6_nc_t **nce);
 
 #ifdef __cplusplus
 }
@@ -102,6 +102,15 @@ typedef struct gnrc_netdev {
      */
     kernel_pid_t pid;
 
+    /**
+     * @brief Length of the link-layer header of the last frame received
+     *
+     * Frames of a network mostly use the same addressing, so it is a good
+     * guess to place the next frame in the packet buffer for its header to be
+     * split off without copying (see gnrc_pktbuf_reserve()).
+     */
+    uint8_t rx_hdr_len_hint;
+
 #ifdef MODULE_GNRC_MAC
     /**
      * @brief general information for the MAC protocol
@@ -53,6 +53,36 @@ typedef enum {
 } gnrc_netreg_type_t;
 #endif
 
+/**
+ * @brief   Expected number of registrations of one protocol type
+ *
+ * E.g. the number of UDP ports an application listens on with socks or
+ * servers at the same time. It is only used to size the hash table of the
+ * registry, more registrations are still possible.
+ */
+#ifndef GNRC_NETREG_EXPECTED_ENTRIES
+#define GNRC_NETREG_EXPECTED_ENTRIES    (8U)
+#endif
+
+/**
+ * @brief   Number of hash buckets per protocol type
+ *
+ * Entries are kept in the bucket gnrc_netreg_entry_t::demux_ctx modulo
+ * this value, so e.g. a UDP packet is only matched against the entries of
+ * the sockets with a port in the same bucket. Defaults to
+ * @ref GNRC_NETREG_EXPECTED_ENTRIES rounded up to a power of 2 (at most 32),
+ * so a bucket holds about one entry.
+ *
+ * @note    Must be a power of 2
+ */
+#ifndef GNRC_NETREG_BUCKETS
+#define GNRC_NETREG_BUCKETS         ((GNRC_NETREG_EXPECTED_ENTRIES <= 2U) ? 2U : \
+                                     (GNRC_NETREG_EXPECTED_ENTRIES <= 4U) ? 4U : \
+                                     (GNRC_NETREG_EXPECTED_ENTRIES <= 8U) ? 8U : \
+                                     (GNRC_NETREG_EXPECTED_ENTRIES <= 16U) ? 16U : \
+                                     32U)
+#endif
+
 /**
  * @brief   Demux context value to get all packets of a certain type.
  *
@@ -69,7 +99,7 @@ typedef enum {
  *
  * @return  An initialized netreg entry
  */
-#ifdef MODULE_GNRC_NETAPI_MBOX
+#if defined(MODULE_GNRC_NETAPI_MBOX) || defined(MODULE_GNRC_NETAPI_CALLBACKS)
 #define GNRC_NETREG_ENTRY_INIT_PID(demux_ctx, pid)  { NULL, demux_ctx, \
                                                       GNRC_NETREG_TYPE_DEFAULT, \
                                                       { pid } }
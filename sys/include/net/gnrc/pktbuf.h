@@ -87,6 +87,32 @@ void gnrc_pktbuf_init(void);
 gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
                                 gnrc_nettype_t type);
 
+/**
+ * @brief   Reserves space in the packet buffer for a frame a network device
+ *          driver receives into directly.
+ *
+ * This is the first half of a reserve-then-commit receive: the caller lets the
+ * driver write the frame into gnrc_pktsnip_t::data of the result and then
+ * commits the number of bytes actually received with
+ * @ref gnrc_pktbuf_realloc_data() (which shrinks the data in place).
+ *
+ * The data is placed in the packet buffer so that the byte following the
+ * first @p hdr_size bytes (e.g. the link-layer header) is aligned. A
+ * subsequent `gnrc_pktbuf_mark(pkt, hdr_size, type)` then splits the header
+ * off in place instead of copying the frame.
+ *
+ * @param[in] size      Maximum length of the frame. Must not be 0.
+ * @param[in] hdr_size  Expected length of the header at the start of the
+ *                      frame. Only a hint: any value is valid, but a wrong
+ *                      one costs a copy in gnrc_pktbuf_mark().
+ * @param[in] type      Protocol type of the gnrc_pktsnip_t.
+ *
+ * @return  The new packet snip of length @p size on success.
+ * @return  NULL, if @p size is 0 or no space is left in the packet buffer.
+ */
+gnrc_pktsnip_t *gnrc_pktbuf_reserve(size_t size, size_t hdr_size,
+                                    gnrc_nettype_t type);
+
 /**
  * @brief   Marks the first @p size bytes in a received packet with a new
  *          packet snip that is appended to the packet.
@@ -107,6 +133,11 @@ gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
  * If `size == pkt->size` then the resulting snip will point to NULL in its
  * gnrc_pktsnip_t::data field and its gnrc_pktsnip_t::size field will be 0.
  *
+ * The data is split in place if the packet buffer implementation allows it
+ * (e.g. if the split point is aligned), otherwise it is copied. See
+ * @ref gnrc_pktbuf_reserve() for how to receive a frame so that its header can
+ * be split off in place.
+ *
  * @pre @p pkt != NULL && @p size != 0
  *
  * @param[in] pkt   A received packet.
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_pktbuf_slab   Size-class packet buffer
+ * @ingroup     net_gnrc_pktbuf
+ * @brief       Packet buffer backend using fixed size slabs
+ *
+ * This is an alternative to the default `gnrc_pktbuf_static` backend. Instead
+ * of a first-fit search in one memory area, memory is split into several
+ * size classes with a fixed number of equally sized objects each: one class
+ * for @ref gnrc_pktsnip_t headers and four classes for packet data (small
+ * headers like UDP, IPv6 headers, IEEE 802.15.4 frames, and full-MTU
+ * packets). Allocation and release are O(1) and the buffer can not fragment.
+ * If a class is exhausted, the next larger class is used.
+ *
+ * @ref gnrc_pktbuf_mark() always splits data in place: both parts keep
+ * referencing the same object, which is freed when both parts are released.
+ *
+ * Use it with
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_pktbuf_slab
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * The size and number of the objects of each class can be configured with
+ * the macros below. Statistics about the usage of each class are available
+ * with @ref gnrc_pktbuf_slab_get_stats() and the `pktbuf` shell command.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Configuration and statistics of the size-class packet buffer
+ */
+#ifndef GNRC_PKTBUF_SLAB_H
+#define GNRC_PKTBUF_SLAB_H
+
+#include <stdint.h>
+
+#include "net/gnrc/pktbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of @ref gnrc_pktsnip_t headers
+ */
+#ifndef GNRC_PKTBUF_SLAB_SNIP_NUMOF
+#define GNRC_PKTBUF_SLAB_SNIP_NUMOF     (32U)
+#endif
+
+/**
+ * @name    Data size classes
+ *
+ * The sizes must be in ascending order. They are rounded up to multiples of the
+ * pointer size, so all objects are aligned.
+ * @{
+ */
+#ifndef GNRC_PKTBUF_SLAB_SIZE_1
+#define GNRC_PKTBUF_SLAB_SIZE_1         (16U)   /**< small headers (e.g. UDP) */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_NUMOF_1
+#define GNRC_PKTBUF_SLAB_NUMOF_1        (32U)   /**< number of small objects */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_SIZE_2
+#define GNRC_PKTBUF_SLAB_SIZE_2         (48U)   /**< IPv6 and netif headers */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_NUMOF_2
+#define GNRC_PKTBUF_SLAB_NUMOF_2        (16U)   /**< number of header objects */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_SIZE_3
+#define GNRC_PKTBUF_SLAB_SIZE_3         (128U)  /**< IEEE 802.15.4 frames */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_NUMOF_3
+#define GNRC_PKTBUF_SLAB_NUMOF_3        (12U)   /**< number of frame objects */
+#endif
+/**
+ * @brief   Full-MTU class
+ *
+ * Large enough for an IPv6 packet of the minimum MTU of 1280 bytes, which is
+ * the largest packet 6LoWPAN reassembles. Ethernet devices (module
+ * `netdev_eth`) receive whole frames of up to 1514 bytes into one object, so
+ * the class is raised to 1536 bytes for them.
+ */
+#ifndef GNRC_PKTBUF_SLAB_SIZE_4
+#ifdef MODULE_NETDEV_ETH
+#define GNRC_PKTBUF_SLAB_SIZE_4         (1536U)
+#else
+#define GNRC_PKTBUF_SLAB_SIZE_4         (1280U)
+#endif
+#endif
+#ifndef GNRC_PKTBUF_SLAB_NUMOF_4
+#define GNRC_PKTBUF_SLAB_NUMOF_4        (3U)    /**< number of MTU objects */
+#endif
+/** @} */
+
+/**
+ * @brief   Number of size classes (including the one for packet snips)
+ */
+#define GNRC_PKTBUF_SLAB_CLASSES        (5U)
+
+/**
+ * @brief   Usage statistics of one size class
+ */
+typedef struct {
+    uint16_t size;          /**< size of the objects in bytes */
+    uint16_t numof;         /**< number of objects */
+    uint16_t used;          /**< number of objects currently in use */
+    uint16_t max_used;      /**< maximum number of objects in use at once */
+    uint32_t allocs;        /**< number of successful allocations */
+    uint32_t fallbacks;     /**< allocations that had to use a larger class
+                             *   because this class was exhausted */
+    uint32_t fails;         /**< allocations that failed because this and all
+                             *   larger classes were exhausted */
+    uint32_t req_bytes;     /**< sum of requested bytes over all allocations,
+                             *   compare with `allocs * size` for internal
+                             *   fragmentation */
+} gnrc_pktbuf_slab_stats_t;
+
+/**
+ * @brief   Get a snapshot of the statistics of a size class
+ *
+ * Class 0 holds packet snip headers, classes 1 to 4 packet data.
+ *
+ * @param[in] cls       A size class < @ref GNRC_PKTBUF_SLAB_CLASSES
+ * @param[out] stats    The statistics of @p cls
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p cls is invalid
+ */
+int gnrc_pktbuf_slab_get_stats(unsigned cls, gnrc_pktbuf_slab_stats_t *stats);
+
+/**
+ * @brief   Prints the statistics of all size classes to stdout
+ */
+void gnrc_pktbuf_slab_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_PKTBUF_SLAB_H */
+/** @} */
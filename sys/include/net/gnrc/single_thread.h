@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_single_thread  Single-thread GNRC
+ * @ingroup     net_gnrc
+ * @brief       Runs the GNRC network layers in one thread
+ *
+ * By default every layer of GNRC (@ref net_gnrc_sixlowpan, @ref net_gnrc_ipv6,
+ * @ref net_gnrc_udp) runs in its own thread, with its own stack and message
+ * queue, and a packet is passed from layer to layer by IPC. With this module
+ * these layers share one network thread instead. A packet is handed from
+ * one layer to the next by function call, so it is processed to completion
+ * without a context switch:
+ *
+ *  - Each layer is registered at @ref net_gnrc_netreg with a callback.
+ *    Called in the network thread, the callback handles the packet right
+ *    away. Called in any other thread (e.g. by a network interface or an
+ *    application), it puts the packet into the work queue of the network
+ *    thread.
+ *  - Messages to the PID of the network thread (which is also
+ *    @ref gnrc_ipv6_pid) still work as before: @ref net_gnrc_netapi packets
+ *    are handled by the layer of their first header, all other messages
+ *    (e.g. timeouts) by the layer knowing the message type.
+ *  - UDP is handled by callbacks in the calling thread
+ *    (module `gnrc_udp_cb`), as it keeps no state.
+ *
+ * The threads of the network interfaces are not affected.
+ *
+ * Use it with
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_single_thread
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief   Single-thread GNRC definitions
+ */
+#ifndef GNRC_SINGLE_THREAD_H
+#define GNRC_SINGLE_THREAD_H
+
+#include <stdbool.h>
+
+#include "kernel_types.h"
+#include "msg.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Default stack size to use for the network thread
+ *
+ * As the layers call each other, the stack must be larger than the one
+ * of a single layer.
+ */
+#ifndef GNRC_SINGLE_THREAD_STACK_SIZE
+#define GNRC_SINGLE_THREAD_STACK_SIZE       (2 * THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Default priority for the network thread
+ */
+#ifndef GNRC_SINGLE_THREAD_PRIO
+#define GNRC_SINGLE_THREAD_PRIO             (THREAD_PRIORITY_MAIN - 3)
+#endif
+
+/**
+ * @brief   Default message queue size to use for the network thread
+ */
+#ifndef GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE
+#define GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE   (8U)
+#endif
+
+/**
+ * @brief   Number of packets the work queue of the network thread can hold
+ *
+ * @note    Must be a power of 2
+ */
+#ifndef GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE
+#define GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE  (8U)
+#endif
+
+/**
+ * @brief   Message type to wake the network thread for its work queue
+ */
+#define GNRC_SINGLE_THREAD_MSG_TYPE_WORK    (0x0207)
+
+/**
+ * @brief   A layer run in the network thread
+ */
+typedef struct gnrc_single_thread_layer {
+    struct gnrc_single_thread_layer *next;  /**< next layer (internal) */
+    gnrc_netreg_entry_t netreg;             /**< netreg entry (internal) */
+    gnrc_netreg_entry_cbd_t cbd;            /**< netreg callback (internal) */
+    gnrc_nettype_t type;                    /**< type of the layer's packets */
+    /**
+     * @brief   Handles a packet
+     *
+     * @param[in] cmd   @ref GNRC_NETAPI_MSG_TYPE_RCV or
+     *                  @ref GNRC_NETAPI_MSG_TYPE_SND.
+     * @param[in] pkt   The packet.
+     */
+    void (*handle_pkt)(uint16_t cmd, gnrc_pktsnip_t *pkt);
+    /**
+     * @brief   Handles any other message the network thread received.
+     *          May be NULL.
+     *
+     * @param[in] msg   The message.
+     *
+     * @return  true, if the message type is known to the layer.
+     * @return  false, otherwise.
+     */
+    bool (*handle_msg)(msg_t *msg);
+} gnrc_single_thread_layer_t;
+
+/**
+ * @brief   Adds a layer to the network thread and starts the thread if
+ *          it is not running yet.
+ *
+ * @param[in] layer     The layer. gnrc_single_thread_layer_t::type,
+ *                      gnrc_single_thread_layer_t::handle_pkt and
+ *                      gnrc_single_thread_layer_t::handle_msg must be
+ *                      initialized. It is registered with gnrc_single_thread_layer_t::type
+ *                      and @ref GNRC_NETREG_DEMUX_CTX_ALL at
+ *                      @ref net_gnrc_netreg.
+ *
+ * @return  PID of the network thread
+ * @return  negative value on error
+ */
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_SINGLE_THREAD_H */
+/** @} */
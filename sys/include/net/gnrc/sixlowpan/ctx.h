@@ -119,12 +119,20 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
  *
  * @param[in] id    A context ID.
  */
-static inline void gnrc_sixlowpan_ctx_remove(uint8_t id)
-{
-    gnrc_sixlowpan_ctx_lookup_id(id)->prefix_len = 0;
-}
+void gnrc_sixlowpan_ctx_remove(uint8_t id);
 #endif
 
+/**
+ * @brief   Gets the generation of the context buffer.
+ *
+ * The generation changes whenever a context is added, changed, removed, or
+ * becomes invalid for compression, so users can detect that state derived
+ * from the contexts is outdated.
+ *
+ * @return  The current generation of the context buffer.
+ */
+unsigned gnrc_sixlowpan_ctx_gen(void);
+
 #ifdef TEST_SUITES
 /**
  * @brief   Resets the whole context buffer.
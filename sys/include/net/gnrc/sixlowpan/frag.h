@@ -38,32 +38,136 @@ extern "C" {
 #endif
 
 /**
- * @brief   Message type for passing one 6LoWPAN fragment down the network stack
+ * @brief   Message type for sending the next 6LoWPAN fragment queued for an
+ *          interface
+ *
+ * msg_t::content::value is the PID of the interface.
  */
 #define GNRC_SIXLOWPAN_MSG_FRAG_SND    (0x0225)
 
+/**
+ * @brief   Message type for triggering garbage collection of the reassembly
+ *          buffer
+ */
+#define GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF (0x0226)
+
+/**
+ * @brief   Number of datagrams that can be fragmented at the same time (for
+ *          all interfaces)
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_QUEUE_SIZE
+#define GNRC_SIXLOWPAN_FRAG_QUEUE_SIZE  (4U)
+#endif
+
+/**
+ * @brief   Delay in microseconds between two fragments sent over the same
+ *          interface
+ *
+ * 0 sends the next fragment as soon as the 6LoWPAN thread handled the
+ * previous one. A delay gives slow radios time to get rid of a fragment
+ * before the next one arrives.
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_PACING
+#define GNRC_SIXLOWPAN_FRAG_PACING      (0U)
+#endif
+
+/**
+ * @brief   Interleave the fragments of datagrams queued for the same
+ *          interface
+ *
+ * If 0, the datagrams are sent one after the other. Otherwise one fragment
+ * of each queued datagram is sent in turn, so a small datagram is not
+ * delayed by a large one queued before it.
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_INTERLEAVE
+#define GNRC_SIXLOWPAN_FRAG_INTERLEAVE  (0)
+#endif
+
 /**
  * @brief   Definition of 6LoWPAN fragmentation type.
  */
-typedef struct {
+typedef struct gnrc_sixlowpan_msg_frag {
+    struct gnrc_sixlowpan_msg_frag *next;   /**< next datagram queued for the
+                                             *   same interface */
     kernel_pid_t pid;       /**< PID of the interface */
     gnrc_pktsnip_t *pkt;    /**< Pointer to the IPv6 packet to be fragmented */
     size_t datagram_size;   /**< Length of just the IPv6 packet to be fragmented */
     uint16_t offset;        /**< Offset of the Nth fragment from the beginning of the
                              *   payload datagram */
+    uint16_t tag;           /**< Datagram tag of the fragments */
+    uint32_t queued;        /**< time in microseconds the datagram was queued */
 } gnrc_sixlowpan_msg_frag_t;
 
+#if defined(MODULE_GNRC_SIXLOWPAN_FRAG_STATS) || defined(DOXYGEN)
 /**
- * @brief   Sends a packet fragmented.
+ * @brief   Fragmentation statistics
  *
- * @param[in] fragment_msg    Message containing status of the 6LoWPAN
- *                            fragmentation progress
+ * @note    Only available with module `gnrc_sixlowpan_frag_stats`.
  */
-void gnrc_sixlowpan_frag_send(gnrc_sixlowpan_msg_frag_t *fragment_msg);
+typedef struct {
+    uint32_t frags_forwarded;       /**< fragments relayed as they arrived */
+    uint32_t frags_reassembled;     /**< fragments added to the reassembly buffer */
+    uint32_t datagrams_forwarded;   /**< datagrams relayed fragment by fragment */
+    uint32_t datagrams_reassembled; /**< datagrams reassembled completely */
+    uint32_t vrb_full;              /**< datagrams reassembled because the virtual
+                                     *   reassembly buffer was full */
+} gnrc_sixlowpan_frag_stats_t;
+
+/**
+ * @brief   Get the fragmentation statistics
+ *
+ * @return  The fragmentation statistics of all interfaces.
+ */
+gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats_get(void);
+#endif
+
+/**
+ * @brief   Generates a new datagram tag
+ *
+ * @return  A datagram tag for the fragments of a new datagram.
+ */
+uint16_t gnrc_sixlowpan_frag_next_tag(void);
+
+/**
+ * @brief   Queues a packet to be sent fragmented.
+ *
+ * The fragments are sent by the calling thread on
+ * @ref GNRC_SIXLOWPAN_MSG_FRAG_SND, which it sends itself.
+ *
+ * @param[in] pid           The interface to send the packet over.
+ * @param[in] pkt           The packet to send, starting with its
+ *                          @ref gnrc_netif_hdr_t.
+ * @param[in] datagram_size Length of the uncompressed IPv6 packet.
+ *
+ * @return  true, if the packet was queued.
+ * @return  false, if the queue is full. @p pkt was not released.
+ */
+bool gnrc_sixlowpan_frag_enqueue(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
+                                 size_t datagram_size);
+
+/**
+ * @brief   Sends the next fragment queued for an interface.
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_SND.
+ *
+ * @param[in] pid   The interface.
+ */
+void gnrc_sixlowpan_frag_send(kernel_pid_t pid);
+
+/**
+ * @brief   Removes timed out datagrams from the reassembly buffer.
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF.
+ */
+void gnrc_sixlowpan_frag_gc_rbuf(void);
 
 /**
  * @brief   Handles a packet containing a fragment header.
  *
+ * With module `gnrc_sixlowpan_frag_vrb` fragments of datagrams that are
+ * routed on are relayed to the next hop as they arrive. Only datagrams
+ * destined to this node (or that can not be relayed) are reassembled.
+ *
  * @param[in] pkt   The packet to handle.
  */
 void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt);
@@ -29,6 +29,18 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of flows in the compression cache
+ *
+ * With module `gnrc_sixlowpan_iphc_cache` the compressed headers of recently
+ * sent flows, identified by their IPv6 header (without payload length),
+ * UDP ports, and link-layer addresses, are kept. The next packet of a flow
+ * then only needs to copy them and fill in its UDP checksum.
+ */
+#ifndef GNRC_SIXLOWPAN_IPHC_CACHE_SIZE
+#define GNRC_SIXLOWPAN_IPHC_CACHE_SIZE  (4U)
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
@@ -61,6 +73,18 @@ size_t gnrc_sixlowpan_iphc_decode(gnrc_pktsnip_t **dec_hdr, gnrc_pktsnip_t *pkt,
  */
 bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt);
 
+#if defined(MODULE_GNRC_SIXLOWPAN_IPHC_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Removes all flows from the compression cache.
+ *
+ * Changes of 6LoWPAN contexts are detected by the cache itself. This needs
+ * to be called if an interface's link-layer address changes.
+ *
+ * @note    Only available with module `gnrc_sixlowpan_iphc_cache`.
+ */
+void gnrc_sixlowpan_iphc_cache_flush(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -155,6 +155,10 @@ void gnrc_sixlowpan_nd_uc_rtr_sol(gnrc_ipv6_nc_t *nce);
  * @param[in] iface             The interface to search the next hop on.
  *                              May be @ref KERNEL_PID_UNDEF if not specified.
  * @param[in] dst               An IPv6 address to search the next hop for.
+ * @param[out] nce              The neighbor cache entry of the next hop, NULL
+ *                              if there is none (e.g. the link-layer address
+ *                              was derived from the next hop's IID). May be
+ *                              NULL.
  *
  * @return  The PID of the interface, on success.
  * @return  -EHOSTUNREACH, if @p dst is not reachable.
@@ -162,7 +166,8 @@ void gnrc_sixlowpan_nd_uc_rtr_sol(gnrc_ipv6_nc_t *nce);
  *          would be long.
  */
 kernel_pid_t gnrc_sixlowpan_nd_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len,
-                                               kernel_pid_t iface, ipv6_addr_t *dst);
+                                               kernel_pid_t iface, ipv6_addr_t *dst,
+                                               gnrc_ipv6_nc_t **nce);
 
 /**
  * @brief   Reschedules the next router advertisement for a neighboring router.
@@ -52,6 +52,25 @@ int gnrc_tcp_init(void);
  */
 void gnrc_tcp_tcb_init(gnrc_tcp_tcb_t *tcb);
 
+/**
+ * @brief Sets the size of the receive buffer of a connection.
+ *
+ * @pre gnrc_tcp_tcb_init() must have been successfully called.
+ * @pre @p tcb must not be NULL.
+ *
+ * @note The buffer is allocated from a pool of GNRC_TCP_RCV_BUF_POOL_SIZE bytes
+ *       when the connection is opened. Without this call GNRC_TCP_RCV_BUF_SIZE
+ *       is used. Buffers larger than 64 KiB are announced with window scaling.
+ *
+ * @param[in,out] tcb    TCB holding the connection information.
+ * @param[in]     size   Size of the receive buffer in bytes.
+ *
+ * @returns   Zero on success.
+ *            -EINVAL if @p size is zero or larger than the pool.
+ *            -EISCONN if TCB is already in use.
+ */
+int gnrc_tcp_tcb_set_rcv_buf_size(gnrc_tcp_tcb_t *tcb, const size_t size);
+
  /**
   * @brief Opens a connection actively.
   *
@@ -107,7 +126,7 @@ int gnrc_tcp_open_active(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
  *            -EINVAL if @p address_family is not the same the address_family used in TCB.
  *            -EISCONN if TCB is already in use.
  *            -ENOMEM if the receive buffer for the TCB could not be allocated.
- *            Hint: Increase "GNRC_TCP_RCV_BUFFERS".
+ *            Hint: Increase "GNRC_TCP_RCV_BUF_POOL_SIZE".
  */
 int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
                           const uint8_t *local_addr, const uint16_t local_port);
@@ -120,6 +139,9 @@ int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
  * @pre @p data must not be NULL.
  *
  * @note Blocks until up to @p len bytes were transmitted or an error occured.
+ *       Data counts as transmitted once it was sent and queued for
+ *       retransmission, several segments can be in flight at once.
+ *       gnrc_tcp_close() waits until all queued data was acknowledged.
  *
  * @param[in,out] tcb                        TCB holding the connection information.
  * @param[in]     data                       Pointer to the data that should be transmitted.
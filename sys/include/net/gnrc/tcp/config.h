@@ -68,7 +68,7 @@ extern "C" {
 #endif
 
 /**
- * @brief Number of preallocated receive buffers
+ * @brief Number of default sized receive buffers the receive buffer pool holds
  */
 #ifndef GNRC_TCP_RCV_BUFFERS
 #define GNRC_TCP_RCV_BUFFERS (1U)
@@ -76,11 +76,53 @@ extern "C" {
 
 /**
  * @brief Default receive buffer size
+ *
+ * Can be changed per connection with gnrc_tcp_tcb_set_rcv_buf_size().
  */
 #ifndef GNRC_TCP_RCV_BUF_SIZE
 #define GNRC_TCP_RCV_BUF_SIZE (GNRC_TCP_DEFAULT_WINDOW)
 #endif
 
+/**
+ * @brief Allocation granularity of the receive buffer pool
+ */
+#ifndef GNRC_TCP_RCV_BUF_BLOCK_SIZE
+#define GNRC_TCP_RCV_BUF_BLOCK_SIZE (64U)
+#endif
+
+/**
+ * @brief Size of the pool all receive buffers are allocated from
+ *
+ * Receive buffers larger than 64 KiB are announced using window scaling
+ * (see RFC 7323).
+ */
+#ifndef GNRC_TCP_RCV_BUF_POOL_SIZE
+#define GNRC_TCP_RCV_BUF_POOL_SIZE (GNRC_TCP_RCV_BUFFERS * GNRC_TCP_RCV_BUF_SIZE)
+#endif
+
+/**
+ * @brief Number of sent but unacknowledged segments a connection can hold
+ *
+ * One slot is kept free for a SYN or FIN, so at most
+ * (GNRC_TCP_SND_QUEUE_SIZE - 1) data segments are in flight. Every queued
+ * segment holds up to GNRC_TCP_MSS bytes of payload in the packet buffer.
+ * Must be at least 2.
+ */
+#ifndef GNRC_TCP_SND_QUEUE_SIZE
+#define GNRC_TCP_SND_QUEUE_SIZE (4U)
+#endif
+
+#if GNRC_TCP_SND_QUEUE_SIZE < 2
+#error "GNRC_TCP_SND_QUEUE_SIZE must be at least 2"
+#endif
+
+/**
+ * @brief Number of duplicate ACKs that trigger a fast retransmit (see RFC 5681)
+ */
+#ifndef GNRC_TCP_DUP_ACK_THRESHOLD
+#define GNRC_TCP_DUP_ACK_THRESHOLD (3U)
+#endif
+
 /**
  * @brief Lower bound for RTO = 1 sec (see RFC 6298)
  */
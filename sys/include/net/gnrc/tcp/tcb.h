@@ -60,14 +60,16 @@ typedef struct _transmission_control_block {
     uint8_t status;        /**< A connections status flags */
     uint32_t snd_una;      /**< Send unacknowledged */
     uint32_t snd_nxt;      /**< Send next */
-    uint16_t snd_wnd;      /**< Send window */
+    uint32_t snd_wnd;      /**< Send window */
     uint32_t snd_wl1;      /**< SeqNo. from last window update */
     uint32_t snd_wl2;      /**< AckNo. from last window update */
     uint32_t rcv_nxt;      /**< Receive next */
-    uint16_t rcv_wnd;      /**< Receive window */
+    uint32_t rcv_wnd;      /**< Receive window */
     uint32_t iss;          /**< Initial sequence sumber */
     uint32_t irs;          /**< Initial received sequence number */
     uint16_t mss;          /**< The peers MSS */
+    uint8_t snd_wscale;    /**< Window scale shift of the peer */
+    uint8_t rcv_wscale;    /**< Window scale shift of the announced receive window */
     uint32_t rtt_start;    /**< Timer value for rtt estimation */
     int32_t rtt_var;       /**< Round trip time variance */
     int32_t srtt;          /**< Smoothed round trip time */
@@ -75,11 +77,22 @@ typedef struct _transmission_control_block {
     uint8_t retries;       /**< Number of retransmissions */
     xtimer_t tim_tout;     /**< Timer struct for timeouts */
     msg_t msg_tout;        /**< Message, sent on timeouts */
-    gnrc_pktsnip_t *pkt_retransmit;   /**< Pointer to packet in "retransmit queue" */
+    uint32_t rtt_seq;      /**< Acknowledgment number that ends the rtt measurement */
+    uint32_t cwnd;         /**< Congestion window */
+    uint32_t ssthresh;     /**< Slow start threshold */
+    uint32_t recover;      /**< snd_nxt at the start of the last loss recovery */
+    uint8_t dup_acks;      /**< Number of consecutive duplicate ACKs */
+    uint8_t snd_queue_head;   /**< Index of the oldest segment in snd_queue */
+    uint8_t snd_queue_len;    /**< Number of segments in snd_queue */
+    gnrc_pktsnip_t *snd_queue[GNRC_TCP_SND_QUEUE_SIZE];   /**< Sent, unacknowledged segments */
     msg_t mbox_raw[GNRC_TCP_TCB_MBOX_SIZE];   /**< Msg queue for mbox */
     mbox_t mbox;             /**< TCB mbox for synchronization */
     uint8_t *rcv_buf_raw;    /**< Pointer to the receive buffer */
+    uint32_t rcv_buf_size;   /**< Size of the receive buffer to allocate */
     ringbuffer_t rcv_buf;    /**< Receive buffer data structure */
+    uint8_t *rcv_user_buf;   /**< Buffer of a waiting gnrc_tcp_recv() call */
+    size_t rcv_user_len;     /**< Size of rcv_user_buf */
+    size_t rcv_user_used;    /**< Number of bytes received directly into rcv_user_buf */
     mutex_t fsm_lock;        /**< Mutex for FSM access synchronization */
     mutex_t function_lock;   /**< Mutex for function call synchronization */
     struct _transmission_control_block *next;   /**< Pointer next TCB */
@@ -83,7 +83,14 @@ gnrc_pktsnip_t *gnrc_udp_hdr_build(gnrc_pktsnip_t *payload, uint16_t src,
 /**
  * @brief   Initialize and start UDP
  *
+ * With module `gnrc_udp_cb` no thread is started. UDP is registered as
+ * a callback to @ref net_gnrc_netreg instead, so received packets are handled
+ * in the thread of the network layer (and sent packets in the thread of
+ * the sender) without a context switch. The stack sizes of these threads
+ * need to take this into account.
+ *
  * @return  PID of the UDP thread
+ * @return  KERNEL_PID_UNDEF, with module `gnrc_udp_cb`
  * @return  negative value on error
  */
 int gnrc_udp_init(void);
@@ -38,6 +38,8 @@ extern "C" {
  * @details The Internet Checksum is not normalized (i. e. its 1's complement
  *          was not taken of the result) to use it for further calculation.
  *          This function handles padding an odd number of bytes across the full domain.
+ *          @p buf is summed up to 32 bits at a time, so it does not need to
+ *          be aligned, but is processed fastest if it is.
  *
  * @param[in] sum       An initial value for the checksum.
  * @param[in] buf       A buffer.
@@ -73,6 +75,60 @@ static inline uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
     return inet_csum_slice(sum, buf, len, 0);
 }
 
+/**
+ * @brief   Updates an Internet Checksum after a 16-bit word of its domain
+ *          changed.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc1624#section-3">
+ *          RFC 1624, section 3
+ *      </a>
+ *
+ * @details Avoids recalculating the checksum over the whole domain, e.g. when
+ *          a header field is rewritten on forwarding. Other than the functions
+ *          above, this works on the normalized checksum as it is found in
+ *          the header.
+ *
+ * @param[in] csum      The checksum (1's complement already taken) of the
+ *                      domain before the change, in host byte order.
+ * @param[in] old_word  The word before the change, in host byte order.
+ * @param[in] new_word  The word after the change, in host byte order.
+ *
+ * @return  The checksum (1's complement taken) of the changed domain.
+ */
+static inline uint16_t inet_csum_update16(uint16_t csum, uint16_t old_word,
+                                          uint16_t new_word)
+{
+    /* HC' = ~(~HC + ~m + m') */
+    uint32_t sum = (uint16_t)~csum + (uint16_t)~old_word + new_word;
+
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+/**
+ * @brief   Updates an Internet Checksum after a part of its domain changed.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc1624#section-3">
+ *          RFC 1624, section 3
+ *      </a>
+ *
+ * @details Like inet_csum_update16(), but for a changed range of bytes,
+ *          e.g. a rewritten IPv6 address in a pseudo header.
+ *
+ * @param[in] csum      The checksum (1's complement already taken) of the
+ *                      domain before the change, in host byte order.
+ * @param[in] old_data  The range before the change.
+ * @param[in] new_data  The range after the change.
+ * @param[in] len       Length of the range in byte.
+ * @param[in] accum_len Offset of the range in the checksum domain.
+ *
+ * @return  The checksum (1's complement taken) of the changed domain.
+ */
+uint16_t inet_csum_update(uint16_t csum, const uint8_t *old_data,
+                          const uint8_t *new_data, uint16_t len,
+                          size_t accum_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,15 @@ typedef struct {
     uint32_t tx_bytes;          /**< sent bytes */
     uint32_t rx_count;          /**< received (data) packets */
     uint32_t rx_bytes;          /**< received bytes */
+    uint32_t tx_copied_bytes;   /**< bytes the module copied to send packets
+                                     (on top of @ref netstats_t::tx_bytes),
+                                     e.g. to duplicate or to fragment them */
+    uint32_t tx_frag_count;     /**< packets sent fragmented */
+    uint32_t tx_frag_latency_max;   /**< maximum time in microseconds from
+                                         queuing a packet for fragmentation
+                                         until its last fragment was sent */
+    uint64_t tx_frag_latency;   /**< sum of these times (64 bit, so it does
+                                     not wrap after about 71 minutes) */
 } netstats_t;
 
 #ifdef __cplusplus
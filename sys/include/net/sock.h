@@ -152,6 +152,22 @@ extern "C" {
  */
 #define SOCK_NO_TIMEOUT     (UINT32_MAX)
 
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Events reported to the callback of a sock object
+ *
+ * Only provided with module `sock_async`. The callback is set with e.g.
+ * sock_udp_set_cb() and is called in the context of the network stack, so
+ * it must not block and should only notify the thread handling the sock.
+ *
+ * @note    Currently only implemented by @ref net_gnrc_sock
+ */
+typedef enum {
+    SOCK_ASYNC_MSG_RECV = 0x01,     /**< a message was received */
+    SOCK_ASYNC_MSG_SENT = 0x02,     /**< a message was handed to the stack */
+} sock_async_flags_t;
+#endif
+
 /**
  * @brief   Abstract IP end point and end point for a raw IP sock object
  */
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_sock_async_event    Asynchronous sock with a shared event thread
+ * @ingroup     net_sock
+ * @brief       Handles the events of several sock objects in one thread
+ *
+ * Without this module, every application using @ref net_sock runs its own
+ * thread, which blocks in e.g. sock_udp_recv(). With it, the callbacks of
+ * `sock_async` (see sock_udp_set_cb()) are passed on to one shared event
+ * thread, so several protocols (e.g. @ref net_gcoap) can share one thread
+ * and its stack:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static sock_udp_t sock;
+ * static sock_udp_event_t sock_event;
+ *
+ * static void _recv(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+ * {
+ *     if (flags & SOCK_ASYNC_MSG_RECV) {
+ *         ssize_t res;
+ *
+ *         while ((res = sock_udp_recv(sock, buf, sizeof(buf), 0, NULL)) != -EAGAIN) {
+ *             ...
+ *         }
+ *     }
+ * }
+ *
+ * sock_udp_create(&sock, &local, NULL, 0);
+ * sock_udp_event_init(&sock_event, &sock, _recv, NULL);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * The events of a sock are merged while it waits in the queue of the event
+ * thread, so a handler must receive until the sock is empty.
+ *
+ * Other events, e.g. timeouts, are handled in the same thread by posting a
+ * @ref sock_event_t with sock_event_post(), also from interrupt context (e.g.
+ * an xtimer callback).
+ *
+ * @{
+ *
+ * @file
+ * @brief   Asynchronous sock with a shared event thread definitions
+ */
+#ifndef NET_SOCK_ASYNC_EVENT_H
+#define NET_SOCK_ASYNC_EVENT_H
+
+#include "clist.h"
+#include "kernel_types.h"
+#include "thread.h"
+
+#ifdef MODULE_SOCK_IP
+#include "net/sock/ip.h"
+#endif
+#ifdef MODULE_SOCK_UDP
+#include "net/sock/udp.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Stack size of the event thread
+ *
+ * The handlers of all sock objects and events run on this stack.
+ */
+#ifndef SOCK_EVENT_STACK_SIZE
+#define SOCK_EVENT_STACK_SIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the event thread
+ */
+#ifndef SOCK_EVENT_PRIO
+#define SOCK_EVENT_PRIO             (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+/**
+ * @brief   Thread flag the event thread is woken up with
+ */
+#define SOCK_EVENT_THREAD_FLAG      (0x1)
+
+/**
+ * @brief   Event type
+ */
+typedef struct sock_event sock_event_t;
+
+/**
+ * @brief   Handler of an event
+ *
+ * @param[in] event The event.
+ */
+typedef void (*sock_event_handler_t)(sock_event_t *event);
+
+/**
+ * @brief   An event handled by the event thread
+ */
+struct sock_event {
+    clist_node_t list_node;         /**< queue node (internal) */
+    sock_event_handler_t handler;   /**< called in the event thread */
+};
+
+#if defined(MODULE_SOCK_IP) || defined(DOXYGEN)
+/**
+ * @brief   Passes the events of a raw IPv4/IPv6 sock object to the event
+ *          thread
+ */
+typedef struct {
+    sock_event_t super;             /**< event base type (internal) */
+    sock_ip_t *sock;                /**< the sock object */
+    sock_ip_cb_t cb;                /**< the callback */
+    void *arg;                      /**< argument for the callback */
+    sock_async_flags_t flags;       /**< pending events (internal) */
+} sock_ip_event_t;
+#endif
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+/**
+ * @brief   Passes the events of a UDP sock object to the event thread
+ */
+typedef struct {
+    sock_event_t super;             /**< event base type (internal) */
+    sock_udp_t *sock;               /**< the sock object */
+    sock_udp_cb_t cb;               /**< the callback */
+    void *arg;                      /**< argument for the callback */
+    sock_async_flags_t flags;       /**< pending events (internal) */
+} sock_udp_event_t;
+#endif
+
+/**
+ * @brief   Starts the event thread, if it is not running yet
+ *
+ * Called by sock_ip_event_init() and sock_udp_event_init().
+ *
+ * @return  PID of the event thread.
+ */
+kernel_pid_t sock_event_init(void);
+
+/**
+ * @brief   Initializes an event
+ *
+ * @param[out] event    An event.
+ * @param[in] handler   The handler of @p event.
+ */
+static inline void sock_event_init_event(sock_event_t *event,
+                                         sock_event_handler_t handler)
+{
+    event->list_node.next = NULL;
+    event->handler = handler;
+}
+
+/**
+ * @brief   Queues an event for the event thread
+ *
+ * Can be called from interrupt context. Does nothing, if @p event already is
+ * queued.
+ *
+ * @pre sock_event_init() was called.
+ *
+ * @param[in] event An event initialized with sock_event_init_event().
+ */
+void sock_event_post(sock_event_t *event);
+
+/**
+ * @brief   Removes an event from the queue of the event thread
+ *
+ * @param[in] event An event.
+ */
+void sock_event_cancel(sock_event_t *event);
+
+#if defined(MODULE_SOCK_IP) || defined(DOXYGEN)
+/**
+ * @brief   Handles the events of a raw IPv4/IPv6 sock object in the event
+ *          thread
+ *
+ * @pre `(event != NULL) && (sock != NULL) && (cb != NULL)`
+ *
+ * @param[out] event    Event context for @p sock. Must stay valid until
+ *                      sock_ip_event_deinit().
+ * @param[in] sock      A created raw IPv4/IPv6 sock object. Its callback is
+ *                      set with sock_ip_set_cb().
+ * @param[in] cb        Callback, called in the event thread.
+ * @param[in] arg       Argument for @p cb.
+ */
+void sock_ip_event_init(sock_ip_event_t *event, sock_ip_t *sock,
+                        sock_ip_cb_t cb, void *arg);
+
+/**
+ * @brief   Stops handling the events of a raw IPv4/IPv6 sock object
+ *
+ * Call before sock_ip_close().
+ *
+ * @param[in] event Event context of the sock object.
+ */
+void sock_ip_event_deinit(sock_ip_event_t *event);
+#endif
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+/**
+ * @brief   Handles the events of a UDP sock object in the event thread
+ *
+ * @pre `(event != NULL) && (sock != NULL) && (cb != NULL)`
+ *
+ * @param[out] event    Event context for @p sock. Must stay valid until
+ *                      sock_udp_event_deinit().
+ * @param[in] sock      A created UDP sock object. Its callback is set with
+ *                      sock_udp_set_cb().
+ * @param[in] cb        Callback, called in the event thread.
+ * @param[in] arg       Argument for @p cb.
+ */
+void sock_udp_event_init(sock_udp_event_t *event, sock_udp_t *sock,
+                         sock_udp_cb_t cb, void *arg);
+
+/**
+ * @brief   Stops handling the events of a UDP sock object
+ *
+ * Call before sock_udp_close().
+ *
+ * @param[in] event Event context of the sock object.
+ */
+void sock_udp_event_deinit(sock_udp_event_t *event);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCK_ASYNC_EVENT_H */
+/** @} */
@@ -12,6 +12,15 @@
  *
  * @brief       Sock DNS client
  *
+ * The client keeps one UDP sock open to @ref sock_dns_server. Several threads
+ * may resolve names at the same time: their queries are sent over this sock
+ * and the replies are matched by their ID. While a query is outstanding,
+ * one of the waiting threads receives on the sock for all of them.
+ *
+ * Answers are cached for their TTL, up to @ref SOCK_DNS_CACHE_SIZE of them.
+ * Names without an address are cached as well ("negative caching",
+ * RFC 2308).
+ *
  * @{
  *
  * @file
@@ -28,6 +37,7 @@
 #include <unistd.h>
 
 #include "net/sock/udp.h"
+#include "timex.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,21 +68,65 @@ typedef struct {
 #define SOCK_DNS_RETRIES        (2)
 
 #define SOCK_DNS_MAX_NAME_LEN   (64U)       /* we're in embedded context. */
-#define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN)
+#define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN + 2)
+/** @} */
+
+/**
+ * @name    Resolver configuration
+ * @{
+ */
+/**
+ * @brief   Time in microseconds to wait for a reply before the query is
+ *          sent again
+ */
+#ifndef SOCK_DNS_TIMEOUT
+#define SOCK_DNS_TIMEOUT        (1U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Maximum number of queries outstanding at the same time
+ *
+ * A lookup with AF_UNSPEC takes two.
+ */
+#ifndef SOCK_DNS_QUERIES_MAX
+#define SOCK_DNS_QUERIES_MAX    (4U)
+#endif
+
+/**
+ * @brief   Number of cached answers; 0 disables the cache
+ *
+ * An answer for AF_UNSPEC takes one entry for each of A and AAAA.
+ */
+#ifndef SOCK_DNS_CACHE_SIZE
+#define SOCK_DNS_CACHE_SIZE     (4U)
+#endif
+
+/**
+ * @brief   Time in seconds a name without an address is cached, if the
+ *          server does not report it with its SOA record
+ */
+#ifndef SOCK_DNS_NEG_TTL
+#define SOCK_DNS_NEG_TTL        (60U)
+#endif
 /** @} */
 
 /**
  * @brief Get IP address for DNS name
  *
  * This function will synchronously try to resolve a DNS A or AAAA record by contacting
- * the DNS server specified in the global variable @ref sock_dns_server.
+ * the DNS server specified in the global variable @ref sock_dns_server, unless
+ * the answer is cached.
  *
  * By supplying AF_INET, AF_INET6 or AF_UNSPEC in @p family requesting of A
- * records (IPv4), AAAA records (IPv6) or both can be selected.
+ * records (IPv4), AAAA records (IPv6) or both can be selected. Both are
+ * queried at the same time.
  *
  * This fuction will return the first DNS record it receives. IF both A and
  * AAAA are requested, AAAA will be preferred.
  *
+ * A change of @ref sock_dns_server takes effect, once no query is
+ * outstanding.
+ *
  * @note @p addr_out needs to provide space for any possible result!
  *       (4byte when family==AF_INET, 16byte otherwise)
  *
@@ -80,8 +134,13 @@ typedef struct {
  * @param[out]  addr_out        buffer to write result into
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
- * @return      0 on success
- * @return      !=0 otherwise
+ * @return      length of the address written to @p addr_out on success
+ * @return      -ENOSPC, if @p domain_name is too long
+ * @return      -EAFNOSUPPORT, if @p family is not supported
+ * @return      -EHOSTUNREACH, if @p domain_name has no address of @p family
+ * @return      -ETIMEDOUT, if the server did not reply
+ * @return      -ENOBUFS, if too many queries are outstanding
+ * @return      other negative errno on error
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
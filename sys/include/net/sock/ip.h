@@ -448,6 +448,34 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
 ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
                      uint8_t proto, const sock_ip_ep_t *remote);
 
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Event callback for a raw IPv4/IPv6 sock object
+ *
+ * @param[in] sock  The sock object the event occurred on.
+ * @param[in] flags The events that occurred.
+ * @param[in] arg   The argument given to sock_ip_set_cb().
+ */
+typedef void (*sock_ip_cb_t)(sock_ip_t *sock, sock_async_flags_t flags,
+                             void *arg);
+
+/**
+ * @brief   Sets the event callback of a raw IPv4/IPv6 sock object
+ *
+ * Only provided with module `sock_async`.
+ *
+ * @pre `sock != NULL`
+ *
+ * @param[in] sock  A raw IPv4/IPv6 sock object. The callback is reset on
+ *                  sock_ip_create().
+ * @param[in] cb    The callback. It is called in the context of the network
+ *                  stack. May be `NULL` to unset the callback. Messages
+ *                  already queued at @p sock are reported to it right away.
+ * @param[in] arg   Argument for @p cb.
+ */
+void sock_ip_set_cb(sock_ip_t *sock, sock_ip_cb_t cb, void *arg);
+#endif
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
@@ -433,6 +433,155 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote);
 
+/**
+ * @brief   A datagram for sock_udp_recv_batch() and sock_udp_send_batch()
+ */
+typedef struct {
+    void *data;             /**< payload of the datagram */
+    /**
+     * @brief   length of the payload
+     *
+     * For sock_udp_recv_batch() this is the space available at
+     * sock_udp_dgram_t::data on input and the length of the received payload
+     * on output.
+     */
+    size_t len;
+    /**
+     * @brief   remote end point of the datagram. May be `NULL`.
+     *
+     * For sock_udp_recv_batch() the remote of the received datagram is
+     * stored here, for sock_udp_send_batch() it is the destination of the
+     * datagram (the remote end point of the sock if `NULL`).
+     */
+    sock_udp_ep_t *remote;
+} sock_udp_dgram_t;
+
+/**
+ * @brief   Receives up to @p num UDP messages with one call
+ *
+ * Waits up to @p timeout for the first message like sock_udp_recv(). All
+ * further messages are only taken if they are already queued for @p sock,
+ * so the call does not block any longer than sock_udp_recv() would. A
+ * message that fails after the first (e.g. with -ENOBUFS or -EPROTO) is
+ * dropped.
+ *
+ * @note    Provided by the `sock_udp_batch` module on top of sock_udp_recv()
+ *          for every implementation.
+ *
+ * @pre `(sock != NULL) && (dgrams != NULL) && (num > 0)`
+ *
+ * @param[in] sock      A UDP sock object.
+ * @param[in,out] dgrams    Datagrams to receive into. sock_udp_dgram_t::data
+ *                      and sock_udp_dgram_t::len must be set.
+ * @param[in] num       Number of elements in @p dgrams.
+ * @param[in] timeout   Timeout for the first message in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ *
+ * @return  The number of messages received (at least 1) on success.
+ * @return  Any of the errors of sock_udp_recv(), if the first message could
+ *          not be received.
+ */
+ssize_t sock_udp_recv_batch(sock_udp_t *sock, sock_udp_dgram_t *dgrams,
+                            size_t num, uint32_t timeout);
+
+/**
+ * @brief   Sends up to @p num UDP messages with one call
+ *
+ * Stops at the first message that can not be sent.
+ *
+ * @note    Provided by the `sock_udp_batch` module on top of sock_udp_send()
+ *          for every implementation.
+ *
+ * @pre `((sock != NULL) || (all sock_udp_dgram_t::remote != NULL)) &&
+ *       (dgrams != NULL) && (num > 0)`
+ *
+ * @param[in] sock      A UDP sock object. May be `NULL`.
+ * @param[in] dgrams    Datagrams to send.
+ * @param[in] num       Number of elements in @p dgrams.
+ *
+ * @return  The number of messages sent (at least 1) on success.
+ * @return  Any of the errors of sock_udp_send(), if the first message could
+ *          not be sent.
+ */
+ssize_t sock_udp_send_batch(sock_udp_t *sock, const sock_udp_dgram_t *dgrams,
+                            size_t num);
+
+/**
+ * @brief   Receives a UDP message without copying it
+ *
+ * Instead of copying the payload to a user buffer like sock_udp_recv(), the
+ * buffer of the network stack holding the payload is lent to the caller.
+ * It must be returned with sock_udp_recv_buf_free() as soon as possible,
+ * since it stays allocated in the stack's packet buffer until then.
+ *
+ * @pre `(sock != NULL) && (data != NULL) && (buf_ctx != NULL)`
+ *
+ * @param[in] sock      A UDP sock object.
+ * @param[out] data     Pointer to the received payload. Must not be written.
+ * @param[out] buf_ctx  Stack-specific context of the lent buffer, to be
+ *                      passed to sock_udp_recv_buf_free().
+ * @param[in] timeout   Timeout for receive in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ * @param[out] remote   Remote end point of the received data.
+ *                      May be `NULL`, if it is not required by the application.
+ *
+ * @return  The number of bytes received on success. @p data and @p buf_ctx
+ *          are only valid in this case.
+ * @return  -EADDRNOTAVAIL, if local of @p sock is not given.
+ * @return  -EAGAIN, if @p timeout is `0` and no data is available.
+ * @return  -ENOMEM, if the payload can not be provided in one contiguous
+ *          buffer.
+ * @return  -EPROTO, if source address of received packet did not equal
+ *          the remote of @p sock.
+ * @return  -ETIMEDOUT, if @p timeout expired.
+ */
+ssize_t sock_udp_recv_buf(sock_udp_t *sock, void **data, void **buf_ctx,
+                          uint32_t timeout, sock_udp_ep_t *remote);
+
+/**
+ * @brief   Returns a buffer lent by sock_udp_recv_buf() to the network stack
+ *
+ * @pre `(sock != NULL) && (buf_ctx != NULL)`
+ *
+ * @param[in] sock      The UDP sock object the buffer was received with.
+ * @param[in] buf_ctx   The context returned by sock_udp_recv_buf().
+ */
+void sock_udp_recv_buf_free(sock_udp_t *sock, void *buf_ctx);
+
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Event callback for a UDP sock object
+ *
+ * @param[in] sock  The sock object the event occurred on.
+ * @param[in] flags The events that occurred.
+ * @param[in] arg   The argument given to sock_udp_set_cb().
+ */
+typedef void (*sock_udp_cb_t)(sock_udp_t *sock, sock_async_flags_t flags,
+                              void *arg);
+
+/**
+ * @brief   Sets the event callback of a UDP sock object
+ *
+ * Only provided with module `sock_async`.
+ *
+ * @pre `sock != NULL`
+ *
+ * @param[in] sock  A UDP sock object. The callback is reset on
+ *                  sock_udp_create().
+ * @param[in] cb    The callback. It is called in the context of the network
+ *                  stack. May be `NULL` to unset the callback. Messages
+ *                  already queued at @p sock are reported to it right away.
+ * @param[in] arg   Argument for @p cb.
+ */
+void sock_udp_set_cb(sock_udp_t *sock, sock_udp_cb_t cb, void *arg);
+#endif
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
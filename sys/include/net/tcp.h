@@ -43,6 +43,7 @@ extern "C" {
 #define TCP_OPTION_KIND_EOL (0x00)  /**< "End of List"-Option */
 #define TCP_OPTION_KIND_NOP (0x01)  /**< "No Operatrion"-Option */
 #define TCP_OPTION_KIND_MSS (0x02)  /**< "Maximum Segment Size"-Option */
+#define TCP_OPTION_KIND_WS  (0x03)  /**< "Window Scale"-Option (RFC 7323) */
 /** @} */
 
 /**
@@ -50,8 +51,14 @@ extern "C" {
  * @{
  */
 #define TCP_OPTION_LENGTH_MSS (0x04)  /**< MSS Option Size always 4 */
+#define TCP_OPTION_LENGTH_WS  (0x03)  /**< Window Scale Option Size always 3 */
 /** @} */
 
+/**
+ * @brief Largest allowed window scale shift count (see RFC 7323)
+ */
+#define TCP_WS_SHIFT_MAX (14U)
+
 /**
  * @brief TCP header definition
  */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_schedtrace Scheduler trace
+ * @ingroup     sys
+ * @brief       Records scheduler and IPC events into a ring buffer
+ *
+ * While @ref core_sched's `schedstatistics` only accumulates the run time of
+ * each thread, this module records single events with a time stamp, so the
+ * chain of context switches, messages and lock waits that led to a delay can
+ * be reconstructed afterwards. Recorded are
+ *
+ *  - context switches (#SCHEDTRACE_SWITCH)
+ *  - sent and received messages (#SCHEDTRACE_MSG_SEND, #SCHEDTRACE_MSG_RECV)
+ *  - threads blocking on and being woken up by a mutex
+ *    (#SCHEDTRACE_MUTEX_BLOCK, #SCHEDTRACE_MUTEX_UNBLOCK)
+ *  - interrupt service routines (#SCHEDTRACE_IRQ_ENTER, #SCHEDTRACE_IRQ_EXIT)
+ *    on CPUs that report them (currently `native`)
+ *  - fired @ref sys_xtimer timers (#SCHEDTRACE_TIMER)
+ *
+ * An event takes 12 bytes and is written in a few instructions with
+ * interrupts disabled. If the buffer is full, the oldest events are
+ * overwritten.
+ *
+ * Use it with
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += schedtrace
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Recording starts after @ref sys_xtimer is initialized. The `schedtrace`
+ * shell command, or @ref schedtrace_dump() called by the application, drains
+ * the buffer as text lines over stdio. `dist/tools/schedtrace/schedtrace2json.py`
+ * converts a terminal log containing these lines into a Chrome trace event
+ * file that can be opened with https://ui.perfetto.dev or chrome://tracing.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Scheduler trace interface
+ */
+
+#ifndef SCHEDTRACE_H
+#define SCHEDTRACE_H
+
+#include <stdint.h>
+
+#include "irq.h"
+#include "kernel_types.h"
+#include "msg.h"
+#include "sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of events in the ring buffer
+ *
+ * @note    Must be a power of 2
+ */
+#ifndef SCHEDTRACE_BUFSIZE
+#define SCHEDTRACE_BUFSIZE          (256U)
+#endif
+
+/**
+ * @brief   Event types
+ *
+ * The values are part of the dump format and must not be changed.
+ */
+enum {
+    SCHEDTRACE_SWITCH = 0,      /**< context switch from schedtrace_event_t::pid
+                                 *   to the thread in schedtrace_event_t::arg */
+    SCHEDTRACE_MSG_SEND,        /**< message sent to the thread in arg */
+    SCHEDTRACE_MSG_RECV,        /**< message from the thread in arg received */
+    SCHEDTRACE_MUTEX_BLOCK,     /**< blocked on the mutex at address arg */
+    SCHEDTRACE_MUTEX_UNBLOCK,   /**< woke up the thread in arg waiting for a
+                                 *   mutex */
+    SCHEDTRACE_IRQ_ENTER,       /**< entered the interrupt arg */
+    SCHEDTRACE_IRQ_EXIT,        /**< left the interrupt arg */
+    SCHEDTRACE_TIMER,           /**< fired timer with the callback at address
+                                 *   arg */
+    SCHEDTRACE_USER,            /**< first type free for the application */
+};
+
+/**
+ * @brief   A trace event
+ */
+typedef struct {
+    uint32_t time;              /**< time stamp in microseconds */
+    uint32_t arg;               /**< type specific argument */
+    kernel_pid_t pid;           /**< thread the event happened in,
+                                 *   KERNEL_PID_ISR in interrupt context */
+    uint8_t type;               /**< event type */
+    uint8_t reserved;           /**< padding */
+} schedtrace_event_t;
+
+#if defined(MODULE_SCHEDTRACE) || defined(DOXYGEN)
+/**
+ * @brief   Records an event
+ *
+ * Does nothing while tracing is stopped. Can be called from interrupt
+ * context.
+ *
+ * @param[in] type  Event type
+ * @param[in] pid   Thread the event happened in
+ * @param[in] arg   Type specific argument
+ */
+void schedtrace_add(uint8_t type, kernel_pid_t pid, uint32_t arg);
+
+/**
+ * @brief   Starts recording events
+ *
+ * Called by auto_init after @ref sys_xtimer is initialized.
+ */
+void schedtrace_start(void);
+
+/**
+ * @brief   Stops recording events
+ *
+ * The recorded events are kept.
+ */
+void schedtrace_stop(void);
+
+/**
+ * @brief   Removes all recorded events and resets the lost event counter
+ */
+void schedtrace_clear(void);
+
+/**
+ * @brief   Takes the oldest recorded events out of the buffer
+ *
+ * @param[out] events   Buffer for the events
+ * @param[in] numof     Maximum number of events to take
+ *
+ * @return  Number of events written to @p events
+ */
+unsigned schedtrace_read(schedtrace_event_t *events, unsigned numof);
+
+/**
+ * @brief   Number of events overwritten before they were read
+ *
+ * @return  The number of lost events since the last schedtrace_clear()
+ */
+uint32_t schedtrace_lost(void);
+
+/**
+ * @brief   Takes all recorded events out of the buffer and prints them
+ *
+ * The output format is read by `dist/tools/schedtrace/schedtrace2json.py`.
+ */
+void schedtrace_dump(void);
+
+/**
+ * @brief   Records an event in the current context
+ *
+ * @param[in] type  Event type
+ * @param[in] arg   Type specific argument
+ */
+static inline void schedtrace_event(uint8_t type, uint32_t arg)
+{
+    schedtrace_add(type, irq_is_in() ? KERNEL_PID_ISR : sched_active_pid, arg);
+}
+#else
+static inline void schedtrace_add(uint8_t type, kernel_pid_t pid, uint32_t arg)
+{
+    (void)type;
+    (void)pid;
+    (void)arg;
+}
+
+static inline void schedtrace_event(uint8_t type, uint32_t arg)
+{
+    (void)type;
+    (void)arg;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDTRACE_H */
+/** @} */
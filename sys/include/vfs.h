@@ -135,6 +135,22 @@ extern "C" {
  */
 #define VFS_ANY_FD (-1)
 
+/**
+ * @name    Events for vfs_poll()
+ * @{
+ */
+#define VFS_POLLIN  (0x0001)    /**< data can be read without blocking */
+#define VFS_POLLOUT (0x0004)    /**< data can be written without blocking */
+/** @} */
+
+#ifndef VFS_POLL_THREAD_FLAG
+/**
+ * @brief Thread flag set on the waiting thread when the readiness of a file
+ *        polled with vfs_poll() changes
+ */
+#define VFS_POLL_THREAD_FLAG (0x1 << 12)
+#endif
+
 /* Forward declarations */
 /**
  * @brief struct @c vfs_file_ops typedef
@@ -346,6 +362,28 @@ struct vfs_file_ops {
      * @return <0 on error
      */
     ssize_t (*write) (vfs_file_t *filp, const void *src, size_t nbytes);
+
+    /**
+     * @brief Check the readiness of an open file and arm its notification
+     *
+     * If @p waiter is not @c KERNEL_PID_UNDEF, the driver must set
+     * @ref VFS_POLL_THREAD_FLAG on @p waiter whenever one of @p events may
+     * have become ready, until it is called again with @c KERNEL_PID_UNDEF.
+     * The notification must be armed before the readiness is checked, so no
+     * event is lost in between. Only one waiter per file is supported.
+     *
+     * If this is NULL, the file is always ready for reading and writing
+     * (like a regular file).
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  events   VFS_POLL* events to check
+     * @param[in]  waiter   thread to notify, @c KERNEL_PID_UNDEF to disarm
+     *
+     * @return the VFS_POLL* events out of @p events that are ready
+     * @return -EOPNOTSUPP if the driver can not tell when the file is ready
+     * @return <0 on other errors
+     */
+    int (*poll) (vfs_file_t *filp, unsigned events, kernel_pid_t waiter);
 };
 
 /**
@@ -626,6 +664,23 @@ ssize_t vfs_read(int fd, void *dest, size_t count);
  */
 ssize_t vfs_write(int fd, const void *src, size_t count);
 
+/**
+ * @brief Check the readiness of an open file
+ *
+ * This is the building block of poll() and select(), see
+ * vfs_file_ops::poll.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  events   VFS_POLL* events to check
+ * @param[in]  waiter   thread to set @ref VFS_POLL_THREAD_FLAG on if one of
+ *                      @p events may have become ready, @c KERNEL_PID_UNDEF
+ *                      to stop notifications
+ *
+ * @return the VFS_POLL* events out of @p events that are ready
+ * @return <0 on error
+ */
+int vfs_poll(int fd, unsigned events, kernel_pid_t waiter);
+
 /**
  * @brief Open a directory for reading with readdir
  *
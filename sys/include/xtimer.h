@@ -20,6 +20,12 @@
  * number of active timers.  The reason for this is that multiplexing is
  * realized by next-first singly linked lists.
  *
+ * If the pseudo-module `xtimer_heap` is used, the lists are replaced by
+ * pairing heaps. Insertion then is O(1) and removal of a timer is
+ * O(log n) amortized, at the cost of two additional pointers per
+ * @ref xtimer_t. Timers with identical targets are not guaranteed to fire
+ * in the order they were set in this mode.
+ *
  * @{
  * @file
  * @brief   xtimer interface definitions
@@ -69,6 +75,12 @@ typedef void (*xtimer_callback_t)(void*);
  */
 typedef struct xtimer {
     struct xtimer *next;         /**< reference to next timer in timer lists */
+#if defined(MODULE_XTIMER_HEAP) || defined(DOXYGEN)
+    struct xtimer *child;        /**< first child in the timer heap
+                                      (only with `xtimer_heap`) */
+    struct xtimer *prev;         /**< parent or previous sibling in the timer
+                                      heap (only with `xtimer_heap`) */
+#endif
     uint32_t target;             /**< lower 32bit absolute target time */
     uint32_t long_target;        /**< upper 32bit absolute target time */
     xtimer_callback_t callback;  /**< callback function to call when timer
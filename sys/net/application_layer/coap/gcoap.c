@@ -13,25 +13,27 @@
  * @file
  * @brief       GNRC's implementation of CoAP protocol
  *
- * Runs a thread (_pid) to manage request/response messaging.
+ * Manages request/response messaging in the shared sock event thread (_pid).
  *
  * @author      Ken Bannister <kb2ma@runbox.com>
  */
 
 #include <errno.h>
+#include <stdbool.h>
+#include "hashes.h"
+#include "kernel_defines.h"
+#include "mutex.h"
 #include "net/gcoap.h"
 #include "random.h"
-#include "thread.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-/** @brief Stack size for module thread */
-#define GCOAP_STACK_SIZE (THREAD_STACKSIZE_DEFAULT + DEBUG_EXTRA_STACKSIZE)
-
 /* Internal functions */
-static void *_event_loop(void *arg);
-static void _listen(sock_udp_t *sock);
+static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t flags, void *arg);
+static bool _listen(sock_udp_t *sock);
+static void _on_resp_timeout(void *arg);
+static void _on_resp_timeout_evt(sock_event_t *event);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len);
 static ssize_t _write_options(coap_pkt_t *pdu, uint8_t *buf, size_t len);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
@@ -40,8 +42,9 @@ static ssize_t _finish_pdu(coap_pkt_t *pdu, uint8_t *buf, size_t len);
 static void _expire_request(gcoap_request_memo_t *memo);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                                                             uint8_t *buf, size_t len);
-static void _find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr);
+static void _find_resource(const char *path, unsigned method_flag,
+                           coap_resource_t **resource_ptr,
+                           gcoap_listener_t **listener_ptr);
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
@@ -64,78 +67,224 @@ static gcoap_state_t _coap_state = {
 };
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
-static char _msg_stack[GCOAP_STACK_SIZE];
 static sock_udp_t _sock;
+static sock_udp_event_t _sock_event;
+
+/*
+ * Open addressing hash indexes over the tables of _coap_state, so a lookup
+ * does not need to compare every entry.
+ *
+ * A slot holds the position of an entry in its table plus 1, 0 if it is
+ * empty. Twice as many slots as entries keep the probe sequences short.
+ */
+#if (GCOAP_REQ_WAITING_MAX >= UINT8_MAX) || \
+    (GCOAP_OBS_CLIENTS_MAX >= UINT8_MAX) || \
+    (GCOAP_OBS_REGISTRATIONS_MAX >= UINT8_MAX)
+#error "gcoap: tables too large for the hash indexes"
+#endif
+
+typedef struct {
+    uint8_t *slots;                 /* the slots of the index */
+    unsigned size;                  /* number of slots */
+    uint32_t (*hash)(unsigned pos); /* hash of the entry at pos */
+} _index_t;
+
+/* returns true, if the entry at pos matches key */
+typedef bool (*_index_match_t)(unsigned pos, const void *key);
+
+static uint32_t _req_memo_hash(unsigned pos);
+static uint32_t _observer_hash(unsigned pos);
+static uint32_t _obs_memo_hash(unsigned pos);
+
+static uint8_t _req_slots[2 * GCOAP_REQ_WAITING_MAX];
+static uint8_t _observer_slots[2 * GCOAP_OBS_CLIENTS_MAX];
+static uint8_t _obs_memo_slots[2 * GCOAP_OBS_REGISTRATIONS_MAX];
+
+/* open requests by token */
+static const _index_t _req_index = {
+    _req_slots, sizeof(_req_slots), _req_memo_hash
+};
+/* observers by address and port */
+static const _index_t _observer_index = {
+    _observer_slots, sizeof(_observer_slots), _observer_hash
+};
+/* observe memos by resource; a resource has one observer at most */
+static const _index_t _obs_memo_index = {
+    _obs_memo_slots, sizeof(_obs_memo_slots), _obs_memo_hash
+};
 
+/* Guards the tables and their indexes: requests are sent and notifications
+ * initialized by application threads while the event thread handles
+ * messages. */
+static mutex_t _lock = MUTEX_INIT;
 
-/* Event/Message loop for gcoap _pid thread. */
-static void *_event_loop(void *arg)
+static inline uint32_t _scatter(uint32_t hash)
 {
-    msg_t msg_rcvd, msg_queue[GCOAP_MSG_QUEUE_SIZE];
-    (void)arg;
+    /* keys often differ only in the last bytes, for which djb2 yields
+     * overlapping runs of values: scatter them to avoid long probe sequences */
+    hash *= 0x9e3779b1UL;
+    return hash ^ (hash >> 16);
+}
 
-    msg_init_queue(msg_queue, GCOAP_MSG_QUEUE_SIZE);
+/* returns the slot of the entry matching key or the empty slot it would be
+ * added to */
+static unsigned _index_find(const _index_t *index, uint32_t hash,
+                            _index_match_t match, const void *key)
+{
+    unsigned slot = hash % index->size;
 
-    sock_udp_ep_t local;
-    memset(&local, 0, sizeof(sock_udp_ep_t));
-    local.family = AF_INET6;
-    local.netif  = SOCK_ADDR_ANY_NETIF;
-    local.port   = GCOAP_PORT;
+    while ((index->slots[slot] != 0) && !match(index->slots[slot] - 1, key)) {
+        slot = (slot + 1) % index->size;
+    }
+    return slot;
+}
 
-    int res = sock_udp_create(&_sock, &local, NULL, 0);
-    if (res < 0) {
-        DEBUG("gcoap: cannot create sock: %d\n", res);
-        return 0;
+static bool _same_pos(unsigned pos, const void *key)
+{
+    return pos == *(const unsigned *)key;
+}
+
+static inline void _index_add(const _index_t *index, unsigned pos)
+{
+    index->slots[_index_find(index, index->hash(pos), _same_pos, &pos)] = pos + 1;
+}
+
+static void _index_remove(const _index_t *index, unsigned pos)
+{
+    unsigned hole = _index_find(index, index->hash(pos), _same_pos, &pos);
+    unsigned slot = hole;
+
+    if (index->slots[hole] == 0) {
+        return;
     }
 
-    while(1) {
-        res = msg_try_receive(&msg_rcvd);
+    /* move entries of the probe sequence behind the hole into it, so lookups
+     * do not need to skip deleted slots */
+    while (index->slots[slot = (slot + 1) % index->size] != 0) {
+        unsigned home = index->hash(index->slots[slot] - 1) % index->size;
 
-        if (res > 0) {
-            switch (msg_rcvd.type) {
-                case GCOAP_MSG_TYPE_TIMEOUT:
-                    _expire_request((gcoap_request_memo_t *)msg_rcvd.content.ptr);
-                    break;
-                case GCOAP_MSG_TYPE_INTR:
-                    /* next _listen() timeout will account for open requests */
-                    break;
-                default:
-                    break;
-            }
+        if ((hole <= slot) ? ((home <= hole) || (home > slot))
+                           : ((home <= hole) && (home > slot))) {
+            index->slots[hole] = index->slots[slot];
+            hole = slot;
         }
-
-        _listen(&_sock);
     }
+    index->slots[hole] = 0;
+}
 
-    return 0;
+static inline uint32_t _token_hash(const uint8_t *token, size_t len)
+{
+    return _scatter(djb2_hash(token, len));
+}
+
+static uint32_t _req_memo_hash(unsigned pos)
+{
+    coap_pkt_t memo_pdu = {
+        .hdr = (coap_hdr_t *)&_coap_state.open_reqs[pos].hdr_buf[0]
+    };
+
+    return _token_hash(&memo_pdu.hdr->data[0], coap_get_token_len(&memo_pdu));
+}
+
+/* matches the token of an open request against the token of a response */
+static bool _req_memo_match(unsigned pos, const void *key)
+{
+    /* nanocoap's accessors take no const PDU */
+    coap_pkt_t *src_pdu = (coap_pkt_t *)key;
+    coap_pkt_t memo_pdu = {
+        .hdr = (coap_hdr_t *)&_coap_state.open_reqs[pos].hdr_buf[0]
+    };
+    unsigned token_len = coap_get_token_len(&memo_pdu);
+
+    return (coap_get_token_len(src_pdu) == token_len) &&
+           (memcmp(src_pdu->token, &memo_pdu.hdr->data[0], token_len) == 0);
+}
+
+static inline unsigned _ep_addr_len(const sock_udp_ep_t *ep)
+{
+    return (ep->family == AF_INET6) ? 16 : 4;
+}
+
+static inline uint32_t _ep_hash(const sock_udp_ep_t *ep)
+{
+    return _scatter(djb2_hash(&ep->addr.ipv6[0], _ep_addr_len(ep)) ^ ep->port);
+}
+
+static uint32_t _observer_hash(unsigned pos)
+{
+    return _ep_hash(&_coap_state.observers[pos]);
+}
+
+static bool _observer_match(unsigned pos, const void *key)
+{
+    const sock_udp_ep_t *observer = &_coap_state.observers[pos];
+    const sock_udp_ep_t *remote = key;
+
+    return (observer->port == remote->port) &&
+           (memcmp(&observer->addr.ipv6[0], &remote->addr.ipv6[0],
+                   _ep_addr_len(observer)) == 0);
+}
+
+static inline uint32_t _resource_hash(const coap_resource_t *resource)
+{
+    return _scatter((uintptr_t)resource);
+}
+
+static uint32_t _obs_memo_hash(unsigned pos)
+{
+    return _resource_hash(_coap_state.observe_memos[pos].resource);
 }
 
-/* Listen for an incoming CoAP message. */
-static void _listen(sock_udp_t *sock)
+static bool _obs_memo_match(unsigned pos, const void *key)
+{
+    return _coap_state.observe_memos[pos].resource == key;
+}
+
+/* Releases an open request; the caller must not hold _lock. */
+static void _req_memo_free(gcoap_request_memo_t *memo)
+{
+    mutex_lock(&_lock);
+    _index_remove(&_req_index, memo - &_coap_state.open_reqs[0]);
+    memo->state = GCOAP_MEMO_UNUSED;
+    mutex_unlock(&_lock);
+}
+
+
+/* Handles the events of _sock in the event thread _pid. */
+static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)arg;
+
+    if (flags & SOCK_ASYNC_MSG_RECV) {
+        /* events of several messages are merged; read until none is left */
+        while (_listen(sock)) {}
+    }
+}
+
+/* Handles an incoming CoAP message; returns false, if none is waiting. */
+static bool _listen(sock_udp_t *sock)
 {
     coap_pkt_t pdu;
     uint8_t buf[GCOAP_PDU_BUF_SIZE];
     sock_udp_ep_t remote;
     gcoap_request_memo_t *memo = NULL;
-    uint8_t open_reqs = gcoap_op_state();
 
-    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
-                                open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
-                                &remote);
+    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf), 0, &remote);
     if (res <= 0) {
 #if ENABLE_DEBUG
-        if (res < 0 && res != -ETIMEDOUT) {
+        if (res < 0 && res != -EAGAIN) {
             DEBUG("gcoap: udp recv failure: %d\n", res);
         }
 #endif
-        return;
+        /* any other error dropped the message */
+        return (res != -EAGAIN) && (res != -EADDRNOTAVAIL);
     }
 
     res = coap_parse(&pdu, buf, res);
     if (res < 0) {
         DEBUG("gcoap: parse failure: %d\n", res);
         /* If a response, can't clear memo, but it will timeout later. */
-        return;
+        return true;
     }
 
     /* incoming request */
@@ -150,10 +299,25 @@ static void _listen(sock_udp_t *sock)
         _find_req_memo(&memo, &pdu, buf, sizeof(buf));
         if (memo) {
             xtimer_remove(&memo->response_timer);
+            sock_event_cancel(&memo->timeout_event);
             memo->resp_handler(memo->state, &pdu);
-            memo->state = GCOAP_MEMO_UNUSED;
+            _req_memo_free(memo);
         }
     }
+    return true;
+}
+
+/* Response timer callback; passes the timeout on to the event thread. */
+static void _on_resp_timeout(void *arg)
+{
+    gcoap_request_memo_t *memo = arg;
+
+    sock_event_post(&memo->timeout_event);
+}
+
+static void _on_resp_timeout_evt(sock_event_t *event)
+{
+    _expire_request(container_of(event, gcoap_request_memo_t, timeout_event));
 }
 
 /*
@@ -172,14 +336,17 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     gcoap_observe_memo_t *memo = NULL;
     gcoap_observe_memo_t *resource_memo = NULL;
 
-    _find_resource(pdu, &resource, &listener);
+    _find_resource((char *)&pdu->url[0],
+                   coap_method2flag(coap_get_code_detail(pdu)),
+                   &resource, &listener);
     if (resource == NULL) {
         return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
     }
-    else {
-        /* used below to ensure a memo not already recorded for the resource */
-        _find_obs_memo_resource(&resource_memo, resource);
-    }
+
+    /* the handler is called below without the lock */
+    mutex_lock(&_lock);
+    /* used below to ensure a memo not already recorded for the resource */
+    _find_obs_memo_resource(&resource_memo, resource);
 
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
         int empty_slot = _find_obs_memo(&memo, remote, pdu);
@@ -193,12 +360,16 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                     if (obs_slot >= 0) {
                         observer = &_coap_state.observers[obs_slot];
                         memcpy(observer, remote, sizeof(sock_udp_ep_t));
+                        _index_add(&_observer_index, obs_slot);
                     } else {
                         DEBUG("gcoap: can't register observer\n");
                     }
                 }
                 if (observer != NULL) {
                     memo = &_coap_state.observe_memos[empty_slot];
+                    memo->observer = observer;
+                    memo->resource = resource;
+                    _index_add(&_obs_memo_index, empty_slot);
                 }
             }
             if (memo == NULL) {
@@ -206,9 +377,22 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                 DEBUG("gcoap: can't register observe memo\n");
             }
         }
+        /* re-registration, possibly for another resource */
+        else if (memo->resource != resource) {
+            if (resource_memo == NULL) {
+                unsigned pos = memo - &_coap_state.observe_memos[0];
+
+                _index_remove(&_obs_memo_index, pos);
+                memo->resource = resource;
+                _index_add(&_obs_memo_index, pos);
+            }
+            else {
+                coap_clear_observe(pdu);
+                memo = NULL;
+                DEBUG("gcoap: can't register observe memo\n");
+            }
+        }
         if (memo != NULL) {
-            memo->observer  = observer;
-            memo->resource  = resource;
             memo->token_len = coap_get_token_len(pdu);
             if (memo->token_len) {
                 memcpy(&memo->token[0], pdu->token, memo->token_len);
@@ -224,12 +408,15 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         /* clear memo, and clear observer if no other memos */
         if (memo != NULL) {
             DEBUG("gcoap: Deregistering observer for: %s\n", memo->resource->path);
+            _index_remove(&_obs_memo_index, memo - &_coap_state.observe_memos[0]);
             memo->observer = NULL;
             memo           = NULL;
             _find_obs_memo(&memo, remote, NULL);
             if (memo == NULL) {
                 _find_observer(&observer, remote);
                 if (observer != NULL) {
+                    _index_remove(&_observer_index,
+                                  observer - &_coap_state.observers[0]);
                     observer->family = AF_UNSPEC;
                 }
             }
@@ -237,10 +424,12 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         coap_clear_observe(pdu);
 
     } else if (coap_has_observe(pdu)) {
+        mutex_unlock(&_lock);
         /* bogus request; don't respond */
         DEBUG("gcoap: Observe value unexpected: %" PRIu32 "\n", coap_get_observe(pdu));
         return -1;
     }
+    mutex_unlock(&_lock);
 
     ssize_t pdu_len = resource->handler(pdu, buf, len);
     if (pdu_len < 0) {
@@ -251,41 +440,61 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 }
 
 /*
- * Searches listener registrations for the resource matching the path in a PDU.
+ * Searches the resources of a listener, sorted by path, for the resource
+ * matching a path and one of the methods in method_flag.
+ */
+static coap_resource_t *_find_listener_resource(gcoap_listener_t *listener,
+                                                const char *path,
+                                                unsigned method_flag)
+{
+    size_t first = 0;
+    size_t last  = listener->resources_len;
+
+    /* find the first resource with a path not before the path searched */
+    while (first < last) {
+        size_t mid = first + (last - first) / 2;
+
+        if (strcmp(listener->resources[mid].path, path) < 0) {
+            first = mid + 1;
+        }
+        else {
+            last = mid;
+        }
+    }
+    /* a path may be listed once for each method */
+    for (; first < listener->resources_len; first++) {
+        coap_resource_t *resource = &listener->resources[first];
+
+        if (strcmp(resource->path, path) != 0) {
+            break;
+        }
+        if (resource->methods & method_flag) {
+            return resource;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Searches listener registrations for the resource matching a path and one
+ * of the methods in method_flag.
  *
  * param[out] resource_ptr -- found resource
  * param[out] listener_ptr -- listener for found resource
  */
-static void _find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr)
+static void _find_resource(const char *path, unsigned method_flag,
+                           coap_resource_t **resource_ptr,
+                           gcoap_listener_t **listener_ptr)
 {
-    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
-
-    /* Find path for CoAP msg among listener resources and execute callback. */
     gcoap_listener_t *listener = _coap_state.listeners;
-    while (listener) {
-        coap_resource_t *resource = listener->resources;
-        for (size_t i = 0; i < listener->resources_len; i++) {
-            if (i) {
-                resource++;
-            }
-            if (! (resource->methods & method_flag)) {
-                continue;
-            }
 
-            int res = strcmp((char *)&pdu->url[0], resource->path);
-            if (res > 0) {
-                continue;
-            }
-            else if (res < 0) {
-                /* resources expected in alphabetical order */
-                break;
-            }
-            else {
-                *resource_ptr = resource;
-                *listener_ptr = listener;
-                return;
-            }
+    while (listener) {
+        coap_resource_t *resource = _find_listener_resource(listener, path,
+                                                            method_flag);
+        if (resource != NULL) {
+            *resource_ptr = resource;
+            *listener_ptr = listener;
+            return;
         }
         listener = listener->next;
     }
@@ -326,37 +535,18 @@ static ssize_t _finish_pdu(coap_pkt_t *pdu, uint8_t *buf, size_t len)
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
                                                             uint8_t *buf, size_t len)
 {
-    gcoap_request_memo_t *memo;
-    coap_pkt_t memo_pdu = { .token = NULL };
     (void) buf;
     (void) len;
 
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED)
-            continue;
-
-        /* setup memo PDU from memo header */
-        memo                 = &_coap_state.open_reqs[i];
-        coap_hdr_t *memo_hdr = (coap_hdr_t *) &memo->hdr_buf[0];
-        memo_pdu.hdr         = memo_hdr;
-        if (coap_get_token_len(&memo_pdu)) {
-            memo_pdu.token = &memo_hdr->data[0];
-        }
-        /* match on token */
-        if (coap_get_token_len(src_pdu) == coap_get_token_len(&memo_pdu)) {
-            uint8_t *src_byte  = src_pdu->token;
-            uint8_t *memo_byte = memo_pdu.token;
-            size_t j;
-            for (j = 0; j < coap_get_token_len(src_pdu); j++) {
-                if (*src_byte++ != *memo_byte++) {
-                    break;      /* token mismatch */
-                }
-            }
-            if (j == coap_get_token_len(src_pdu)) {
-                *memo_ptr = memo;
-            }
-        }
+    mutex_lock(&_lock);
+    unsigned slot = _index_find(&_req_index,
+                                _token_hash(src_pdu->token,
+                                            coap_get_token_len(src_pdu)),
+                                _req_memo_match, src_pdu);
+    if (_req_slots[slot] != 0) {
+        *memo_ptr = &_coap_state.open_reqs[_req_slots[slot] - 1];
     }
+    mutex_unlock(&_lock);
 }
 
 /* Calls handler callback on receipt of a timeout message. */
@@ -372,7 +562,7 @@ static void _expire_request(gcoap_request_memo_t *memo)
             req.hdr = (coap_hdr_t *)&memo->hdr_buf[0];   /* for reference */
             memo->resp_handler(memo->state, &req);
         }
-        memo->state = GCOAP_MEMO_UNUSED;
+        _req_memo_free(memo);
     }
     else {
         /* Response already handled; timeout must have fired while response */
@@ -484,31 +674,20 @@ static ssize_t _write_options(coap_pkt_t *pdu, uint8_t *buf, size_t len)
  */
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
 {
-    int empty_slot = -1;
-    *observer      = NULL;
-    for (unsigned i = 0; i < GCOAP_OBS_CLIENTS_MAX; i++) {
-        unsigned cmplen = 0;
+    unsigned slot = _index_find(&_observer_index, _ep_hash(remote),
+                                _observer_match, remote);
 
+    if (_observer_slots[slot] != 0) {
+        *observer = &_coap_state.observers[_observer_slots[slot] - 1];
+        return -1;
+    }
+    *observer = NULL;
+    for (unsigned i = 0; i < GCOAP_OBS_CLIENTS_MAX; i++) {
         if (_coap_state.observers[i].family == AF_UNSPEC) {
-            cmplen     = 0;
-            empty_slot = i;
-        }
-        else if (_coap_state.observers[i].family == AF_INET6) {
-            cmplen = 16;
-        }
-        else {
-            cmplen = 4;
-        }
-        if (cmplen &&
-                memcmp(&_coap_state.observers[i].addr.ipv6[0], &remote->addr.ipv6[0],
-                                                               cmplen) == 0
-                && _coap_state.observers[i].port == remote->port) {
-
-            *observer = &_coap_state.observers[i];
-            break;
+            return i;
         }
     }
-    return empty_slot;
+    return -1;
 }
 
 /*
@@ -565,13 +744,12 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource)
 {
+    unsigned slot = _index_find(&_obs_memo_index, _resource_hash(resource),
+                                _obs_memo_match, resource);
+
     *memo = NULL;
-    for (int i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer != NULL
-                && _coap_state.observe_memos[i].resource == resource) {
-            *memo = &_coap_state.observe_memos[i];
-            break;
-        }
+    if (_obs_memo_slots[slot] != 0) {
+        *memo = &_coap_state.observe_memos[_obs_memo_slots[slot] - 1];
     }
 }
 
@@ -581,24 +759,55 @@ static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
 
 kernel_pid_t gcoap_init(void)
 {
+    sock_udp_ep_t local;
+
     if (_pid != KERNEL_PID_UNDEF) {
         return -EEXIST;
     }
-    _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
-                            THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
 
     /* Blank lists so we know if an entry is available. */
     memset(&_coap_state.open_reqs[0], 0, sizeof(_coap_state.open_reqs));
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
+    memset(_req_slots, 0, sizeof(_req_slots));
+    memset(_observer_slots, 0, sizeof(_observer_slots));
+    memset(_obs_memo_slots, 0, sizeof(_obs_memo_slots));
+    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
+
+        memo->response_timer.callback = _on_resp_timeout;
+        memo->response_timer.arg      = memo;
+        sock_event_init_event(&memo->timeout_event, _on_resp_timeout_evt);
+    }
     /* randomize initial value */
     _coap_state.last_message_id = random_uint32() & 0xFFFF;
 
+    memset(&local, 0, sizeof(sock_udp_ep_t));
+    local.family = AF_INET6;
+    local.netif  = SOCK_ADDR_ANY_NETIF;
+    local.port   = GCOAP_PORT;
+
+    int res = sock_udp_create(&_sock, &local, NULL, 0);
+    if (res < 0) {
+        DEBUG("gcoap: cannot create sock: %d\n", res);
+        return res;
+    }
+    _pid = sock_event_init();
+    sock_udp_event_init(&_sock_event, &_sock, _on_sock_evt, NULL);
+
     return _pid;
 }
 
 void gcoap_register_listener(gcoap_listener_t *listener)
 {
+#ifdef DEVELHELP
+    /* resources are looked up by binary search */
+    for (size_t i = 1; i < listener->resources_len; i++) {
+        assert(strcmp(listener->resources[i - 1].path,
+                      listener->resources[i].path) <= 0);
+    }
+#endif
+
     /* Add the listener to the end of the linked list. */
     gcoap_listener_t *_last = _coap_state.listeners;
     while (_last->next) {
@@ -683,38 +892,27 @@ size_t gcoap_req_send2(uint8_t *buf, size_t len, sock_udp_ep_t *remote,
     assert(resp_handler != NULL);
 
     /* Find empty slot in list of open requests. */
+    mutex_lock(&_lock);
     for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
         if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED) {
             memo = &_coap_state.open_reqs[i];
             memo->state = GCOAP_MEMO_WAIT;
+            memcpy(&memo->hdr_buf[0], buf, GCOAP_HEADER_MAXLEN);
+            memo->resp_handler = resp_handler;
+            _index_add(&_req_index, i);
             break;
         }
     }
+    mutex_unlock(&_lock);
     if (memo) {
-        memcpy(&memo->hdr_buf[0], buf, GCOAP_HEADER_MAXLEN);
-        memo->resp_handler = resp_handler;
-
         size_t res = sock_udp_send(&_sock, buf, len, remote);
 
         if (res && (GCOAP_NON_TIMEOUT > 0)) {
-            /* interrupt sock listening (to set a listen timeout) */
-            msg_t mbox_msg;
-            mbox_msg.type          = GCOAP_MSG_TYPE_INTR;
-            mbox_msg.content.value = 0;
-            if (mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
-                /* start response wait timer */
-                memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
-                memo->timeout_msg.content.ptr = (char *)memo;
-                xtimer_set_msg(&memo->response_timer, GCOAP_NON_TIMEOUT,
-                                                      &memo->timeout_msg, _pid);
-            }
-            else {
-                memo->state = GCOAP_MEMO_UNUSED;
-                DEBUG("gcoap: can't wake up mbox; no timeout for msg\n");
-            }
+            /* start response wait timer */
+            xtimer_set(&memo->response_timer, GCOAP_NON_TIMEOUT);
         }
         else if (!res) {
-            memo->state = GCOAP_MEMO_UNUSED;
+            _req_memo_free(memo);
             DEBUG("gcoap: sock send failed: %d\n", res);
         }
         return res;
@@ -746,8 +944,10 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     ssize_t hdrlen;
     gcoap_observe_memo_t *memo = NULL;
 
+    mutex_lock(&_lock);
     _find_obs_memo_resource(&memo, resource);
     if (memo == NULL) {
+        mutex_unlock(&_lock);
         /* Unique return value to specify there is not an observer */
         return GCOAP_OBS_INIT_UNUSED;
     }
@@ -756,6 +956,7 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     hdrlen   = coap_build_hdr(pdu->hdr, COAP_TYPE_NON, &memo->token[0],
                               memo->token_len, COAP_CODE_CONTENT,
                               ++_coap_state.last_message_id);
+    mutex_unlock(&_lock);
     if (hdrlen > 0) {
         uint32_t now       = xtimer_now_usec();
         pdu->observe_value = (now >> GCOAP_OBS_TICK_EXPONENT) & 0xFFFFFF;
@@ -778,17 +979,33 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 size_t gcoap_obs_send(uint8_t *buf, size_t len, const coap_resource_t *resource)
 {
     gcoap_observe_memo_t *memo = NULL;
+    sock_udp_ep_t observer;
 
+    mutex_lock(&_lock);
     _find_obs_memo_resource(&memo, resource);
+    if (memo) {
+        /* the observer may deregister while the notification is sent */
+        memcpy(&observer, memo->observer, sizeof(observer));
+    }
+    mutex_unlock(&_lock);
 
     if (memo) {
-        return sock_udp_send(&_sock, buf, len, memo->observer);
+        return sock_udp_send(&_sock, buf, len, &observer);
     }
     else {
         return 0;
     }
 }
 
+const coap_resource_t *gcoap_find_resource(const char *path, unsigned method_flag)
+{
+    coap_resource_t *resource;
+    gcoap_listener_t *listener;
+
+    _find_resource(path, method_flag, &resource, &listener);
+    return resource;
+}
+
 uint8_t gcoap_op_state(void)
 {
     uint8_t count = 0;
@@ -15,9 +15,13 @@
  * @}
  */
 
+#include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 
+#include "mutex.h"
+#include "random.h"
+#include "xtimer.h"
 #include "net/sock/udp.h"
 #include "net/sock/dns.h"
 
@@ -28,6 +32,64 @@
 /* min domain name length is 1, so minimum record length is 7 */
 #define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
 
+#define DNS_TYPE_SOA        (6)
+#define DNS_FLAGS_QR        (0x8000)
+#define DNS_FLAGS_RCODE     (0x000f)
+#define DNS_RCODE_NXDOMAIN  (3)
+/* length of type, class, TTL and data length of a resource record */
+#define DNS_RR_HDR_LEN      (10U)
+/* length of serial, refresh, retry, expire and minimum of an SOA record */
+#define DNS_SOA_TAIL_LEN    (20U)
+#define DNS_REPLY_BUF_LEN   (512U)
+
+/* a lookup with AF_UNSPEC queries AAAA and A */
+#define LOOKUP_TYPES_MAX    (2U)
+
+/**
+ * @brief   An outstanding query, matched with its reply by its ID
+ */
+typedef struct {
+    const char *name;       /**< domain name; NULL, if unused */
+    uint8_t *addr;          /**< buffer for the address */
+    mutex_t *wake;          /**< unlocked, when the query is done */
+    int res;                /**< result */
+    uint16_t id;            /**< ID of the query */
+    uint16_t type;          /**< DNS_TYPE_AAAA or DNS_TYPE_A */
+    bool done;              /**< res is final */
+} _query_t;
+
+/**
+ * @brief   A name being looked up by sock_dns_query()
+ */
+typedef struct {
+    _query_t *queries[LOOKUP_TYPES_MAX];        /**< outstanding queries */
+    int res[LOOKUP_TYPES_MAX];                  /**< results; 0 if unknown */
+    uint8_t addrs[LOOKUP_TYPES_MAX][16];        /**< addresses */
+    unsigned num;                               /**< number of types */
+    mutex_t wake;                               /**< wakes the caller */
+} _lookup_t;
+
+#if SOCK_DNS_CACHE_SIZE
+typedef struct {
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];   /**< domain name */
+    uint8_t addr[16];                       /**< address */
+    uint32_t expires;                       /**< expiry in seconds */
+    int16_t res;                            /**< address length or -errno */
+    uint16_t type;                          /**< record type; 0, if unused */
+} _cache_entry_t;
+
+static _cache_entry_t _cache[SOCK_DNS_CACHE_SIZE];
+#endif
+
+/* protects all variables below and the queries */
+static mutex_t _lock = MUTEX_INIT;
+/* held by the thread receiving on _sock for all queries */
+static mutex_t _recv_lock = MUTEX_INIT;
+static _query_t _queries[SOCK_DNS_QUERIES_MAX];
+static sock_udp_t _sock;
+static sock_udp_ep_t _server;
+static bool _sock_open = false;
+
 static ssize_t _enc_domain_name(uint8_t *out, const char *domain_name)
 {
     /*
@@ -63,128 +125,504 @@ static unsigned _put_short(uint8_t *out, uint16_t val)
     return 2;
 }
 
-static unsigned _get_short(uint8_t *buf)
+static unsigned _get_short(const uint8_t *buf)
 {
     uint16_t _tmp;
     memcpy(&_tmp, buf, 2);
     return _tmp;
 }
 
-static size_t _skip_hostname(uint8_t *buf)
+static uint32_t _get_long(const uint8_t *buf)
 {
-    uint8_t *bufpos = buf;
+    uint32_t _tmp;
+    memcpy(&_tmp, buf, 4);
+    return _tmp;
+}
 
-    /* handle DNS Message Compression */
-    if (*bufpos >= 192) {
-        return 2;
-    }
+/* returns 0, if the name exceeds end */
+static size_t _skip_hostname(const uint8_t *buf, const uint8_t *end)
+{
+    const uint8_t *bufpos = buf;
 
-    while(*bufpos) {
+    while (bufpos < end) {
+        /* handle DNS Message Compression */
+        if (*bufpos >= 192) {
+            return ((bufpos + 2) <= end) ? (size_t)(bufpos - buf + 2) : 0;
+        }
+        if (*bufpos == 0) {
+            return (bufpos - buf + 1);
+        }
         bufpos += *bufpos + 1;
     }
-    return (bufpos - buf + 1);
+    return 0;
 }
 
-static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family)
+/* the TTL of a negative answer is the one of the SOA record (RFC 2308) */
+static int _parse_soa_ttl(const uint8_t *bufpos, unsigned rdlen,
+                          uint32_t rr_ttl, uint32_t *ttl)
 {
-    sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
-    uint8_t *bufpos = buf + sizeof(*hdr);
+    const uint8_t *end = bufpos + rdlen;
+
+    /* skip MNAME and RNAME */
+    for (unsigned i = 0; i < 2; i++) {
+        size_t len = _skip_hostname(bufpos, end);
+
+        if (len == 0) {
+            return -EBADMSG;
+        }
+        bufpos += len;
+    }
+    if ((bufpos + DNS_SOA_TAIL_LEN) > end) {
+        return -EBADMSG;
+    }
+    uint32_t minimum = ntohl(_get_long(bufpos + DNS_SOA_TAIL_LEN - 4));
+    *ttl = (rr_ttl < minimum) ? rr_ttl : minimum;
+    return 0;
+}
+
+static int _parse_dns_reply(const uint8_t *buf, size_t len, uint16_t type,
+                            void *addr_out, uint32_t *ttl)
+{
+    const sock_dns_hdr_t *hdr = (const sock_dns_hdr_t *)buf;
+    const uint8_t *bufpos = buf + sizeof(*hdr);
+    const uint8_t *end = buf + len;
+    unsigned flags = ntohs(_get_short((const uint8_t *)&hdr->flags));
+    unsigned ancount = ntohs(_get_short((const uint8_t *)&hdr->ancount));
+    unsigned nscount = ntohs(_get_short((const uint8_t *)&hdr->nscount));
+    unsigned qdcount = ntohs(_get_short((const uint8_t *)&hdr->qdcount));
+    unsigned addrlen = (type == DNS_TYPE_AAAA) ? 16 : 4;
+
+    if (!(flags & DNS_FLAGS_QR) ||
+        (((flags & DNS_FLAGS_RCODE) != 0) &&
+         ((flags & DNS_FLAGS_RCODE) != DNS_RCODE_NXDOMAIN))) {
+        return -EBADMSG;
+    }
 
     /* skip all queries that are part of the reply */
-    for (unsigned n = 0; n < ntohs(hdr->qdcount); n++) {
-        bufpos += _skip_hostname(bufpos);
-        bufpos += 4;    /* skip type and class of query */
+    for (unsigned n = 0; n < qdcount; n++) {
+        size_t name_len = _skip_hostname(bufpos, end);
+
+        if ((name_len == 0) || ((bufpos + name_len + 4) > end)) {
+            return -EBADMSG;
+        }
+        bufpos += name_len + 4;     /* skip type and class of query */
     }
 
-    for (unsigned n = 0; n < ntohs(hdr->ancount); n++) {
-        bufpos += _skip_hostname(bufpos);
+    *ttl = SOCK_DNS_NEG_TTL;
+    /* answer section, then authority section */
+    for (unsigned n = 0; n < (ancount + nscount); n++) {
+        size_t name_len = _skip_hostname(bufpos, end);
+
+        if ((name_len == 0) || ((bufpos + name_len + DNS_RR_HDR_LEN) > end)) {
+            return -EBADMSG;
+        }
+        bufpos += name_len;
         uint16_t _type = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        uint16_t class = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        bufpos += 4; /* skip ttl */
-
-        unsigned addrlen = ntohs(_get_short(bufpos));
-        bufpos += 2;
-        if ((bufpos + addrlen) > (buf + len)) {
+        uint16_t class = ntohs(_get_short(bufpos + 2));
+        uint32_t rr_ttl = ntohl(_get_long(bufpos + 4));
+        unsigned rdlen = ntohs(_get_short(bufpos + 8));
+        bufpos += DNS_RR_HDR_LEN;
+        if ((bufpos + rdlen) > end) {
             return -EBADMSG;
         }
 
-        /* skip unwanted answers */
-        if ((class != DNS_CLASS_IN) ||
-                ((_type == DNS_TYPE_A) && (family == AF_INET6)) ||
-                ((_type == DNS_TYPE_AAAA) && (family == AF_INET)) ||
-                ! ((_type == DNS_TYPE_A) || ((_type == DNS_TYPE_AAAA))
-                    )) {
-            bufpos += addrlen;
-            continue;
+        if (class == DNS_CLASS_IN) {
+            if ((n < ancount) && (_type == type) && (rdlen == addrlen)) {
+                memcpy(addr_out, bufpos, addrlen);
+                *ttl = rr_ttl;
+                return addrlen;
+            }
+            if ((n >= ancount) && (_type == DNS_TYPE_SOA) &&
+                (_parse_soa_ttl(bufpos, rdlen, rr_ttl, ttl) < 0)) {
+                return -EBADMSG;
+            }
         }
+        bufpos += rdlen;
+    }
 
-        memcpy(addr_out, bufpos, addrlen);
-        return addrlen;
+    /* NXDOMAIN or no record of this type */
+    return -EHOSTUNREACH;
+}
+
+#if SOCK_DNS_CACHE_SIZE
+static uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static bool _cache_valid(const _cache_entry_t *entry, uint32_t now)
+{
+    return (entry->type != 0) && ((int32_t)(entry->expires - now) > 0);
+}
+
+/* returns the cached result or 0, if there is none */
+static int _cache_get(const char *name, uint16_t type, uint8_t *addr)
+{
+    uint32_t now = _now_sec();
+
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *entry = &_cache[i];
+
+        if (_cache_valid(entry, now) && (entry->type == type) &&
+            (strcmp(entry->name, name) == 0)) {
+            if (entry->res > 0) {
+                memcpy(addr, entry->addr, entry->res);
+            }
+            return entry->res;
+        }
+    }
+    return 0;
+}
+
+static void _cache_add(const char *name, uint16_t type, int res,
+                       const uint8_t *addr, uint32_t ttl)
+{
+    uint32_t now = _now_sec();
+    _cache_entry_t *entry = NULL;
+
+    if (ttl == 0) {
+        return;
     }
+    /* keeps the difference to now comparable */
+    if (ttl > INT32_MAX) {
+        ttl = INT32_MAX;
+    }
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *tmp = &_cache[i];
 
-    return -1;
+        if ((tmp->type == type) && (strcmp(tmp->name, name) == 0)) {
+            entry = tmp;
+            break;
+        }
+        /* replace an expired entry or else the one expiring first */
+        if ((entry == NULL) || !_cache_valid(tmp, now) ||
+            (_cache_valid(entry, now) &&
+             ((int32_t)(tmp->expires - entry->expires) < 0))) {
+            entry = tmp;
+        }
+    }
+    strcpy(entry->name, name);
+    if (res > 0) {
+        memcpy(entry->addr, addr, res);
+    }
+    entry->expires = now + ttl;
+    entry->res = res;
+    entry->type = type;
+}
+#else
+static inline int _cache_get(const char *name, uint16_t type, uint8_t *addr)
+{
+    (void)name;
+    (void)type;
+    (void)addr;
+    return 0;
 }
 
-int sock_dns_query(const char *domain_name, void *addr_out, int family)
+static inline void _cache_add(const char *name, uint16_t type, int res,
+                              const uint8_t *addr, uint32_t ttl)
 {
-    uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
-    uint8_t reply_buf[512];
+    (void)name;
+    (void)type;
+    (void)res;
+    (void)addr;
+    (void)ttl;
+}
+#endif
 
-    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
-        return -ENOSPC;
+/*
+ * returns the index of the result of a lookup or -1, if it is not known yet:
+ * the first address found in order of preference or else the last error
+ */
+static int _pick(const int *res, unsigned num)
+{
+    for (unsigned i = 0; i < num; i++) {
+        if (res[i] == 0) {
+            return -1;
+        }
+        if (res[i] > 0) {
+            return i;
+        }
     }
+    return num - 1;
+}
+
+/* must be called with _lock held */
+static _query_t *_query_find(uint16_t id)
+{
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_MAX; i++) {
+        if ((_queries[i].name != NULL) && (_queries[i].id == id)) {
+            return &_queries[i];
+        }
+    }
+    return NULL;
+}
+
+/* must be called with _lock held */
+static _query_t *_query_add(const char *name, uint16_t type, uint8_t *addr,
+                            mutex_t *wake)
+{
+    _query_t *query = NULL;
+    uint16_t id;
 
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_MAX; i++) {
+        if (_queries[i].name == NULL) {
+            query = &_queries[i];
+            break;
+        }
+    }
+    if (query == NULL) {
+        return NULL;
+    }
+    do {
+        id = (uint16_t)random_uint32();
+    } while (_query_find(id) != NULL);
+    query->name = name;
+    query->addr = addr;
+    query->wake = wake;
+    query->res = -ETIMEDOUT;
+    query->id = id;
+    query->type = type;
+    query->done = false;
+    return query;
+}
+
+/* opens _sock to sock_dns_server; must be called with _lock held */
+static int _sock_update(void)
+{
+    bool idle = true;
+    int res;
+
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_MAX; i++) {
+        if (_queries[i].name != NULL) {
+            idle = false;
+        }
+    }
+    if (_sock_open &&
+        (!idle || (memcmp(&_server, &sock_dns_server, sizeof(_server)) == 0))) {
+        return 0;
+    }
+    if (_sock_open) {
+        sock_udp_close(&_sock);
+        _sock_open = false;
+    }
+    res = sock_udp_create(&_sock, NULL, &sock_dns_server, 0);
+    if (res == 0) {
+        memcpy(&_server, &sock_dns_server, sizeof(_server));
+        _sock_open = true;
+    }
+    return res;
+}
+
+/* must be called with _lock held */
+static void _query_send(_query_t *query)
+{
+    uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
+    uint8_t *bufpos = buf + sizeof(*hdr);
+    ssize_t res;
+
     memset(hdr, 0, sizeof(*hdr));
-    hdr->id = 0; /* random? */
+    hdr->id = query->id;
     hdr->flags = htons(0x0120);
-    hdr->qdcount = htons(1 + (family == AF_UNSPEC));
+    hdr->qdcount = htons(1);
+    bufpos += _enc_domain_name(bufpos, query->name);
+    bufpos += _put_short(bufpos, htons(query->type));
+    bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+
+    res = sock_udp_send(&_sock, buf, (bufpos - buf), NULL);
+    if (res <= 0) {
+        /* nobody would receive a reply */
+        query->res = (res < 0) ? res : -EIO;
+        query->done = true;
+    }
+}
 
-    uint8_t *bufpos = buf + sizeof(*hdr);
+/* checks that the only question of a reply is the one asked by query */
+static bool _question_matches(const uint8_t *buf, size_t len,
+                              const _query_t *query)
+{
+    const sock_dns_hdr_t *hdr = (const sock_dns_hdr_t *)buf;
+    const uint8_t *bufpos = buf + sizeof(*hdr);
+    uint8_t name[SOCK_DNS_MAX_NAME_LEN + 2];
+    size_t name_len;
 
-    unsigned _name_ptr;
-    if ((family == AF_INET6) || (family == AF_UNSPEC)) {
-        _name_ptr = (bufpos - buf);
-        bufpos += _enc_domain_name(bufpos, domain_name);
-        bufpos += _put_short(bufpos, htons(DNS_TYPE_AAAA));
-        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+    if (ntohs(_get_short((const uint8_t *)&hdr->qdcount)) != 1) {
+        return false;
     }
+    name_len = _enc_domain_name(name, query->name);
+    if ((bufpos + name_len + 4) > (buf + len)) {
+        return false;
+    }
+    return (memcmp(bufpos, name, name_len) == 0) &&
+           (ntohs(_get_short(bufpos + name_len)) == query->type) &&
+           (ntohs(_get_short(bufpos + name_len + 2)) == DNS_CLASS_IN);
+}
 
-    if ((family == AF_INET) || (family == AF_UNSPEC)) {
-        if (family == AF_UNSPEC) {
-            bufpos += _put_short(bufpos, htons((0xc000) | (_name_ptr)));
+/* passes a reply to its query */
+static void _dispatch(const uint8_t *buf, size_t len)
+{
+    _query_t *query;
+
+    if (len <= DNS_MIN_REPLY_LEN) {
+        return;
+    }
+    mutex_lock(&_lock);
+    query = _query_find(_get_short(buf));
+    /* a reply with the ID of a query, but to another question, is dropped */
+    if ((query != NULL) && !query->done &&
+        _question_matches(buf, len, query)) {
+        uint32_t ttl;
+        int res = _parse_dns_reply(buf, len, query->type, query->addr, &ttl);
+
+        query->res = res;
+        /* on a bad reply the query is sent again */
+        if ((res > 0) || (res == -EHOSTUNREACH)) {
+            _cache_add(query->name, query->type, res, query->addr, ttl);
+            query->done = true;
+            mutex_unlock(query->wake);
+        }
+    }
+    mutex_unlock(&_lock);
+}
+
+/* updates the results of a lookup; must be called with _lock held */
+static bool _lookup_finished(_lookup_t *lookup)
+{
+    for (unsigned i = 0; i < lookup->num; i++) {
+        _query_t *query = lookup->queries[i];
+
+        if ((query != NULL) && query->done) {
+            lookup->res[i] = query->res;
+        }
+    }
+    return _pick(lookup->res, lookup->num) >= 0;
+}
+
+/* wakes another thread waiting for a reply, so it takes over receiving */
+static void _handoff(const mutex_t *wake)
+{
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_MAX; i++) {
+        _query_t *query = &_queries[i];
+
+        if ((query->name != NULL) && !query->done && (query->wake != wake)) {
+            mutex_unlock(query->wake);
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+}
+
+static void _lookup_wait(_lookup_t *lookup, uint64_t deadline)
+{
+    while (1) {
+        uint64_t now = xtimer_now_usec64();
+        bool finished;
+
+        mutex_lock(&_lock);
+        finished = _lookup_finished(lookup);
+        mutex_unlock(&_lock);
+        if (finished || (now >= deadline)) {
+            break;
+        }
+        /* one thread receives for all queries, the others wait until their
+         * query is done or they are handed over receiving */
+        if (mutex_trylock(&_recv_lock)) {
+            uint8_t reply_buf[DNS_REPLY_BUF_LEN];
+            ssize_t res = sock_udp_recv(&_sock, reply_buf, sizeof(reply_buf),
+                                        (uint32_t)(deadline - now), NULL);
+
+            mutex_unlock(&_recv_lock);
+            if (res > 0) {
+                _dispatch(reply_buf, res);
+            }
         }
         else {
-            bufpos += _enc_domain_name(bufpos, domain_name);
+            xtimer_mutex_lock_timeout(&lookup->wake, deadline - now);
         }
-        bufpos += _put_short(bufpos, htons(DNS_TYPE_A));
-        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
     }
+    _handoff(&lookup->wake);
+}
 
-    sock_udp_t sock_dns;
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    static const uint16_t types[] = { DNS_TYPE_AAAA, DNS_TYPE_A };
+    _lookup_t lookup = { .num = 0, .wake = MUTEX_INIT_LOCKED };
+    unsigned first = 0;
+    int res;
 
-    ssize_t res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
-    if (res) {
-            puts("a");
-        goto out;
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+    switch (family) {
+        case AF_UNSPEC:
+            lookup.num = 2;
+            break;
+        case AF_INET6:
+            lookup.num = 1;
+            break;
+        case AF_INET:
+            first = 1;
+            lookup.num = 1;
+            break;
+        default:
+            return -EAFNOSUPPORT;
     }
 
-    for (int i = 0; i < SOCK_DNS_RETRIES; i++) {
-        res = sock_udp_send(&sock_dns, buf, (bufpos-buf), NULL);
-        if (res <= 0) {
-            continue;
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < lookup.num; i++) {
+        lookup.queries[i] = NULL;
+        lookup.res[i] = _cache_get(domain_name, types[first + i],
+                                   lookup.addrs[i]);
+    }
+    res = 0;
+    if (_pick(lookup.res, lookup.num) < 0) {
+        res = _sock_update();
+    }
+    for (unsigned i = 0; (res == 0) && (i < lookup.num); i++) {
+        if (lookup.res[i] == 0) {
+            lookup.queries[i] = _query_add(domain_name, types[first + i],
+                                           lookup.addrs[i], &lookup.wake);
+            if (lookup.queries[i] == NULL) {
+                res = -ENOBUFS;
+            }
         }
-        res = sock_udp_recv(&sock_dns, reply_buf, sizeof(reply_buf), 1000000LU, NULL);
-        if ((res > 0) && (res > (int)DNS_MIN_REPLY_LEN)) {
-            if ((res = _parse_dns_reply(reply_buf, res, addr_out, family)) > 0) {
-                goto out;
+    }
+    mutex_unlock(&_lock);
+
+    /* AAAA and A are queried at the same time */
+    for (int i = 0; (res == 0) && (i < SOCK_DNS_RETRIES); i++) {
+        bool finished;
+
+        mutex_lock(&_lock);
+        for (unsigned j = 0; j < lookup.num; j++) {
+            if ((lookup.queries[j] != NULL) && !lookup.queries[j]->done) {
+                _query_send(lookup.queries[j]);
             }
         }
+        finished = _lookup_finished(&lookup);
+        mutex_unlock(&_lock);
+        if (finished) {
+            break;
+        }
+        _lookup_wait(&lookup, xtimer_now_usec64() + SOCK_DNS_TIMEOUT);
     }
 
-out:
-    sock_udp_close(&sock_dns);
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < lookup.num; i++) {
+        if (lookup.queries[i] != NULL) {
+            lookup.res[i] = lookup.queries[i]->res;
+            lookup.queries[i]->name = NULL;
+        }
+    }
+    mutex_unlock(&_lock);
+    if (res == 0) {
+        int idx = _pick(lookup.res, lookup.num);
+
+        res = lookup.res[idx];
+        if (res > 0) {
+            memcpy(addr_out, lookup.addrs[idx], res);
+        }
+    }
     return res;
 }
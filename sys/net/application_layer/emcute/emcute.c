@@ -23,6 +23,7 @@
 #include "log.h"
 #include "mutex.h"
 #include "sched.h"
+#include "sema.h"
 #include "xtimer.h"
 #include "thread_flags.h"
 
@@ -37,27 +38,68 @@
 #define PUB_FLAGS           (EMCUTE_QOS_MASK | EMCUTE_RETAIN)
 #define SUB_FLAGS           (EMCUTE_DUP | EMCUTE_QOS_MASK | EMCUTE_TIT_MASK)
 
-#define TFLAGS_RESP         (0x0001)
-#define TFLAGS_TIMEOUT      (0x0002)
-#define TFLAGS_ANY          (TFLAGS_RESP | TFLAGS_TIMEOUT)
+#define TFLAGS_RECV         (0x0001)
+#define TFLAGS_RETRY        (0x0002)
+#define TFLAGS_PING         (0x0004)
+#define TFLAGS_ANY          (TFLAGS_RECV | TFLAGS_RETRY | TFLAGS_PING)
 
+#define BATCH_INIT          { MUTEX_INIT, 0, EMCUTE_OK }
+
+/**
+ * @brief   States of an in-flight slot
+ */
+enum {
+    SLOT_FREE = 0,          /**< unused */
+    SLOT_RESERVED,          /**< owned by a thread building a message */
+    SLOT_ACTIVE             /**< sent and waiting for its response */
+};
+
+/**
+ * @brief   A group of messages a thread waits for
+ */
+typedef struct {
+    mutex_t idle;           /**< locked while messages are in flight */
+    unsigned pending;       /**< number of messages in flight */
+    int res;                /**< first error or else the last result */
+} batch_t;
+
+/**
+ * @brief   A message sent to the gateway, kept until it is acknowledged
+ */
+typedef struct {
+    xtimer_t timer;         /**< retransmit timer */
+    batch_t *batch;         /**< the group the message belongs to */
+    emcute_topic_t *topic;  /**< topic to set the ID of (REGISTER only) */
+    uint16_t len;           /**< length of the message */
+    uint16_t id;            /**< message ID */
+    uint8_t resp;           /**< type of the expected response */
+    uint8_t state;          /**< see SLOT_FREE etc. */
+    uint8_t retries;        /**< number of retransmissions so far */
+    volatile uint8_t due;   /**< set when the retransmit timer fired */
+    uint8_t buf[EMCUTE_BUFSIZE];    /**< the message */
+} inflight_t;
 
 static const char *cli_id;
 static sock_udp_t sock;
 static sock_udp_ep_t gateway;
 
 static uint8_t rbuf[EMCUTE_BUFSIZE];
-static uint8_t tbuf[EMCUTE_BUFSIZE];
 
 static emcute_sub_t *subs = NULL;
 
-static mutex_t txlock;
-
-static xtimer_t timer;
+/* protects the in-flight table */
+static mutex_t txlock = MUTEX_INIT;
+/* serializes exchanges without message ID (CONNECT, DISCONNECT, WILL...) */
+static mutex_t ctllock = MUTEX_INIT;
+/* counts the free slots of the in-flight table */
+static sema_t window = SEMA_CREATE(EMCUTE_INFLIGHT_MAX);
+static inflight_t inflight[EMCUTE_INFLIGHT_MAX];
+/* publishes sent with emcute_pub_async() */
+static batch_t pubs = BATCH_INIT;
+
+static thread_t *emcute_thread = NULL;
+static xtimer_t ping_timer;
 static uint16_t id_next = 0x1234;
-static volatile uint8_t waiton = 0xff;
-static volatile uint16_t waitonid = 0;
-static volatile int result;
 
 static inline uint16_t get_u16(const uint8_t *buf)
 {
@@ -87,7 +129,7 @@ static int set_len(uint8_t *buf, size_t len)
     }
     else {
         buf[0] = 0x01;
-        set_u16(&tbuf[1], (uint16_t)(len + 3));
+        set_u16(&buf[1], (uint16_t)(len + 3));
         return 3;
     }
 }
@@ -106,63 +148,177 @@ static int get_len(uint8_t *buf, uint16_t *len)
 
 static void time_evt(void *arg)
 {
-    thread_flags_set((thread_t *)arg, TFLAGS_TIMEOUT);
+    ((inflight_t *)arg)->due = 1;
+    thread_flags_set(emcute_thread, TFLAGS_RETRY);
 }
 
-static int syncsend(uint8_t resp, size_t len, bool unlock)
+static void ping_evt(void *arg)
 {
-    int res = EMCUTE_TIMEOUT;
-    waiton = resp;
-    timer.arg = (void *)sched_active_thread;
-    /* clear flags, in case the timer was triggered last time right before the
-     * remove was called */
-    thread_flags_clear(TFLAGS_ANY);
+    thread_flags_set((thread_t *)arg, TFLAGS_PING);
+}
 
-    for (unsigned retries = 0; retries < EMCUTE_N_RETRY; retries++) {
-        DEBUG("[emcute] syncsend: sending round %i\n", retries);
-        sock_udp_send(&sock, tbuf, len, &gateway);
+/* reserves a slot, waits while all slots are in use */
+static inflight_t *slot_get(void)
+{
+    inflight_t *slot = NULL;
 
-        xtimer_set(&timer, (EMCUTE_T_RETRY * US_PER_SEC));
-        thread_flags_t flags = thread_flags_wait_any(TFLAGS_ANY);
-        if (flags & TFLAGS_RESP) {
-            DEBUG("[emcute] syncsend: got response [%i]\n", result);
-            xtimer_remove(&timer);
-            res = result;
-            retries = EMCUTE_N_RETRY;
+    sema_wait(&window);
+    mutex_lock(&txlock);
+    for (unsigned i = 0; i < EMCUTE_INFLIGHT_MAX; i++) {
+        if (inflight[i].state == SLOT_FREE) {
+            slot = &inflight[i];
+            break;
         }
     }
+    assert(slot != NULL);
+    slot->state = SLOT_RESERVED;
+    slot->topic = NULL;
+    if (id_next == 0) {
+        id_next++;
+    }
+    slot->id = id_next++;
+    mutex_unlock(&txlock);
+    return slot;
+}
 
-    /* cleanup sync state */
-    waiton = 0xff;
-    if (unlock) {
-        mutex_unlock(&txlock);
+/* must be called with txlock held */
+static void slot_free(inflight_t *slot)
+{
+    slot->state = SLOT_FREE;
+    sema_post(&window);
+}
+
+/* sends a message that is not acknowledged and frees its slot */
+static void slot_send_once(inflight_t *slot, size_t len)
+{
+    mutex_lock(&txlock);
+    sock_udp_send(&sock, slot->buf, len, &gateway);
+    slot_free(slot);
+    mutex_unlock(&txlock);
+}
+
+/* sends a message, which is retransmitted until its response arrives */
+static void slot_send(inflight_t *slot, uint8_t resp, size_t len,
+                      batch_t *batch)
+{
+    mutex_lock(&txlock);
+    if (batch->pending++ == 0) {
+        mutex_lock(&batch->idle);
+    }
+    slot->batch = batch;
+    slot->len = (uint16_t)len;
+    slot->resp = resp;
+    slot->retries = 0;
+    slot->due = 0;
+    slot->state = SLOT_ACTIVE;
+    slot->timer.callback = time_evt;
+    slot->timer.arg = slot;
+    DEBUG("[emcute] slot_send: sending [%s], id %i\n",
+          emcute_type_str(slot->buf[(slot->buf[0] == 0x01) ? 3 : 1]),
+          (int)slot->id);
+    sock_udp_send(&sock, slot->buf, len, &gateway);
+    xtimer_set(&slot->timer, (EMCUTE_T_RETRY * US_PER_SEC));
+    mutex_unlock(&txlock);
+}
+
+/* sends a message and waits for its response */
+static int syncsend(inflight_t *slot, uint8_t resp, size_t len)
+{
+    batch_t batch = BATCH_INIT;
+
+    slot_send(slot, resp, len, &batch);
+    /* unlocked once the message is done */
+    mutex_lock(&batch.idle);
+    return batch.res;
+}
+
+/* must be called with txlock held */
+static void slot_done(inflight_t *slot, int result)
+{
+    batch_t *batch = slot->batch;
+
+    xtimer_remove(&slot->timer);
+    if ((result > 0) && (slot->topic != NULL)) {
+        slot->topic->id = (uint16_t)result;
     }
-    return res;
+    if (batch->res >= 0) {
+        batch->res = result;
+    }
+    slot_free(slot);
+    if (--batch->pending == 0) {
+        mutex_unlock(&batch->idle);
+    }
+}
+
+static void retransmit(void)
+{
+    mutex_lock(&txlock);
+    for (unsigned i = 0; i < EMCUTE_INFLIGHT_MAX; i++) {
+        inflight_t *slot = &inflight[i];
+
+        if ((slot->state != SLOT_ACTIVE) || !slot->due) {
+            continue;
+        }
+        slot->due = 0;
+        if (++slot->retries >= EMCUTE_N_RETRY) {
+            DEBUG("[emcute] retransmit: id %i timed out\n", (int)slot->id);
+            slot_done(slot, EMCUTE_TIMEOUT);
+            continue;
+        }
+        uint16_t len;
+        int pos = get_len(slot->buf, &len);
+        if (slot->buf[pos] == PUBLISH) {
+            slot->buf[pos + 1] |= EMCUTE_DUP;
+        }
+        DEBUG("[emcute] retransmit: id %i, round %i\n", (int)slot->id,
+              (int)slot->retries);
+        sock_udp_send(&sock, slot->buf, slot->len, &gateway);
+        xtimer_set(&slot->timer, (EMCUTE_T_RETRY * US_PER_SEC));
+    }
+    mutex_unlock(&txlock);
+}
+
+/* must be called with txlock held */
+static inflight_t *find_slot(uint8_t type, int id_pos)
+{
+    for (unsigned i = 0; i < EMCUTE_INFLIGHT_MAX; i++) {
+        inflight_t *slot = &inflight[i];
+
+        if ((slot->state == SLOT_ACTIVE) && (slot->resp == type) &&
+            (!id_pos || (slot->id == get_u16(&rbuf[id_pos])))) {
+            return slot;
+        }
+    }
+    return NULL;
 }
 
 static void on_disconnect(void)
 {
-    if (waiton == DISCONNECT) {
+    mutex_lock(&txlock);
+    inflight_t *slot = find_slot(DISCONNECT, 0);
+    if (slot) {
         gateway.port = 0;
-        result = EMCUTE_OK;
-        thread_flags_set((thread_t *)timer.arg, TFLAGS_RESP);
+        slot_done(slot, EMCUTE_OK);
     }
+    mutex_unlock(&txlock);
 }
 
 static void on_ack(uint8_t type, int id_pos, int ret_pos, int res_pos)
 {
-    if ((waiton == type) && (!id_pos || (waitonid == get_u16(&rbuf[id_pos])))) {
+    mutex_lock(&txlock);
+    inflight_t *slot = find_slot(type, id_pos);
+    if (slot) {
         if (!ret_pos || (rbuf[ret_pos] == ACCEPT)) {
             if (res_pos == 0) {
-                result = EMCUTE_OK;
+                slot_done(slot, EMCUTE_OK);
             } else {
-                result = (int)get_u16(&rbuf[res_pos]);
+                slot_done(slot, (int)get_u16(&rbuf[res_pos]));
             }
         } else {
-            result = EMCUTE_REJECT;
+            slot_done(slot, EMCUTE_REJECT);
         }
-        thread_flags_set((thread_t *)timer.arg, TFLAGS_RESP);
     }
+    mutex_unlock(&txlock);
 }
 
 static void on_publish(void)
@@ -227,13 +383,20 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 {
     int res;
     size_t len;
+    inflight_t *slot;
 
     assert(!will_topic || (will_topic && will_msg && !(will_flags & ~PUB_FLAGS)));
 
-    mutex_lock(&txlock);
+    if (will_topic && ((strlen(will_topic) > EMCUTE_TOPIC_MAXLEN) ||
+                       ((will_msg_len + 4) > EMCUTE_BUFSIZE))) {
+        return EMCUTE_OVERFLOW;
+    }
+
+    mutex_lock(&ctllock);
 
     /* check for existing connections and copy given UDP endpoint */
     if (gateway.port != 0) {
+        mutex_unlock(&ctllock);
         return EMCUTE_NOGW;
     }
     memcpy(&gateway, remote, sizeof(sock_udp_ep_t));
@@ -245,53 +408,52 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
     }
 
     /* compute packet size */
+    slot = slot_get();
     len = (strlen(cli_id) + 6);
-    tbuf[0] = (uint8_t)len;
-    tbuf[1] = CONNECT;
-    tbuf[2] = flags;
-    tbuf[3] = PROTOCOL_VERSION;
-    set_u16(&tbuf[4], EMCUTE_KEEPALIVE);
-    memcpy(&tbuf[6], cli_id, strlen(cli_id));
+    slot->buf[0] = (uint8_t)len;
+    slot->buf[1] = CONNECT;
+    slot->buf[2] = flags;
+    slot->buf[3] = PROTOCOL_VERSION;
+    set_u16(&slot->buf[4], EMCUTE_KEEPALIVE);
+    memcpy(&slot->buf[6], cli_id, strlen(cli_id));
 
     /* configure 'state machine' and send the connection request */
     if (will_topic) {
         size_t topic_len = strlen(will_topic);
-        if ((topic_len > EMCUTE_TOPIC_MAXLEN) ||
-            ((will_msg_len + 4) > EMCUTE_BUFSIZE)) {
-            gateway.port = 0;
-            return EMCUTE_OVERFLOW;
-        }
 
-        res = syncsend(WILLTOPICREQ, len, false);
+        res = syncsend(slot, WILLTOPICREQ, len);
         if (res != EMCUTE_OK) {
-            gateway.port = 0;
-            return res;
+            goto out;
         }
 
         /* now send WILLTOPIC */
-        int pos = set_len(tbuf, (topic_len + 2));
+        slot = slot_get();
+        int pos = set_len(slot->buf, (topic_len + 2));
         len = (pos + topic_len + 2);
-        tbuf[pos++] = WILLTOPIC;
-        tbuf[pos++] = will_flags;
-        memcpy(&tbuf[pos], will_topic, strlen(will_topic));
+        slot->buf[pos++] = WILLTOPIC;
+        slot->buf[pos++] = will_flags;
+        memcpy(&slot->buf[pos], will_topic, topic_len);
 
-        res = syncsend(WILLMSGREQ, len, false);
+        res = syncsend(slot, WILLMSGREQ, len);
         if (res != EMCUTE_OK) {
-            gateway.port = 0;
-            return res;
+            goto out;
         }
 
         /* and WILLMSG afterwards */
-        pos = set_len(tbuf, (will_msg_len + 1));
+        slot = slot_get();
+        pos = set_len(slot->buf, (will_msg_len + 1));
         len = (pos + will_msg_len + 1);
-        tbuf[pos++] = WILLMSG;
-        memcpy(&tbuf[pos], will_msg, will_msg_len);
+        slot->buf[pos++] = WILLMSG;
+        memcpy(&slot->buf[pos], will_msg, will_msg_len);
     }
 
-    res = syncsend(CONNACK, len, true);
+    res = syncsend(slot, CONNACK, len);
+
+out:
     if (res != EMCUTE_OK) {
         gateway.port = 0;
     }
+    mutex_unlock(&ctllock);
     return res;
 }
 
@@ -301,12 +463,29 @@ int emcute_discon(void)
         return EMCUTE_NOGW;
     }
 
-    mutex_lock(&txlock);
+    mutex_lock(&ctllock);
 
-    tbuf[0] = 2;
-    tbuf[1] = DISCONNECT;
+    inflight_t *slot = slot_get();
+    slot->buf[0] = 2;
+    slot->buf[1] = DISCONNECT;
 
-    return syncsend(DISCONNECT, 2, true);
+    int res = syncsend(slot, DISCONNECT, 2);
+    mutex_unlock(&ctllock);
+    return res;
+}
+
+/* fills in a REGISTER message */
+static size_t reg_msg(inflight_t *slot, emcute_topic_t *topic)
+{
+    size_t len = strlen(topic->name);
+
+    slot->buf[0] = (len + 6);
+    slot->buf[1] = REGISTER;
+    set_u16(&slot->buf[2], 0);
+    set_u16(&slot->buf[4], slot->id);
+    memcpy(&slot->buf[6], topic->name, len);
+    slot->topic = topic;
+    return (len + 6);
 }
 
 int emcute_reg(emcute_topic_t *topic)
@@ -320,28 +499,39 @@ int emcute_reg(emcute_topic_t *topic)
         return EMCUTE_OVERFLOW;
     }
 
-    mutex_lock(&txlock);
+    inflight_t *slot = slot_get();
+    int res = syncsend(slot, REGACK, reg_msg(slot, topic));
+    return (res > 0) ? EMCUTE_OK : res;
+}
 
-    tbuf[0] = (strlen(topic->name) + 6);
-    tbuf[1] = REGISTER;
-    set_u16(&tbuf[2], 0);
-    set_u16(&tbuf[4], id_next);
-    waitonid = id_next++;
-    memcpy(&tbuf[6], topic->name, strlen(topic->name));
+int emcute_reg_batch(emcute_topic_t *topics, size_t numof)
+{
+    batch_t batch = BATCH_INIT;
 
-    int res = syncsend(REGACK, (size_t)tbuf[0], true);
-    if (res > 0) {
-        topic->id = (uint16_t)res;
-        res = EMCUTE_OK;
+    assert(topics || (numof == 0));
+
+    if (gateway.port == 0) {
+        return EMCUTE_NOGW;
     }
-    return res;
+    for (size_t i = 0; i < numof; i++) {
+        assert(topics[i].name);
+        if (strlen(topics[i].name) > EMCUTE_TOPIC_MAXLEN) {
+            return EMCUTE_OVERFLOW;
+        }
+    }
+
+    /* up to EMCUTE_INFLIGHT_MAX registrations are in flight at once */
+    for (size_t i = 0; i < numof; i++) {
+        inflight_t *slot = slot_get();
+        slot_send(slot, REGACK, reg_msg(slot, &topics[i]), &batch);
+    }
+    mutex_lock(&batch.idle);
+    return (batch.res > 0) ? EMCUTE_OK : batch.res;
 }
 
-int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
-               unsigned flags)
+static int pub(emcute_topic_t *topic, const void *data, size_t len,
+               unsigned flags, batch_t *batch)
 {
-    int res = EMCUTE_OK;
-
     assert((topic->id != 0) && data && (len > 0) && !(flags & ~PUB_FLAGS));
 
     if (gateway.port == 0) {
@@ -354,27 +544,52 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
         return EMCUTE_NOTSUP;
     }
 
-    mutex_lock(&txlock);
-
-    int pos = set_len(tbuf, (len + 6));
-    len += (pos + 6);
-    tbuf[pos++] = PUBLISH;
-    tbuf[pos++] = flags;
-    set_u16(&tbuf[pos], topic->id);
+    inflight_t *slot = slot_get();
+    int pos = set_len(slot->buf, (len + 6));
+    size_t pkt_len = (pos + len + 6);
+    slot->buf[pos++] = PUBLISH;
+    slot->buf[pos++] = flags;
+    set_u16(&slot->buf[pos], topic->id);
     pos += 2;
-    set_u16(&tbuf[pos], id_next);
-    waitonid = id_next++;
+    set_u16(&slot->buf[pos], slot->id);
     pos += 2;
-    memcpy(&tbuf[pos], data, len);
+    memcpy(&slot->buf[pos], data, len);
 
-    if (flags & EMCUTE_QOS_1) {
-        res = syncsend(PUBACK, len, true);
+    if (!(flags & EMCUTE_QOS_1)) {
+        slot_send_once(slot, pkt_len);
+        return EMCUTE_OK;
     }
-    else {
-        sock_udp_send(&sock, tbuf, len, &gateway);
-        mutex_unlock(&txlock);
+    if (batch == NULL) {
+        return syncsend(slot, PUBACK, pkt_len);
     }
+    slot_send(slot, PUBACK, pkt_len, batch);
+    return EMCUTE_OK;
+}
+
+int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
+               unsigned flags)
+{
+    return pub(topic, data, len, flags, NULL);
+}
 
+int emcute_pub_async(emcute_topic_t *topic, const void *data, size_t len,
+                     unsigned flags)
+{
+    return pub(topic, data, len, flags, &pubs);
+}
+
+int emcute_flush(void)
+{
+    int res;
+
+    /* wait until no asynchronous publish is in flight */
+    mutex_lock(&pubs.idle);
+    mutex_unlock(&pubs.idle);
+
+    mutex_lock(&txlock);
+    res = pubs.res;
+    pubs.res = EMCUTE_OK;
+    mutex_unlock(&txlock);
     return res;
 }
 
@@ -389,20 +604,19 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
         return EMCUTE_OVERFLOW;
     }
 
-    mutex_lock(&txlock);
-
-    tbuf[0] = (strlen(sub->topic.name) + 5);
-    tbuf[1] = SUBSCRIBE;
-    tbuf[2] = flags;
-    set_u16(&tbuf[3], id_next);
-    waitonid = id_next++;
-    memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
+    inflight_t *slot = slot_get();
+    slot->buf[0] = (strlen(sub->topic.name) + 5);
+    slot->buf[1] = SUBSCRIBE;
+    slot->buf[2] = flags;
+    set_u16(&slot->buf[3], slot->id);
+    memcpy(&slot->buf[5], sub->topic.name, strlen(sub->topic.name));
 
-    int res = syncsend(SUBACK, (size_t)tbuf[0], false);
+    int res = syncsend(slot, SUBACK, (size_t)slot->buf[0]);
     if (res > 0) {
         DEBUG("[emcute] sub: success, topic id is %i\n", res);
         sub->topic.id = res;
 
+        mutex_lock(&txlock);
         /* check if subscription is already in the list, only insert if not*/
         emcute_sub_t *s;
         for (s = subs; s && (s != sub); s = s->next) {}
@@ -411,9 +625,9 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
             subs = sub;
             res = EMCUTE_OK;
         }
+        mutex_unlock(&txlock);
     }
 
-    mutex_unlock(&txlock);
     return res;
 }
 
@@ -425,17 +639,16 @@ int emcute_unsub(emcute_sub_t *sub)
         return EMCUTE_NOGW;
     }
 
-    mutex_lock(&txlock);
-
-    tbuf[0] = (strlen(sub->topic.name) + 5);
-    tbuf[1] = UNSUBSCRIBE;
-    tbuf[2] = 0;
-    set_u16(&tbuf[3], id_next);
-    waitonid = id_next++;
-    memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
+    inflight_t *slot = slot_get();
+    slot->buf[0] = (strlen(sub->topic.name) + 5);
+    slot->buf[1] = UNSUBSCRIBE;
+    slot->buf[2] = 0;
+    set_u16(&slot->buf[3], slot->id);
+    memcpy(&slot->buf[5], sub->topic.name, strlen(sub->topic.name));
 
-    int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
+    int res = syncsend(slot, UNSUBACK, (size_t)slot->buf[0]);
     if (res == EMCUTE_OK) {
+        mutex_lock(&txlock);
         if (subs == sub) {
             subs = sub->next;
         }
@@ -448,9 +661,9 @@ int emcute_unsub(emcute_sub_t *sub)
                 }
             }
         }
+        mutex_unlock(&txlock);
     }
 
-    mutex_unlock(&txlock);
     return res;
 }
 
@@ -465,19 +678,22 @@ int emcute_willupd_topic(const char *topic, unsigned flags)
         return EMCUTE_OVERFLOW;
     }
 
-    mutex_lock(&txlock);
+    mutex_lock(&ctllock);
 
-    tbuf[1] = WILLTOPICUPD;
+    inflight_t *slot = slot_get();
+    slot->buf[1] = WILLTOPICUPD;
     if (!topic) {
-        tbuf[0] = 2;
+        slot->buf[0] = 2;
     }
     else {
-        tbuf[0] = (strlen(topic) + 3);
-        tbuf[2] = flags;
-        memcpy(&tbuf[3], topic, strlen(topic));
+        slot->buf[0] = (strlen(topic) + 3);
+        slot->buf[2] = flags;
+        memcpy(&slot->buf[3], topic, strlen(topic));
     }
 
-    return syncsend(WILLTOPICRESP, (size_t)tbuf[0], true);
+    int res = syncsend(slot, WILLTOPICRESP, (size_t)slot->buf[0]);
+    mutex_unlock(&ctllock);
+    return res;
 }
 
 int emcute_willupd_msg(const void *data, size_t len)
@@ -491,15 +707,57 @@ int emcute_willupd_msg(const void *data, size_t len)
         return EMCUTE_OVERFLOW;
     }
 
-    mutex_lock(&txlock);
+    mutex_lock(&ctllock);
+
+    inflight_t *slot = slot_get();
+    int pos = set_len(slot->buf, (len + 1));
+    slot->buf[pos++] = WILLMSGUPD;
+    memcpy(&slot->buf[pos], data, len);
 
-    int pos = set_len(tbuf, (len + 1));
-    len += (pos + 1);
-    tbuf[pos++] = WILLMSGUPD;
-    memcpy(&tbuf[pos], data, len);
+    int res = syncsend(slot, WILLMSGRESP, (pos + len));
+    mutex_unlock(&ctllock);
+    return res;
+}
+
+static void on_packet(ssize_t len, sock_udp_ep_t *remote)
+{
+    if (len >= 2) {
+        /* handle the packet */
+        uint16_t pkt_len;
+        int pos = get_len(rbuf, &pkt_len);
+        uint8_t type = rbuf[pos];
+
+        switch (type) {
+            case CONNACK:       on_ack(type, 0, 2, 0);  break;
+            case WILLTOPICREQ:  on_ack(type, 0, 0, 0);  break;
+            case WILLMSGREQ:    on_ack(type, 0, 0, 0);  break;
+            case REGACK:        on_ack(type, 4, 6, 2);  break;
+            case PUBLISH:       on_publish();           break;
+            case PUBACK:        on_ack(type, 4, 6, 0);  break;
+            case SUBACK:        on_ack(type, 5, 7, 3);  break;
+            case UNSUBACK:      on_ack(type, 2, 0, 0);  break;
+            case PINGREQ:       on_pingreq(remote);     break;
+            case PINGRESP:      on_pingresp();          break;
+            case DISCONNECT:    on_disconnect();        break;
+            case WILLTOPICRESP: on_ack(type, 0, 0, 0);  break;
+            case WILLMSGRESP:   on_ack(type, 0, 0, 0);  break;
+            default:
+                LOG_DEBUG("[emcute] received unexpected type [%s]\n",
+                          emcute_type_str(type));
+        }
+    }
+}
 
-    return syncsend(WILLMSGRESP, len, true);
+#ifdef MODULE_SOCK_ASYNC
+/* called in the context of the network stack */
+static void on_sock_evt(sock_udp_t *s, sock_async_flags_t flags, void *arg)
+{
+    (void)s;
+    if (flags & SOCK_ASYNC_MSG_RECV) {
+        thread_flags_set((thread_t *)arg, TFLAGS_RECV);
+    }
 }
+#endif
 
 void emcute_run(uint16_t port, const char *id)
 {
@@ -509,60 +767,55 @@ void emcute_run(uint16_t port, const char *id)
     sock_udp_ep_t remote;
     local.port = port;
     cli_id = id;
-    timer.callback = time_evt;
-    timer.arg = NULL;
-    mutex_init(&txlock);
+    emcute_thread = (thread_t *)sched_active_thread;
+    ping_timer.callback = ping_evt;
+    ping_timer.arg = emcute_thread;
 
     if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
         LOG_ERROR("[emcute] unable to open UDP socket on port %i\n", (int)port);
         return;
     }
+#ifdef MODULE_SOCK_ASYNC
+    sock_udp_set_cb(&sock, on_sock_evt, emcute_thread);
+#endif
 
-    uint32_t start = xtimer_now_usec();
-    uint32_t t_out = (EMCUTE_KEEPALIVE * US_PER_SEC);
+    xtimer_set(&ping_timer, (EMCUTE_KEEPALIVE * US_PER_SEC));
 
     while (1) {
-        ssize_t len = sock_udp_recv(&sock, rbuf, sizeof(rbuf), t_out, &remote);
-
+        thread_flags_t flags;
+        ssize_t len;
+
+#ifdef MODULE_SOCK_ASYNC
+        flags = thread_flags_wait_any(TFLAGS_ANY);
+        if (flags & TFLAGS_RECV) {
+            while ((len = sock_udp_recv(&sock, rbuf, sizeof(rbuf), 0,
+                                        &remote)) != -EAGAIN) {
+                if (len < 0) {
+                    LOG_ERROR("[emcute] error while receiving UDP packet\n");
+                    return;
+                }
+                on_packet(len, &remote);
+            }
+        }
+#else
+        /* the timers are only noticed when sock_udp_recv() returns, so
+         * retransmissions may be late by up to EMCUTE_T_RETRY */
+        len = sock_udp_recv(&sock, rbuf, sizeof(rbuf),
+                            (EMCUTE_T_RETRY * US_PER_SEC), &remote);
         if ((len < 0) && (len != -ETIMEDOUT)) {
             LOG_ERROR("[emcute] error while receiving UDP packet\n");
             return;
         }
+        on_packet(len, &remote);
+        flags = thread_flags_clear(TFLAGS_RETRY | TFLAGS_PING);
+#endif
 
-        if (len >= 2) {
-            /* handle the packet */
-            uint16_t pkt_len;
-            int pos = get_len(rbuf, &pkt_len);
-            uint8_t type = rbuf[pos];
-
-            switch (type) {
-                case CONNACK:       on_ack(type, 0, 2, 0);  break;
-                case WILLTOPICREQ:  on_ack(type, 0, 0, 0);  break;
-                case WILLMSGREQ:    on_ack(type, 0, 0, 0);  break;
-                case REGACK:        on_ack(type, 4, 6, 2);  break;
-                case PUBLISH:       on_publish();           break;
-                case PUBACK:        on_ack(type, 4, 6, 0);  break;
-                case SUBACK:        on_ack(type, 5, 7, 3);  break;
-                case UNSUBACK:      on_ack(type, 2, 0, 0);  break;
-                case PINGREQ:       on_pingreq(&remote);    break;
-                case PINGRESP:      on_pingresp();          break;
-                case DISCONNECT:    on_disconnect();        break;
-                case WILLTOPICRESP: on_ack(type, 0, 0, 0);  break;
-                case WILLMSGRESP:   on_ack(type, 0, 0, 0);  break;
-                default:
-                    LOG_DEBUG("[emcute] received unexpected type [%s]\n",
-                              emcute_type_str(type));
-            }
+        if (flags & TFLAGS_RETRY) {
+            retransmit();
         }
-
-        uint32_t now = xtimer_now_usec();
-        if ((now - start) >= (EMCUTE_KEEPALIVE * US_PER_SEC)) {
+        if (flags & TFLAGS_PING) {
             send_ping();
-            start = now;
-            t_out = (EMCUTE_KEEPALIVE * US_PER_SEC);
-        }
-        else {
-            t_out = (EMCUTE_KEEPALIVE * US_PER_SEC) - (now - start);
+            xtimer_set(&ping_timer, (EMCUTE_KEEPALIVE * US_PER_SEC));
         }
     }
 }
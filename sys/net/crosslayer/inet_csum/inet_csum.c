@@ -14,12 +14,69 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include "byteorder.h"
 #include "od.h"
 #include "net/inet_csum.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+/* folds a sum of 16-bit words to 16 bit */
+static inline uint16_t _fold(uint64_t sum)
+{
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return (uint16_t)sum;
+}
+
+/* Sums buf as 16-bit words in network byte order; a trailing odd byte is
+ * padded with a zero byte. buf must be 16-bit aligned.
+ *
+ * The words are loaded in host byte order, up to 32 bits at a time. Since
+ * the 1's complement sum is independent of the byte order (RFC 1071,
+ * section 2 (B)), the result only needs to be swapped once at the end. */
+static uint16_t _csum_aligned(const uint8_t *buf, size_t len)
+{
+    const uint32_t *words;
+    uint64_t sum = 0;
+
+    if ((((uintptr_t)buf) & 2) && (len >= 2)) {
+        sum += *((const uint16_t *)buf);
+        buf += 2;
+        len -= 2;
+    }
+    words = (const uint32_t *)buf;
+    while (len >= 8 * sizeof(uint32_t)) {
+        sum += words[0];
+        sum += words[1];
+        sum += words[2];
+        sum += words[3];
+        sum += words[4];
+        sum += words[5];
+        sum += words[6];
+        sum += words[7];
+        words += 8;
+        len -= 8 * sizeof(uint32_t);
+    }
+    while (len >= sizeof(uint32_t)) {
+        sum += *(words++);
+        len -= sizeof(uint32_t);
+    }
+    buf = (const uint8_t *)words;
+    if (len >= 2) {
+        sum += *((const uint16_t *)buf);
+        buf += 2;
+        len -= 2;
+    }
+    if (len > 0) {
+        /* last byte is top half of 16-bit word */
+        sum += ntohs((uint16_t)(*buf << 8));
+    }
+
+    return ntohs(_fold(sum));
+}
+
 uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len)
 {
     uint32_t csum = sum;
@@ -41,25 +98,38 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
         csum += *buf;         /* add first byte as bottom half of 16-byte word */
         buf++;
         len--;
-        accum_len++;
     }
 
-    for (int i = 0; i < (len >> 1); buf += 2, i++) {
-        csum += (uint16_t)(*buf << 8) + *(buf + 1); /* group bytes by 16-byte words */
-                                                    /* and add them */
+    if (((uintptr_t)buf) & 1) {
+        if (len > 0) {
+            /* add first byte as top half of 16-bit word. The rest is shifted
+             * by one byte against the 16-bit words, so its sum is swapped */
+            csum += (uint16_t)(*buf << 8);
+            csum += byteorder_swaps(_csum_aligned(buf + 1, len - 1));
+        }
     }
-
-    if ((accum_len + len) & 1)          /* if accumulated length is odd */
-        csum += (uint16_t)(*buf << 8);  /* add last byte as top half of 16-byte word */
-
-    while (csum >> 16) {
-        uint16_t carry = csum >> 16;
-        csum = (csum & 0xffff) + carry;
+    else {
+        csum += _csum_aligned(buf, len);
     }
 
+    csum = _fold(csum);
+
     DEBUG("inet_sum: new sum = 0x%04" PRIx32 "\n", csum);
 
     return csum;
 }
 
+uint16_t inet_csum_update(uint16_t csum, const uint8_t *old_data,
+                          const uint8_t *new_data, uint16_t len,
+                          size_t accum_len)
+{
+    /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+    uint32_t sum = (uint16_t)~csum;
+
+    sum += (uint16_t)~inet_csum_slice(0, old_data, len, accum_len);
+    sum += inet_csum_slice(0, new_data, len, accum_len);
+
+    return ~_fold(sum);
+}
+
 /** @} */
@@ -36,9 +36,10 @@ static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
     gnrc_pktsnip_t *pkt = NULL;
 
     if (bytes_expected > 0) {
-        pkt = gnrc_pktbuf_add(NULL, NULL,
-                bytes_expected,
-                GNRC_NETTYPE_UNDEF);
+        /* receive directly into the packet buffer, placed so that the
+         * ethernet header can be split off without copying the payload */
+        pkt = gnrc_pktbuf_reserve(bytes_expected, sizeof(ethernet_hdr_t),
+                                  GNRC_NETTYPE_UNDEF);
 
         if(!pkt) {
             DEBUG("_recv_ethernet_packet: cannot allocate pktsnip.\n");
@@ -34,6 +34,7 @@ int gnrc_netdev_ieee802154_init(gnrc_netdev_t *gnrc_netdev,
     gnrc_netdev->send = _send;
     gnrc_netdev->recv = _recv;
     gnrc_netdev->dev = (netdev_t *)dev;
+    gnrc_netdev->rx_hdr_len_hint = 0;
 
     return 0;
 }
@@ -76,7 +77,9 @@ static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
     if (bytes_expected > 0) {
         int nread;
 
-        pkt = gnrc_pktbuf_add(NULL, NULL, bytes_expected, GNRC_NETTYPE_UNDEF);
+        pkt = gnrc_pktbuf_reserve(bytes_expected,
+                                  gnrc_netdev->rx_hdr_len_hint,
+                                  GNRC_NETTYPE_UNDEF);
         if (pkt == NULL) {
             DEBUG("_recv_ieee802154: cannot allocate pktsnip.\n");
             return NULL;
@@ -99,6 +102,7 @@ static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
                 gnrc_pktbuf_release(pkt);
                 return NULL;
             }
+            gnrc_netdev->rx_hdr_len_hint = mhr_len;
             nread -= mhr_len;
             /* mark IEEE 802.15.4 header */
             ieee802154_hdr = gnrc_pktbuf_mark(pkt, mhr_len, GNRC_NETTYPE_UNDEF);
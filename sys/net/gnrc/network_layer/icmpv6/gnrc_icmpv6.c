@@ -30,6 +30,9 @@
 
 #include "net/gnrc/icmpv6.h"
 #include "net/gnrc/icmpv6/echo.h"
+#ifdef MODULE_GNRC_IPV6_DCACHE
+#include "net/gnrc/ipv6/dcache.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -85,7 +88,23 @@ void gnrc_icmpv6_demux(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
     }
 
     switch (hdr->type) {
-        /* TODO: handle ICMPv6 errors */
+        /* TODO: handle other ICMPv6 errors */
+#ifdef MODULE_GNRC_IPV6_DCACHE
+        case ICMPV6_PKT_TOO_BIG:
+            DEBUG("icmpv6: packet too big received\n");
+            /* the message carries as much of the packet as possible, so at
+             * least its IPv6 header */
+            if (icmpv6->size >= (sizeof(icmpv6_error_pkt_too_big_t) +
+                                 sizeof(ipv6_hdr_t))) {
+                icmpv6_error_pkt_too_big_t *ptb = (icmpv6_error_pkt_too_big_t *)hdr;
+                ipv6_hdr_t *orig = (ipv6_hdr_t *)(ptb + 1);
+
+                gnrc_ipv6_dcache_update_pmtu(&orig->dst,
+                                             byteorder_ntohl(ptb->mtu));
+            }
+            break;
+#endif
+
 #ifdef MODULE_GNRC_ICMPV6_ECHO
         case ICMPV6_ECHO_REQ:
             DEBUG("icmpv6: handle echo request.\n");
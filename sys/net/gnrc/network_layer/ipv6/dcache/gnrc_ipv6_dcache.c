@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "hashes.h"
+#include "net/gnrc/ipv6/dcache.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/ipv6.h"
+#include "net/ipv6.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_IPV6_DCACHE_SIZE & (GNRC_IPV6_DCACHE_SIZE - 1)) != 0
+#error "GNRC_IPV6_DCACHE_SIZE must be a power of 2"
+#endif
+
+/* the FIB of GNRC is part of gnrc_ipv6 */
+#if defined(MODULE_FIB) && defined(MODULE_GNRC_IPV6)
+#define DCACHE_FIB  (1)
+#else
+#define DCACHE_FIB  (0)
+#endif
+
+/**
+ * @brief   Destination cache entry
+ */
+typedef struct {
+    ipv6_addr_t dst;            /**< destination address */
+    gnrc_ipv6_nc_t *nc;         /**< neighbor cache entry of the next hop,
+                                 *   NULL if the entry is unused */
+    unsigned version;           /**< FIB version the next hop was
+                                 *   determined with */
+    kernel_pid_t iface;         /**< interface the lookup was restricted to */
+    uint16_t pmtu;              /**< path MTU towards
+                                 *   gnrc_ipv6_dcache_t::dst */
+    uint16_t nc_gen;            /**< generation of gnrc_ipv6_dcache_t::nc when
+                                 *   the entry was added */
+    uint8_t nc_flags;           /**< flags of gnrc_ipv6_dcache_t::nc when
+                                 *   the entry was added */
+} gnrc_ipv6_dcache_t;
+
+static gnrc_ipv6_dcache_t _dcache[GNRC_IPV6_DCACHE_SIZE];
+static gnrc_ipv6_dcache_stats_t _stats;
+
+/* the interface is not part of the hash, so Packet Too Big messages find the
+ * entry of their destination without knowing the interface of the lookup */
+static inline gnrc_ipv6_dcache_t *_bucket(const ipv6_addr_t *dst)
+{
+    uint32_t hash = djb2_hash(dst->u8, sizeof(ipv6_addr_t));
+
+    return &_dcache[hash & (GNRC_IPV6_DCACHE_SIZE - 1)];
+}
+
+static inline bool _is_valid(const gnrc_ipv6_dcache_t *entry)
+{
+    return (entry->nc != NULL) &&
+           (entry->version == gnrc_ipv6_dcache_get_version()) &&
+           (entry->nc->gen == entry->nc_gen) &&
+           (entry->nc->flags == entry->nc_flags);
+}
+
+unsigned gnrc_ipv6_dcache_get_version(void)
+{
+#if DCACHE_FIB
+    return fib_get_version(&gnrc_ipv6_fib_table);
+#else
+    return 0;
+#endif
+}
+
+kernel_pid_t gnrc_ipv6_dcache_get(uint8_t *l2addr, uint8_t *l2addr_len,
+                                  kernel_pid_t iface, const ipv6_addr_t *dst)
+{
+    gnrc_ipv6_dcache_t *entry = _bucket(dst);
+
+    assert((l2addr != NULL) && (l2addr_len != NULL));
+    if ((entry->iface == iface) && _is_valid(entry) &&
+        ipv6_addr_equal(&entry->dst, dst)) {
+        kernel_pid_t res = gnrc_ipv6_nc_get_l2_addr(l2addr, l2addr_len,
+                                                    entry->nc);
+
+        if (res != KERNEL_PID_UNDEF) {
+            _stats.hits++;
+            return res;
+        }
+    }
+    _stats.misses++;
+    return KERNEL_PID_UNDEF;
+}
+
+void gnrc_ipv6_dcache_add(kernel_pid_t iface, const ipv6_addr_t *dst,
+                          gnrc_ipv6_nc_t *nc, unsigned version)
+{
+    gnrc_ipv6_dcache_t *entry = _bucket(dst);
+    gnrc_ipv6_netif_t *netif;
+
+    if ((nc == NULL) || !gnrc_ipv6_nc_is_reachable(nc)) {
+        DEBUG("ipv6_dcache: no reachable neighbor for next hop, not caching\n");
+        entry->nc = NULL;
+        return;
+    }
+    netif = gnrc_ipv6_netif_get(nc->iface);
+    memcpy(&entry->dst, dst, sizeof(ipv6_addr_t));
+    /* the path can only be as wide as the link to the next hop */
+    entry->pmtu = (netif != NULL) ? netif->mtu : IPV6_MIN_MTU;
+    entry->nc = nc;
+    entry->nc_gen = nc->gen;
+    entry->nc_flags = nc->flags;
+    entry->iface = iface;
+    entry->version = version;
+}
+
+uint16_t gnrc_ipv6_dcache_get_pmtu(kernel_pid_t iface, const ipv6_addr_t *dst)
+{
+    gnrc_ipv6_dcache_t *entry = _bucket(dst);
+
+    if ((entry->iface == iface) && _is_valid(entry) &&
+        ipv6_addr_equal(&entry->dst, dst)) {
+        return entry->pmtu;
+    }
+    return 0;
+}
+
+void gnrc_ipv6_dcache_update_pmtu(const ipv6_addr_t *dst, uint32_t mtu)
+{
+    gnrc_ipv6_dcache_t *entry = _bucket(dst);
+
+    if ((entry->nc == NULL) || !ipv6_addr_equal(&entry->dst, dst)) {
+        DEBUG("ipv6_dcache: no entry for path MTU update\n");
+        return;
+    }
+    /* see RFC 8201, section 4 */
+    if (mtu < IPV6_MIN_MTU) {
+        mtu = IPV6_MIN_MTU;
+    }
+    if (mtu < entry->pmtu) {
+        DEBUG("ipv6_dcache: path MTU lowered to %u\n", (unsigned)mtu);
+        entry->pmtu = (uint16_t)mtu;
+    }
+}
+
+void gnrc_ipv6_dcache_flush(void)
+{
+    for (unsigned i = 0; i < GNRC_IPV6_DCACHE_SIZE; i++) {
+        _dcache[i].nc = NULL;
+    }
+}
+
+void gnrc_ipv6_dcache_get_stats(gnrc_ipv6_dcache_stats_t *stats)
+{
+    *stats = _stats;
+}
+
+/** @} */
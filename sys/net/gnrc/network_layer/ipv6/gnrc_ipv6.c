@@ -29,6 +29,7 @@
 #include "thread.h"
 #include "utlist.h"
 
+#include "net/gnrc/ipv6/dcache.h"
 #include "net/gnrc/ipv6/nc.h"
 #include "net/gnrc/ipv6/netif.h"
 #include "net/gnrc/ipv6/whitelist.h"
@@ -36,16 +37,22 @@
 
 #include "net/gnrc/ipv6.h"
 
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
 #define _MAX_L2_ADDR_LEN    (8U)
 
+#ifndef MODULE_GNRC_SINGLE_THREAD
 #if ENABLE_DEBUG
 static char _stack[GNRC_IPV6_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_IPV6_STACK_SIZE];
 #endif
+#endif
 
 #ifdef MODULE_FIB
 #include "net/fib.h"
@@ -73,8 +80,20 @@ static void _receive(gnrc_pktsnip_t *pkt);
  * prep_hdr: prepare header for sending (call to _fill_ipv6_hdr()), otherwise
  * assume it is already prepared */
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr);
+/* handles GNRC_NETAPI_MSG_TYPE_RCV and GNRC_NETAPI_MSG_TYPE_SND commands */
+static void _handle_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt);
+/* handles all other messages to IPv6, returns false for unknown types */
+static bool _handle_msg(msg_t *msg);
+#ifdef MODULE_GNRC_SINGLE_THREAD
+static gnrc_single_thread_layer_t _layer = {
+    .type = GNRC_NETTYPE_IPV6,
+    .handle_pkt = _handle_pkt,
+    .handle_msg = _handle_msg,
+};
+#else
 /* Main event loop for IPv6 */
 static void *_event_loop(void *args);
+#endif
 
 /* Handles encapsulated IPv6 packets: http://tools.ietf.org/html/rfc2473 */
 static void _decapsulate(gnrc_pktsnip_t *pkt);
@@ -82,9 +101,13 @@ static void _decapsulate(gnrc_pktsnip_t *pkt);
 kernel_pid_t gnrc_ipv6_init(void)
 {
     if (gnrc_ipv6_pid == KERNEL_PID_UNDEF) {
+#ifdef MODULE_GNRC_SINGLE_THREAD
+        gnrc_ipv6_pid = gnrc_single_thread_add(&_layer);
+#else
         gnrc_ipv6_pid = thread_create(_stack, sizeof(_stack), GNRC_IPV6_PRIO,
                                       THREAD_CREATE_STACKTEST,
                                       _event_loop, NULL, "ipv6");
+#endif
     }
 
 #ifdef MODULE_FIB
@@ -248,6 +271,109 @@ static void _dispatch_next_header(gnrc_pktsnip_t *current, gnrc_pktsnip_t *pkt,
     }
 }
 
+static void _handle_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt)
+{
+    switch (cmd) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
+            _receive(pkt);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
+            _send(pkt, true);
+            break;
+
+        default:
+            gnrc_pktbuf_release(pkt);
+            break;
+    }
+}
+
+static bool _handle_msg(msg_t *msg)
+{
+    switch (msg->type) {
+#ifdef MODULE_GNRC_NDP
+        case GNRC_NDP_MSG_RTR_TIMEOUT:
+            DEBUG("ipv6: Router timeout received\n");
+            ((gnrc_ipv6_nc_t *)msg->content.ptr)->flags &= ~GNRC_IPV6_NC_IS_ROUTER;
+            return true;
+
+        /* XXX reactivate when https://github.com/RIOT-OS/RIOT/issues/5122 is
+         * solved properly */
+        /* case GNRC_NDP_MSG_ADDR_TIMEOUT: */
+        /*     DEBUG("ipv6: Router advertisement timer event received\n"); */
+        /*     gnrc_ipv6_netif_remove_addr(KERNEL_PID_UNDEF, */
+        /*                                 msg->content.ptr); */
+        /*     break; */
+
+        case GNRC_NDP_MSG_NBR_SOL_RETRANS:
+            DEBUG("ipv6: Neigbor solicitation retransmission timer event received\n");
+            gnrc_ndp_retrans_nbr_sol(msg->content.ptr);
+            return true;
+
+        case GNRC_NDP_MSG_NC_STATE_TIMEOUT:
+            DEBUG("ipv6: Neigbor cache state timeout received\n");
+            gnrc_ndp_state_timeout(msg->content.ptr);
+            return true;
+#endif
+#ifdef MODULE_GNRC_NDP_ROUTER
+        case GNRC_NDP_MSG_RTR_ADV_RETRANS:
+            DEBUG("ipv6: Router advertisement retransmission event received\n");
+            gnrc_ndp_router_retrans_rtr_adv(msg->content.ptr);
+            return true;
+        case GNRC_NDP_MSG_RTR_ADV_DELAY:
+            DEBUG("ipv6: Delayed router advertisement event received\n");
+            gnrc_ndp_router_send_rtr_adv(msg->content.ptr);
+            return true;
+#endif
+#ifdef MODULE_GNRC_NDP_HOST
+        case GNRC_NDP_MSG_RTR_SOL_RETRANS:
+            DEBUG("ipv6: Router solicitation retransmission event received\n");
+            gnrc_ndp_host_retrans_rtr_sol(msg->content.ptr);
+            return true;
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_ND
+        case GNRC_SIXLOWPAN_ND_MSG_MC_RTR_SOL:
+            DEBUG("ipv6: Multicast router solicitation event received\n");
+            gnrc_sixlowpan_nd_mc_rtr_sol(msg->content.ptr);
+            return true;
+        case GNRC_SIXLOWPAN_ND_MSG_UC_RTR_SOL:
+            DEBUG("ipv6: Unicast router solicitation event received\n");
+            gnrc_sixlowpan_nd_uc_rtr_sol(msg->content.ptr);
+            return true;
+#   ifdef MODULE_GNRC_SIXLOWPAN_CTX
+        case GNRC_SIXLOWPAN_ND_MSG_DELETE_CTX:
+            DEBUG("ipv6: Delete 6LoWPAN context event received\n");
+            gnrc_sixlowpan_ctx_remove(((((gnrc_sixlowpan_ctx_t *)msg->content.ptr)->flags_id) &
+                                       GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
+            return true;
+#   endif
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
+        case GNRC_SIXLOWPAN_ND_MSG_ABR_TIMEOUT:
+            DEBUG("ipv6: border router timeout event received\n");
+            gnrc_sixlowpan_nd_router_abr_remove(msg->content.ptr);
+            return true;
+        /* XXX reactivate when https://github.com/RIOT-OS/RIOT/issues/5122 is
+         * solved properly */
+        /* case GNRC_SIXLOWPAN_ND_MSG_AR_TIMEOUT: */
+        /*     DEBUG("ipv6: address registration timeout received\n"); */
+        /*     gnrc_sixlowpan_nd_router_gc_nc(msg->content.ptr); */
+        /*     break; */
+        case GNRC_NDP_MSG_RTR_ADV_SIXLOWPAN_DELAY:
+            DEBUG("ipv6: Delayed router advertisement event received\n");
+            gnrc_ipv6_nc_t *nc_entry = msg->content.ptr;
+            gnrc_ndp_internal_send_rtr_adv(nc_entry->iface, NULL,
+                                           &(nc_entry->ipv6_addr), false);
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *args)
 {
     msg_t msg, reply, msg_q[GNRC_IPV6_MSG_QUEUE_SIZE];
@@ -270,13 +396,8 @@ static void *_event_loop(void *args)
 
         switch (msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
-                _receive(msg.content.ptr);
-                break;
-
             case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
-                _send(msg.content.ptr, true);
+                _handle_pkt(msg.type, msg.content.ptr);
                 break;
 
             case GNRC_NETAPI_MSG_TYPE_GET:
@@ -286,88 +407,15 @@ static void *_event_loop(void *args)
                 msg_reply(&msg, &reply);
                 break;
 
-#ifdef MODULE_GNRC_NDP
-            case GNRC_NDP_MSG_RTR_TIMEOUT:
-                DEBUG("ipv6: Router timeout received\n");
-                ((gnrc_ipv6_nc_t *)msg.content.ptr)->flags &= ~GNRC_IPV6_NC_IS_ROUTER;
-                break;
-
-            /* XXX reactivate when https://github.com/RIOT-OS/RIOT/issues/5122 is
-             * solved properly */
-            /* case GNRC_NDP_MSG_ADDR_TIMEOUT: */
-            /*     DEBUG("ipv6: Router advertisement timer event received\n"); */
-            /*     gnrc_ipv6_netif_remove_addr(KERNEL_PID_UNDEF, */
-            /*                                 msg.content.ptr); */
-            /*     break; */
-
-            case GNRC_NDP_MSG_NBR_SOL_RETRANS:
-                DEBUG("ipv6: Neigbor solicitation retransmission timer event received\n");
-                gnrc_ndp_retrans_nbr_sol(msg.content.ptr);
-                break;
-
-            case GNRC_NDP_MSG_NC_STATE_TIMEOUT:
-                DEBUG("ipv6: Neigbor cache state timeout received\n");
-                gnrc_ndp_state_timeout(msg.content.ptr);
-                break;
-#endif
-#ifdef MODULE_GNRC_NDP_ROUTER
-            case GNRC_NDP_MSG_RTR_ADV_RETRANS:
-                DEBUG("ipv6: Router advertisement retransmission event received\n");
-                gnrc_ndp_router_retrans_rtr_adv(msg.content.ptr);
-                break;
-            case GNRC_NDP_MSG_RTR_ADV_DELAY:
-                DEBUG("ipv6: Delayed router advertisement event received\n");
-                gnrc_ndp_router_send_rtr_adv(msg.content.ptr);
-                break;
-#endif
-#ifdef MODULE_GNRC_NDP_HOST
-            case GNRC_NDP_MSG_RTR_SOL_RETRANS:
-                DEBUG("ipv6: Router solicitation retransmission event received\n");
-                gnrc_ndp_host_retrans_rtr_sol(msg.content.ptr);
-                break;
-#endif
-#ifdef MODULE_GNRC_SIXLOWPAN_ND
-            case GNRC_SIXLOWPAN_ND_MSG_MC_RTR_SOL:
-                DEBUG("ipv6: Multicast router solicitation event received\n");
-                gnrc_sixlowpan_nd_mc_rtr_sol(msg.content.ptr);
-                break;
-            case GNRC_SIXLOWPAN_ND_MSG_UC_RTR_SOL:
-                DEBUG("ipv6: Unicast router solicitation event received\n");
-                gnrc_sixlowpan_nd_uc_rtr_sol(msg.content.ptr);
-                break;
-#   ifdef MODULE_GNRC_SIXLOWPAN_CTX
-            case GNRC_SIXLOWPAN_ND_MSG_DELETE_CTX:
-                DEBUG("ipv6: Delete 6LoWPAN context event received\n");
-                gnrc_sixlowpan_ctx_remove(((((gnrc_sixlowpan_ctx_t *)msg.content.ptr)->flags_id) &
-                                           GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
-                break;
-#   endif
-#endif
-#ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
-            case GNRC_SIXLOWPAN_ND_MSG_ABR_TIMEOUT:
-                DEBUG("ipv6: border router timeout event received\n");
-                gnrc_sixlowpan_nd_router_abr_remove(msg.content.ptr);
-                break;
-            /* XXX reactivate when https://github.com/RIOT-OS/RIOT/issues/5122 is
-             * solved properly */
-            /* case GNRC_SIXLOWPAN_ND_MSG_AR_TIMEOUT: */
-            /*     DEBUG("ipv6: address registration timeout received\n"); */
-            /*     gnrc_sixlowpan_nd_router_gc_nc(msg.content.ptr); */
-            /*     break; */
-            case GNRC_NDP_MSG_RTR_ADV_SIXLOWPAN_DELAY:
-                DEBUG("ipv6: Delayed router advertisement event received\n");
-                gnrc_ipv6_nc_t *nc_entry = msg.content.ptr;
-                gnrc_ndp_internal_send_rtr_adv(nc_entry->iface, NULL,
-                                               &(nc_entry->ipv6_addr), false);
-                break;
-#endif
             default:
+                _handle_msg(&msg);
                 break;
         }
     }
 
     return NULL;
 }
+#endif
 
 static void _send_to_iface(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
 {
@@ -509,6 +557,19 @@ static int _fill_ipv6_hdr(kernel_pid_t iface, gnrc_pktsnip_t *ipv6,
     return 0;
 }
 
+#ifdef MODULE_NETSTATS_IPV6
+/* accounts the data of dup if gnrc_pktbuf_start_write() had to copy orig */
+static inline void _count_copy(kernel_pid_t iface, gnrc_pktsnip_t *orig,
+                               gnrc_pktsnip_t *dup)
+{
+    if ((dup != NULL) && (dup != orig)) {
+        gnrc_ipv6_netif_get_stats(iface)->tx_copied_bytes += dup->size;
+    }
+}
+#else
+#define _count_copy(iface, orig, dup)   (void)iface
+#endif
+
 static inline void _send_multicast_over_iface(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
 {
     DEBUG("ipv6: send multicast over interface %" PRIkernel_pid "\n", iface);
@@ -554,6 +615,7 @@ static void _send_multicast(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
                 gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(pkt);
                 gnrc_pktsnip_t *ptr = tmp->next;
                 ipv6 = tmp;
+                _count_copy(ifs[i], pkt, tmp);
 
                 if (ipv6 == NULL) {
                     DEBUG("ipv6: unable to get write access to IPv6 header, "
@@ -572,6 +634,7 @@ static void _send_multicast(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
                         gnrc_pktbuf_release(ipv6);
                         return;
                     }
+                    _count_copy(ifs[i], ptr, tmp->next);
                     tmp = tmp->next;
                     ptr = ptr->next;
                 }
@@ -629,18 +692,32 @@ static inline kernel_pid_t _next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len
                                             gnrc_pktsnip_t *pkt)
 {
     kernel_pid_t found_iface;
+    gnrc_ipv6_nc_t *nc = NULL;
+#ifdef MODULE_GNRC_IPV6_DCACHE
+    unsigned version = gnrc_ipv6_dcache_get_version();
+
+    found_iface = gnrc_ipv6_dcache_get(l2addr, l2addr_len, iface, dst);
+    if (found_iface > KERNEL_PID_UNDEF) {
+        return found_iface;
+    }
+#endif
 #if defined(MODULE_GNRC_SIXLOWPAN_ND)
     (void)pkt;
-    found_iface = gnrc_sixlowpan_nd_next_hop_l2addr(l2addr, l2addr_len, iface, dst);
+    found_iface = gnrc_sixlowpan_nd_next_hop_l2addr(l2addr, l2addr_len, iface,
+                                                    dst, &nc);
     if (found_iface > KERNEL_PID_UNDEF) {
+#ifdef MODULE_GNRC_IPV6_DCACHE
+        gnrc_ipv6_dcache_add(iface, dst, nc, version);
+#endif
         return found_iface;
     }
 #endif
 #if defined(MODULE_GNRC_NDP_NODE)
-    found_iface = gnrc_ndp_node_next_hop_l2addr(l2addr, l2addr_len, iface, dst, pkt);
+    found_iface = gnrc_ndp_node_next_hop_l2addr(l2addr, l2addr_len, iface, dst,
+                                                pkt, &nc);
 #elif !defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_IPV6_NC)
     (void)pkt;
-    gnrc_ipv6_nc_t *nc = gnrc_ipv6_nc_get(iface, dst);
+    nc = gnrc_ipv6_nc_get(iface, dst);
     found_iface = gnrc_ipv6_nc_get_l2_addr(l2addr, l2addr_len, nc);
 #elif !defined(MODULE_GNRC_SIXLOWPAN_ND)
     found_iface = KERNEL_PID_UNDEF;
@@ -651,6 +728,12 @@ static inline kernel_pid_t _next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len
     (void)pkt;
     *l2addr_len = 0;
 #endif
+#ifdef MODULE_GNRC_IPV6_DCACHE
+    if (found_iface > KERNEL_PID_UNDEF) {
+        gnrc_ipv6_dcache_add(iface, dst, nc, version);
+    }
+#endif
+    (void)nc;
     return found_iface;
 }
 
@@ -22,6 +22,7 @@
 #include "net/gnrc/ndp.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/sixlowpan/nd.h"
+#include "hashes.h"
 #include "thread.h"
 #include "xtimer.h"
 
@@ -35,8 +36,93 @@
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 #endif
 
+/**
+ * @brief   Number of slots of the hash index
+ *
+ * Twice the number of entries keeps the probe sequences short.
+ */
+#define NC_INDEX_SIZE   (2 * GNRC_IPV6_NC_SIZE)
+
 static gnrc_ipv6_nc_t ncache[GNRC_IPV6_NC_SIZE];
 
+/**
+ * @brief   Open addressing hash index over the IPv6 addresses of ncache
+ *
+ * A slot holds the position of an entry in ncache plus 1, 0 if it is empty.
+ * Since gnrc_ipv6_nc_add() never adds an address twice, the address alone
+ * identifies an entry.
+ */
+static uint16_t _index[NC_INDEX_SIZE];
+
+/**
+ * @brief   Clock for the least recently used eviction
+ */
+static uint32_t _lru_clock;
+
+/**
+ * @brief   Source for gnrc_ipv6_nc_t::gen
+ *
+ * Not reset by gnrc_ipv6_nc_init(), so stale pointers stay detectable.
+ */
+static uint16_t _gen;
+
+static inline unsigned _hash(const ipv6_addr_t *ipv6_addr)
+{
+    uint32_t hash = djb2_hash(ipv6_addr->u8, sizeof(ipv6_addr_t));
+
+    /* neighbors often differ only in the last bytes, for which djb2 yields
+     * overlapping runs of values: scatter them to avoid long probe sequences */
+    hash *= 0x9e3779b1UL;
+    return (hash ^ (hash >> 16)) % NC_INDEX_SIZE;
+}
+
+/* returns the index slot of ipv6_addr or the empty slot it would be added to */
+static unsigned _index_find(const ipv6_addr_t *ipv6_addr)
+{
+    unsigned slot = _hash(ipv6_addr);
+
+    while ((_index[slot] != 0) &&
+           !ipv6_addr_equal(&ncache[_index[slot] - 1].ipv6_addr, ipv6_addr)) {
+        slot = (slot + 1) % NC_INDEX_SIZE;
+    }
+
+    return slot;
+}
+
+static inline void _index_add(gnrc_ipv6_nc_t *entry)
+{
+    _index[_index_find(&entry->ipv6_addr)] = (entry - ncache) + 1;
+}
+
+static void _index_remove(gnrc_ipv6_nc_t *entry)
+{
+    unsigned hole = _index_find(&entry->ipv6_addr);
+    unsigned slot = hole;
+
+    if (_index[hole] == 0) {
+        return;
+    }
+
+    /* move entries of the probe sequence behind the hole into it, so lookups
+     * do not need to skip deleted slots */
+    while (_index[slot = (slot + 1) % NC_INDEX_SIZE] != 0) {
+        unsigned home = _hash(&ncache[_index[slot] - 1].ipv6_addr);
+
+        if ((hole <= slot) ? ((home <= hole) || (home > slot))
+                           : ((home <= hole) && (home > slot))) {
+            _index[hole] = _index[slot];
+            hole = slot;
+        }
+    }
+
+    _index[hole] = 0;
+}
+
+static inline void _touch(gnrc_ipv6_nc_t *entry)
+{
+    entry->last_used = ++_lru_clock;
+}
+
 static void _nc_remove(kernel_pid_t iface, gnrc_ipv6_nc_t *entry)
 {
     (void) iface;
@@ -44,6 +130,10 @@ static void _nc_remove(kernel_pid_t iface, gnrc_ipv6_nc_t *entry)
         return;
     }
 
+    if (!ipv6_addr_is_unspecified(&(entry->ipv6_addr))) {
+        _index_remove(entry);
+    }
+
     DEBUG("ipv6_nc: Remove %s for interface %" PRIkernel_pid "\n",
           ipv6_addr_to_str(addr_str, &(entry->ipv6_addr), sizeof(addr_str)),
           iface);
@@ -76,6 +166,7 @@ static void _nc_remove(kernel_pid_t iface, gnrc_ipv6_nc_t *entry)
     ipv6_addr_set_unspecified(&(entry->ipv6_addr));
     entry->iface = KERNEL_PID_UNDEF;
     entry->flags = 0;
+    entry->gen = ++_gen;
 }
 
 void gnrc_ipv6_nc_init(void)
@@ -86,6 +177,10 @@ void gnrc_ipv6_nc_init(void)
         _nc_remove(entry->iface, entry);
     }
     memset(ncache, 0, sizeof(ncache));
+    memset(_index, 0, sizeof(_index));
+    for (entry = ncache; entry < (ncache + GNRC_IPV6_NC_SIZE); entry++) {
+        entry->gen = ++_gen;
+    }
 }
 
 gnrc_ipv6_nc_t *_find_free_entry(void)
@@ -99,6 +194,35 @@ gnrc_ipv6_nc_t *_find_free_entry(void)
     return NULL;
 }
 
+static inline bool _is_evictable(const gnrc_ipv6_nc_t *entry)
+{
+    return (gnrc_ipv6_nc_get_state(entry) != GNRC_IPV6_NC_STATE_UNMANAGED) &&
+           (gnrc_ipv6_nc_get_type(entry) != GNRC_IPV6_NC_TYPE_REGISTERED) &&
+           !(entry->flags & GNRC_IPV6_NC_IS_ROUTER);
+}
+
+/* removes the least recently used entry that may be evicted */
+static gnrc_ipv6_nc_t *_evict(void)
+{
+    gnrc_ipv6_nc_t *lru = NULL;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        if (_is_evictable(&ncache[i]) &&
+            ((lru == NULL) ||
+             ((_lru_clock - ncache[i].last_used) > (_lru_clock - lru->last_used)))) {
+            lru = &ncache[i];
+        }
+    }
+
+    if (lru != NULL) {
+        DEBUG("ipv6_nc: evicting %s\n",
+              ipv6_addr_to_str(addr_str, &lru->ipv6_addr, sizeof(addr_str)));
+        _nc_remove(lru->iface, lru);
+    }
+
+    return lru;
+}
+
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr,
                                  const void *l2_addr, size_t l2_addr_len, uint8_t flags)
 {
@@ -114,33 +238,33 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
         return NULL;
     }
 
-    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
-        if (ipv6_addr_equal(&(ncache[i].ipv6_addr), ipv6_addr)) {
-            DEBUG("ipv6_nc: Address %s already registered.\n",
-                  ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
-
-            if ((l2_addr != NULL) && (l2_addr_len > 0)) {
-                DEBUG("ipv6_nc: Update to L2 address %s",
-                      gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
-                                             l2_addr, l2_addr_len));
-
-                memcpy(&(ncache[i].l2_addr), l2_addr, l2_addr_len);
-                ncache[i].l2_addr_len = l2_addr_len;
-                ncache[i].flags = flags;
-                DEBUG(" with flags = 0x%0x\n", flags);
-
-            }
-            return &ncache[i];
-        }
+    unsigned slot = _index_find(ipv6_addr);
+
+    if (_index[slot] != 0) {
+        gnrc_ipv6_nc_t *entry = &ncache[_index[slot] - 1];
+
+        DEBUG("ipv6_nc: Address %s already registered.\n",
+              ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
+
+        if ((l2_addr != NULL) && (l2_addr_len > 0)) {
+            DEBUG("ipv6_nc: Update to L2 address %s",
+                  gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
+                                         l2_addr, l2_addr_len));
+
+            memcpy(&(entry->l2_addr), l2_addr, l2_addr_len);
+            entry->l2_addr_len = l2_addr_len;
+            entry->flags = flags;
+            DEBUG(" with flags = 0x%0x\n", flags);
 
-        if (ipv6_addr_is_unspecified(&(ncache[i].ipv6_addr)) && !free_entry) {
-            /* found the first free entry */
-            free_entry = &ncache[i];
         }
+        _touch(entry);
+        return entry;
     }
 
-    if (!free_entry) {
-        /* reached end of NC without finding updateable or free entry */
+    free_entry = _find_free_entry();
+
+    if (!free_entry && !(free_entry = _evict())) {
+        /* NC is full and all entries must be kept */
         DEBUG("ipv6_nc: neighbor cache full.\n");
         return NULL;
     }
@@ -152,6 +276,9 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
     free_entry->pkts = NULL;
 #endif
     memcpy(&(free_entry->ipv6_addr), ipv6_addr, sizeof(ipv6_addr_t));
+    free_entry->gen = ++_gen;
+    _index_add(free_entry);
+    _touch(free_entry);
     DEBUG("ipv6_nc: Register %s for interface %" PRIkernel_pid,
           ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
           iface);
@@ -204,16 +331,20 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_get(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
         return NULL;
     }
 
-    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
-        if (((ncache[i].iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
-             (iface == ncache[i].iface)) &&
-            ipv6_addr_equal(&(ncache[i].ipv6_addr), ipv6_addr)) {
+    unsigned slot = _index_find(ipv6_addr);
+
+    if (_index[slot] != 0) {
+        gnrc_ipv6_nc_t *entry = &ncache[_index[slot] - 1];
+
+        if ((entry->iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
+            (iface == entry->iface)) {
             DEBUG("ipv6_nc: Found entry for %s on interface %" PRIkernel_pid
                   " (0 = all interfaces) [%p]\n",
                   ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
-                  iface, (void *)(ncache + i));
+                  iface, (void *)entry);
 
-            return ncache + i;
+            _touch(entry);
+            return entry;
         }
     }
 
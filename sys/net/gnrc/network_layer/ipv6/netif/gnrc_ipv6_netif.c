@@ -32,6 +32,7 @@
 #include "net/gnrc/sixlowpan/nd.h"
 #include "net/gnrc/sixlowpan/netif.h"
 
+#include "net/gnrc/ipv6/dcache.h"
 #include "net/gnrc/ipv6/netif.h"
 
 #define ENABLE_DEBUG    (0)
@@ -86,6 +87,10 @@ static ipv6_addr_t *_add_addr_to_entry(gnrc_ipv6_netif_t *entry, const ipv6_addr
 
     tmp_addr->prefix_len = prefix_len;
     tmp_addr->flags = flags;
+#ifdef MODULE_GNRC_IPV6_DCACHE
+    /* the new prefix might change the next hop of cached destinations */
+    gnrc_ipv6_dcache_flush();
+#endif
 
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
     if (!ipv6_addr_is_multicast(&(tmp_addr->addr)) &&
@@ -322,6 +327,9 @@ static void _remove_addr_from_entry(gnrc_ipv6_netif_t *entry, ipv6_addr_t *addr)
                   ipv6_addr_to_str(addr_str, addr, sizeof(addr_str)), entry->pid);
             ipv6_addr_set_unspecified(&(entry->addrs[i].addr));
             entry->addrs[i].flags = 0;
+#ifdef MODULE_GNRC_IPV6_DCACHE
+            gnrc_ipv6_dcache_flush();
+#endif
 #ifdef MODULE_GNRC_NDP_ROUTER
             /* Removal of prefixes MAY allow the router to retransmit up to
              * GNRC_NDP_MAX_INIT_RTR_ADV_NUMOF unsolicited RA
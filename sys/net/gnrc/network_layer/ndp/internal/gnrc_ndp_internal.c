@@ -34,7 +34,10 @@ static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 static gnrc_ipv6_nc_t *_last_router = NULL; /* last router chosen as default
                                              * router. Only used if reachability
                                              * is suspect (i. e. incomplete or
-                                             * not at all) */
+                                             * not at all). Only serves as
+                                             * position to continue the
+                                             * iteration from, so it may be
+                                             * evicted in the meantime */
 static gnrc_pktsnip_t *_build_headers(kernel_pid_t iface, gnrc_pktsnip_t *payload,
                                       ipv6_addr_t *dst, ipv6_addr_t *src);
 static size_t _get_l2src(kernel_pid_t iface, uint8_t *l2src, size_t l2src_maxlen);
@@ -57,7 +57,8 @@ static gnrc_pktqueue_t *_alloc_pkt_node(gnrc_pktsnip_t *pkt)
 
 kernel_pid_t gnrc_ndp_node_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len,
                                            kernel_pid_t iface, ipv6_addr_t *dst,
-                                           gnrc_pktsnip_t *pkt)
+                                           gnrc_pktsnip_t *pkt,
+                                           gnrc_ipv6_nc_t **nce)
 {
     gnrc_ipv6_nc_t *nc_entry;
     ipv6_addr_t *next_hop_ip = NULL, *prefix = NULL;
@@ -124,6 +125,9 @@ kernel_pid_t gnrc_ndp_node_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len,
         if (gnrc_ipv6_nc_get_state(nc_entry) == GNRC_IPV6_NC_STATE_STALE) {
             gnrc_ndp_internal_set_state(nc_entry, GNRC_IPV6_NC_STATE_DELAY);
         }
+        if (nce != NULL) {
+            *nce = nc_entry;
+        }
         return gnrc_ipv6_nc_get_l2_addr(l2addr, l2addr_len, nc_entry);
     }
     else if (nc_entry == NULL) {
@@ -17,15 +17,24 @@
  */
 
 #include "kernel_types.h"
+#ifdef MODULE_NETSTATS_IPV6
+#include "net/gnrc/ipv6/netif.h"
+#endif
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netapi.h"
+#include "net/gnrc/netif.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/sixlowpan/frag.h"
 #include "net/gnrc/sixlowpan/netif.h"
 #include "net/sixlowpan.h"
+#include "thread.h"
 #include "utlist.h"
+#include "xtimer.h"
 
 #include "rbuf.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+#include "vrb.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -35,7 +44,31 @@
 #include <inttypes.h>
 #endif
 
+/**
+ * @brief   Delay in microseconds before the next fragment is retried when the
+ *          message queue of the 6LoWPAN thread was full
+ */
+#define _FRAG_RETRY_DELAY   (1000U)
+
+/**
+ * @brief   Datagrams being fragmented for an interface
+ */
+typedef struct {
+    gnrc_sixlowpan_msg_frag_t *queue;   /**< datagrams to fragment, the next
+                                         *   fragment is taken from the head */
+    xtimer_t timer;                     /**< paces the fragments */
+    msg_t msg;                          /**< @ref GNRC_SIXLOWPAN_MSG_FRAG_SND
+                                         *   for the interface */
+    bool scheduled;                     /**< @ref _frag_iface_t::msg is pending */
+} _frag_iface_t;
+
 static uint16_t _tag;
+static gnrc_sixlowpan_msg_frag_t _frag_msgs[GNRC_SIXLOWPAN_FRAG_QUEUE_SIZE];
+static _frag_iface_t _frag_ifaces[GNRC_NETIF_NUMOF];
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+static gnrc_sixlowpan_frag_stats_t _stats;
+#endif
 
 static inline uint16_t _floor8(uint16_t length)
 {
@@ -47,6 +80,35 @@ static inline size_t _min(size_t a, size_t b)
     return (a < b) ? a : b;
 }
 
+/* accounts the payload copied into a fragment */
+static inline void _count_copy(kernel_pid_t iface, uint16_t bytes)
+{
+#ifdef MODULE_NETSTATS_IPV6
+    gnrc_ipv6_netif_get_stats(iface)->tx_copied_bytes += bytes;
+#else
+    (void)iface;
+    (void)bytes;
+#endif
+}
+
+/* accounts a datagram sent completely */
+static inline void _count_datagram(kernel_pid_t iface, uint32_t queued)
+{
+#ifdef MODULE_NETSTATS_IPV6
+    netstats_t *stats = gnrc_ipv6_netif_get_stats(iface);
+    uint32_t latency = xtimer_now_usec() - queued;
+
+    stats->tx_frag_count++;
+    stats->tx_frag_latency += latency;
+    if (latency > stats->tx_frag_latency_max) {
+        stats->tx_frag_latency_max = latency;
+    }
+#else
+    (void)iface;
+    (void)queued;
+#endif
+}
+
 static gnrc_pktsnip_t *_build_frag_pkt(gnrc_pktsnip_t *pkt, size_t payload_len,
                                        size_t size)
 {
@@ -82,7 +144,8 @@ static gnrc_pktsnip_t *_build_frag_pkt(gnrc_pktsnip_t *pkt, size_t payload_len,
 }
 
 static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t *pkt,
-                                   size_t payload_len, size_t datagram_size)
+                                   size_t payload_len, size_t datagram_size,
+                                   uint16_t tag)
 {
     gnrc_pktsnip_t *frag;
     uint16_t local_offset = 0;
@@ -110,7 +173,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
     hdr->disp_size = byteorder_htons((uint16_t)datagram_size);
     hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
-    hdr->tag = byteorder_htons(_tag);
+    hdr->tag = byteorder_htons(tag);
 
     pkt = pkt->next;    /* don't copy netif header */
 
@@ -129,7 +192,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
     DEBUG("6lo frag: send first fragment (datagram size: %u, "
           "datagram tag: %" PRIu16 ", fragment size: %" PRIu16 ")\n",
-          (unsigned int)datagram_size, _tag, local_offset);
+          (unsigned int)datagram_size, tag, local_offset);
     if (gnrc_netapi_send(iface->pid, frag) < 1) {
         DEBUG("6lo frag: unable to send first fragment\n");
         gnrc_pktbuf_release(frag);
@@ -140,7 +203,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
 static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t *pkt,
                                    size_t payload_len, size_t datagram_size,
-                                   uint16_t offset)
+                                   uint16_t offset, uint16_t tag)
 {
     gnrc_pktsnip_t *frag;
     /* since dispatches aren't supposed to go into subsequent fragments, we need not account
@@ -166,7 +229,7 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     /* XXX: truncation of datagram_size > 4095 may happen here */
     hdr->disp_size = byteorder_htons((uint16_t)datagram_size);
     hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
-    hdr->tag = byteorder_htons(_tag);
+    hdr->tag = byteorder_htons(tag);
     /* don't mention payload diff in offset */
     hdr->offset = (uint8_t)((offset + (datagram_size - payload_len)) >> 3);
     pkt = pkt->next;    /* don't copy netif header */
@@ -206,7 +269,7 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     DEBUG("6lo frag: send subsequent fragment (datagram size: %u, "
           "datagram tag: %" PRIu16 ", offset: %" PRIu8 " (%u bytes), "
           "fragment size: %" PRIu16 ")\n",
-          (unsigned int)datagram_size, _tag, hdr->offset, hdr->offset << 3,
+          (unsigned int)datagram_size, tag, hdr->offset, hdr->offset << 3,
           local_offset);
     if (gnrc_netapi_send(iface->pid, frag) < 1) {
         DEBUG("6lo frag: unable to send subsequent fragment\n");
@@ -216,69 +279,169 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     return local_offset;
 }
 
-void gnrc_sixlowpan_frag_send(gnrc_sixlowpan_msg_frag_t *fragment_msg)
+uint16_t gnrc_sixlowpan_frag_next_tag(void)
 {
-    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(fragment_msg->pid);
+    return ++_tag;
+}
+
+void gnrc_sixlowpan_frag_gc_rbuf(void)
+{
+    rbuf_gc();
+}
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats_get(void)
+{
+    return &_stats;
+}
+#endif
+
+static _frag_iface_t *_frag_iface_get(kernel_pid_t pid, bool create)
+{
+    _frag_iface_t *free = NULL;
+
+    for (unsigned i = 0; i < GNRC_NETIF_NUMOF; i++) {
+        _frag_iface_t *fif = &_frag_ifaces[i];
+
+        if ((fif->queue != NULL) || fif->scheduled) {
+            if ((kernel_pid_t)fif->msg.content.value == pid) {
+                return fif;
+            }
+        }
+        else if (free == NULL) {
+            free = fif;
+        }
+    }
+    if (create && (free != NULL)) {
+        free->msg.type = GNRC_SIXLOWPAN_MSG_FRAG_SND;
+        free->msg.content.value = (uint32_t)pid;
+        return free;
+    }
+    return NULL;
+}
+
+static void _frag_schedule(_frag_iface_t *fif, uint32_t delay)
+{
+    if (fif->scheduled) {
+        return;
+    }
+    fif->scheduled = true;
+    if ((delay == 0) && (msg_send_to_self(&fif->msg) == 1)) {
+        return;
+    }
+    if (delay == 0) {
+        /* the message queue is full: try again once the thread worked some of
+         * it off, otherwise the interface would never be served again */
+        DEBUG("6lo frag: message queue full, retrying in %u us\n",
+              _FRAG_RETRY_DELAY);
+        delay = _FRAG_RETRY_DELAY;
+    }
+    xtimer_set_msg(&fif->timer, delay, &fif->msg, sched_active_pid);
+}
+
+/* removes a datagram from the queue of its interface */
+static void _frag_done(_frag_iface_t *fif, gnrc_sixlowpan_msg_frag_t *fragment_msg)
+{
+    LL_DELETE(fif->queue, fragment_msg);
+    gnrc_pktbuf_release(fragment_msg->pkt);
+    /* 6LoWPAN free for next fragmentation */
+    fragment_msg->pkt = NULL;
+}
+
+bool gnrc_sixlowpan_frag_enqueue(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
+                                 size_t datagram_size)
+{
+    gnrc_sixlowpan_msg_frag_t *fragment_msg = NULL;
+    _frag_iface_t *fif;
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_QUEUE_SIZE; i++) {
+        if (_frag_msgs[i].pkt == NULL) {
+            fragment_msg = &_frag_msgs[i];
+            break;
+        }
+    }
+    if ((fragment_msg == NULL) || ((fif = _frag_iface_get(pid, true)) == NULL)) {
+        DEBUG("6lo frag: fragmentation queue full\n");
+        return false;
+    }
+
+    fragment_msg->pid = pid;
+    fragment_msg->pkt = pkt;
+    fragment_msg->datagram_size = datagram_size;
+    /* Sending the first fragment has an offset==0 */
+    fragment_msg->offset = 0;
+    fragment_msg->tag = gnrc_sixlowpan_frag_next_tag();
+    fragment_msg->queued = xtimer_now_usec();
+    LL_APPEND(fif->queue, fragment_msg);
+    /* the first fragment of an idle interface goes out right away */
+    _frag_schedule(fif, 0);
+    return true;
+}
+
+void gnrc_sixlowpan_frag_send(kernel_pid_t pid)
+{
+    _frag_iface_t *fif = _frag_iface_get(pid, false);
+    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(pid);
+    gnrc_sixlowpan_msg_frag_t *fragment_msg;
     uint16_t res;
     /* payload_len: actual size of the packet vs
      * datagram_size: size of the uncompressed IPv6 packet */
-    size_t payload_len = gnrc_pkt_len(fragment_msg->pkt->next);
-    msg_t msg;
+    size_t payload_len;
 
-#if defined(DEVELHELP) && defined(ENABLE_DEBUG)
+    if (fif == NULL) {
+        return;
+    }
+    fif->scheduled = false;
+    if ((fragment_msg = fif->queue) == NULL) {
+        return;
+    }
     if (iface == NULL) {
-        DEBUG("6lo frag: iface == NULL, expect segmentation fault.\n");
-        /* remove original packet from packet buffer */
-        gnrc_pktbuf_release(fragment_msg->pkt);
-        /* 6LoWPAN free for next fragmentation */
-        fragment_msg->pkt = NULL;
+        DEBUG("6lo frag: iface %" PRIkernel_pid " not a 6LoWPAN interface "
+              "anymore, dropping queued datagrams\n", pid);
+        while (fif->queue != NULL) {
+            _frag_done(fif, fif->queue);
+        }
         return;
     }
-#endif
 
+    payload_len = gnrc_pkt_len(fragment_msg->pkt->next);
     /* Check weater to send the first or an Nth fragment */
     if (fragment_msg->offset == 0) {
-        /* increment tag for successive, fragmented datagrams */
-        _tag++;
-        if ((res = _send_1st_fragment(iface, fragment_msg->pkt, payload_len, fragment_msg->datagram_size)) == 0) {
-            /* error sending first fragment */
-            DEBUG("6lo frag: error sending 1st fragment\n");
-            gnrc_pktbuf_release(fragment_msg->pkt);
-            fragment_msg->pkt = NULL;
-            return;
-        }
-        fragment_msg->offset += res;
+        res = _send_1st_fragment(iface, fragment_msg->pkt, payload_len,
+                                 fragment_msg->datagram_size, fragment_msg->tag);
+    }
+    else {
+        res = _send_nth_fragment(iface, fragment_msg->pkt, payload_len,
+                                 fragment_msg->datagram_size,
+                                 fragment_msg->offset, fragment_msg->tag);
+    }
 
-        /* send message to self*/
-        msg.type = GNRC_SIXLOWPAN_MSG_FRAG_SND;
-        msg.content.ptr = (void *)fragment_msg;
-        msg_send_to_self(&msg);
-        thread_yield();
+    if (res == 0) {
+        /* error sending fragment */
+        DEBUG("6lo frag: error sending fragment (offset = %" PRIu16 ")\n",
+              fragment_msg->offset);
+        _frag_done(fif, fragment_msg);
     }
     else {
+        _count_copy(iface->pid, res);
+        fragment_msg->offset += res;
+
         /* (offset + (datagram_size - payload_len) < datagram_size) simplified */
-        if (fragment_msg->offset < payload_len) {
-            if ((res = _send_nth_fragment(iface, fragment_msg->pkt, payload_len, fragment_msg->datagram_size,
-                                          fragment_msg->offset)) == 0) {
-                /* error sending subsequent fragment */
-                DEBUG("6lo frag: error sending subsequent fragment (offset = %" PRIu16
-                      ")\n", fragment_msg->offset);
-                gnrc_pktbuf_release(fragment_msg->pkt);
-                fragment_msg->pkt = NULL;
-                return;
-                }
-            fragment_msg->offset += res;
-
-            /* send message to self*/
-            msg.type = GNRC_SIXLOWPAN_MSG_FRAG_SND;
-            msg.content.ptr = (void *)fragment_msg;
-            msg_send_to_self(&msg);
-            thread_yield();
+        if (fragment_msg->offset >= payload_len) {
+            _count_datagram(iface->pid, fragment_msg->queued);
+            _frag_done(fif, fragment_msg);
         }
+#if GNRC_SIXLOWPAN_FRAG_INTERLEAVE
         else {
-            gnrc_pktbuf_release(fragment_msg->pkt);
-            fragment_msg->pkt = NULL;
+            /* next fragment is taken from the next datagram */
+            LL_DELETE(fif->queue, fragment_msg);
+            LL_APPEND(fif->queue, fragment_msg);
         }
+#endif
+    }
+
+    if (fif->queue != NULL) {
+        _frag_schedule(fif, GNRC_SIXLOWPAN_FRAG_PACING);
     }
 }
 
@@ -306,6 +469,13 @@ void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
             return;
     }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+    /* relay fragments of datagrams that are not for this node right away */
+    if (vrb_forward(hdr, pkt, frag_size, offset)) {
+        return;
+    }
+#endif
+
     rbuf_add(hdr, pkt, frag_size, offset);
 
     gnrc_pktbuf_release(pkt);
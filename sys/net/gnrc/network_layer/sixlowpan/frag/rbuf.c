@@ -15,6 +15,7 @@
 #include <inttypes.h>
 #include <stdbool.h>
 
+#include "hashes.h"
 #include "rbuf.h"
 #include "net/ipv6/hdr.h"
 #include "net/gnrc.h"
@@ -29,23 +30,25 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-/* estimated fragment payload size to determinate RBUF_INT_SIZE, default to
- * MAC payload size - fragment header. */
-#ifndef GNRC_SIXLOWPAN_FRAG_SIZE
-/* assuming 64-bit source/destination address, source PAN ID omitted */
-#define GNRC_SIXLOWPAN_FRAG_SIZE (104 - 5)
-#endif
-
-#ifndef RBUF_INT_SIZE
 /* same as ((int) ceil((double) N / D)) */
 #define DIV_CEIL(N, D) (((N) + (D) - 1) / (D))
-#define RBUF_INT_SIZE (DIV_CEIL(GNRC_IPV6_NETIF_DEFAULT_MTU, GNRC_SIXLOWPAN_FRAG_SIZE) * RBUF_SIZE)
-#endif
-
-static rbuf_int_t rbuf_int[RBUF_INT_SIZE];
 
 static rbuf_t rbuf[RBUF_SIZE];
 
+/* hash index of the entries in use */
+static rbuf_t *rbuf_idx[RBUF_IDX_SIZE];
+/* entries in use ordered by arrival of their last fragment, oldest first */
+static rbuf_t *rbuf_lru;
+/* entries that were used before and are free again */
+static rbuf_t *rbuf_free;
+/* number of entries that were never used */
+static unsigned int rbuf_unused = RBUF_SIZE;
+
+static xtimer_t _gc_timer;
+static msg_t _gc_msg = { .type = GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF };
+static uint32_t _gc_deadline;
+static bool _gc_armed;
+
 #if ENABLE_DEBUG
 static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 #endif
@@ -53,20 +56,31 @@ static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 /* ------------------------------------
  * internal function definitions
  * ------------------------------------*/
-/* checks whether start and end overlaps, but not identical to, given interval i */
-static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, uint16_t end);
-/* gets a free entry from interval buffer */
-static rbuf_int_t *_rbuf_int_get_free(void);
+/* gets the hash bucket of a datagram */
+static rbuf_t **_rbuf_bucket(const void *src, size_t src_len,
+                             const void *dst, size_t dst_len,
+                             size_t size, uint16_t tag);
 /* remove entry from reassembly buffer */
 static void _rbuf_rem(rbuf_t *entry);
-/* update interval buffer of entry */
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
-/* checks timeouts and removes entries if necessary (oldest if full) */
-static void _rbuf_gc(void);
-/* gets an entry identified by its tupel */
+/* marks the units of a fragment as received. Returns 1 for a new fragment,
+ * 0 for a duplicate, and -1 if it overlaps received fragments partially */
+static int _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
+/* removes timed out entries, starting with the oldest */
+static void _rbuf_gc(uint32_t now_usec);
+/* sets the timer to remove the oldest entry when it times out */
+static void _rbuf_arm_gc(uint32_t now_usec);
+/* checks if an entry belongs to the datagram identified by the tupel */
+static bool _rbuf_match(const rbuf_t *entry, const void *src, size_t src_len,
+                        const void *dst, size_t dst_len,
+                        size_t size, uint16_t tag);
+/* looks up an entry identified by its tupel */
+static rbuf_t *_rbuf_find(const void *src, size_t src_len,
+                          const void *dst, size_t dst_len,
+                          size_t size, uint16_t tag);
+/* gets an entry identified by its tupel, creates it if necessary */
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
-                         size_t size, uint16_t tag);
+                         size_t size, uint16_t tag, uint32_t now_usec);
 
 void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
               size_t frag_size, size_t offset)
@@ -77,22 +91,21 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     unsigned int data_offset = 0;
     size_t original_size = frag_size;
     sixlowpan_frag_t *frag = pkt->data;
-    rbuf_int_t *ptr;
     uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
+    uint32_t now_usec = xtimer_now_usec();
 
-    _rbuf_gc();
+    _rbuf_gc(now_usec);
     entry = _rbuf_get(gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len,
                       gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len,
                       byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK,
-                      byteorder_ntohs(frag->tag));
+                      byteorder_ntohs(frag->tag), now_usec);
+    _rbuf_arm_gc(now_usec);
 
     if (entry == NULL) {
         DEBUG("6lo rbuf: reassembly buffer full.\n");
         return;
     }
 
-    ptr = entry->ints;
-
     /* dispatches in the first fragment are ignored */
     if (offset == 0) {
         if (data[0] == SIXLOWPAN_UNCOMP) {
@@ -130,11 +143,11 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         return;
     }
 
-    /* If the fragment overlaps another fragment and differs in either the size
-     * or the offset of the overlapped fragment, discards the datagram
-     * https://tools.ietf.org/html/rfc4944#section-5.3 */
-    while (ptr != NULL) {
-        if (_rbuf_int_overlap_partially(ptr, offset, offset + frag_size - 1)) {
+    switch (_rbuf_update_ints(entry, offset, frag_size)) {
+        case -1:
+            /* If the fragment overlaps another fragment and differs in either
+             * the size or the offset of the overlapped fragment, discards the
+             * datagram https://tools.ietf.org/html/rfc4944#section-5.3 */
             DEBUG("6lo rfrag: overlapping intervals, discarding datagram\n");
             gnrc_pktbuf_release(entry->pkt);
             _rbuf_rem(entry);
@@ -145,16 +158,20 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
             rbuf_add(netif_hdr, pkt, original_size, offset);
 
             return;
-        }
-
-        ptr = ptr->next;
-    }
 
-    if (_rbuf_update_ints(entry, offset, frag_size)) {
-        DEBUG("6lo rbuf: add fragment data\n");
-        entry->cur_size += (uint16_t)frag_size;
-        memcpy(((uint8_t *)entry->pkt->data) + offset + data_offset, data,
-               frag_size - data_offset);
+        case 0:
+            DEBUG("6lo rbuf: duplicate fragment\n");
+            break;
+
+        default:
+            DEBUG("6lo rbuf: add fragment data\n");
+            entry->cur_size += (uint16_t)frag_size;
+            memcpy(((uint8_t *)entry->pkt->data) + offset + data_offset, data,
+                   frag_size - data_offset);
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+            gnrc_sixlowpan_frag_stats_get()->frags_reassembled++;
+#endif
+            break;
     }
 
     if (entry->cur_size == entry->pkt->size) {
@@ -178,6 +195,9 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         new_netif_hdr->lqi = netif_hdr->lqi;
         new_netif_hdr->rssi = netif_hdr->rssi;
         LL_APPEND(entry->pkt, netif);
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+        gnrc_sixlowpan_frag_stats_get()->datagrams_reassembled++;
+#endif
 
         if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL,
                                           entry->pkt)) {
@@ -189,142 +209,182 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     }
 }
 
-static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, uint16_t end)
+void rbuf_gc(void)
+{
+    uint32_t now_usec = xtimer_now_usec();
+
+    _gc_armed = false;
+    _rbuf_gc(now_usec);
+    _rbuf_arm_gc(now_usec);
+}
+
+bool rbuf_has(gnrc_netif_hdr_t *netif_hdr, size_t size, uint16_t tag)
 {
-    /* start and ends are both inclusive, so using <= for both */
-    return ((i->start <= end) && (start <= i->end)) && /* overlaps */
-        ((start != i->start) || (end != i->end)); /* not identical */
+    return _rbuf_find(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                      netif_hdr->src_l2addr_len,
+                      gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                      netif_hdr->dst_l2addr_len, size, tag) != NULL;
 }
 
-static rbuf_int_t *_rbuf_int_get_free(void)
+static rbuf_t **_rbuf_bucket(const void *src, size_t src_len,
+                             const void *dst, size_t dst_len,
+                             size_t size, uint16_t tag)
 {
-    for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
-        }
-    }
+    uint32_t hash = djb2_hash(src, src_len) ^ (djb2_hash(dst, dst_len) << 1) ^
+                    ((uint32_t)size << 16) ^ tag;
 
-    return NULL;
+    return &rbuf_idx[hash % RBUF_IDX_SIZE];
 }
 
 static void _rbuf_rem(rbuf_t *entry)
 {
-    while (entry->ints != NULL) {
-        rbuf_int_t *next = entry->ints->next;
-
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
-        entry->ints = next;
-    }
+    rbuf_t **bucket = _rbuf_bucket(entry->src, entry->src_len,
+                                   entry->dst, entry->dst_len,
+                                   entry->datagram_size, entry->tag);
 
+    LL_DELETE(*bucket, entry);
+    DL_DELETE2(rbuf_lru, entry, lru_prev, lru_next);
     entry->pkt = NULL;
+    LL_PREPEND(rbuf_free, entry);
 }
 
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
+static int _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
 {
-    rbuf_int_t *new;
-    uint16_t end = (uint16_t)(offset + frag_size - 1);
-
-    new = _rbuf_int_get_free();
+    unsigned int start = offset / RBUF_UNIT;
+    unsigned int end = DIV_CEIL(offset + frag_size, RBUF_UNIT);
+    unsigned int received = 0;
 
-    if (new == NULL) {
-        DEBUG("6lo rfrag: no space left in rbuf interval buffer.\n");
-        return false;
+    for (unsigned int i = start; i < end; i++) {
+        if (bf_isset(entry->received, i)) {
+            received++;
+        }
+    }
+    if (received == (end - start)) {
+        return 0;
+    }
+    if (received > 0) {
+        return -1;
     }
 
-    new->start = offset;
-    new->end = end;
-
-    DEBUG("6lo rfrag: add interval (%" PRIu16 ", %" PRIu16 ") to entry (%s, ",
-          new->start, new->end, gnrc_netif_addr_to_str(l2addr_str,
-                  sizeof(l2addr_str), entry->src, entry->src_len));
+    DEBUG("6lo rfrag: add interval (%u, %u) to entry (%s, ",
+          offset, (unsigned)(offset + frag_size - 1),
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
+                                 entry->src, entry->src_len));
     DEBUG("%s, %u, %u)\n", gnrc_netif_addr_to_str(l2addr_str,
             sizeof(l2addr_str), entry->dst, entry->dst_len),
           (unsigned)entry->pkt->size, entry->tag);
 
-    LL_PREPEND(entry->ints, new);
+    for (unsigned int i = start; i < end; i++) {
+        bf_set(entry->received, i);
+    }
+    return 1;
+}
 
-    return true;
+static void _rbuf_gc(uint32_t now_usec)
+{
+    /* since pkt occupies pktbuf, aggressivly collect garbage */
+    while ((rbuf_lru != NULL) && ((now_usec - rbuf_lru->arrival) > RBUF_TIMEOUT)) {
+        DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
+                sizeof(l2addr_str), rbuf_lru->src, rbuf_lru->src_len));
+        DEBUG("%s, %u, %u) timed out\n",
+              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), rbuf_lru->dst,
+                                     rbuf_lru->dst_len),
+              (unsigned)rbuf_lru->pkt->size, rbuf_lru->tag);
+
+        gnrc_pktbuf_release(rbuf_lru->pkt);
+        _rbuf_rem(rbuf_lru);
+    }
 }
 
-static void _rbuf_gc(void)
+static void _rbuf_arm_gc(uint32_t now_usec)
 {
-    uint32_t now_usec = xtimer_now_usec();
-    unsigned int i;
-
-    for (i = 0; i < RBUF_SIZE; i++) {
-        /* since pkt occupies pktbuf, aggressivly collect garbage */
-        if ((rbuf[i].pkt != NULL) &&
-              ((now_usec - rbuf[i].arrival) > RBUF_TIMEOUT)) {
-            DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
-                    sizeof(l2addr_str), rbuf[i].src, rbuf[i].src_len));
-            DEBUG("%s, %u, %u) timed out\n",
-                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), rbuf[i].dst,
-                                         rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-
-            gnrc_pktbuf_release(rbuf[i].pkt);
-            _rbuf_rem(&(rbuf[i]));
-        }
+    uint32_t offset = 0;
+
+    /* don't set the timer again while it is pending, unless its message got
+     * lost on a full message queue */
+    if ((rbuf_lru == NULL) ||
+        (_gc_armed && ((int32_t)(now_usec - _gc_deadline) < (int32_t)RBUF_TIMEOUT))) {
+        return;
     }
+    if ((now_usec - rbuf_lru->arrival) <= RBUF_TIMEOUT) {
+        offset = RBUF_TIMEOUT - (now_usec - rbuf_lru->arrival) + 1;
+    }
+    _gc_deadline = now_usec + offset;
+    _gc_armed = true;
+    xtimer_set_msg(&_gc_timer, offset, &_gc_msg, sched_active_pid);
 }
 
-static rbuf_t *_rbuf_get(const void *src, size_t src_len,
-                         const void *dst, size_t dst_len,
-                         size_t size, uint16_t tag)
+static bool _rbuf_match(const rbuf_t *entry, const void *src, size_t src_len,
+                        const void *dst, size_t dst_len,
+                        size_t size, uint16_t tag)
 {
-    rbuf_t *res = NULL, *oldest = NULL;
-    uint32_t now_usec = xtimer_now_usec();
+    return (entry->datagram_size == size) &&
+           (entry->tag == tag) && (entry->src_len == src_len) &&
+           (entry->dst_len == dst_len) &&
+           (memcmp(entry->src, src, src_len) == 0) &&
+           (memcmp(entry->dst, dst, dst_len) == 0);
+}
 
-    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
-        /* check first if entry already available */
-        if ((rbuf[i].pkt != NULL) && (rbuf[i].pkt->size == size) &&
-            (rbuf[i].tag == tag) && (rbuf[i].src_len == src_len) &&
-            (rbuf[i].dst_len == dst_len) &&
-            (memcmp(rbuf[i].src, src, src_len) == 0) &&
-            (memcmp(rbuf[i].dst, dst, dst_len) == 0)) {
-            DEBUG("6lo rfrag: entry %p (%s, ", (void *)(&rbuf[i]),
-                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].src, rbuf[i].src_len));
-            DEBUG("%s, %u, %u) found\n",
-                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].dst, rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-            rbuf[i].arrival = now_usec;
-            return &(rbuf[i]);
-        }
+static rbuf_t *_rbuf_find(const void *src, size_t src_len,
+                          const void *dst, size_t dst_len,
+                          size_t size, uint16_t tag)
+{
+    rbuf_t *entry = *_rbuf_bucket(src, src_len, dst, dst_len, size, tag);
 
-        /* if there is a free spot: remember it */
-        if ((res == NULL) && (rbuf[i].pkt == NULL)) {
-            res = &(rbuf[i]);
-        }
+    while ((entry != NULL) &&
+           !_rbuf_match(entry, src, src_len, dst, dst_len, size, tag)) {
+        entry = entry->next;
+    }
+    return entry;
+}
 
-        /* remember oldest slot */
-        /* note that xtimer_now will overflow in ~1.2 hours */
-        if ((oldest == NULL) || (oldest->arrival - rbuf[i].arrival < UINT32_MAX / 2)) {
-            oldest = &(rbuf[i]);
-        }
+static rbuf_t *_rbuf_get(const void *src, size_t src_len,
+                         const void *dst, size_t dst_len,
+                         size_t size, uint16_t tag, uint32_t now_usec)
+{
+    rbuf_t *res = _rbuf_find(src, src_len, dst, dst_len, size, tag);
+    gnrc_pktsnip_t *pkt;
+
+    /* check first if entry already available */
+    if (res != NULL) {
+        DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
+              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
+                                     res->src, res->src_len));
+        DEBUG("%s, %u, %u) found\n",
+              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
+                                     res->dst, res->dst_len),
+              (unsigned)res->pkt->size, res->tag);
+        res->arrival = now_usec;
+        /* move to the end of the arrival order */
+        DL_DELETE2(rbuf_lru, res, lru_prev, lru_next);
+        DL_APPEND2(rbuf_lru, res, lru_prev, lru_next);
+        return res;
     }
 
-    /* entry not in buffer and no empty spot found */
-    if (res == NULL) {
-        assert(oldest != NULL);
-        assert(oldest->pkt != NULL); /* if oldest->pkt == NULL, res must not be NULL */
+    /* entry not in buffer and no empty spot left: remove oldest entry */
+    if ((rbuf_free == NULL) && (rbuf_unused == 0)) {
+        assert(rbuf_lru != NULL);
         DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
-        gnrc_pktbuf_release(oldest->pkt);
-        _rbuf_rem(oldest);
-        res = oldest;
+        gnrc_pktbuf_release(rbuf_lru->pkt);
+        _rbuf_rem(rbuf_lru);
     }
 
-    /* now we have an empty spot */
-
-    res->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_IPV6);
-    if (res->pkt == NULL) {
+    pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_IPV6);
+    if (pkt == NULL) {
         DEBUG("6lo rfrag: can not allocate reassembly buffer space.\n");
         return NULL;
     }
 
+    /* now we have an empty spot */
+    if (rbuf_free != NULL) {
+        res = rbuf_free;
+        LL_DELETE(rbuf_free, res);
+    }
+    else {
+        res = &rbuf[--rbuf_unused];
+    }
+
+    res->pkt = pkt;
     *((uint64_t *)res->pkt->data) = 0;  /* clean first few bytes for later
                                          * look-ups */
     res->arrival = now_usec;
@@ -333,7 +393,11 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
     res->src_len = src_len;
     res->dst_len = dst_len;
     res->tag = tag;
+    res->datagram_size = size;
     res->cur_size = 0;
+    memset(res->received, 0, sizeof(res->received));
+    LL_PREPEND(*_rbuf_bucket(src, src_len, dst, dst_len, size, tag), res);
+    DL_APPEND2(rbuf_lru, res, lru_prev, lru_next);
 
     DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
           gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->src,
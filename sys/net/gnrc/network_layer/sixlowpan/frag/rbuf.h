@@ -20,9 +20,12 @@
 #define GNRC_SIXLOWPAN_FRAG_RBUF_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 
+#include "bitfield.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
+#include "net/sixlowpan.h"
 
 #include "net/gnrc/sixlowpan/frag.h"
 #ifdef __cplusplus
@@ -31,26 +34,18 @@ extern "C" {
 #endif
 
 #define RBUF_L2ADDR_MAX_LEN (8U)               /**< maximum length for link-layer addresses */
+#ifndef RBUF_SIZE
 #define RBUF_SIZE           (4U)               /**< size of the reassembly buffer */
+#endif
+#ifndef RBUF_IDX_SIZE
+#define RBUF_IDX_SIZE       (RBUF_SIZE)        /**< number of buckets of the hash index */
+#endif
 #define RBUF_TIMEOUT        (3U * US_PER_SEC) /**< timeout for reassembly in microseconds */
-
+#define RBUF_UNIT           (8U)               /**< granularity of fragment offsets in bytes */
 /**
- * @brief   Fragment intervals to identify limits of fragments.
- *
- * @note    Fragments MUST NOT overlap and overlapping fragments are to be
- *          discarded
- *
- * @see <a href="https://tools.ietf.org/html/rfc4944#section-5.3">
- *          RFC 4944, section 5.3
- *      </a>
- *
- * @internal
+ * @brief   number of @ref RBUF_UNIT sized units of the largest datagram
  */
-typedef struct rbuf_int {
-    struct rbuf_int *next;  /**< next element in interval list */
-    uint16_t start;         /**< start byte of interval */
-    uint16_t end;           /**< end byte of interval */
-} rbuf_int_t;
+#define RBUF_UNITS          ((SIXLOWPAN_FRAG_MAX_LEN + RBUF_UNIT - 1) / RBUF_UNIT)
 
 /**
  * @brief   An entry in the 6LoWPAN reassembly buffer.
@@ -64,14 +59,20 @@ typedef struct rbuf_int {
  *
  * to identify all fragments that belong to the given datagram.
  *
+ * Fragment offsets are multiples of @ref RBUF_UNIT bytes, so the received
+ * parts of the datagram are kept in a bitmap of @ref RBUF_UNIT sized units.
+ *
  * @see <a href="https://tools.ietf.org/html/rfc4944#section-5.3">
  *          RFC 4944, section 5.3
  *      </a>
  *
  * @internal
  */
-typedef struct {
-    rbuf_int_t *ints;                   /**< intervals of the fragment */
+typedef struct rbuf_entry {
+    struct rbuf_entry *next;            /**< next entry in hash bucket or
+                                         *   in free list */
+    struct rbuf_entry *lru_prev;        /**< previous entry in order of arrival */
+    struct rbuf_entry *lru_next;        /**< next entry in order of arrival */
     gnrc_pktsnip_t *pkt;                /**< the reassembled packet in packet buffer */
     uint32_t arrival;                   /**< time in microseconds of arrival of
                                          *   last received fragment */
@@ -80,7 +81,9 @@ typedef struct {
     uint8_t src_len;                    /**< length of source address */
     uint8_t dst_len;                    /**< length of destination address */
     uint16_t tag;                       /**< the datagram's tag */
+    uint16_t datagram_size;             /**< the datagram's size */
     uint16_t cur_size;                  /**< the datagram's current size */
+    BITFIELD(received, RBUF_UNITS);     /**< received units of the datagram */
 } rbuf_t;
 
 /**
@@ -100,6 +103,31 @@ typedef struct {
 void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *frag,
               size_t frag_size, size_t offset);
 
+/**
+ * @brief   Removes timed out entries from the reassembly buffer.
+ *
+ * Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, which the reassembly
+ * buffer sends itself when its oldest entry times out.
+ *
+ * @internal
+ */
+void rbuf_gc(void);
+
+/**
+ * @brief   Checks if a datagram is already being reassembled.
+ *
+ * @param[in] netif_hdr     The interface header of a fragment of the datagram,
+ *                          with its source and destination address set.
+ * @param[in] size          The datagram's size.
+ * @param[in] tag           The datagram's tag.
+ *
+ * @return  true, if the reassembly buffer holds an entry for the datagram.
+ * @return  false, otherwise.
+ *
+ * @internal
+ */
+bool rbuf_has(gnrc_netif_hdr_t *netif_hdr, size_t size, uint16_t tag);
+
 #ifdef __cplusplus
 }
 #endif
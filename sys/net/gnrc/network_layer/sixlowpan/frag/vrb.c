@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "rbuf.h"
+#include "vrb.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/netif.h"
+#ifdef MODULE_GNRC_IPV6_DCACHE
+#include "net/gnrc/ipv6/dcache.h"
+#endif
+#include "net/gnrc/sixlowpan.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_ND
+#include "net/gnrc/sixlowpan/nd.h"
+#endif
+#include "net/protnum.h"
+#include "net/sixlowpan.h"
+#include "net/udp.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static vrb_t vrb[VRB_SIZE];
+
+#if ENABLE_DEBUG
+static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
+#endif
+
+/* ------------------------------------
+ * internal function definitions
+ * ------------------------------------*/
+/* gets a free entry */
+static vrb_t *_vrb_get_free(void);
+/* checks if a datagram with this header would be routed on */
+static bool _is_routed(const ipv6_hdr_t *hdr);
+#if defined(MODULE_GNRC_IPV6_DCACHE) || defined(MODULE_GNRC_SIXLOWPAN_ND)
+/* determines the next hop towards dst */
+static kernel_pid_t _next_hop(uint8_t *l2addr, uint8_t *l2addr_len, ipv6_addr_t *dst);
+#endif
+/* decodes the IPv6 header of a first fragment */
+static gnrc_pktsnip_t *_decode(gnrc_pktsnip_t *pkt, size_t datagram_size,
+                               size_t *hdr_len);
+/* builds the first fragment for the next hop */
+static gnrc_pktsnip_t *_build_1st(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *ipv6,
+                                  size_t hdr_len, vrb_t *entry);
+/* sends a fragment to the next hop */
+static void _send(vrb_t *entry, gnrc_pktsnip_t *frag);
+/* relays the first fragment of a datagram */
+static bool _forward_1st(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                         size_t datagram_size, uint16_t tag);
+/* relays a subsequent fragment of a datagram */
+static bool _forward_nth(vrb_t *entry, gnrc_pktsnip_t *pkt, size_t frag_size);
+
+bool vrb_forward(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                 size_t frag_size, size_t offset)
+{
+    sixlowpan_frag_t *frag = pkt->data;
+    size_t datagram_size = byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK;
+    uint16_t tag = byteorder_ntohs(frag->tag);
+    vrb_t *entry;
+
+    vrb_gc();
+
+    if (offset == 0) {
+        return _forward_1st(netif_hdr, pkt, datagram_size, tag);
+    }
+
+    entry = vrb_get(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                    netif_hdr->src_l2addr_len, datagram_size, tag);
+    if (entry == NULL) {
+        /* first fragment was not seen or not relayed */
+        return false;
+    }
+    return _forward_nth(entry, pkt, frag_size);
+}
+
+vrb_t *vrb_add(const void *src, size_t src_len, size_t datagram_size,
+               uint16_t tag, kernel_pid_t out_iface, const void *out_dst,
+               size_t out_dst_len)
+{
+    vrb_t *entry;
+
+    assert((src_len <= RBUF_L2ADDR_MAX_LEN) &&
+           (out_dst_len <= RBUF_L2ADDR_MAX_LEN) && (datagram_size > 0));
+    if ((entry = _vrb_get_free()) == NULL) {
+        return NULL;
+    }
+    memcpy(entry->src, src, src_len);
+    entry->src_len = src_len;
+    memcpy(entry->out_dst, out_dst, out_dst_len);
+    entry->out_dst_len = out_dst_len;
+    entry->out_iface = out_iface;
+    entry->tag = tag;
+    entry->out_tag = gnrc_sixlowpan_frag_next_tag();
+    entry->datagram_size = (uint16_t)datagram_size;
+    entry->cur_size = 0;
+    entry->arrival = xtimer_now_usec();
+
+    DEBUG("6lo vrb: relay datagram (%s, %u, %u) ",
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), entry->src,
+                                 entry->src_len), (unsigned)datagram_size, tag);
+    DEBUG("to (%s, %u)\n",
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), entry->out_dst,
+                                 entry->out_dst_len), entry->out_tag);
+    return entry;
+}
+
+vrb_t *vrb_get(const void *src, size_t src_len, size_t datagram_size,
+               uint16_t tag)
+{
+    for (unsigned int i = 0; i < VRB_SIZE; i++) {
+        if ((vrb[i].datagram_size != 0) && (vrb[i].datagram_size == datagram_size) &&
+            (vrb[i].tag == tag) && (vrb[i].src_len == src_len) &&
+            (memcmp(vrb[i].src, src, src_len) == 0)) {
+            return &vrb[i];
+        }
+    }
+    return NULL;
+}
+
+void vrb_gc(void)
+{
+    uint32_t now_usec = xtimer_now_usec();
+
+    for (unsigned int i = 0; i < VRB_SIZE; i++) {
+        if ((vrb[i].datagram_size != 0) &&
+            ((now_usec - vrb[i].arrival) > VRB_TIMEOUT)) {
+            DEBUG("6lo vrb: entry (%s, %u, %u) timed out\n",
+                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
+                                         vrb[i].src, vrb[i].src_len),
+                  (unsigned)vrb[i].datagram_size, vrb[i].tag);
+            vrb_rm(&vrb[i]);
+        }
+    }
+}
+
+static bool _forward_1st(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                         size_t datagram_size, uint16_t tag)
+{
+    gnrc_pktsnip_t *ipv6, *out;
+    ipv6_hdr_t *hdr;
+    vrb_t *entry;
+    uint8_t out_dst[RBUF_L2ADDR_MAX_LEN];
+    uint8_t out_dst_len = sizeof(out_dst);
+    size_t hdr_len;
+    kernel_pid_t iface;
+
+    /* subsequent fragments overtook the first one: stay with reassembly */
+    if (rbuf_has(netif_hdr, datagram_size, tag)) {
+        return false;
+    }
+
+    if ((ipv6 = _decode(pkt, datagram_size, &hdr_len)) == NULL) {
+        return false;
+    }
+    hdr = ipv6->data;
+
+    if (!_is_routed(hdr)) {
+        DEBUG("6lo vrb: datagram is not routed on, reassemble it\n");
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+
+#if defined(MODULE_GNRC_IPV6_DCACHE) || defined(MODULE_GNRC_SIXLOWPAN_ND)
+    iface = _next_hop(out_dst, &out_dst_len, &hdr->dst);
+#else
+    /* no way to determine the next hop: datagrams are always reassembled */
+    iface = KERNEL_PID_UNDEF;
+#endif
+    if ((iface <= KERNEL_PID_UNDEF) || (gnrc_sixlowpan_netif_get(iface) == NULL)) {
+        DEBUG("6lo vrb: no 6LoWPAN next hop, reassemble datagram\n");
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+
+    if ((entry = vrb_add(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                         netif_hdr->src_l2addr_len, datagram_size, tag, iface,
+                         out_dst, out_dst_len)) == NULL) {
+        DEBUG("6lo vrb: virtual reassembly buffer full\n");
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+        gnrc_sixlowpan_frag_stats_get()->vrb_full++;
+#endif
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+
+    hdr->hl--;
+    /* the number of bytes of the uncompressed datagram in this fragment */
+    entry->cur_size = (uint16_t)(ipv6->size + pkt->size - sizeof(sixlowpan_frag_t) - hdr_len);
+
+    if ((out = _build_1st(pkt, ipv6, hdr_len, entry)) == NULL) {
+        /* header does not fit into the first fragment after recompression */
+        vrb_rm(entry);
+        return false;
+    }
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+    gnrc_sixlowpan_frag_stats_get()->datagrams_forwarded++;
+#endif
+    gnrc_pktbuf_release(pkt);
+    _send(entry, out);
+    return true;
+}
+
+static bool _forward_nth(vrb_t *entry, gnrc_pktsnip_t *pkt, size_t frag_size)
+{
+    gnrc_pktsnip_t *netif = pkt->next, *frag;
+
+    entry->arrival = xtimer_now_usec();
+    entry->cur_size += (uint16_t)frag_size;
+
+    /* only the fragment header is changed, the payload is relayed as is */
+    if ((frag = gnrc_pktbuf_start_write(pkt)) == NULL) {
+        DEBUG("6lo vrb: can not get write access on fragment\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    gnrc_pktbuf_remove_snip(frag, netif);
+    ((sixlowpan_frag_t *)frag->data)->tag = byteorder_htons(entry->out_tag);
+
+    _send(entry, frag);
+
+    if (entry->cur_size >= entry->datagram_size) {
+        DEBUG("6lo vrb: all fragments of datagram relayed\n");
+        vrb_rm(entry);
+    }
+    return true;
+}
+
+static void _send(vrb_t *entry, gnrc_pktsnip_t *frag)
+{
+    gnrc_pktsnip_t *netif;
+
+    /* the source address is filled in by the device */
+    netif = gnrc_netif_hdr_build(NULL, 0, entry->out_dst, entry->out_dst_len);
+    if (netif == NULL) {
+        DEBUG("6lo vrb: error allocating link-layer header\n");
+        gnrc_pktbuf_release(frag);
+        return;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = entry->out_iface;
+    netif->next = frag;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+    gnrc_sixlowpan_frag_stats_get()->frags_forwarded++;
+#endif
+    if (gnrc_netapi_send(entry->out_iface, netif) < 1) {
+        DEBUG("6lo vrb: unable to relay fragment\n");
+        gnrc_pktbuf_release(netif);
+    }
+}
+
+static gnrc_pktsnip_t *_decode(gnrc_pktsnip_t *pkt, size_t datagram_size,
+                               size_t *hdr_len)
+{
+    uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
+    size_t data_len = pkt->size - sizeof(sixlowpan_frag_t);
+    gnrc_pktsnip_t *ipv6 = NULL;
+
+#ifndef MODULE_GNRC_SIXLOWPAN_IPHC
+    (void)datagram_size;
+#endif
+    if ((data_len > sizeof(ipv6_hdr_t)) && (data[0] == SIXLOWPAN_UNCOMP) &&
+        ipv6_hdr_is((ipv6_hdr_t *)(data + 1))) {
+        ipv6 = gnrc_pktbuf_add(NULL, data + 1, sizeof(ipv6_hdr_t),
+                               GNRC_NETTYPE_IPV6);
+        *hdr_len = 1 + sizeof(ipv6_hdr_t);
+    }
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC
+    else if ((data_len > 0) && sixlowpan_iphc_is(data)) {
+        size_t nh_len = 0;
+
+        /* room for the UDP header decompressed by NHC */
+        ipv6 = gnrc_pktbuf_add(NULL, NULL, sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t),
+                               GNRC_NETTYPE_IPV6);
+        if (ipv6 == NULL) {
+            DEBUG("6lo vrb: can not allocate IPv6 header\n");
+            return NULL;
+        }
+        /* decoding ORs some of the header fields in */
+        memset(ipv6->data, 0, ipv6->size);
+        *hdr_len = gnrc_sixlowpan_iphc_decode(&ipv6, pkt, datagram_size,
+                                              sizeof(sixlowpan_frag_t), &nh_len);
+        if ((*hdr_len == 0) || (*hdr_len > data_len)) {
+            DEBUG("6lo vrb: could not decode IPHC dispatch\n");
+            gnrc_pktbuf_release(ipv6);
+            return NULL;
+        }
+        gnrc_pktbuf_realloc_data(ipv6, sizeof(ipv6_hdr_t) + nh_len);
+    }
+#endif
+    else {
+        DEBUG("6lo vrb: unsupported dispatch in first fragment\n");
+    }
+    return ipv6;
+}
+
+static gnrc_pktsnip_t *_build_1st(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *ipv6,
+                                  size_t hdr_len, vrb_t *entry)
+{
+    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(entry->out_iface);
+    uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t) + hdr_len;
+    size_t data_len = pkt->size - sizeof(sixlowpan_frag_t) - hdr_len;
+    size_t nh_len = ipv6->size - sizeof(ipv6_hdr_t);
+    gnrc_pktsnip_t *netif, *payload, *frag;
+    sixlowpan_frag_t *frag_hdr;
+
+    /* netif header is only needed for IPHC and is replaced on sending */
+    netif = gnrc_netif_hdr_build(NULL, 0, entry->out_dst, entry->out_dst_len);
+    payload = gnrc_pktbuf_add(NULL, NULL, nh_len + data_len, GNRC_NETTYPE_UNDEF);
+    frag = gnrc_pktbuf_add(NULL, NULL, sizeof(sixlowpan_frag_t),
+                           GNRC_NETTYPE_SIXLOWPAN);
+    if ((netif == NULL) || (payload == NULL) || (frag == NULL)) {
+        DEBUG("6lo vrb: can not allocate first fragment\n");
+        gnrc_pktbuf_release(netif);
+        gnrc_pktbuf_release(payload);
+        gnrc_pktbuf_release(frag);
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = entry->out_iface;
+
+    /* next header decompressed by NHC is compressed again together with the
+     * IPv6 header, so it goes in front of the payload */
+    memcpy(payload->data, ((uint8_t *)ipv6->data) + sizeof(ipv6_hdr_t), nh_len);
+    memcpy(((uint8_t *)payload->data) + nh_len, data, data_len);
+    gnrc_pktbuf_realloc_data(ipv6, sizeof(ipv6_hdr_t));
+    netif->next = ipv6;
+    ipv6->next = payload;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC
+    if (iface->iphc_enabled &&
+        ((((ipv6_hdr_t *)ipv6->data)->nh != PROTNUM_UDP) ||
+         (payload->size >= sizeof(udp_hdr_t)))) {
+        if (!gnrc_sixlowpan_iphc_encode(netif)) {
+            DEBUG("6lo vrb: error on IPHC encoding\n");
+            gnrc_pktbuf_release(netif);
+            gnrc_pktbuf_release(frag);
+            return NULL;
+        }
+    }
+    else
+#endif
+    {
+        gnrc_pktsnip_t *disp = gnrc_pktbuf_add(ipv6, NULL, sizeof(uint8_t),
+                                               GNRC_NETTYPE_SIXLOWPAN);
+        if (disp == NULL) {
+            DEBUG("6lo vrb: can not allocate dispatch\n");
+            gnrc_pktbuf_release(netif);
+            gnrc_pktbuf_release(frag);
+            return NULL;
+        }
+        *((uint8_t *)disp->data) = SIXLOWPAN_UNCOMP;
+        netif->next = disp;
+    }
+
+    frag_hdr = frag->data;
+    frag_hdr->disp_size = byteorder_htons(entry->datagram_size);
+    frag_hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+    frag_hdr->tag = byteorder_htons(entry->out_tag);
+    frag->next = netif->next;
+    netif->next = NULL;
+    gnrc_pktbuf_release(netif);
+
+    if (gnrc_pkt_len(frag) > iface->max_frag_size) {
+        DEBUG("6lo vrb: first fragment too big for next hop\n");
+        gnrc_pktbuf_release(frag);
+        return NULL;
+    }
+    return frag;
+}
+
+static bool _is_routed(const ipv6_hdr_t *hdr)
+{
+    /* RFC 4291, section 2.5.6 states: "Routers must not forward any
+     * packets with Link-Local source or destination addresses to other
+     * links." Packets that reach hop limit 0 are not relayed either, so
+     * IPv6 can deal with both after reassembly. */
+    return !ipv6_addr_is_multicast(&hdr->dst) &&
+           !ipv6_addr_is_link_local(&hdr->dst) &&
+           !ipv6_addr_is_link_local(&hdr->src) &&
+           (hdr->hl > 1) &&
+           (gnrc_ipv6_netif_find_by_addr(NULL, &hdr->dst) == KERNEL_PID_UNDEF);
+}
+
+#if defined(MODULE_GNRC_IPV6_DCACHE) || defined(MODULE_GNRC_SIXLOWPAN_ND)
+static kernel_pid_t _next_hop(uint8_t *l2addr, uint8_t *l2addr_len, ipv6_addr_t *dst)
+{
+    kernel_pid_t iface = KERNEL_PID_UNDEF;
+
+#ifdef MODULE_GNRC_IPV6_DCACHE
+    iface = gnrc_ipv6_dcache_get(l2addr, l2addr_len, KERNEL_PID_UNDEF, dst);
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_ND
+    if (iface <= KERNEL_PID_UNDEF) {
+        iface = gnrc_sixlowpan_nd_next_hop_l2addr(l2addr, l2addr_len,
+                                                  KERNEL_PID_UNDEF, dst, NULL);
+    }
+#endif
+    if ((iface > KERNEL_PID_UNDEF) &&
+        ((*l2addr_len == 0) || (*l2addr_len > RBUF_L2ADDR_MAX_LEN))) {
+        return KERNEL_PID_UNDEF;
+    }
+    return iface;
+}
+#endif
+
+static vrb_t *_vrb_get_free(void)
+{
+    for (unsigned int i = 0; i < VRB_SIZE; i++) {
+        if (vrb[i].datagram_size == 0) {
+            return &vrb[i];
+        }
+    }
+    return NULL;
+}
+
+/** @} */
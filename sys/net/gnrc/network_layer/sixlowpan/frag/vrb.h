@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_sixlowpan_frag
+ * @{
+ *
+ * @file
+ * @internal
+ * @brief   6LoWPAN virtual reassembly buffer
+ *
+ * Instead of reassembling a datagram that is routed on, only the IPv6 header
+ * in the first fragment is looked at to determine the next hop. All
+ * fragments of the datagram are then relayed to this next hop as they arrive,
+ * only their link-layer header and datagram tag are replaced.
+ *
+ * @see <a href="https://tools.ietf.org/html/draft-ietf-lwig-6lowpan-virtual-reassembly-00">
+ *          draft-ietf-lwig-6lowpan-virtual-reassembly-00
+ *      </a>
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_H
+#define GNRC_SIXLOWPAN_FRAG_VRB_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "kernel_types.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pkt.h"
+
+#include "rbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VRB_SIZE
+#define VRB_SIZE            (4U)            /**< size of the virtual reassembly buffer */
+#endif
+#define VRB_TIMEOUT         (RBUF_TIMEOUT)  /**< timeout for forwarding in microseconds */
+
+/**
+ * @brief   An entry in the 6LoWPAN virtual reassembly buffer.
+ *
+ * @details Maps a datagram, identified by the source address of the previous
+ *          hop, the datagram size, and the datagram tag, to the next hop and
+ *          the datagram tag used towards it.
+ *
+ * @internal
+ */
+typedef struct {
+    uint32_t arrival;                       /**< time in microseconds of arrival
+                                             *   of last received fragment */
+    uint8_t src[RBUF_L2ADDR_MAX_LEN];       /**< source address */
+    uint8_t out_dst[RBUF_L2ADDR_MAX_LEN];   /**< link-layer address of the next hop */
+    uint8_t src_len;                        /**< length of source address */
+    uint8_t out_dst_len;                    /**< length of next hop address */
+    kernel_pid_t out_iface;                 /**< interface to the next hop */
+    uint16_t tag;                           /**< the datagram's tag */
+    uint16_t out_tag;                       /**< the datagram's tag towards the
+                                             *   next hop */
+    uint16_t datagram_size;                 /**< the datagram's size, 0 if the
+                                             *   entry is unused */
+    uint16_t cur_size;                      /**< number of bytes forwarded */
+} vrb_t;
+
+/**
+ * @brief   Relays a fragment to the next hop of its datagram.
+ *
+ * A first fragment creates a new entry if its datagram is routed on over a
+ * 6LoWPAN interface. Subsequent fragments are relayed if there is an entry
+ * for their datagram.
+ *
+ * @param[in] netif_hdr     The interface header of the fragment, with
+ *                          gnrc_netif_hdr_t::if_pid and its source and
+ *                          destination address set.
+ * @param[in] pkt           The fragment to relay.
+ * @param[in] frag_size     The fragment's size.
+ * @param[in] offset        The fragment's offset.
+ *
+ * @return  true, if the fragment was relayed or dropped. @p pkt was released.
+ * @return  false, if the fragment needs to be reassembled. @p pkt was not
+ *          touched.
+ *
+ * @internal
+ */
+bool vrb_forward(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
+                 size_t frag_size, size_t offset);
+
+/**
+ * @brief   Adds a new entry to the virtual reassembly buffer.
+ *
+ * A new datagram tag towards the next hop is generated for the entry.
+ *
+ * @param[in] src           Link-layer address of the previous hop.
+ * @param[in] src_len       Length of @p src. Must not exceed
+ *                          @ref RBUF_L2ADDR_MAX_LEN.
+ * @param[in] datagram_size The datagram's size.
+ * @param[in] tag           The datagram's tag.
+ * @param[in] out_iface     Interface to the next hop.
+ * @param[in] out_dst       Link-layer address of the next hop.
+ * @param[in] out_dst_len   Length of @p out_dst. Must not exceed
+ *                          @ref RBUF_L2ADDR_MAX_LEN.
+ *
+ * @return  The new entry.
+ * @return  NULL, if the virtual reassembly buffer is full.
+ *
+ * @internal
+ */
+vrb_t *vrb_add(const void *src, size_t src_len, size_t datagram_size,
+               uint16_t tag, kernel_pid_t out_iface, const void *out_dst,
+               size_t out_dst_len);
+
+/**
+ * @brief   Looks up the entry of a datagram.
+ *
+ * @param[in] src           Link-layer address of the previous hop.
+ * @param[in] src_len       Length of @p src.
+ * @param[in] datagram_size The datagram's size.
+ * @param[in] tag           The datagram's tag.
+ *
+ * @return  The entry of the datagram.
+ * @return  NULL, if there is none.
+ *
+ * @internal
+ */
+vrb_t *vrb_get(const void *src, size_t src_len, size_t datagram_size,
+               uint16_t tag);
+
+/**
+ * @brief   Removes entries that did not relay a fragment for
+ *          @ref VRB_TIMEOUT.
+ *
+ * @internal
+ */
+void vrb_gc(void);
+
+/**
+ * @brief   Removes an entry from the virtual reassembly buffer.
+ *
+ * @param[in] entry     An entry of the virtual reassembly buffer.
+ *
+ * @internal
+ */
+static inline void vrb_rm(vrb_t *entry)
+{
+    entry->datagram_size = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_SIXLOWPAN_FRAG_VRB_H */
+/** @} */
@@ -24,6 +24,10 @@
 #include "net/gnrc/sixlowpan/netif.h"
 #include "net/sixlowpan.h"
 
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -34,23 +38,33 @@
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 
-#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
-static gnrc_sixlowpan_msg_frag_t fragment_msg = {KERNEL_PID_UNDEF, NULL, 0, 0};
-#endif
-
+#ifndef MODULE_GNRC_SINGLE_THREAD
 #if ENABLE_DEBUG
 static char _stack[GNRC_SIXLOWPAN_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_SIXLOWPAN_STACK_SIZE];
 #endif
+#endif
 
 
 /* handles GNRC_NETAPI_MSG_TYPE_RCV commands */
 static void _receive(gnrc_pktsnip_t *pkt);
 /* handles GNRC_NETAPI_MSG_TYPE_SND commands */
 static void _send(gnrc_pktsnip_t *pkt);
+/* handles GNRC_NETAPI_MSG_TYPE_RCV and GNRC_NETAPI_MSG_TYPE_SND commands */
+static void _handle_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt);
+/* handles all other messages to 6LoWPAN, returns false for unknown types */
+static bool _handle_msg(msg_t *msg);
+#ifdef MODULE_GNRC_SINGLE_THREAD
+static gnrc_single_thread_layer_t _layer = {
+    .type = GNRC_NETTYPE_SIXLOWPAN,
+    .handle_pkt = _handle_pkt,
+    .handle_msg = _handle_msg,
+};
+#else
 /* Main event loop for 6LoWPAN */
 static void *_event_loop(void *args);
+#endif
 
 kernel_pid_t gnrc_sixlowpan_init(void)
 {
@@ -58,8 +72,12 @@ kernel_pid_t gnrc_sixlowpan_init(void)
         return _pid;
     }
 
+#ifdef MODULE_GNRC_SINGLE_THREAD
+    _pid = gnrc_single_thread_add(&_layer);
+#else
     _pid = thread_create(_stack, sizeof(_stack), GNRC_SIXLOWPAN_PRIO,
                          THREAD_CREATE_STACKTEST, _event_loop, NULL, "6lo");
+#endif
 
     return _pid;
 }
@@ -272,27 +290,13 @@ static void _send(gnrc_pktsnip_t *pkt)
         return;
     }
 #ifdef MODULE_GNRC_SIXLOWPAN_FRAG
-    else if (fragment_msg.pkt != NULL) {
-        DEBUG("6lo: Fragmentation already ongoing. Dropping packet\n");
-        gnrc_pktbuf_release(pkt2);
-        return;
-    }
     else if (datagram_size <= SIXLOWPAN_FRAG_MAX_LEN) {
         DEBUG("6lo: Send fragmented (%u > %" PRIu16 ")\n",
               (unsigned int)datagram_size, iface->max_frag_size);
-        msg_t msg;
-
-        fragment_msg.pid = hdr->if_pid;
-        fragment_msg.pkt = pkt2;
-        fragment_msg.datagram_size = datagram_size;
-        /* Sending the first fragment has an offset==0 */
-        fragment_msg.offset = 0;
-
-        /* set the outgoing message's fields */
-        msg.type = GNRC_SIXLOWPAN_MSG_FRAG_SND;
-        msg.content.ptr = &fragment_msg;
-        /* send message to self */
-        msg_send_to_self(&msg);
+        if (!gnrc_sixlowpan_frag_enqueue(hdr->if_pid, pkt2, datagram_size)) {
+            DEBUG("6lo: Fragmentation queue full. Dropping packet\n");
+            gnrc_pktbuf_release(pkt2);
+        }
     }
     else {
         DEBUG("6lo: packet too big (%u > %" PRIu16 ")\n",
@@ -307,6 +311,44 @@ static void _send(gnrc_pktsnip_t *pkt)
 #endif
 }
 
+static void _handle_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt)
+{
+    switch (cmd) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_RCV received\n");
+            _receive(pkt);
+            break;
+
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_SND received\n");
+            _send(pkt);
+            break;
+
+        default:
+            gnrc_pktbuf_release(pkt);
+            break;
+    }
+}
+
+static bool _handle_msg(msg_t *msg)
+{
+    switch (msg->type) {
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
+        case GNRC_SIXLOWPAN_MSG_FRAG_SND:
+            DEBUG("6lo: send fragmented event received\n");
+            gnrc_sixlowpan_frag_send((kernel_pid_t)msg->content.value);
+            return true;
+        case GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF:
+            DEBUG("6lo: garbage collect reassembly buffer event received\n");
+            gnrc_sixlowpan_frag_gc_rbuf();
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *args)
 {
     msg_t msg, reply, msg_q[GNRC_SIXLOWPAN_MSG_QUEUE_SIZE];
@@ -329,13 +371,8 @@ static void *_event_loop(void *args)
 
         switch (msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_RCV received\n");
-                _receive(msg.content.ptr);
-                break;
-
             case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("6lo: GNRC_NETDEV_MSG_TYPE_SND received\n");
-                _send(msg.content.ptr);
+                _handle_pkt(msg.type, msg.content.ptr);
                 break;
 
             case GNRC_NETAPI_MSG_TYPE_GET:
@@ -344,20 +381,17 @@ static void *_event_loop(void *args)
                 reply.content.value = -ENOTSUP;
                 msg_reply(&msg, &reply);
                 break;
-#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
-            case GNRC_SIXLOWPAN_MSG_FRAG_SND:
-                DEBUG("6lo: send fragmented event received\n");
-                gnrc_sixlowpan_frag_send(msg.content.ptr);
-                break;
-#endif
 
             default:
-                DEBUG("6lo: operation not supported\n");
+                if (!_handle_msg(&msg)) {
+                    DEBUG("6lo: operation not supported\n");
+                }
                 break;
         }
     }
 
     return NULL;
 }
+#endif
 
 /** @} */
@@ -30,6 +30,11 @@
 
 #include "net/gnrc/sixlowpan/iphc.h"
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+#include "hashes.h"
+#include "xtimer.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -89,6 +94,51 @@
 #define NHC_UDP_8BIT_PORT           (0xF000)
 #define NHC_UDP_8BIT_MASK           (0xFF00)
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+/* dispatch, CID extension, TF, NH, HL, source, destination, NHC ID */
+#define IPHC_CACHE_HDR_LEN          (SIXLOWPAN_IPHC_HDR_LEN + SIXLOWPAN_IPHC_CID_EXT_LEN + \
+                                     4 + 1 + 1 + (2 * sizeof(ipv6_addr_t)) + 1)
+/* ports and checksum */
+#define IPHC_CACHE_NHC_LEN          (sizeof(udp_hdr_t) - 2)
+
+/**
+ * @brief   Header fields that determine the compressed headers of a flow
+ */
+typedef struct {
+    ipv6_addr_t src;                /**< source address */
+    ipv6_addr_t dst;                /**< destination address */
+    uint32_t v_tc_fl;               /**< version, traffic class, and flow label */
+    network_uint16_t src_port;      /**< UDP source port */
+    network_uint16_t dst_port;      /**< UDP destination port */
+    kernel_pid_t if_pid;            /**< interface */
+    uint8_t nh;                     /**< next header */
+    uint8_t hl;                     /**< hop limit */
+    uint8_t src_l2addr[8];          /**< link-layer source address */
+    uint8_t dst_l2addr[8];          /**< link-layer destination address */
+    uint8_t src_l2addr_len;         /**< length of link-layer source address */
+    uint8_t dst_l2addr_len;         /**< length of link-layer destination address */
+} _iphc_flow_t;
+
+/**
+ * @brief   Compressed headers of a flow
+ */
+typedef struct {
+    _iphc_flow_t flow;              /**< the flow */
+    uint64_t expires;               /**< time in microseconds a context used
+                                     *   for compression expires */
+    unsigned ctx_gen;               /**< context buffer generation the headers
+                                     *   were compressed with */
+    uint8_t hdr[IPHC_CACHE_HDR_LEN];    /**< IPHC dispatch and inline fields */
+    uint8_t nhc[IPHC_CACHE_NHC_LEN];    /**< inline fields of NHC UDP header */
+    uint8_t hdr_len;                /**< length of _iphc_cache_t::hdr,
+                                     *   0 if entry is unused */
+    uint8_t nhc_len;                /**< length of _iphc_cache_t::nhc
+                                     *   including the checksum, 0 without NHC */
+} _iphc_cache_t;
+
+static _iphc_cache_t _iphc_cache[GNRC_SIXLOWPAN_IPHC_CACHE_SIZE];
+#endif
+
 static inline bool _context_overlaps_iid(gnrc_sixlowpan_ctx_t *ctx,
                                          ipv6_addr_t *addr,
                                          eui64_t *iid)
@@ -520,6 +570,21 @@ size_t gnrc_sixlowpan_iphc_decode(gnrc_pktsnip_t **dec_hdr, gnrc_pktsnip_t *pkt,
 }
 
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+/* removes the space the NHC UDP header saved in front of the UDP header */
+inline static void iphc_nhc_udp_shrink(gnrc_pktsnip_t *udp, size_t nhc_len)
+{
+    uint8_t *udp_data = udp->data;
+
+    /* In case payload is in this snip (e.g. a forwarded packet):
+     * move data to right place */
+    size_t diff = sizeof(udp_hdr_t) - nhc_len;
+    for (size_t i = nhc_len; i < (udp->size - diff); i++) {
+      udp_data[i] = udp_data[i + diff];
+    }
+    /* NOTE: gnrc_pktbuf_realloc_data overflow if (udp->size - diff) < 4 */
+    gnrc_pktbuf_realloc_data(udp, (udp->size - diff));
+}
+
 inline static size_t iphc_nhc_udp_encode(gnrc_pktsnip_t *udp, ipv6_hdr_t *ipv6_hdr)
 {
     udp_hdr_t *udp_hdr = udp->data;
@@ -568,19 +633,144 @@ inline static size_t iphc_nhc_udp_encode(gnrc_pktsnip_t *udp, ipv6_hdr_t *ipv6_h
     /* Set UDP header ID (rfc6282#section-5). */
     ipv6_hdr->nh |= NHC_UDP_ID;
 
-    /* In case payload is in this snip (e.g. a forwarded packet):
-     * move data to right place */
-    size_t diff = sizeof(udp_hdr_t) - nhc_len;
-    for (size_t i = nhc_len; i < (udp->size - diff); i++) {
-      udp_data[i] = udp_data[i + diff];
-    }
-    /* NOTE: gnrc_pktbuf_realloc_data overflow if (udp->size - diff) < 4 */
-    gnrc_pktbuf_realloc_data(udp, (udp->size - diff));
+    iphc_nhc_udp_shrink(udp, nhc_len);
 
     return nhc_len;
 }
 #endif
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+static void _iphc_flow_init(_iphc_flow_t *flow, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    ipv6_hdr_t *ipv6_hdr = pkt->next->data;
+
+    /* compared with memcmp(), so clear padding as well */
+    memset(flow, 0, sizeof(_iphc_flow_t));
+    flow->src = ipv6_hdr->src;
+    flow->dst = ipv6_hdr->dst;
+    flow->v_tc_fl = ipv6_hdr->v_tc_fl.u32;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if ((ipv6_hdr->nh == PROTNUM_UDP) && (pkt->next->next != NULL) &&
+        (pkt->next->next->size >= sizeof(udp_hdr_t))) {
+        udp_hdr_t *udp_hdr = pkt->next->next->data;
+
+        flow->src_port = udp_hdr->src_port;
+        flow->dst_port = udp_hdr->dst_port;
+    }
+#endif
+    flow->if_pid = netif_hdr->if_pid;
+    flow->nh = ipv6_hdr->nh;
+    flow->hl = ipv6_hdr->hl;
+    if (netif_hdr->src_l2addr_len <= sizeof(flow->src_l2addr)) {
+        flow->src_l2addr_len = netif_hdr->src_l2addr_len;
+        memcpy(flow->src_l2addr, gnrc_netif_hdr_get_src_addr(netif_hdr),
+               netif_hdr->src_l2addr_len);
+    }
+    if (netif_hdr->dst_l2addr_len <= sizeof(flow->dst_l2addr)) {
+        flow->dst_l2addr_len = netif_hdr->dst_l2addr_len;
+        memcpy(flow->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+               netif_hdr->dst_l2addr_len);
+    }
+}
+
+static inline _iphc_cache_t *_iphc_cache_entry(const _iphc_flow_t *flow)
+{
+    return &_iphc_cache[djb2_hash((const uint8_t *)flow, sizeof(_iphc_flow_t)) %
+                        GNRC_SIXLOWPAN_IPHC_CACHE_SIZE];
+}
+
+/* returns 1 if pkt was compressed from the cache, 0 if flow is not cached,
+ * and -1 on error */
+static int _iphc_cache_encode(gnrc_pktsnip_t *pkt, const _iphc_flow_t *flow)
+{
+    _iphc_cache_t *entry = _iphc_cache_entry(flow);
+    gnrc_pktsnip_t *dispatch;
+
+    if ((entry->hdr_len == 0) ||
+        (memcmp(&entry->flow, flow, sizeof(_iphc_flow_t)) != 0) ||
+        (entry->ctx_gen != gnrc_sixlowpan_ctx_gen())) {
+        return 0;
+    }
+    if ((entry->expires != UINT64_MAX) && (xtimer_now_usec64() >= entry->expires)) {
+        DEBUG("6lo iphc: context of cached flow expired\n");
+        return 0;
+    }
+    dispatch = gnrc_pktbuf_add(NULL, entry->hdr, entry->hdr_len,
+                               GNRC_NETTYPE_SIXLOWPAN);
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        return -1;
+    }
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (entry->nhc_len > 0) {
+        gnrc_pktsnip_t *udp = pkt->next->next;
+        uint8_t *udp_data = udp->data;
+        network_uint16_t checksum = ((udp_hdr_t *)udp->data)->checksum;
+
+        /* only the checksum differs between packets of the flow */
+        memcpy(udp_data, entry->nhc, entry->nhc_len - sizeof(checksum));
+        udp_data[entry->nhc_len - 2] = checksum.u8[0];
+        udp_data[entry->nhc_len - 1] = checksum.u8[1];
+        iphc_nhc_udp_shrink(udp, entry->nhc_len);
+    }
+#endif
+
+    /* remove IPv6 header */
+    pkt = gnrc_pktbuf_remove_snip(pkt, pkt->next);
+
+    /* insert dispatch into packet */
+    dispatch->next = pkt->next;
+    pkt->next = dispatch;
+
+    return 1;
+}
+
+static void _iphc_cache_add(const _iphc_flow_t *flow, unsigned ctx_gen,
+                            uint16_t ctx_ltime, gnrc_pktsnip_t *dispatch)
+{
+    _iphc_cache_t *entry = _iphc_cache_entry(flow);
+
+    entry->flow = *flow;
+    entry->ctx_gen = ctx_gen;
+    entry->expires = UINT64_MAX;
+    if (ctx_ltime < UINT16_MAX) {
+        entry->expires = xtimer_now_usec64() +
+                         ((uint64_t)ctx_ltime * 60 * US_PER_SEC);
+    }
+    memcpy(entry->hdr, dispatch->data, dispatch->size);
+    entry->hdr_len = dispatch->size;
+    entry->nhc_len = 0;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (((entry->hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH) != 0) &&
+        (dispatch->next != NULL)) {
+        uint8_t nhc_id = entry->hdr[entry->hdr_len - 1];
+        size_t nhc_len;
+
+        switch (nhc_id & NHC_UDP_PP_MASK) {
+            case NHC_UDP_SD_ELIDED:
+                nhc_len = 3;
+                break;
+            case NHC_UDP_S_INLINE:
+            case NHC_UDP_D_INLINE:
+                nhc_len = 5;
+                break;
+            default:
+                nhc_len = 6;
+                break;
+        }
+        memcpy(entry->nhc, dispatch->next->data, nhc_len);
+        entry->nhc_len = nhc_len;
+    }
+#endif
+}
+
+void gnrc_sixlowpan_iphc_cache_flush(void)
+{
+    memset(_iphc_cache, 0, sizeof(_iphc_cache));
+}
+#endif
+
 bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
 {
     gnrc_netif_hdr_t *netif_hdr = pkt->data;
@@ -589,8 +779,27 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
     uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
     bool addr_comp = false, nhc_comp = false;
     gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch = gnrc_pktbuf_add(NULL, NULL, pkt->next->size,
-                                               GNRC_NETTYPE_SIXLOWPAN);
+    gnrc_pktsnip_t *dispatch;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+    _iphc_flow_t flow;
+    /* read generation before the lookups, so a concurrent change of a
+     * context invalidates the new entry */
+    unsigned ctx_gen = gnrc_sixlowpan_ctx_gen();
+    uint16_t ctx_ltime = UINT16_MAX;
+
+    _iphc_flow_init(&flow, pkt);
+    switch (_iphc_cache_encode(pkt, &flow)) {
+        case 1:
+            return true;
+        case -1:
+            return false;
+        default:
+            break;
+    }
+#endif
+
+    dispatch = gnrc_pktbuf_add(NULL, NULL, pkt->next->size,
+                               GNRC_NETTYPE_SIXLOWPAN);
 
     if (dispatch == NULL) {
         DEBUG("6lo iphc: error allocating dispatch space\n");
@@ -828,6 +1037,9 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
                 memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u16 + 6, 4);
                 inline_pos += 4;
                 addr_comp = true;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+                ctx_ltime = ctx->ltime;
+#endif
             }
         }
     }
@@ -892,6 +1104,16 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
     dispatch->next = pkt->next;
     pkt->next = dispatch;
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+    if ((src_ctx != NULL) && (src_ctx->ltime < ctx_ltime)) {
+        ctx_ltime = src_ctx->ltime;
+    }
+    if ((dst_ctx != NULL) && (dst_ctx->ltime < ctx_ltime)) {
+        ctx_ltime = dst_ctx->ltime;
+    }
+    _iphc_cache_add(&flow, ctx_gen, ctx_ltime, dispatch);
+#endif
+
     return true;
 }
 
@@ -119,11 +119,16 @@ void gnrc_sixlowpan_nd_uc_rtr_sol(gnrc_ipv6_nc_t *nce)
 }
 
 kernel_pid_t gnrc_sixlowpan_nd_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len,
-                                               kernel_pid_t iface, ipv6_addr_t *dst)
+                                               kernel_pid_t iface, ipv6_addr_t *dst,
+                                               gnrc_ipv6_nc_t **nce)
 {
     ipv6_addr_t *next_hop = NULL;
     gnrc_ipv6_nc_t *nc_entry = NULL;
 
+    if (nce != NULL) {
+        *nce = NULL;
+    }
+
 #ifdef MODULE_FIB
     kernel_pid_t fib_iface;
     ipv6_addr_t next_hop_actual;    /* FIB copies address into this variable */
@@ -224,6 +229,9 @@ kernel_pid_t gnrc_sixlowpan_nd_next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_
             gnrc_ndp_internal_set_state(nc_entry, GNRC_IPV6_NC_STATE_DELAY);
         }
     }
+    if (nce != NULL) {
+        *nce = nc_entry;
+    }
     return gnrc_ipv6_nc_get_l2_addr(l2addr, l2addr_len, nc_entry);
 }
 
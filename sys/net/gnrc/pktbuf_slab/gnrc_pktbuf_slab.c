@@ -0,0 +1,618 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_pktbuf_slab
+ * @{
+ *
+ * @file
+ * @brief   Size-class (slab) packet buffer implementation
+ *
+ * Every size class is an array of equally sized objects. Unused objects are
+ * kept in a singly linked free list that is stored inside the objects
+ * themselves. As gnrc_pktbuf_mark() splits data in place, an object can be
+ * referenced by several snips, so a reference counter is kept per object.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "mutex.h"
+#include "utlist.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/pktbuf_slab.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define _ALIGNMENT_MASK    (sizeof(void *) - 1)
+#define _ALIGN(size)       (((size) + _ALIGNMENT_MASK) & ~(_ALIGNMENT_MASK))
+#define _SNIP_SIZE         (_ALIGN(sizeof(gnrc_pktsnip_t)))
+
+/* declares the pool and the reference counters of a class, uintptr_t is used
+ * to get pointer alignment; obj_size is rounded up, so every object is
+ * aligned as well */
+#define _SLAB_MEM(n, obj_size, obj_numof) \
+    static uintptr_t _pool ## n[((obj_numof) * _ALIGN(obj_size)) / sizeof(uintptr_t)]; \
+    static uint8_t _refs ## n[obj_numof]
+
+#define _SLAB(n, obj_size, obj_numof) \
+    { (uint8_t *)_pool ## n, _refs ## n, NULL, \
+      { .size = _ALIGN(obj_size), .numof = (obj_numof) } }
+
+typedef struct _free {
+    struct _free *next;
+} _free_t;
+
+typedef struct {
+    uint8_t *pool;
+    uint8_t *refs;
+    _free_t *free;
+    gnrc_pktbuf_slab_stats_t stats;
+} _slab_t;
+
+_SLAB_MEM(0, _SNIP_SIZE, GNRC_PKTBUF_SLAB_SNIP_NUMOF);
+_SLAB_MEM(1, GNRC_PKTBUF_SLAB_SIZE_1, GNRC_PKTBUF_SLAB_NUMOF_1);
+_SLAB_MEM(2, GNRC_PKTBUF_SLAB_SIZE_2, GNRC_PKTBUF_SLAB_NUMOF_2);
+_SLAB_MEM(3, GNRC_PKTBUF_SLAB_SIZE_3, GNRC_PKTBUF_SLAB_NUMOF_3);
+_SLAB_MEM(4, GNRC_PKTBUF_SLAB_SIZE_4, GNRC_PKTBUF_SLAB_NUMOF_4);
+
+static _slab_t _slabs[GNRC_PKTBUF_SLAB_CLASSES] = {
+    _SLAB(0, _SNIP_SIZE, GNRC_PKTBUF_SLAB_SNIP_NUMOF),
+    _SLAB(1, GNRC_PKTBUF_SLAB_SIZE_1, GNRC_PKTBUF_SLAB_NUMOF_1),
+    _SLAB(2, GNRC_PKTBUF_SLAB_SIZE_2, GNRC_PKTBUF_SLAB_NUMOF_2),
+    _SLAB(3, GNRC_PKTBUF_SLAB_SIZE_3, GNRC_PKTBUF_SLAB_NUMOF_3),
+    _SLAB(4, GNRC_PKTBUF_SLAB_SIZE_4, GNRC_PKTBUF_SLAB_NUMOF_4),
+};
+
+/* first class used for packet data */
+#define _DATA_CLASS        (1U)
+#define _MAX_DATA_SIZE     (_ALIGN(GNRC_PKTBUF_SLAB_SIZE_4))
+
+static mutex_t _mutex = MUTEX_INIT;
+
+/* internal gnrc_pktbuf functions */
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type);
+
+static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
+                                void *data, size_t size, gnrc_nettype_t type)
+{
+    pkt->next = next;
+    pkt->data = data;
+    pkt->size = size;
+    pkt->type = type;
+    pkt->users = 1;
+#ifdef MODULE_GNRC_NETERR
+    pkt->err_sub = KERNEL_PID_UNDEF;
+#endif
+}
+
+static inline size_t _slab_mem_size(const _slab_t *slab)
+{
+    return (size_t)slab->stats.size * slab->stats.numof;
+}
+
+/* returns the class containing ptr and the index of the object in *idx */
+static _slab_t *_slab_find(const void *ptr, unsigned *idx)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _slab_t *slab = &_slabs[i];
+        size_t offset = (size_t)((const uint8_t *)ptr - slab->pool);
+
+        if (((const uint8_t *)ptr >= slab->pool) &&
+            (offset < _slab_mem_size(slab))) {
+            *idx = offset / slab->stats.size;
+            return slab;
+        }
+    }
+    return NULL;
+}
+
+static void *_slab_alloc(size_t size, unsigned first)
+{
+    _slab_t *fit = NULL;
+
+    for (unsigned i = first; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _slab_t *slab = &_slabs[i];
+
+        if (size > slab->stats.size) {
+            continue;
+        }
+        if (fit == NULL) {
+            fit = slab;
+        }
+        if (slab->free != NULL) {
+            _free_t *obj = slab->free;
+            unsigned idx = ((uint8_t *)obj - slab->pool) / slab->stats.size;
+
+            slab->free = obj->next;
+            slab->refs[idx] = 1;
+            if (++slab->stats.used > slab->stats.max_used) {
+                slab->stats.max_used = slab->stats.used;
+            }
+            slab->stats.allocs++;
+            slab->stats.req_bytes += size;
+            if (slab != fit) {
+                fit->stats.fallbacks++;
+            }
+            return obj;
+        }
+    }
+    DEBUG("pktbuf: no object of size %u left\n", (unsigned)size);
+    if (fit != NULL) {
+        fit->stats.fails++;
+    }
+    return NULL;
+}
+
+/* takes another reference to the object containing ptr */
+static void _slab_ref(void *ptr)
+{
+    unsigned idx;
+    _slab_t *slab = _slab_find(ptr, &idx);
+
+    assert(slab != NULL);
+    assert(slab->refs[idx] < UINT8_MAX);
+    slab->refs[idx]++;
+}
+
+static void _slab_free(void *ptr)
+{
+    unsigned idx;
+    _slab_t *slab;
+
+    if ((ptr == NULL) || ((slab = _slab_find(ptr, &idx)) == NULL)) {
+        return;
+    }
+    assert(slab->refs[idx] > 0);
+    if (--slab->refs[idx] == 0) {
+        _free_t *obj = (_free_t *)(slab->pool + (idx * slab->stats.size));
+
+        obj->next = slab->free;
+        slab->free = obj;
+        slab->stats.used--;
+    }
+}
+
+/* number of bytes from ptr to the end of its object, if ptr is the only
+ * user of the object (0 otherwise) */
+static size_t _slab_room(void *ptr)
+{
+    unsigned idx;
+    _slab_t *slab = _slab_find(ptr, &idx);
+
+    if ((slab == NULL) || (slab->refs[idx] != 1)) {
+        return 0;
+    }
+    return (size_t)((slab->pool + ((idx + 1) * slab->stats.size)) -
+                    (uint8_t *)ptr);
+}
+
+void gnrc_pktbuf_init(void)
+{
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _slab_t *slab = &_slabs[i];
+        uint16_t size = slab->stats.size;
+        uint16_t numof = slab->stats.numof;
+
+        memset(&slab->stats, 0, sizeof(slab->stats));
+        slab->stats.size = size;
+        slab->stats.numof = numof;
+        memset(slab->refs, 0, numof);
+        slab->free = NULL;
+        /* build free list in reverse, so the first object is used first */
+        for (unsigned j = numof; j > 0; j--) {
+            _free_t *obj = (_free_t *)(slab->pool + ((j - 1) * size));
+
+            obj->next = slab->free;
+            slab->free = obj;
+        }
+    }
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
+                                gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+
+    if (size > _MAX_DATA_SIZE) {
+        DEBUG("pktbuf: size (%u) > GNRC_PKTBUF_SLAB_SIZE_4 (%u)\n",
+              (unsigned)size, (unsigned)_MAX_DATA_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(next, data, size, type);
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_reserve(size_t size, size_t hdr_size,
+                                    gnrc_nettype_t type)
+{
+    /* the header is split off in place anyway, but padding in front of the
+     * data keeps the payload behind it aligned */
+    size_t pad = (sizeof(void *) - (hdr_size & _ALIGNMENT_MASK)) & _ALIGNMENT_MASK;
+    gnrc_pktsnip_t *pkt;
+
+    if ((size == 0) || ((size + pad) > _MAX_DATA_SIZE)) {
+        DEBUG("pktbuf: size == 0 or size (%u) > GNRC_PKTBUF_SLAB_SIZE_4 (%u)\n",
+              (unsigned)size, (unsigned)_MAX_DATA_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(NULL, NULL, size + pad, type);
+    if (pkt != NULL) {
+        pkt->data = ((uint8_t *)pkt->data) + pad;
+        pkt->size = size;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *marked_snip;
+    void *new_data_marked;
+
+    mutex_lock(&_mutex);
+    if ((size == 0) || (pkt == NULL) || (size > pkt->size) || (pkt->data == NULL)) {
+        DEBUG("pktbuf: size == 0 (was %u) or pkt == NULL (was %p) or "
+              "size > pkt->size (was %u) or pkt->data == NULL (was %p)\n",
+              (unsigned)size, (void *)pkt, (pkt ? (unsigned)pkt->size : 0),
+              (pkt ? pkt->data : NULL));
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* create new snip descriptor for marked data */
+    marked_snip = _slab_alloc(sizeof(gnrc_pktsnip_t), 0);
+    if (marked_snip == NULL) {
+        DEBUG("pktbuf: could not allocate marked snip.\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* split data in place, both parts reference the same object */
+    new_data_marked = pkt->data;
+    if (pkt->size != size) {
+        pkt->data = ((uint8_t *)pkt->data) + size;
+        _slab_ref(new_data_marked);
+    }
+    else {
+        pkt->data = NULL;
+    }
+    pkt->size -= size;
+    _set_pktsnip(marked_snip, pkt->next, new_data_marked, size, type);
+    pkt->next = marked_snip;
+    mutex_unlock(&_mutex);
+    return marked_snip;
+}
+
+int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
+{
+    mutex_lock(&_mutex);
+    assert(pkt != NULL);
+    if (size == pkt->size) {
+        /* nothing to do */
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    if (size == 0) {
+        _slab_free(pkt->data);
+        pkt->data = NULL;
+    }
+    else if ((pkt->data == NULL) ||
+             ((size > pkt->size) && (size > _slab_room(pkt->data)))) {
+        void *new_data = (size <= _MAX_DATA_SIZE) ?
+                         _slab_alloc(size, _DATA_CLASS) : NULL;
+
+        if (new_data == NULL) {
+            DEBUG("pktbuf: error allocating new data section\n");
+            mutex_unlock(&_mutex);
+            return ENOMEM;
+        }
+        if (pkt->data != NULL) {
+            memcpy(new_data, pkt->data, (pkt->size < size) ? pkt->size : size);
+        }
+        _slab_free(pkt->data);
+        pkt->data = new_data;
+    }
+    /* otherwise the data still fits its object: shrink or grow in place */
+    pkt->size = size;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        pkt->users += num;
+        pkt = pkt->next;
+    }
+    mutex_unlock(&_mutex);
+}
+
+static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    while (pkt) {
+        gnrc_pktsnip_t *tmp;
+        tmp = pkt->next;
+        if (pkt->users == 1) {
+            pkt->users = 0; /* not necessary but to be on the safe side */
+            _slab_free(pkt->data);
+            _slab_free(pkt);
+        }
+        else {
+            pkt->users--;
+        }
+        DEBUG("pktbuf: report status code %" PRIu32 "\n", err);
+        gnrc_neterr_report(pkt, err);
+        pkt = tmp;
+    }
+}
+
+void gnrc_pktbuf_release_error(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    mutex_lock(&_mutex);
+    _release_error_locked(pkt, err);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    if ((pkt == NULL) || (pkt->size == 0)) {
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->users > 1) {
+        gnrc_pktsnip_t *new;
+        new = _create_snip(pkt->next, pkt->data, pkt->size, pkt->type);
+        if (new != NULL) {
+            pkt->users--;
+        }
+        mutex_unlock(&_mutex);
+        return new;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_get_iovec(gnrc_pktsnip_t *pkt, size_t *len)
+{
+    size_t length;
+    gnrc_pktsnip_t *head;
+    struct iovec *vec;
+
+    assert(len != NULL);
+    if (pkt == NULL) {
+        *len = 0;
+        return NULL;
+    }
+
+    /* count the number of snips in the packet and allocate the IOVEC */
+    length = gnrc_pkt_count(pkt);
+    head = gnrc_pktbuf_add(pkt, NULL, (length * sizeof(struct iovec)),
+                           GNRC_NETTYPE_IOVEC);
+    if (head == NULL) {
+        *len = 0;
+        return NULL;
+    }
+
+    assert(head->data != NULL);
+    vec = (struct iovec *)(head->data);
+    /* fill the IOVEC */
+    while (pkt != NULL) {
+        vec->iov_base = pkt->data;
+        vec->iov_len = pkt->size;
+        ++vec;
+        pkt = pkt->next;
+    }
+    *len = length;
+    return head;
+}
+
+int gnrc_pktbuf_slab_get_stats(unsigned cls, gnrc_pktbuf_slab_stats_t *stats)
+{
+    if (cls >= GNRC_PKTBUF_SLAB_CLASSES) {
+        return -EINVAL;
+    }
+    mutex_lock(&_mutex);
+    *stats = _slabs[cls].stats;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_slab_print_stats(void)
+{
+    puts("class  size numof  used   max     allocs  fallbacks      fails  fill");
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        gnrc_pktbuf_slab_stats_t stats;
+        unsigned fill = 0;
+
+        gnrc_pktbuf_slab_get_stats(i, &stats);
+        if (stats.allocs > 0) {
+            fill = (unsigned)(((uint64_t)stats.req_bytes * 100) /
+                              ((uint64_t)stats.allocs * stats.size));
+        }
+        printf("%5u %5u %5u %5u %5u %10" PRIu32 " %10" PRIu32 " %10" PRIu32
+               " %4u%%\n", i, stats.size, stats.numof, stats.used,
+               stats.max_used, stats.allocs, stats.fallbacks, stats.fails,
+               fill);
+    }
+}
+
+#ifdef DEVELHELP
+void gnrc_pktbuf_stats(void)
+{
+    gnrc_pktbuf_slab_print_stats();
+}
+#endif
+
+#ifdef TEST_SUITES
+bool gnrc_pktbuf_is_empty(void)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        if (_slabs[i].stats.used > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gnrc_pktbuf_is_sane(void)
+{
+    /* Invariants of this implementation:
+     *  - all objects in a free list are inside their class' pool and aligned
+     *    to the object size
+     *  - forall objects in a free list: the reference counter is 0
+     *  - length of free list + used == numof
+     */
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _slab_t *slab = &_slabs[i];
+        unsigned free_num = 0;
+
+        for (_free_t *obj = slab->free; obj != NULL; obj = obj->next) {
+            size_t offset = (size_t)((uint8_t *)obj - slab->pool);
+
+            if (((uint8_t *)obj < slab->pool) ||
+                (offset >= _slab_mem_size(slab)) ||
+                ((offset % slab->stats.size) != 0) ||
+                (slab->refs[offset / slab->stats.size] != 0) ||
+                (++free_num > slab->stats.numof)) {
+                return false;
+            }
+        }
+        if ((free_num + slab->stats.used) != slab->stats.numof) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = _slab_alloc(sizeof(gnrc_pktsnip_t), 0);
+    void *_data = NULL;
+
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        return NULL;
+    }
+    if (size > 0) {
+        _data = _slab_alloc(size, _DATA_CLASS);
+        if (_data == NULL) {
+            DEBUG("pktbuf: error allocating data for new packet snip\n");
+            _slab_free(pkt);
+            return NULL;
+        }
+    }
+    _set_pktsnip(pkt, next, _data, size, type);
+    if (data != NULL) {
+        memcpy(_data, data, size);
+    }
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_remove_snip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *snip)
+{
+    LL_DELETE(pkt, snip);
+    snip->next = NULL;
+    gnrc_pktbuf_release(snip);
+
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_replace_snip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *old, gnrc_pktsnip_t *add)
+{
+    /* If add is a list we need to preserve its tail */
+    if (add->next != NULL) {
+        gnrc_pktsnip_t *tail = add->next;
+        gnrc_pktsnip_t *back;
+        LL_SEARCH_SCALAR(tail, back, next, NULL); /* find the last snip in add */
+        /* Replace old */
+        LL_REPLACE_ELEM(pkt, old, add);
+        /* and wire in the tail between */
+        back->next = add->next;
+        add->next = tail;
+    }
+    else {
+        /* add is a single element, has no tail, simply replace */
+        LL_REPLACE_ELEM(pkt, old, add);
+    }
+    old->next = NULL;
+    gnrc_pktbuf_release(old);
+
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_duplicate_upto(gnrc_pktsnip_t *pkt, gnrc_nettype_t type)
+{
+    mutex_lock(&_mutex);
+
+    bool is_shared = pkt->users > 1;
+    size_t size = gnrc_pkt_len_upto(pkt, type);
+
+    DEBUG("pktbuf: duplicating %d octets\n", (int) size);
+
+    gnrc_pktsnip_t *tmp;
+    gnrc_pktsnip_t *target = gnrc_pktsnip_search_type(pkt, type);
+    gnrc_pktsnip_t *next = (target == NULL) ? NULL : target->next;
+    gnrc_pktsnip_t *new = (size <= _MAX_DATA_SIZE) ?
+                          _create_snip(next, NULL, size, type) : NULL;
+
+    if (new == NULL) {
+        mutex_unlock(&_mutex);
+
+        return NULL;
+    }
+
+    /* copy payloads */
+    for (tmp = pkt; tmp != NULL; tmp = tmp->next) {
+        uint8_t *dest = ((uint8_t *)new->data) + (size - tmp->size);
+
+        memcpy(dest, tmp->data, tmp->size);
+
+        size -= tmp->size;
+
+        if (tmp->type == type) {
+            break;
+        }
+    }
+
+    /* decrements reference counters */
+
+    if (target != NULL) {
+        target->next = NULL;
+    }
+
+    _release_error_locked(pkt, GNRC_NETERR_SUCCESS);
+
+    if (is_shared && (target != NULL)) {
+        target->next = next;
+    }
+
+    mutex_unlock(&_mutex);
+
+    return new;
+}
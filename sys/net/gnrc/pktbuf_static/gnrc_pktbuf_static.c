@@ -67,6 +67,25 @@ static inline size_t _align(size_t size)
     return (size + _ALIGNMENT_MASK) & ~(_ALIGNMENT_MASK);
 }
 
+/* offset of ptr to the start of its chunk: data split off in place or
+ * reserved by gnrc_pktbuf_reserve() does not need to be aligned */
+static inline size_t _align_offset(void *ptr)
+{
+    return (size_t)((uint8_t *)ptr - _pktbuf) & _ALIGNMENT_MASK;
+}
+
+/* data of pkt_size bytes can be split after size bytes without moving it if
+ * the split point is aligned and both resulting chunks fit an _unused_t
+ * marker for proper free */
+static inline bool _split_in_place(void *data, size_t size, size_t pkt_size)
+{
+    size_t offset = _align_offset(data);
+
+    return (((offset + size) & _ALIGNMENT_MASK) == 0) &&
+           ((offset + size) >= sizeof(_unused_t)) &&
+           ((pkt_size - size) >= sizeof(_unused_t));
+}
+
 static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
                                 void *data, size_t size, gnrc_nettype_t type)
 {
@@ -105,12 +124,31 @@ gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
     return pkt;
 }
 
+gnrc_pktsnip_t *gnrc_pktbuf_reserve(size_t size, size_t hdr_size,
+                                    gnrc_nettype_t type)
+{
+    /* padding in front of the data, so the byte behind the header is aligned */
+    size_t pad = (sizeof(void *) - (hdr_size & _ALIGNMENT_MASK)) & _ALIGNMENT_MASK;
+    gnrc_pktsnip_t *pkt;
+
+    if ((size == 0) || ((size + pad) > GNRC_PKTBUF_SIZE)) {
+        DEBUG("pktbuf: size == 0 or size (%u) > GNRC_PKTBUF_SIZE (%u)\n",
+              (unsigned)size, GNRC_PKTBUF_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(NULL, NULL, size + pad, type);
+    if (pkt != NULL) {
+        pkt->data = ((uint8_t *)pkt->data) + pad;
+        pkt->size = size;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
 gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
 {
     gnrc_pktsnip_t *marked_snip;
-    /* size required for chunk */
-    size_t required_new_size = (size < sizeof(_unused_t)) ?
-                               _align(sizeof(_unused_t)) : _align(size);
     void *new_data_marked;
 
     mutex_lock(&_mutex);
@@ -129,10 +167,9 @@ gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_
         mutex_unlock(&_mutex);
         return NULL;
     }
-    /* marked data would not fit _unused_t marker => move data around to allow
-     * for proper free */
-    if ((pkt->size != size) &&
-        ((size < required_new_size) || ((pkt->size - size) < sizeof(_unused_t)))) {
+    /* split point is not aligned or marked data would not fit _unused_t
+     * marker => move data around to allow for proper free */
+    if ((pkt->size != size) && !_split_in_place(pkt->data, size, pkt->size)) {
         void *new_data_rest;
         new_data_marked = _pktbuf_alloc(size);
         if (new_data_marked == NULL) {
@@ -170,13 +207,16 @@ gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_
 
 int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
 {
-    size_t aligned_size = (size < sizeof(_unused_t)) ?
-                          _align(sizeof(_unused_t)) : _align(size);
+    size_t offset, aligned_size;
 
     mutex_lock(&_mutex);
     assert(pkt != NULL);
     assert(((pkt->size == 0) && (pkt->data == NULL)) ||
            ((pkt->size > 0) && (pkt->data != NULL) && _pktbuf_contains(pkt->data)));
+    /* the chunk of the data starts offset bytes before pkt->data */
+    offset = (pkt->data != NULL) ? _align_offset(pkt->data) : 0;
+    aligned_size = ((size + offset) < sizeof(_unused_t)) ?
+                   _align(sizeof(_unused_t)) : _align(size + offset);
     /* new size and old size are equal */
     if (size == pkt->size) {
         /* nothing to do */
@@ -191,7 +231,7 @@ int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
     }
     /* if new size is bigger than old size */
     else if ((size > pkt->size) ||                          /* new size does not fit */
-        ((pkt->size - aligned_size) < sizeof(_unused_t))) { /* resulting hole would not fit marker */
+        ((pkt->size + offset - aligned_size) < sizeof(_unused_t))) { /* resulting hole would not fit marker */
         void *new_data = _pktbuf_alloc(size);
         if (new_data == NULL) {
             DEBUG("pktbuf: error allocating new data section\n");
@@ -204,9 +244,9 @@ int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
         _pktbuf_free(pkt->data, pkt->size);
         pkt->data = new_data;
     }
-    else if (_align(pkt->size) > aligned_size) {
-        _pktbuf_free(((uint8_t *)pkt->data) + aligned_size,
-                     pkt->size - aligned_size);
+    else if (_align(pkt->size + offset) > aligned_size) {
+        _pktbuf_free(((uint8_t *)pkt->data) - offset + aligned_size,
+                     pkt->size + offset - aligned_size);
     }
     pkt->size = size;
     mutex_unlock(&_mutex);
@@ -489,13 +529,17 @@ static inline _unused_t *_merge(_unused_t *a, _unused_t *b)
 
 static void _pktbuf_free(void *data, size_t size)
 {
-    size_t bytes_at_end;
-    _unused_t *new = (_unused_t *)data, *prev = NULL, *ptr = _first_unused;
+    size_t bytes_at_end, offset;
+    _unused_t *new, *prev = NULL, *ptr = _first_unused;
 
     if (!_pktbuf_contains(data)) {
         return;
     }
-    while (ptr && (((void *)ptr) < data)) {
+    /* data split off in place might not start at the beginning of its chunk */
+    offset = _align_offset(data);
+    new = (_unused_t *)(((uint8_t *)data) - offset);
+    size += offset;
+    while (ptr && (ptr < new)) {
         prev = ptr;
         ptr = ptr->next;
     }
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+
+#include "irq.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/single_thread.h"
+#include "utlist.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE & (GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE - 1)) != 0
+#error "GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE must be a power of 2"
+#endif
+
+/**
+ * @brief   Packet handed to a layer by another thread
+ */
+typedef struct {
+    gnrc_single_thread_layer_t *layer;  /**< the layer */
+    gnrc_pktsnip_t *pkt;                /**< the packet */
+    uint16_t cmd;                       /**< the netapi command */
+} _work_t;
+
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+
+#if ENABLE_DEBUG
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
+#else
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE];
+#endif
+
+static gnrc_single_thread_layer_t *_layers = NULL;
+
+/* work queue as ring buffer; head and tail only ever increase */
+static _work_t _work[GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE];
+static unsigned _work_head = 0, _work_tail = 0;
+
+static void _netreg_cb(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    gnrc_single_thread_layer_t *layer = ctx;
+    msg_t msg;
+    unsigned state;
+
+    if (sched_active_pid == _pid) {
+        /* run to completion */
+        layer->handle_pkt(cmd, pkt);
+        return;
+    }
+    state = irq_disable();
+    if ((_work_tail - _work_head) >= GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE) {
+        irq_restore(state);
+        DEBUG("gnrc_single_thread: work queue full, dropping packet\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    _work_t *work = &_work[_work_tail++ & (GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE - 1)];
+    work->layer = layer;
+    work->pkt = pkt;
+    work->cmd = cmd;
+    irq_restore(state);
+    msg.type = GNRC_SINGLE_THREAD_MSG_TYPE_WORK;
+    /* if the message queue is full, the network thread has messages to
+     * handle and empties the work queue afterwards anyway */
+    msg_try_send(&msg, _pid);
+}
+
+static void _run_work(void)
+{
+    while (1) {
+        _work_t work;
+        unsigned state = irq_disable();
+
+        if (_work_head == _work_tail) {
+            irq_restore(state);
+            return;
+        }
+        work = _work[_work_head++ & (GNRC_SINGLE_THREAD_WORK_QUEUE_SIZE - 1)];
+        irq_restore(state);
+        work.layer->handle_pkt(work.cmd, work.pkt);
+    }
+}
+
+static gnrc_single_thread_layer_t *_layer_of_pkt(gnrc_pktsnip_t *pkt)
+{
+    gnrc_single_thread_layer_t *layer;
+    gnrc_nettype_t type = pkt->type;
+
+    if ((type == GNRC_NETTYPE_NETIF) && (pkt->next != NULL)) {
+        type = pkt->next->type;
+    }
+    LL_SEARCH_SCALAR(_layers, layer, type, type);
+    return layer;
+}
+
+static void _handle_msg(msg_t *msg)
+{
+    gnrc_single_thread_layer_t *layer;
+
+    switch (msg->type) {
+        case GNRC_SINGLE_THREAD_MSG_TYPE_WORK:
+            /* work queue is emptied after every message */
+            break;
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            layer = _layer_of_pkt(msg->content.ptr);
+            if (layer == NULL) {
+                DEBUG("gnrc_single_thread: no layer for packet\n");
+                gnrc_pktbuf_release(msg->content.ptr);
+                break;
+            }
+            layer->handle_pkt(msg->type, msg->content.ptr);
+            break;
+        case GNRC_NETAPI_MSG_TYPE_GET:
+        case GNRC_NETAPI_MSG_TYPE_SET: {
+            msg_t reply;
+
+            DEBUG("gnrc_single_thread: reply to unsupported get/set\n");
+            reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+            reply.content.value = -ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
+        }
+        default:
+            LL_FOREACH(_layers, layer) {
+                if ((layer->handle_msg != NULL) && layer->handle_msg(msg)) {
+                    return;
+                }
+            }
+            DEBUG("gnrc_single_thread: operation not supported\n");
+            break;
+    }
+}
+
+static void *_event_loop(void *args)
+{
+    msg_t msg, msg_q[GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE];
+
+    (void)args;
+    msg_init_queue(msg_q, GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE);
+
+    /* start event loop */
+    while (1) {
+        DEBUG("gnrc_single_thread: waiting for incoming message.\n");
+        msg_receive(&msg);
+        _handle_msg(&msg);
+        _run_work();
+    }
+
+    return NULL;
+}
+
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer)
+{
+    if (_pid == KERNEL_PID_UNDEF) {
+        kernel_pid_t pid = thread_create(_stack, sizeof(_stack),
+                                         GNRC_SINGLE_THREAD_PRIO,
+                                         THREAD_CREATE_STACKTEST,
+                                         _event_loop, NULL, "gnrc");
+
+        if (pid < 0) {
+            return pid;
+        }
+        _pid = pid;
+    }
+    layer->cbd.cb = _netreg_cb;
+    layer->cbd.ctx = layer;
+    gnrc_netreg_entry_init_cb(&layer->netreg, GNRC_NETREG_DEMUX_CTX_ALL,
+                              &layer->cbd);
+    LL_APPEND(_layers, layer);
+    gnrc_netreg_register(layer->type, &layer->netreg);
+    return _pid;
+}
+
+/** @} */
@@ -40,18 +40,41 @@ extern "C" {
 #define SOCK_MBOX_SIZE      (8)         /**< Size for gnrc_sock_reg_t::mbox_queue */
 #endif
 
+/**
+ * @brief   Forward declaration
+ * @internal
+ */
+typedef struct gnrc_sock_reg gnrc_sock_reg_t;
+
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Event callback for a gnrc_sock_reg_t
+ * @internal
+ */
+typedef void (*gnrc_sock_reg_cb_t)(gnrc_sock_reg_t *reg,
+                                   sock_async_flags_t flags);
+#endif
+
 /**
  * @brief   sock @ref net_gnrc_netreg info
  * @internal
  */
-typedef struct gnrc_sock_reg {
+struct gnrc_sock_reg {
 #ifdef MODULE_GNRC_SOCK_CHECK_REUSE
     struct gnrc_sock_reg *next;         /**< list-like for internal storage */
 #endif
     gnrc_netreg_entry_t entry;          /**< @ref net_gnrc_netreg entry for mbox */
     mbox_t mbox;                        /**< @ref core_mbox target for the sock */
     msg_t mbox_queue[SOCK_MBOX_SIZE];   /**< queue for gnrc_sock_reg_t::mbox */
-} gnrc_sock_reg_t;
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+    /**
+     * @brief   @ref net_gnrc_netreg callback putting packets into
+     *          gnrc_sock_reg_t::mbox
+     */
+    gnrc_netreg_entry_cbd_t netreg_cb;
+    gnrc_sock_reg_cb_t async_cb;        /**< event callback of the sock type */
+#endif
+};
 
 /**
  * @brief   Raw IP sock type
@@ -62,6 +85,10 @@ struct sock_ip {
     sock_ip_ep_t local;                 /**< local end-point */
     sock_ip_ep_t remote;                /**< remote end-point */
     uint16_t flags;                     /**< option flags */
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+    sock_ip_cb_t async_cb;              /**< event callback */
+    void *async_cb_arg;                 /**< argument for sock_ip::async_cb */
+#endif
 };
 
 /**
@@ -73,6 +100,10 @@ struct sock_udp {
     sock_udp_ep_t local;                /**< local end-point */
     sock_udp_ep_t remote;               /**< remote end-point */
     uint16_t flags;                     /**< option flags */
+#if defined(MODULE_SOCK_ASYNC) || defined(DOXYGEN)
+    sock_udp_cb_t async_cb;             /**< event callback */
+    void *async_cb_arg;                 /**< argument for sock_udp::async_cb */
+#endif
 };
 
 #ifdef __cplusplus
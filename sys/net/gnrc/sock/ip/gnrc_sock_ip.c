@@ -18,6 +18,7 @@
 #include <errno.h>
 
 #include "byteorder.h"
+#include "irq.h"
 #include "net/af.h"
 #include "net/protnum.h"
 #include "net/gnrc/ipv6.h"
@@ -26,6 +27,17 @@
 
 #include "gnrc_sock_internal.h"
 
+#ifdef MODULE_SOCK_ASYNC
+static void _async_cb(gnrc_sock_reg_t *reg, sock_async_flags_t flags)
+{
+    sock_ip_t *sock = (sock_ip_t *)reg;
+
+    if (sock->async_cb != NULL) {
+        sock->async_cb(sock, flags, sock->async_cb_arg);
+    }
+}
+#endif
+
 int sock_ip_create(sock_ip_t *sock, const sock_ip_ep_t *local,
                    const sock_ip_ep_t *remote, uint8_t proto, uint16_t flags)
 {
@@ -53,6 +65,10 @@ int sock_ip_create(sock_ip_t *sock, const sock_ip_ep_t *local,
         }
         memcpy(&sock->remote, remote, sizeof(sock_ip_ep_t));
     }
+#ifdef MODULE_SOCK_ASYNC
+    sock->reg.async_cb = NULL;
+    sock->async_cb = NULL;
+#endif
     gnrc_sock_create(&sock->reg, GNRC_NETTYPE_IPV6,
                      proto);
     sock->flags = flags;
@@ -193,7 +209,35 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
     if (res <= 0) {
         return res;
     }
+#ifdef MODULE_SOCK_ASYNC
+    if ((sock != NULL) && (sock->async_cb != NULL)) {
+        sock->async_cb(sock, SOCK_ASYNC_MSG_SENT, sock->async_cb_arg);
+    }
+#endif
     return res;
 }
 
+#ifdef MODULE_SOCK_ASYNC
+void sock_ip_set_cb(sock_ip_t *sock, sock_ip_cb_t cb, void *arg)
+{
+    unsigned queued = 0;
+
+    assert(sock != NULL);
+    sock->reg.async_cb = NULL;
+    sock->async_cb = cb;
+    sock->async_cb_arg = arg;
+    if (cb != NULL) {
+        unsigned state = irq_disable();
+
+        queued = cib_avail(&sock->reg.mbox.cib);
+        sock->reg.async_cb = _async_cb;
+        irq_restore(state);
+    }
+    /* report what was received before the callback was set */
+    while (queued--) {
+        cb(sock, SOCK_ASYNC_MSG_RECV, arg);
+    }
+}
+#endif
+
 /** @} */
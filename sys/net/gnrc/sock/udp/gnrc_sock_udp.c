@@ -18,6 +18,7 @@
 #include <errno.h>
 
 #include "byteorder.h"
+#include "irq.h"
 #include "net/af.h"
 #include "net/protnum.h"
 #include "net/gnrc/ipv6.h"
@@ -83,6 +84,17 @@ static uint16_t _get_dyn_port(sock_udp_t *sock)
     return GNRC_SOCK_DYN_PORTRANGE_ERR;
 }
 
+#ifdef MODULE_SOCK_ASYNC
+static void _async_cb(gnrc_sock_reg_t *reg, sock_async_flags_t flags)
+{
+    sock_udp_t *sock = (sock_udp_t *)reg;
+
+    if (sock->async_cb != NULL) {
+        sock->async_cb(sock, flags, sock->async_cb_arg);
+    }
+}
+#endif
+
 int sock_udp_create(sock_udp_t *sock, const sock_udp_ep_t *local,
                     const sock_udp_ep_t *remote, uint16_t flags)
 {
@@ -125,6 +137,10 @@ int sock_udp_create(sock_udp_t *sock, const sock_udp_ep_t *local,
         }
         memcpy(&sock->remote, remote, sizeof(sock_udp_ep_t));
     }
+#ifdef MODULE_SOCK_ASYNC
+    sock->reg.async_cb = NULL;
+    sock->async_cb = NULL;
+#endif
     if (local != NULL) {
         /* listen only with local given */
         gnrc_sock_create(&sock->reg, GNRC_NETTYPE_UDP, local->port);
@@ -165,28 +181,30 @@ int sock_udp_get_remote(sock_udp_t *sock, sock_udp_ep_t *remote)
     return 0;
 }
 
-ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
-                      uint32_t timeout, sock_udp_ep_t *remote)
+/**
+ * @brief   Receives a UDP packet for @p sock and checks its remote
+ *
+ * @return  0 on success, @p pkt is the packet with the payload in its
+ *          first snip then.
+ * @return  negative errno on error.
+ */
+static int _recv(sock_udp_t *sock, gnrc_pktsnip_t **pkt, uint32_t timeout,
+                 sock_udp_ep_t *remote)
 {
-    gnrc_pktsnip_t *pkt, *udp;
+    gnrc_pktsnip_t *udp;
     udp_hdr_t *hdr;
     sock_ip_ep_t tmp;
     int res;
 
-    assert((sock != NULL) && (data != NULL) && (max_len > 0));
     if (sock->local.family == AF_UNSPEC) {
         return -EADDRNOTAVAIL;
     }
     tmp.family = sock->local.family;
-    res = gnrc_sock_recv((gnrc_sock_reg_t *)sock, &pkt, timeout, &tmp);
+    res = gnrc_sock_recv((gnrc_sock_reg_t *)sock, pkt, timeout, &tmp);
     if (res < 0) {
         return res;
     }
-    if (pkt->size > max_len) {
-        gnrc_pktbuf_release(pkt);
-        return -ENOBUFS;
-    }
-    udp = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_UDP);
+    udp = gnrc_pktsnip_search_type(*pkt, GNRC_NETTYPE_UDP);
     assert(udp);
     hdr = udp->data;
     if (remote != NULL) {
@@ -201,12 +219,54 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
         ((memcmp(&sock->remote.addr, &ipv6_addr_unspecified,
                  sizeof(ipv6_addr_t)) != 0) &&
          (memcmp(&sock->remote.addr, &tmp.addr, sizeof(ipv6_addr_t)) != 0)))) {
-        gnrc_pktbuf_release(pkt);
+        gnrc_pktbuf_release(*pkt);
         return -EPROTO;
     }
-    memcpy(data, pkt->data, pkt->size);
+    return 0;
+}
+
+ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
+                      uint32_t timeout, sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    size_t size;
+    int res;
+
+    assert((sock != NULL) && (data != NULL) && (max_len > 0));
+    if ((res = _recv(sock, &pkt, timeout, remote)) < 0) {
+        return res;
+    }
+    size = pkt->size;
+    if (size > max_len) {
+        gnrc_pktbuf_release(pkt);
+        return -ENOBUFS;
+    }
+    memcpy(data, pkt->data, size);
     gnrc_pktbuf_release(pkt);
-    return (int)pkt->size;
+    return (ssize_t)size;
+}
+
+ssize_t sock_udp_recv_buf(sock_udp_t *sock, void **data, void **buf_ctx,
+                          uint32_t timeout, sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    int res;
+
+    assert((sock != NULL) && (data != NULL) && (buf_ctx != NULL));
+    if ((res = _recv(sock, &pkt, timeout, remote)) < 0) {
+        return res;
+    }
+    /* the payload is already contiguous in the packet buffer */
+    *data = pkt->data;
+    *buf_ctx = pkt;
+    return (ssize_t)pkt->size;
+}
+
+void sock_udp_recv_buf_free(sock_udp_t *sock, void *buf_ctx)
+{
+    (void)sock;
+    assert(buf_ctx != NULL);
+    gnrc_pktbuf_release(buf_ctx);
 }
 
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
@@ -302,7 +362,38 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
     if (res > 0) {
         res -= sizeof(udp_hdr_t);
     }
+#ifdef MODULE_SOCK_ASYNC
+    if ((res >= 0) && (sock != NULL) && (sock->async_cb != NULL)) {
+        sock->async_cb(sock, SOCK_ASYNC_MSG_SENT, sock->async_cb_arg);
+    }
+#endif
     return res;
 }
 
+#ifdef MODULE_SOCK_ASYNC
+void sock_udp_set_cb(sock_udp_t *sock, sock_udp_cb_t cb, void *arg)
+{
+    unsigned queued = 0;
+
+    assert(sock != NULL);
+    sock->reg.async_cb = NULL;
+    sock->async_cb = cb;
+    sock->async_cb_arg = arg;
+    if (cb != NULL) {
+        unsigned state = irq_disable();
+
+        /* the mbox only exists once the sock is bound */
+        if (sock->local.family != AF_UNSPEC) {
+            queued = cib_avail(&sock->reg.mbox.cib);
+        }
+        sock->reg.async_cb = _async_cb;
+        irq_restore(state);
+    }
+    /* report what was received before the callback was set */
+    while (queued--) {
+        cb(sock, SOCK_ASYNC_MSG_RECV, arg);
+    }
+}
+#endif
+
 /** @} */
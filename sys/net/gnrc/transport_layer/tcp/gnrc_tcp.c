@@ -240,11 +240,33 @@ void gnrc_tcp_tcb_init(gnrc_tcp_tcb_t *tcb)
     tcb->rtt_var = RTO_UNINITIALIZED;
     tcb->srtt = RTO_UNINITIALIZED;
     tcb->rto = RTO_UNINITIALIZED;
+    tcb->rcv_buf_size = GNRC_TCP_RCV_BUF_SIZE;
     mbox_init(&(tcb->mbox), tcb->mbox_raw, GNRC_TCP_TCB_MBOX_SIZE);
     mutex_init(&(tcb->fsm_lock));
     mutex_init(&(tcb->function_lock));
 }
 
+int gnrc_tcp_tcb_set_rcv_buf_size(gnrc_tcp_tcb_t *tcb, const size_t size)
+{
+    assert(tcb != NULL);
+
+    if (size == 0 || size > GNRC_TCP_RCV_BUF_POOL_SIZE) {
+        return -EINVAL;
+    }
+
+    /* Lock the TCB for this function call */
+    mutex_lock(&(tcb->function_lock));
+
+    /* The buffer is allocated on open */
+    if (tcb->state != FSM_STATE_CLOSED) {
+        mutex_unlock(&(tcb->function_lock));
+        return -EISCONN;
+    }
+    tcb->rcv_buf_size = size;
+    mutex_unlock(&(tcb->function_lock));
+    return 0;
+}
+
 int gnrc_tcp_open_active(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
                          const uint8_t *target_addr, const uint16_t target_port,
                          const uint16_t local_port)
@@ -336,8 +358,9 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         _setup_timeout(&user_timeout, timeout_duration_us, _cb_mbox_put_msg, &user_timeout_arg);
     }
 
-    /* Loop until something was sent and acked */
-    while (ret == 0 || tcb->pkt_retransmit != NULL) {
+    /* Loop until something was sent. Acknowledgments are awaited only if the */
+    /* send window, the congestion window or the retransmission queue is full. */
+    while (ret == 0) {
         /* Check if the connections state is closed. If so, a reset was received */
         if (tcb->state == FSM_STATE_CLOSED) {
             ret = -ECONNRESET;
@@ -357,8 +380,11 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         }
 
         /* Try to send data in case there nothing has been sent and we are not probing */
-        if (ret == 0 && !probing_mode) {
+        if (!probing_mode) {
             ret = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (void *) data, len);
+            if (ret > 0) {
+                break;
+            }
         }
 
         /* Wait for responses */
@@ -372,7 +398,6 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
 
             case MSG_TYPE_USER_SPEC_TIMEOUT:
                 DEBUG("gnrc_tcp.c : gnrc_tcp_send() : USER_SPEC_TIMEOUT\n");
-                _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
                 ret = -ETIMEDOUT;
                 break;
 
@@ -503,6 +528,15 @@ ssize_t gnrc_tcp_recv(gnrc_tcp_tcb_t *tcb, void *data, const size_t max_len,
         }
     }
 
+    /* Take back the buffer lent to the FSM. Return data received into it meanwhile */
+    mutex_lock(&(tcb->fsm_lock));
+    tcb->rcv_user_buf = NULL;
+    if (tcb->rcv_user_used > 0) {
+        ret = tcb->rcv_user_used;
+        tcb->rcv_user_used = 0;
+    }
+    mutex_unlock(&(tcb->fsm_lock));
+
     /* Cleanup */
     xtimer_remove(&connection_timeout);
     xtimer_remove(&user_timeout);
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc
+ * @{
+ *
+ * @file
+ * @brief       Implementation of internal/cc.h
+ * @}
+ */
+#include "internal/common.h"
+#include "internal/pkt.h"
+#include "internal/cc.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static inline uint32_t _min(const uint32_t x, const uint32_t y)
+{
+    return (x < y) ? x : y;
+}
+
+static inline uint32_t _max(const uint32_t x, const uint32_t y)
+{
+    return (x > y) ? x : y;
+}
+
+/**
+ * @brief Sets ssthresh to half of the data in flight (see RFC 5681, equation 4).
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _reduce_ssthresh(gnrc_tcp_tcb_t *tcb)
+{
+    tcb->ssthresh = _max(_cc_flight_size(tcb) / 2, 2 * _cc_smss(tcb));
+}
+
+uint16_t _cc_smss(const gnrc_tcp_tcb_t *tcb)
+{
+    /* Use our own MSS if the peer did not announce one */
+    if (tcb->mss == 0 || tcb->mss > GNRC_TCP_MSS) {
+        return GNRC_TCP_MSS;
+    }
+    return tcb->mss;
+}
+
+uint32_t _cc_flight_size(const gnrc_tcp_tcb_t *tcb)
+{
+    return tcb->snd_nxt - tcb->snd_una;
+}
+
+void _cc_init(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = _cc_smss(tcb);
+
+    /* Initial window, see RFC 3390 */
+    tcb->cwnd = _min(4 * smss, _max(2 * smss, 4380));
+    tcb->ssthresh = UINT32_MAX;
+    tcb->recover = tcb->snd_una;
+    tcb->dup_acks = 0;
+    tcb->status &= ~STATUS_FAST_RECOVERY;
+}
+
+void _cc_ack(gnrc_tcp_tcb_t *tcb, const uint32_t acked)
+{
+    uint32_t smss = _cc_smss(tcb);
+
+    tcb->dup_acks = 0;
+
+    if (tcb->status & STATUS_FAST_RECOVERY) {
+        /* Full acknowledgment: Deflate the window and leave fast recovery */
+        if (GEQ_32_BIT(tcb->snd_una, tcb->recover)) {
+            DEBUG("gnrc_tcp_cc.c : _cc_ack() : Full ACK, leave fast recovery\n");
+            tcb->cwnd = _min(tcb->ssthresh, _max(_cc_flight_size(tcb), smss) + smss);
+            tcb->status &= ~STATUS_FAST_RECOVERY;
+        }
+        /* Partial acknowledgment: The next segment was lost as well */
+        else {
+            DEBUG("gnrc_tcp_cc.c : _cc_ack() : Partial ACK, retransmit\n");
+            _pkt_retransmit(tcb);
+            tcb->cwnd = (tcb->cwnd > acked) ? tcb->cwnd - acked : 0;
+            if (acked >= smss) {
+                tcb->cwnd += smss;
+            }
+            tcb->cwnd = _max(tcb->cwnd, smss);
+        }
+        return;
+    }
+
+    /* Segments sent before a retransmission timeout are likely lost as well.
+     * Resend them one by one as the acknowledgments come in. */
+    if (LSS_32_BIT(tcb->snd_una, tcb->recover)) {
+        _pkt_retransmit(tcb);
+    }
+
+    /* Slow start or congestion avoidance */
+    if (tcb->cwnd < tcb->ssthresh) {
+        tcb->cwnd += _min(acked, smss);
+    }
+    else {
+        tcb->cwnd += _max(1, (smss * smss) / tcb->cwnd);
+    }
+
+    /* There is no use in a window larger than the send queue */
+    tcb->cwnd = _min(tcb->cwnd, (GNRC_TCP_SND_QUEUE_SIZE - 1) * smss);
+}
+
+void _cc_dup_ack(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = _cc_smss(tcb);
+
+    /* Every further duplicate ACK means another segment left the network */
+    if (tcb->status & STATUS_FAST_RECOVERY) {
+        tcb->cwnd += smss;
+        tcb->status |= STATUS_NOTIFY_USER;
+        return;
+    }
+
+    tcb->dup_acks += 1;
+    if (tcb->dup_acks != GNRC_TCP_DUP_ACK_THRESHOLD) {
+        return;
+    }
+
+    /* Do not start over for losses of the recovery that just ended (RFC 6582) */
+    if (LSS_32_BIT(tcb->snd_una, tcb->recover)) {
+        return;
+    }
+
+    DEBUG("gnrc_tcp_cc.c : _cc_dup_ack() : Fast retransmit\n");
+    _reduce_ssthresh(tcb);
+    tcb->recover = tcb->snd_nxt;
+    _pkt_retransmit(tcb);
+    tcb->cwnd = tcb->ssthresh + GNRC_TCP_DUP_ACK_THRESHOLD * smss;
+    tcb->status |= STATUS_FAST_RECOVERY;
+}
+
+void _cc_timeout(gnrc_tcp_tcb_t *tcb)
+{
+    DEBUG("gnrc_tcp_cc.c : _cc_timeout()\n");
+
+    /* Only the first timeout of a loss reduces ssthresh */
+    if (!LSS_32_BIT(tcb->snd_una, tcb->recover)) {
+        _reduce_ssthresh(tcb);
+    }
+    tcb->cwnd = _cc_smss(tcb);
+    tcb->recover = tcb->snd_nxt;
+    tcb->dup_acks = 0;
+    tcb->status &= ~STATUS_FAST_RECOVERY;
+}
@@ -23,6 +23,7 @@
 #include "internal/pkt.h"
 #include "internal/option.h"
 #include "internal/rcvbuf.h"
+#include "internal/cc.h"
 #include "internal/fsm.h"
 
 #ifdef MODULE_GNRC_IPV6
@@ -80,11 +81,16 @@ static uint16_t _get_random_local_port(void)
  */
 static int _clear_retransmit(gnrc_tcp_tcb_t *tcb)
 {
-    if (tcb->pkt_retransmit != NULL) {
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
+    if (tcb->snd_queue_len > 0) {
         xtimer_remove(&(tcb->tim_tout));
-        tcb->pkt_retransmit = NULL;
+        while (tcb->snd_queue_len > 0) {
+            gnrc_pktbuf_release(tcb->snd_queue[tcb->snd_queue_head]);
+            tcb->snd_queue[tcb->snd_queue_head] = NULL;
+            tcb->snd_queue_head = (tcb->snd_queue_head + 1) % GNRC_TCP_SND_QUEUE_SIZE;
+            tcb->snd_queue_len -= 1;
+        }
     }
+    tcb->status &= ~(STATUS_FAST_RECOVERY | STATUS_RTT_MEASURE);
     return 0;
 }
 
@@ -145,6 +151,11 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
 #endif
             tcb->peer_port = PORT_UNSPEC;
 
+            /* Window scaling is negotiated again for the next connection */
+            tcb->status &= ~STATUS_WSCALE;
+            tcb->snd_wscale = 0;
+            tcb->rcv_wscale = 0;
+
             /* Allocate receive buffer */
             if (_rcvbuf_get_buffer(tcb) == -ENOMEM) {
                 return -ENOMEM;
@@ -189,6 +200,10 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
             break;
 
         case FSM_STATE_ESTABLISHED:
+            _cc_init(tcb);
+            tcb->status |= STATUS_NOTIFY_USER;
+            break;
+
         case FSM_STATE_CLOSE_WAIT:
             tcb->status |= STATUS_NOTIFY_USER;
             break;
@@ -218,7 +233,6 @@ static int _fsm_call_open(gnrc_tcp_tcb_t *tcb)
     int ret = 0;
 
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_open()\n");
-    tcb->rcv_wnd = GNRC_TCP_DEFAULT_WINDOW;
 
     if (tcb->status & STATUS_PASSIVE) {
         /* Passive open, T: CLOSED -> LISTEN */
@@ -240,6 +254,9 @@ static int _fsm_call_open(gnrc_tcp_tcb_t *tcb)
             return ret;
         }
 
+        /* Offer window scaling as needed for the receive buffer */
+        tcb->rcv_wscale = _option_calc_ws(tcb->rcv_buf.size);
+
         /* Send SYN */
         gnrc_pktsnip_t *out_pkt = NULL;
         uint16_t seq_con = 0;
@@ -253,6 +270,9 @@ static int _fsm_call_open(gnrc_tcp_tcb_t *tcb)
 /**
  * @brief FSM Handling function for sending data.
  *
+ * @note Sends as many segments as the send window, the congestion window
+ *       and the retransmission queue allow.
+ *
  * @param[in,out] tcb   TCB holding the connection information.
  * @param[in,out] buf   Buffer containing data to send.
  * @param[in]     len   Maximum Number of Bytes to send from @p buf.
@@ -263,24 +283,40 @@ static int _fsm_call_send(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_send()\n");
 
-    size_t payload = (tcb->snd_una + tcb->snd_wnd) - tcb->snd_nxt;
+    size_t sent = 0;
+    uint32_t smss = _cc_smss(tcb);
+
+    /* Keep one slot of the retransmission queue free for the FIN */
+    while (sent < len && tcb->snd_queue_len < (GNRC_TCP_SND_QUEUE_SIZE - 1)) {
+        uint32_t wnd = (tcb->snd_wnd < tcb->cwnd) ? tcb->snd_wnd : tcb->cwnd;
+        uint32_t flight = _cc_flight_size(tcb);
+
+        /* Check if window is open */
+        if (flight >= wnd) {
+            break;
+        }
 
-    /* Check if window is open and all packets were transmitted */
-    if (payload > 0 && tcb->snd_wnd > 0 && tcb->pkt_retransmit == NULL) {
         /* Calculate segment size */
-        payload = (payload < GNRC_TCP_MSS) ? payload : GNRC_TCP_MSS;
-        payload = (payload < tcb->mss) ? payload : tcb->mss;
-        payload = (payload < len) ? payload : len;
+        size_t payload = wnd - flight;
+        payload = (payload < smss) ? payload : smss;
+        payload = (payload < (len - sent)) ? payload : (len - sent);
+
+        /* Avoid sending small segments while data is in flight (see RFC 1122, 4.2.3.4) */
+        if (flight > 0 && payload < smss && payload < (len - sent)) {
+            break;
+        }
 
-        /* Calculate payload size for this segment */
         gnrc_pktsnip_t *out_pkt = NULL;
         uint16_t seq_con = 0;
-        _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt, buf, payload);
+        if (_pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt,
+                       (uint8_t *) buf + sent, payload) < 0) {
+            break;
+        }
         _pkt_setup_retransmit(tcb, out_pkt, false);
         _pkt_send(tcb, out_pkt, seq_con, false);
-        return payload;
+        sent += payload;
     }
-    return 0;
+    return sent;
 }
 
 /**
@@ -296,9 +332,23 @@ static int _fsm_call_recv(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_recv()\n");
 
+    /* Return data that was received directly into the buffer of this call */
+    if (tcb->rcv_user_used > 0) {
+        size_t rcvd = tcb->rcv_user_used;
+        tcb->rcv_user_buf = NULL;
+        tcb->rcv_user_used = 0;
+        return rcvd;
+    }
+
     if (ringbuffer_empty(&tcb->rcv_buf)) {
+        /* A blocking call lends its buffer: Incomming data is copied there directly */
+        if (tcb->status & STATUS_WAIT_FOR_MSG) {
+            tcb->rcv_user_buf = buf;
+            tcb->rcv_user_len = len;
+        }
         return 0;
     }
+    tcb->rcv_user_buf = NULL;
 
     /* Read data into 'buf' up to 'len' bytes from receive buffer */
     size_t rcvd = ringbuffer_get(&(tcb->rcv_buf), buf, len);
@@ -406,17 +456,28 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
     LL_SEARCH_SCALAR(in_pkt, snp, type, GNRC_NETTYPE_TCP);
     tcp_hdr_t *tcp_hdr = (tcp_hdr_t *) snp->data;
 
-    /* Parse packet options, return if they are malformed */
-    if (_option_parse(tcb, tcp_hdr) < 0) {
-        return 0;
-    }
-
     /* Extract header values */
     ctl = byteorder_ntohs(tcp_hdr->off_ctl);
     seg_seq = byteorder_ntohl(tcp_hdr->seq_num);
     seg_ack = byteorder_ntohl(tcp_hdr->ack_num);
     seg_wnd = byteorder_ntohs(tcp_hdr->window);
 
+    /* Forget window scaling options of earlier SYNs before a new one is parsed */
+    if ((ctl & MSK_SYN) && (tcb->state == FSM_STATE_LISTEN || tcb->state == FSM_STATE_SYN_SENT)) {
+        tcb->status &= ~STATUS_WSCALE;
+        tcb->snd_wscale = 0;
+    }
+
+    /* Parse packet options, return if they are malformed */
+    if (_option_parse(tcb, tcp_hdr) < 0) {
+        return 0;
+    }
+
+    /* The window in SYN segments is never scaled (see RFC 7323) */
+    if (!(ctl & MSK_SYN)) {
+        seg_wnd <<= tcb->snd_wscale;
+    }
+
     /* Extract network layer header */
 #ifdef MODULE_GNRC_IPV6
     LL_SEARCH_SCALAR(in_pkt, snp, type, GNRC_NETTYPE_IPV6);
@@ -489,6 +550,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
             tcb->snd_nxt = tcb->iss;
             tcb->snd_wnd = seg_wnd;
 
+            /* Use window scaling if the peer offered it */
+            if (tcb->status & STATUS_WSCALE) {
+                tcb->rcv_wscale = _option_calc_ws(tcb->rcv_buf.size);
+            }
+
             /* Send SYN+ACK: seq_no = iss, ack_no = rcv_nxt, T: LISTEN -> SYN_RCVD */
             _pkt_build(tcb, &out_pkt, &seq_con, MSK_SYN_ACK, tcb->iss, tcb->rcv_nxt, NULL, 0);
             _pkt_setup_retransmit(tcb, out_pkt, false);
@@ -523,6 +589,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
         if (ctl & MSK_SYN) {
             tcb->rcv_nxt = seg_seq + 1;
             tcb->irs = seg_seq;
+
+            /* Window scaling is only used if both sides offered it */
+            if (!(tcb->status & STATUS_WSCALE)) {
+                tcb->rcv_wscale = 0;
+            }
             if (ctl & MSK_ACK) {
                 tcb->snd_una = seg_ack;
                 _pkt_acknowledge(tcb, seg_ack);
@@ -614,8 +685,16 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 tcb->state == FSM_STATE_CLOSING || tcb->state == FSM_STATE_LAST_ACK) {
                 /* Acknowledge previously sent data */
                 if (LSS_32_BIT(tcb->snd_una, seg_ack) && LEQ_32_BIT(seg_ack, tcb->snd_nxt)) {
+                    uint32_t acked = seg_ack - tcb->snd_una;
                     tcb->snd_una = seg_ack;
                     _pkt_acknowledge(tcb, seg_ack);
+                    _cc_ack(tcb, acked);
+                }
+                /* Duplicate ACK: Segment without data that neither acknowledges */
+                /* anything new nor updates the window, while data is outstanding */
+                else if (seg_ack == tcb->snd_una && pay_len == 0 && !(ctl & MSK_FIN) &&
+                         seg_wnd == tcb->snd_wnd && tcb->snd_queue_len > 0) {
+                    _cc_dup_ack(tcb);
                 }
                 /* ACK received for something not yet sent: Reply with pure ACK */
                 else if (LSS_32_BIT(tcb->snd_nxt, seg_ack)) {
@@ -639,25 +718,25 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Additional processing */
                 /* Check additionaly if previously sent FIN was acknowledged */
                 if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->snd_queue_len == 0) {
                         _transition_to(tcb, FSM_STATE_FIN_WAIT_2);
                     }
                 }
                 /* If retransmission queue is empty, acknowledge close operation */
                 if (tcb->state == FSM_STATE_FIN_WAIT_2) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->snd_queue_len == 0) {
                         /* Optional: Unblock user close operation */
                     }
                 }
                 /* If our FIN has been acknowledged: Transition to TIME_WAIT */
                 if (tcb->state == FSM_STATE_CLOSING) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->snd_queue_len == 0) {
                         _transition_to(tcb, FSM_STATE_TIME_WAIT);
                     }
                 }
                 /* If our FIN was acknowledged and status is LAST_ACK: close connection */
                 if (tcb->state == FSM_STATE_LAST_ACK) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->snd_queue_len == 0) {
                         _transition_to(tcb, FSM_STATE_CLOSED);
                         return 0;
                     }
@@ -679,7 +758,24 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 if (tcb->rcv_nxt == seg_seq) {
                     /* Copy contents into receive buffer */
                     while (snp && snp->type == GNRC_NETTYPE_UNDEF) {
-                        tcb->rcv_nxt += ringbuffer_add(&(tcb->rcv_buf), snp->data, snp->size);
+                        uint8_t *data = snp->data;
+                        size_t left = snp->size;
+
+                        /* Copy into the buffer of a waiting gnrc_tcp_recv() call */
+                        /* first, if there is no older data in the receive buffer */
+                        if (tcb->rcv_user_buf != NULL && ringbuffer_empty(&(tcb->rcv_buf))) {
+                            size_t num = tcb->rcv_user_len - tcb->rcv_user_used;
+                            num = (num < left) ? num : left;
+                            memcpy(tcb->rcv_user_buf + tcb->rcv_user_used, data, num);
+                            tcb->rcv_user_used += num;
+                            tcb->rcv_nxt += num;
+                            data += num;
+                            left -= num;
+                            if (tcb->rcv_user_used == tcb->rcv_user_len) {
+                                tcb->rcv_user_buf = NULL;
+                            }
+                        }
+                        tcb->rcv_nxt += ringbuffer_add(&(tcb->rcv_buf), (char *) data, left);
                         snp = snp->next;
                     }
                     /* Shrink receive window */
@@ -711,7 +807,7 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 _transition_to(tcb, FSM_STATE_CLOSE_WAIT);
             }
             else if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                if (tcb->pkt_retransmit == NULL) {
+                if (tcb->snd_queue_len == 0) {
                     _transition_to(tcb, FSM_STATE_TIME_WAIT);
                 }
                 else {
@@ -753,9 +849,11 @@ static int _fsm_timeout_timewait(gnrc_tcp_tcb_t *tcb)
 static int _fsm_timeout_retransmit(gnrc_tcp_tcb_t *tcb)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit()\n");
-    if (tcb->pkt_retransmit != NULL) {
-        _pkt_setup_retransmit(tcb, tcb->pkt_retransmit, true);
-        _pkt_send(tcb, tcb->pkt_retransmit, 0, true);
+    if (tcb->snd_queue_len > 0) {
+        gnrc_pktsnip_t *pkt = tcb->snd_queue[tcb->snd_queue_head];
+        _cc_timeout(tcb);
+        _pkt_setup_retransmit(tcb, pkt, true);
+        _pkt_send(tcb, pkt, 0, true);
     }
     else {
         DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : Retransmit queue is empty\n");
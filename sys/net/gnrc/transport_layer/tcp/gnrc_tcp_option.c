@@ -60,6 +60,23 @@ int _option_parse(gnrc_tcp_tcb_t *tcb, tcp_hdr_t *hdr)
                       tcb->mss);
                 break;
 
+            case TCP_OPTION_KIND_WS:
+                if (option->length != TCP_OPTION_LENGTH_WS) {
+                    DEBUG("gnrc_tcp_option.c : _option_parse() : invalid WS Option length.\n");
+                    return -1;
+                }
+                /* Window scaling is negotiated in SYN segments only (see RFC 7323) */
+                if (byteorder_ntohs(hdr->off_ctl) & MSK_SYN) {
+                    tcb->snd_wscale = option->value[0];
+                    if (tcb->snd_wscale > TCP_WS_SHIFT_MAX) {
+                        tcb->snd_wscale = TCP_WS_SHIFT_MAX;
+                    }
+                    tcb->status |= STATUS_WSCALE;
+                }
+                DEBUG("gnrc_tcp_option.c : _option_parse() : WS option found. WS=%"PRIu8"\n",
+                      tcb->snd_wscale);
+                break;
+
             default:
                 DEBUG("gnrc_tcp_option.c : _option_parse() : Unknown option found.\
                       KIND=%"PRIu8", LENGTH=%"PRIu8"\n", option->kind, option->length);
@@ -16,6 +16,8 @@
  * @author      Simon Brummer <simon.brummer@posteo.de>
  */
 #include <errno.h>
+#include <stdbool.h>
+#include <string.h>
 #include "internal/rcvbuf.h"
 
 #define ENABLE_DEBUG (0)
@@ -26,6 +28,37 @@
  */
 rcvbuf_t _static_buf;
 
+/**
+ * @brief Checks if a block of the pool is allocated.
+ *
+ * @param[in] block   Index of the block.
+ *
+ * @returns   Non-zero if @p block is in use.
+ */
+static inline uint32_t _block_used(const size_t block)
+{
+    return _static_buf.used[block / 32] & (1UL << (block % 32));
+}
+
+/**
+ * @brief Marks a run of blocks as allocated or free.
+ *
+ * @param[in] first   Index of the first block.
+ * @param[in] num     Number of blocks.
+ * @param[in] used    True to allocate, false to free the blocks.
+ */
+static void _blocks_mark(const size_t first, const size_t num, const bool used)
+{
+    for (size_t i = first; i < first + num; ++i) {
+        if (used) {
+            _static_buf.used[i / 32] |= (1UL << (i % 32));
+        }
+        else {
+            _static_buf.used[i / 32] &= ~(1UL << (i % 32));
+        }
+    }
+}
+
 /**
  * @brief Initializes all receive buffers.
  */
@@ -33,26 +66,32 @@ void _rcvbuf_init(void)
 {
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_init() : entry\n");
     mutex_init(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        _static_buf.entries[i].used = 0;
-    }
+    memset(_static_buf.used, 0, sizeof(_static_buf.used));
 }
 
 /**
  * @brief Allocate receive buffer.
  *
+ * @param[in] size   Size of the buffer in bytes.
+ *
  * @returns   Not NULL if a receive buffer was allocated.
  *            NULL if allocation failed.
  */
-static void* _rcvbuf_alloc(void)
+static void* _rcvbuf_alloc(const size_t size)
 {
     void *result = NULL;
+    size_t num = (size + GNRC_TCP_RCV_BUF_BLOCK_SIZE - 1) / GNRC_TCP_RCV_BUF_BLOCK_SIZE;
+    size_t run = 0;
+
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_alloc() : Entry\n");
     mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if (_static_buf.entries[i].used == 0) {
-            _static_buf.entries[i].used = 1;
-            result = (void *)(_static_buf.entries[i].buffer);
+    /* First fit: Search for num contiguous free blocks */
+    for (size_t i = 0; i < RCVBUF_BLOCKS && num > 0; ++i) {
+        run = _block_used(i) ? 0 : run + 1;
+        if (run == num) {
+            size_t first = i + 1 - num;
+            _blocks_mark(first, num, true);
+            result = (void *)(_static_buf.pool + first * GNRC_TCP_RCV_BUF_BLOCK_SIZE);
             break;
         }
     }
@@ -63,39 +102,40 @@ static void* _rcvbuf_alloc(void)
 /**
  * @brief Release allocated receive buffer.
  *
- * @param[in] buf   Pointer to buffer that should be released.
+ * @param[in] buf    Pointer to buffer that should be released.
+ * @param[in] size   Size of the buffer in bytes.
  */
-static void _rcvbuf_free(void * const buf)
+static void _rcvbuf_free(void * const buf, const size_t size)
 {
+    size_t first = ((uint8_t *) buf - _static_buf.pool) / GNRC_TCP_RCV_BUF_BLOCK_SIZE;
+    size_t num = (size + GNRC_TCP_RCV_BUF_BLOCK_SIZE - 1) / GNRC_TCP_RCV_BUF_BLOCK_SIZE;
+
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_free() : Entry\n");
     mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if ((_static_buf.entries[i].used == 1) && (buf == _static_buf.entries[i].buffer)) {
-            _static_buf.entries[i].used = 0;
-        }
-    }
+    _blocks_mark(first, num, false);
     mutex_unlock(&(_static_buf.lock));
 }
 
 int _rcvbuf_get_buffer(gnrc_tcp_tcb_t *tcb)
 {
     if (tcb->rcv_buf_raw == NULL) {
-        tcb->rcv_buf_raw = _rcvbuf_alloc();
+        tcb->rcv_buf_raw = _rcvbuf_alloc(tcb->rcv_buf_size);
         if (tcb->rcv_buf_raw == NULL) {
             DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_get_buffer() : Can't allocate rcv_buf_raw\n");
             return -ENOMEM;
         }
         else {
-            ringbuffer_init(&tcb->rcv_buf, (char *) tcb->rcv_buf_raw, GNRC_TCP_RCV_BUF_SIZE);
+            ringbuffer_init(&tcb->rcv_buf, (char *) tcb->rcv_buf_raw, tcb->rcv_buf_size);
         }
     }
+    tcb->rcv_wnd = ringbuffer_get_free(&(tcb->rcv_buf));
     return 0;
 }
 
 void _rcvbuf_release_buffer(gnrc_tcp_tcb_t *tcb)
 {
     if (tcb->rcv_buf_raw != NULL) {
-        _rcvbuf_free(tcb->rcv_buf_raw);
+        _rcvbuf_free(tcb->rcv_buf_raw, tcb->rcv_buf.size);
         tcb->rcv_buf_raw = NULL;
     }
 }
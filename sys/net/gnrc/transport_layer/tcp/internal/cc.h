@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_tcp
+ * @{
+ *
+ * @file
+ * @brief       TCP congestion control declarations (NewReno, RFC 5681 and RFC 6582).
+ */
+
+#ifndef GNRC_TCP_INTERNAL_CC_H
+#define GNRC_TCP_INTERNAL_CC_H
+
+#include <stdint.h>
+#include "net/gnrc/tcp/tcb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the sender maximum segment size of a connection.
+ *
+ * @param[in] tcb   TCB holding the connection information.
+ *
+ * @returns   The smaller one of GNRC_TCP_MSS and the peers MSS.
+ */
+uint16_t _cc_smss(const gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Get the number of sent but unacknowledged bytes.
+ *
+ * @param[in] tcb   TCB holding the connection information.
+ *
+ * @returns   The amount of data in flight.
+ */
+uint32_t _cc_flight_size(const gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Initializes the congestion control state of an established connection.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+void _cc_init(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Updates the congestion window after snd_una advanced.
+ *
+ * @note Retransmits the oldest queued segment on a partial acknowledgment
+ *       during loss recovery.
+ *
+ * @param[in,out] tcb     TCB holding the connection information.
+ * @param[in]     acked   Number of newly acknowledged bytes.
+ */
+void _cc_ack(gnrc_tcp_tcb_t *tcb, const uint32_t acked);
+
+/**
+ * @brief Handles a duplicate acknowledgment.
+ *
+ * @note Triggers a fast retransmit on the GNRC_TCP_DUP_ACK_THRESHOLD-th
+ *       duplicate ACK.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+void _cc_dup_ack(gnrc_tcp_tcb_t *tcb);
+
+/**
+ * @brief Updates the congestion window after a retransmission timeout.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+void _cc_timeout(gnrc_tcp_tcb_t *tcb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_TCP_INTERNAL_CC_H */
+/** @} */
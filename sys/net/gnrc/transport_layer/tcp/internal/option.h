@@ -44,6 +44,35 @@ inline static uint32_t _option_build_mss(uint16_t mss)
             ((uint32_t) TCP_OPTION_LENGTH_MSS << 16) | mss);
 }
 
+/**
+ * @brief Helper function to build the window scale option, preceded by a NOP.
+ *
+ * @param[in] shift   Window scale shift count.
+ *
+ * @returns   Window scale option value.
+ */
+inline static uint32_t _option_build_ws(uint8_t shift)
+{
+    return (((uint32_t) TCP_OPTION_KIND_NOP << 24) | ((uint32_t) TCP_OPTION_KIND_WS << 16) |
+            ((uint32_t) TCP_OPTION_LENGTH_WS << 8) | shift);
+}
+
+/**
+ * @brief Calculates the window scale shift needed to announce a window.
+ *
+ * @param[in] wnd   Largest window that will be announced.
+ *
+ * @returns   Smallest shift count, that fits @p wnd into 16 bit.
+ */
+inline static uint8_t _option_calc_ws(uint32_t wnd)
+{
+    uint8_t shift = 0;
+    while ((wnd >> shift) > UINT16_MAX && shift < TCP_WS_SHIFT_MAX) {
+        shift += 1;
+    }
+    return shift;
+}
+
 /**
  * @brief Helper function to build the combined option and control flag field.
  *
@@ -32,19 +32,20 @@ extern "C" {
 #endif
 
 /**
- * @brief Receive buffer entry.
+ * @brief Number of blocks in the receive buffer pool.
  */
-typedef struct rcvbuf_entry {
-    uint8_t used;                          /**< Flag: Is buffer in use? */
-    uint8_t buffer[GNRC_TCP_RCV_BUF_SIZE]; /**< Receive buffer storage */
-} rcvbuf_entry_t;
+#define RCVBUF_BLOCKS ((GNRC_TCP_RCV_BUF_POOL_SIZE + GNRC_TCP_RCV_BUF_BLOCK_SIZE - 1) / \
+                       GNRC_TCP_RCV_BUF_BLOCK_SIZE)
 
 /**
- * @brief   Stuct holding receive buffers.
+ * @brief   Pool all receive buffers are allocated from.
+ *
+ * A receive buffer occupies a contiguous run of blocks.
  */
 typedef struct rcvbuf {
-    mutex_t lock;                                 /**< Lock for allocation synchronization */
-    rcvbuf_entry_t entries[GNRC_TCP_RCV_BUFFERS]; /**< Maintained receive buffers */
+    mutex_t lock;                                       /**< Lock for allocation synchronization */
+    uint32_t used[(RCVBUF_BLOCKS + 31) / 32];           /**< Bitmap of allocated blocks */
+    uint8_t pool[RCVBUF_BLOCKS * GNRC_TCP_RCV_BUF_BLOCK_SIZE];  /**< Receive buffer storage */
 } rcvbuf_t;
 
 /**
@@ -58,7 +59,7 @@ void _rcvbuf_init(void);
  * @param[in,out] tcb   TCB that aquires receive buffer.
  *
  * @returns   Zero  on success.
- *            -ENOMEM if all receive buffers are currently used.
+ *            -ENOMEM if the pool has no free space of tcb->rcv_buf_size bytes.
  */
 int _rcvbuf_get_buffer(gnrc_tcp_tcb_t *tcb);
 
@@ -33,6 +33,17 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifdef MODULE_GNRC_UDP_CB
+/**
+ * @brief   Callback UDP is registered with at netreg
+ */
+static gnrc_netreg_entry_cbd_t _cbd;
+
+/**
+ * @brief   UDP's netreg entry
+ */
+static gnrc_netreg_entry_t _netreg;
+#else
 /**
  * @brief   Save the UDP's thread PID for later reference
  */
@@ -46,6 +57,7 @@ static char _stack[GNRC_UDP_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_UDP_STACK_SIZE];
 #endif
+#endif
 
 /**
  * @brief   Calculate the UDP checksum dependent on the network protocol
@@ -217,6 +229,26 @@ static void _send(gnrc_pktsnip_t *pkt)
     }
 }
 
+#ifdef MODULE_GNRC_UDP_CB
+static void _netapi_cb(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    (void)ctx;
+    switch (cmd) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("udp: GNRC_NETAPI_MSG_TYPE_RCV\n");
+            _receive(pkt);
+            break;
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("udp: GNRC_NETAPI_MSG_TYPE_SND\n");
+            _send(pkt);
+            break;
+        default:
+            DEBUG("udp: received unidentified command\n");
+            gnrc_pktbuf_release(pkt);
+            break;
+    }
+}
+#else
 static void *_event_loop(void *arg)
 {
     (void)arg;
@@ -257,6 +289,7 @@ static void *_event_loop(void *arg)
     /* never reached */
     return NULL;
 }
+#endif
 
 int gnrc_udp_calc_csum(gnrc_pktsnip_t *hdr, gnrc_pktsnip_t *pseudo_hdr)
 {
@@ -298,6 +331,15 @@ gnrc_pktsnip_t *gnrc_udp_hdr_build(gnrc_pktsnip_t *payload, uint16_t src,
 
 int gnrc_udp_init(void)
 {
+#ifdef MODULE_GNRC_UDP_CB
+    /* check if already registered */
+    if (_cbd.cb == NULL) {
+        _cbd.cb = _netapi_cb;
+        gnrc_netreg_entry_init_cb(&_netreg, GNRC_NETREG_DEMUX_CTX_ALL, &_cbd);
+        gnrc_netreg_register(GNRC_NETTYPE_UDP, &_netreg);
+    }
+    return KERNEL_PID_UNDEF;
+#else
     /* check if thread is already running */
     if (_pid == KERNEL_PID_UNDEF) {
         /* start UDP thread */
@@ -305,4 +347,5 @@ int gnrc_udp_init(void)
                              THREAD_CREATE_STACKTEST, _event_loop, NULL, "udp");
     }
     return _pid;
+#endif
 }
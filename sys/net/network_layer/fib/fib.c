@@ -24,12 +24,14 @@
 #include <string.h>
 #include <inttypes.h>
 #include <errno.h>
+#include "irq.h"
 #include "thread.h"
 #include "mutex.h"
 #include "msg.h"
 #include "xtimer.h"
 #include "timex.h"
 #include "utlist.h"
+#include "kernel_defines.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -65,9 +67,407 @@ static void fib_lifetime_to_absolute(uint32_t ms, uint64_t *target)
     *target = xtimer_now_usec64() + (ms * US_PER_MS);
 }
 
+/**
+ * @name Types of the index nodes
+ * @{
+ */
+#define FIB_TRIE_NODE_UNUSED    (0) /**< node is free */
+#define FIB_TRIE_NODE_ENTRY     (1) /**< node holds an entry */
+#define FIB_TRIE_NODE_BRANCH    (2) /**< node is a pure branching node */
+/** @} */
+
+/**
+ * @brief maximum offset in us the expiry timer is set to at once
+ */
+#define FIB_EXPIRY_MAX_OFFSET   (0x7fffffffUL)
+
+/**
+ * @brief returns the key byte at position @p idx,
+ *        the address size is the first byte of a key
+ */
+static inline uint8_t fib_key_byte(const uint8_t *addr, size_t addr_size, size_t idx)
+{
+    return (idx == 0) ? (uint8_t)addr_size : addr[idx - 1];
+}
+
+/**
+ * @brief returns the key bit at position @p bit (MSB first)
+ */
+static inline unsigned fib_key_bit(const uint8_t *addr, size_t addr_size, unsigned bit)
+{
+    return (fib_key_byte(addr, addr_size, bit >> 3) >> (7 - (bit & 0x7))) & 0x1;
+}
+
+/**
+ * @brief returns the number of leading key bits two keys have in common,
+ *        at most @p max_bits
+ */
+static unsigned fib_key_common_bits(const uint8_t *a, size_t a_size,
+                                    const uint8_t *b, size_t b_size,
+                                    unsigned max_bits)
+{
+    for (unsigned i = 0; (i << 3) < max_bits; ++i) {
+        uint8_t xor = fib_key_byte(a, a_size, i) ^ fib_key_byte(b, b_size, i);
+        if (xor != 0) {
+            unsigned bits = i << 3;
+            while (!(xor & 0x80)) {
+                xor <<= 1;
+                bits++;
+            }
+            return (bits < max_bits) ? bits : max_bits;
+        }
+        if (i >= a_size) {
+            /* the sizes are equal so this is the last byte */
+            break;
+        }
+    }
+    return max_bits;
+}
+
+/**
+ * @brief returns the entry holding the given index node
+ */
+static inline fib_entry_t *fib_trie_entry(fib_trie_node_t *node)
+{
+    return container_of(node, fib_entry_t, trie_node);
+}
+
+/**
+ * @brief returns the number of key bits of an entry in the index
+ *
+ * The all zero address is the default route and matches any address of the
+ * same size. Entries with a prefix length in their flags match all addresses
+ * with this prefix, all others only match their exact address.
+ */
+static unsigned fib_trie_key_len(uint8_t *dst, size_t dst_size, uint32_t dst_flags)
+{
+    size_t prefix_len = (dst_flags & FIB_FLAG_NET_PREFIX_MASK) >> FIB_FLAG_NET_PREFIX_SHIFT;
+    bool is_all_zeros_addr = true;
+
+    for (size_t i = 0; i < dst_size; ++i) {
+        if (dst[i] != 0) {
+            is_all_zeros_addr = false;
+            break;
+        }
+    }
+
+    if (is_all_zeros_addr) {
+        prefix_len = 0;
+    }
+    else if ((prefix_len == 0) || (prefix_len > (dst_size << 3))) {
+        prefix_len = dst_size << 3;
+    }
+
+    /* the address size is part of the key */
+    return prefix_len + 8;
+}
+
+/**
+ * @brief checks if the first @p len key bits of an entry match the given address
+ */
+static bool fib_trie_match(fib_entry_t *entry, unsigned len,
+                           uint8_t *dst, size_t dst_size)
+{
+    universal_address_container_t *global = entry->global;
+    size_t bytes = (len - 8) >> 3;
+    unsigned bits = (len - 8) & 0x7;
+
+    if (global->address_size != dst_size) {
+        return false;
+    }
+    if (memcmp(global->address, dst, bytes) != 0) {
+        return false;
+    }
+    if (bits != 0) {
+        uint8_t mask = 0xff << (8 - bits);
+        return ((global->address[bytes] ^ dst[bytes]) & mask) == 0;
+    }
+    return true;
+}
+
+/**
+ * @brief takes an unused branching node from the entries of a table
+ *
+ * A Patricia trie never has more branching nodes than entries, so there
+ * is always one available.
+ */
+static fib_trie_node_t *fib_trie_branch_alloc(fib_table_t *table)
+{
+    for (size_t i = 0; i < table->size; ++i) {
+        fib_trie_node_t *node = &table->data.entries[i].trie_branch;
+        if (node->type == FIB_TRIE_NODE_UNUSED) {
+            node->type = FIB_TRIE_NODE_BRANCH;
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief releases an index node
+ */
+static inline void fib_trie_node_free(fib_trie_node_t *node)
+{
+    memset(node, 0, sizeof(fib_trie_node_t));
+}
+
+/**
+ * @brief inserts an entry into the index of a table
+ *
+ * @param[in] table     the FIB table
+ * @param[in] entry     the entry, its global address must be set
+ * @param[in] len       the number of key bits of the entry
+ *                      (see @ref fib_trie_key_len())
+ */
+static void fib_trie_insert(fib_table_t *table, fib_entry_t *entry, unsigned len)
+{
+    fib_trie_node_t *x = &entry->trie_node;
+    uint8_t *key = entry->global->address;
+    size_t key_size = entry->global->address_size;
+
+    x->child[0] = NULL;
+    x->child[1] = NULL;
+    x->next = NULL;
+    x->len = len;
+    x->type = FIB_TRIE_NODE_ENTRY;
+
+    if (table->trie_root == NULL) {
+        table->trie_root = x;
+        return;
+    }
+
+    /* walk down as far as the key leads */
+    fib_trie_node_t *n = table->trie_root;
+    while (n->len < len) {
+        fib_trie_node_t *c = n->child[fib_key_bit(key, key_size, n->len)];
+        if (c == NULL) {
+            break;
+        }
+        n = c;
+    }
+
+    /* all keys below n share its first bits, take any entry below to find
+     * the bit where the new key leaves the trie */
+    fib_trie_node_t *r = n;
+    while (r->type == FIB_TRIE_NODE_BRANCH) {
+        r = r->child[0];
+    }
+    universal_address_container_t *ref = fib_trie_entry(r)->global;
+    unsigned d = fib_key_common_bits(key, key_size, ref->address,
+                                     ref->address_size,
+                                     (len < r->len) ? len : r->len);
+
+    fib_trie_node_t **pp = &table->trie_root;
+    while ((*pp != NULL) && (((*pp)->len < d) || (((*pp)->len == d) && (d < len)))) {
+        pp = &(*pp)->child[fib_key_bit(key, key_size, (*pp)->len)];
+    }
+
+    fib_trie_node_t *m = *pp;
+    if (m == NULL) {
+        *pp = x;
+    }
+    else if (m->len == d) {
+        /* m->len == len here */
+        if (m->type == FIB_TRIE_NODE_BRANCH) {
+            /* the entry takes the place of the branching node */
+            x->child[0] = m->child[0];
+            x->child[1] = m->child[1];
+            *pp = x;
+            fib_trie_node_free(m);
+        }
+        else {
+            /* another entry with the same prefix */
+            while (m->next != NULL) {
+                m = m->next;
+            }
+            m->next = x;
+        }
+    }
+    else if (d == len) {
+        /* the new entry is a prefix of the sub-trie at m */
+        x->child[fib_key_bit(ref->address, ref->address_size, len)] = m;
+        *pp = x;
+    }
+    else {
+        fib_trie_node_t *b = fib_trie_branch_alloc(table);
+        b->len = d;
+        b->child[fib_key_bit(key, key_size, d)] = x;
+        b->child[fib_key_bit(ref->address, ref->address_size, d)] = m;
+        *pp = b;
+    }
+}
+
+/**
+ * @brief removes an entry from the index of a table
+ *
+ * @param[in] table     the FIB table
+ * @param[in] entry     the entry to remove, may be unused
+ */
+static void fib_trie_remove(fib_table_t *table, fib_entry_t *entry)
+{
+    fib_trie_node_t *x = &entry->trie_node;
+    fib_trie_node_t **pp = &table->trie_root;
+    fib_trie_node_t **parent_pp = NULL;
+
+    if (x->type != FIB_TRIE_NODE_ENTRY) {
+        return;
+    }
+
+    uint8_t *key = entry->global->address;
+    size_t key_size = entry->global->address_size;
+
+    while ((*pp != NULL) && (*pp != x)) {
+        if (((*pp)->len == x->len) && ((*pp)->type == FIB_TRIE_NODE_ENTRY)) {
+            /* x can only be chained to an entry with the same prefix */
+            fib_trie_node_t *prev = *pp;
+            while ((prev->next != NULL) && (prev->next != x)) {
+                prev = prev->next;
+            }
+            if (prev->next == x) {
+                prev->next = x->next;
+                fib_trie_node_free(x);
+            }
+            return;
+        }
+        if ((*pp)->len >= x->len) {
+            return;
+        }
+        parent_pp = pp;
+        pp = &(*pp)->child[fib_key_bit(key, key_size, (*pp)->len)];
+    }
+
+    if (*pp == NULL) {
+        return;
+    }
+
+    if (x->next != NULL) {
+        /* the next entry with the same prefix takes its place */
+        x->next->child[0] = x->child[0];
+        x->next->child[1] = x->child[1];
+        *pp = x->next;
+    }
+    else if ((x->child[0] != NULL) && (x->child[1] != NULL)) {
+        fib_trie_node_t *b = fib_trie_branch_alloc(table);
+        b->len = x->len;
+        b->child[0] = x->child[0];
+        b->child[1] = x->child[1];
+        *pp = b;
+    }
+    else if ((x->child[0] != NULL) || (x->child[1] != NULL)) {
+        *pp = (x->child[0] != NULL) ? x->child[0] : x->child[1];
+    }
+    else {
+        *pp = NULL;
+        if ((parent_pp != NULL) && ((*parent_pp)->type == FIB_TRIE_NODE_BRANCH)) {
+            /* a branching node with a single sub-trie is not needed anymore */
+            fib_trie_node_t *p = *parent_pp;
+            *parent_pp = (p->child[0] != NULL) ? p->child[0] : p->child[1];
+            fib_trie_node_free(p);
+        }
+    }
+
+    fib_trie_node_free(x);
+}
+
+/**
+ * @brief callback of the expiry timer
+ */
+/* the expiry timer changes the version from the ISR, so all increments have
+ * to be atomic */
+static inline void _version_inc(fib_table_t *table)
+{
+    unsigned state = irq_disable();
+    table->version++;
+    irq_restore(state);
+}
+
+static void fib_expiry_cb(void *arg)
+{
+    fib_table_t *table = arg;
+
+    table->expiry_pending = 1;
+    /* cached lookup results may refer to the expiring entries */
+    _version_inc(table);
+}
+
+/**
+ * @brief sets the expiry timer of a table if @p lifetime is earlier than the
+ *        currently set expiry time
+ *
+ * @param[in] table     the FIB table
+ * @param[in] lifetime  the absolute lifetime of an entry
+ */
+static void fib_expiry_set(fib_table_t *table, uint64_t lifetime)
+{
+    if ((lifetime == FIB_LIFETIME_NO_EXPIRE) ||
+        ((table->next_expiry != 0) && (table->next_expiry <= lifetime))) {
+        return;
+    }
+
+    uint64_t now = xtimer_now_usec64();
+    table->next_expiry = lifetime;
+
+    if (lifetime <= now) {
+        table->expiry_pending = 1;
+        return;
+    }
+
+    uint64_t offset = lifetime - now;
+    table->expiry_timer.callback = fib_expiry_cb;
+    table->expiry_timer.arg = table;
+    /* if the offset is too large the timer just fires early, nothing
+     * expires and it is set again */
+    xtimer_set(&table->expiry_timer, (offset > FIB_EXPIRY_MAX_OFFSET) ?
+               FIB_EXPIRY_MAX_OFFSET : (uint32_t)offset);
+}
+
+static int fib_remove(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief removes all expired entries of a table if the expiry timer fired
+ *        and sets the timer to the next expiring entry
+ *
+ * Must be called with the table locked by every function reading the entries,
+ * so no expired entry is ever handed out.
+ *
+ * @param[in] table     the FIB table
+ */
+static void fib_expire(fib_table_t *table)
+{
+    if (!table->expiry_pending) {
+        return;
+    }
+
+    table->expiry_pending = 0;
+    table->next_expiry = 0;
+
+    uint64_t now = xtimer_now_usec64();
+    uint64_t next = FIB_LIFETIME_NO_EXPIRE;
+
+    for (size_t i = 0; i < table->size; ++i) {
+        fib_entry_t *entry = &table->data.entries[i];
+
+        if ((entry->global == NULL) || (entry->lifetime == FIB_LIFETIME_NO_EXPIRE)) {
+            continue;
+        }
+
+        if (entry->lifetime <= now) {
+            fib_remove(table, entry);
+        }
+        else if (entry->lifetime < next) {
+            next = entry->lifetime;
+        }
+    }
+
+    fib_expiry_set(table, next);
+}
+
 /**
  * @brief returns pointer to the entry for the given destination address
  *
+ * The entries are looked up in the longest prefix match index of the table.
+ * Expired entries are removed beforehand if the expiry timer fired.
+ *
  * @param[in] table                the FIB table to search in
  * @param[in] dst                  the destination address
  * @param[in] dst_size             the destination address size
@@ -81,13 +481,11 @@ static void fib_lifetime_to_absolute(uint32_t ms, uint64_t *target)
  */
 static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
                           fib_entry_t **entry_arr, size_t *entry_arr_size) {
-    uint64_t now = xtimer_now_usec64();
+    fib_expire(table);
 
     size_t count = 0;
-    size_t prefix_size = 0;
-    size_t match_size = dst_size << 3;
     int ret = -EHOSTUNREACH;
-    bool is_all_zeros_addr = true;
+    unsigned key_len = (dst_size + 1) << 3;
 
 #if ENABLE_DEBUG
     DEBUG("[fib_find_entry] dst =");
@@ -97,82 +495,40 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
     DEBUG("\n");
 #endif
 
-    for (size_t i = 0; i < dst_size; ++i) {
-        if (dst[i] != 0) {
-            is_all_zeros_addr = false;
-            break;
-        }
+    if (dst_size > UNIVERSAL_ADDRESS_SIZE) {
+        *entry_arr_size = 0;
+        return -EHOSTUNREACH;
     }
 
-    for (size_t i = 0; i < table->size; ++i) {
-
-        /* autoinvalidate if the entry lifetime is not set to not expire */
-        if (table->data.entries[i].lifetime != FIB_LIFETIME_NO_EXPIRE) {
-
-            /* check if the lifetime expired */
-            if (table->data.entries[i].lifetime < now) {
-                /* remove this entry if its lifetime expired */
-                table->data.entries[i].lifetime = 0;
-                table->data.entries[i].global_flags = 0;
-                table->data.entries[i].next_hop_flags = 0;
-                table->data.entries[i].iface_id = KERNEL_PID_UNDEF;
+    fib_trie_node_t *node = table->trie_root;
 
-                if (table->data.entries[i].global != NULL) {
-                    universal_address_rem(table->data.entries[i].global);
-                    table->data.entries[i].global = NULL;
-                }
+    while (node != NULL) {
+        if (node->type == FIB_TRIE_NODE_ENTRY) {
+            if (!fib_trie_match(fib_trie_entry(node), node->len, dst, dst_size)) {
+                /* nothing below can match either */
+                break;
+            }
 
-                if (table->data.entries[i].next_hop != NULL) {
-                    universal_address_rem(table->data.entries[i].next_hop);
-                    table->data.entries[i].next_hop = NULL;
+            for (fib_trie_node_t *n = node; n != NULL; n = n->next) {
+                fib_entry_t *entry = fib_trie_entry(n);
+                if (memcmp(entry->global->address, dst, dst_size) == 0) {
+                    /* we will not find a better one so we return */
+                    entry_arr[0] = entry;
+                    *entry_arr_size = 1;
+                    return 1;
                 }
             }
-        }
 
-        if ((prefix_size < (dst_size<<3)) && (table->data.entries[i].global != NULL)) {
+            /* we could find a better one so we move on */
+            entry_arr[0] = fib_trie_entry(node);
+            ret = 0;
+            count = 1;
+        }
 
-            int ret_comp = universal_address_compare(table->data.entries[i].global, dst, &match_size);
-            /* If we found an exact match */
-            if ((ret_comp == UNIVERSAL_ADDRESS_EQUAL)
-                || (is_all_zeros_addr && (ret_comp == UNIVERSAL_ADDRESS_IS_ALL_ZERO_ADDRESS))) {
-                entry_arr[0] = &(table->data.entries[i]);
-                *entry_arr_size = 1;
-                /* we will not find a better one so we return */
-                return 1;
-            }
-            else {
-                /* we try to find the most fitting prefix */
-                if (ret_comp == UNIVERSAL_ADDRESS_MATCHING_PREFIX) {
-                    if (table->data.entries[i].global_flags & FIB_FLAG_NET_PREFIX_MASK) {
-                        /* we shift the most upper flag byte back to get the number of prefix bits */
-                        size_t global_prefix_len = (table->data.entries[i].global_flags
-                                                    & FIB_FLAG_NET_PREFIX_MASK) >> FIB_FLAG_NET_PREFIX_SHIFT;
-
-                        if ((match_size >= global_prefix_len) &&
-                            ((prefix_size == 0) || (match_size > prefix_size))) {
-                            entry_arr[0] = &(table->data.entries[i]);
-                            /* we could find a better one so we move on */
-                            ret = 0;
-
-                            prefix_size = match_size;
-                            count = 1;
-                        }
-                    }
-                 }
-                 else if (ret_comp == UNIVERSAL_ADDRESS_IS_ALL_ZERO_ADDRESS) {
-                    /* we found the default gateway entry, e.g. ::/0 for IPv6
-                     * and we keep it only if there is no better one
-                     */
-                    if (prefix_size == 0) {
-                        entry_arr[0] = &(table->data.entries[i]);
-                        /* we could find a better one so we move on */
-                        ret = 0;
-                        count = 1;
-                    }
-                }
-                match_size = dst_size<<3;
-            }
+        if (node->len >= key_len) {
+            break;
         }
+        node = node->child[fib_key_bit(dst, dst_size, node->len)];
     }
 
 #if ENABLE_DEBUG
@@ -192,6 +548,7 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
 /**
  * @brief updates the next hop the lifetime and the interface id for a given entry
  *
+ * @param[in] table          the FIB table the entry belongs to
  * @param[in] entry          the entry to be updated
  * @param[in] next_hop       the next hop address to be updated
  * @param[in] next_hop_size  the next hop address size
@@ -201,7 +558,7 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
  * @return 0 if the entry has been updated
  *         -ENOMEM if the entry cannot be updated due to insufficient RAM
  */
-static int fib_upd_entry(fib_entry_t *entry, uint8_t *next_hop,
+static int fib_upd_entry(fib_table_t *table, fib_entry_t *entry, uint8_t *next_hop,
                          size_t next_hop_size, uint32_t next_hop_flags,
                          uint32_t lifetime)
 {
@@ -214,9 +571,11 @@ static int fib_upd_entry(fib_entry_t *entry, uint8_t *next_hop,
     universal_address_rem(entry->next_hop);
     entry->next_hop = container;
     entry->next_hop_flags = next_hop_flags;
+    _version_inc(table);
 
     if (lifetime != (uint32_t)FIB_LIFETIME_NO_EXPIRE) {
         fib_lifetime_to_absolute(lifetime, &entry->lifetime);
+        fib_expiry_set(table, entry->lifetime);
     }
     else {
         entry->lifetime = FIB_LIFETIME_NO_EXPIRE;
@@ -263,11 +622,15 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
 
                 if (lifetime != (uint32_t) FIB_LIFETIME_NO_EXPIRE) {
                     fib_lifetime_to_absolute(lifetime, &table->data.entries[i].lifetime);
+                    fib_expiry_set(table, table->data.entries[i].lifetime);
                 }
                 else {
                     table->data.entries[i].lifetime = FIB_LIFETIME_NO_EXPIRE;
                 }
 
+                fib_trie_insert(table, &table->data.entries[i],
+                                fib_trie_key_len(dst, dst_size, dst_flags));
+                _version_inc(table);
                 return 0;
             }
         }
@@ -279,12 +642,19 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
 /**
  * @brief removes the given entry
  *
+ * @param[in] table the FIB table the entry belongs to
  * @param[in] entry the entry to be removed
  *
  * @return 0 on success
  */
-static int fib_remove(fib_entry_t *entry)
+static int fib_remove(fib_table_t *table, fib_entry_t *entry)
 {
+    if (entry->global != NULL) {
+        _version_inc(table);
+    }
+
+    fib_trie_remove(table, entry);
+
     if (entry->global != NULL) {
         universal_address_rem(entry->global);
     }
@@ -403,7 +773,7 @@ int fib_add_entry(fib_table_t *table,
 
     if (ret == 1) {
         /* we must take the according entry and update the values */
-        ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        ret = fib_upd_entry(table, entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
     }
     else {
         ret = fib_create_entry(table, iface_id, dst, dst_size, dst_flags,
@@ -433,7 +803,7 @@ int fib_update_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
     if (fib_find_entry(table, dst, dst_size, &(entry[0]), &count) == 1) {
         DEBUG("[fib_update_entry] found entry: %p\n", (void *)(entry[0]));
         /* we must take the according entry and update the values */
-        ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        ret = fib_upd_entry(table, entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -457,7 +827,7 @@ void fib_remove_entry(fib_table_t *table, uint8_t *dst, size_t dst_size)
 
     if (ret == 1) {
         /* we must take the according entry and update the values */
-        fib_remove(entry[0]);
+        fib_remove(table, entry[0]);
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -477,7 +847,7 @@ void fib_flush(fib_table_t *table, kernel_pid_t interface)
     for (size_t i = 0; i < table->size; ++i) {
         if ((interface == KERNEL_PID_UNDEF) ||
             (interface == table->data.entries[i].iface_id)) {
-            fib_remove(&table->data.entries[i]);
+            fib_remove(table, &table->data.entries[i]);
         }
     }
 
@@ -544,6 +914,8 @@ int fib_get_destination_set(fib_table_t *table, uint8_t *prefix,
                             size_t* dst_set_size)
 {
     mutex_lock(&(table->mtx_access));
+    fib_expire(table);
+
     int ret = -EHOSTUNREACH;
     size_t found_entries = 0;
 
@@ -596,6 +968,11 @@ void fib_init(fib_table_t *table)
     }
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
+        xtimer_remove(&table->expiry_timer);
+        table->trie_root = NULL;
+        table->next_expiry = 0;
+        table->expiry_pending = 0;
+        _version_inc(table);
     }
     universal_address_init();
     mutex_unlock(&(table->mtx_access));
@@ -621,6 +998,11 @@ void fib_deinit(fib_table_t *table)
     }
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
+        xtimer_remove(&table->expiry_timer);
+        table->trie_root = NULL;
+        table->next_expiry = 0;
+        table->expiry_pending = 0;
+        _version_inc(table);
     }
     universal_address_reset();
     mutex_unlock(&(table->mtx_access));
@@ -655,6 +1037,8 @@ int fib_register_rp(fib_table_t *table, uint8_t *prefix, size_t prefix_addr_type
 int fib_get_num_used_entries(fib_table_t *table)
 {
     mutex_lock(&(table->mtx_access));
+    fib_expire(table);
+
     size_t used_entries = 0;
 
     for (size_t i = 0; i < table->size; ++i) {
@@ -1457,6 +1841,7 @@ void fib_print_notify_rp(fib_table_t *table)
 void fib_print_fib_table(fib_table_t *table)
 {
     mutex_lock(&(table->mtx_access));
+    fib_expire(table);
 
     for (size_t i = 0; i < table->size; ++i) {
         printf("[fib_print_table] %d) iface_id: %d, global: %p, next hop: %p, lifetime: %"PRIu32"\n",
@@ -1531,6 +1916,7 @@ static void fib_print_address(universal_address_container_t *entry)
 void fib_print_routes(fib_table_t *table)
 {
     mutex_lock(&(table->mtx_access));
+    fib_expire(table);
     uint64_t now = xtimer_now_usec64();
 
     if (table->table_type == FIB_TABLE_TYPE_SH) {
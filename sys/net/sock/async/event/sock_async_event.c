@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+
+#include "irq.h"
+#include "kernel_defines.h"
+#include "mutex.h"
+#include "thread_flags.h"
+
+#include "net/sock/async/event.h"
+
+static char _stack[SOCK_EVENT_STACK_SIZE];
+static clist_node_t _queue = { .next = NULL };
+static thread_t *_thread = NULL;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static mutex_t _init_lock = MUTEX_INIT;
+
+static sock_event_t *_get(void)
+{
+    unsigned state = irq_disable();
+    sock_event_t *event = (sock_event_t *)clist_lpop(&_queue);
+
+    if (event != NULL) {
+        /* marks the event as not queued */
+        event->list_node.next = NULL;
+    }
+    irq_restore(state);
+    return event;
+}
+
+static void *_event_loop(void *arg)
+{
+    (void)arg;
+    while (1) {
+        sock_event_t *event;
+
+        thread_flags_wait_any(SOCK_EVENT_THREAD_FLAG);
+        while ((event = _get()) != NULL) {
+            event->handler(event);
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t sock_event_init(void)
+{
+    mutex_lock(&_init_lock);
+    if (_pid == KERNEL_PID_UNDEF) {
+        _pid = thread_create(_stack, sizeof(_stack), SOCK_EVENT_PRIO,
+                             THREAD_CREATE_STACKTEST, _event_loop, NULL,
+                             "sock_event");
+        assert(_pid > KERNEL_PID_UNDEF);
+        _thread = (thread_t *)thread_get(_pid);
+    }
+    mutex_unlock(&_init_lock);
+    return _pid;
+}
+
+void sock_event_post(sock_event_t *event)
+{
+    unsigned state = irq_disable();
+
+    assert(_thread != NULL);
+    if (event->list_node.next == NULL) {
+        clist_rpush(&_queue, &event->list_node);
+    }
+    irq_restore(state);
+    thread_flags_set(_thread, SOCK_EVENT_THREAD_FLAG);
+}
+
+void sock_event_cancel(sock_event_t *event)
+{
+    unsigned state = irq_disable();
+
+    clist_remove(&_queue, &event->list_node);
+    event->list_node.next = NULL;
+    irq_restore(state);
+}
+
+#ifdef MODULE_SOCK_IP
+static void _ip_handler(sock_event_t *super)
+{
+    sock_ip_event_t *event = container_of(super, sock_ip_event_t, super);
+    unsigned state = irq_disable();
+    sock_async_flags_t flags = event->flags;
+
+    event->flags = 0;
+    irq_restore(state);
+    if (flags) {
+        event->cb(event->sock, flags, event->arg);
+    }
+}
+
+/* called in the context of the network stack */
+static void _ip_cb(sock_ip_t *sock, sock_async_flags_t flags, void *arg)
+{
+    sock_ip_event_t *event = arg;
+    unsigned state = irq_disable();
+
+    (void)sock;
+    event->flags |= flags;
+    irq_restore(state);
+    sock_event_post(&event->super);
+}
+
+void sock_ip_event_init(sock_ip_event_t *event, sock_ip_t *sock,
+                        sock_ip_cb_t cb, void *arg)
+{
+    assert((event != NULL) && (sock != NULL) && (cb != NULL));
+    sock_event_init();
+    sock_event_init_event(&event->super, _ip_handler);
+    event->sock = sock;
+    event->cb = cb;
+    event->arg = arg;
+    event->flags = 0;
+    sock_ip_set_cb(sock, _ip_cb, event);
+}
+
+void sock_ip_event_deinit(sock_ip_event_t *event)
+{
+    sock_ip_set_cb(event->sock, NULL, NULL);
+    sock_event_cancel(&event->super);
+}
+#endif
+
+#ifdef MODULE_SOCK_UDP
+static void _udp_handler(sock_event_t *super)
+{
+    sock_udp_event_t *event = container_of(super, sock_udp_event_t, super);
+    unsigned state = irq_disable();
+    sock_async_flags_t flags = event->flags;
+
+    event->flags = 0;
+    irq_restore(state);
+    if (flags) {
+        event->cb(event->sock, flags, event->arg);
+    }
+}
+
+/* called in the context of the network stack */
+static void _udp_cb(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    sock_udp_event_t *event = arg;
+    unsigned state = irq_disable();
+
+    (void)sock;
+    event->flags |= flags;
+    irq_restore(state);
+    sock_event_post(&event->super);
+}
+
+void sock_udp_event_init(sock_udp_event_t *event, sock_udp_t *sock,
+                         sock_udp_cb_t cb, void *arg)
+{
+    assert((event != NULL) && (sock != NULL) && (cb != NULL));
+    sock_event_init();
+    sock_event_init_event(&event->super, _udp_handler);
+    event->sock = sock;
+    event->cb = cb;
+    event->arg = arg;
+    event->flags = 0;
+    sock_udp_set_cb(sock, _udp_cb, event);
+}
+
+void sock_udp_event_deinit(sock_udp_event_t *event)
+{
+    sock_udp_set_cb(event->sock, NULL, NULL);
+    sock_event_cancel(&event->super);
+}
+#endif
+
+/** @} */
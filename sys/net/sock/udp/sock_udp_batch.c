@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_udp
+ * @{
+ *
+ * @file
+ * @brief   Batch send and receive on top of any sock_udp implementation
+ *
+ * None of the network stacks has a primitive below sock to move several
+ * datagrams at once, so the batch calls loop over the single datagram ones.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+
+#include "net/sock/udp.h"
+
+ssize_t sock_udp_recv_batch(sock_udp_t *sock, sock_udp_dgram_t *dgrams,
+                            size_t num, uint32_t timeout)
+{
+    size_t i = 0;
+
+    assert((sock != NULL) && (dgrams != NULL) && (num > 0));
+    while (i < num) {
+        ssize_t res = sock_udp_recv(sock, dgrams[i].data, dgrams[i].len,
+                                    (i == 0) ? timeout : 0, dgrams[i].remote);
+
+        if (res < 0) {
+            if (i == 0) {
+                return res;
+            }
+            else if (res == -EAGAIN) {
+                break;
+            }
+            /* datagram was dropped, try the next one already queued */
+            continue;
+        }
+        dgrams[i++].len = (size_t)res;
+    }
+    return (ssize_t)i;
+}
+
+ssize_t sock_udp_send_batch(sock_udp_t *sock, const sock_udp_dgram_t *dgrams,
+                            size_t num)
+{
+    size_t i;
+
+    assert((dgrams != NULL) && (num > 0));
+    for (i = 0; i < num; i++) {
+        ssize_t res = sock_udp_send(sock, dgrams[i].data, dgrams[i].len,
+                                    dgrams[i].remote);
+
+        if (res < 0) {
+            return (i == 0) ? res : (ssize_t)i;
+        }
+    }
+    return (ssize_t)i;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    posix_poll  POSIX poll() and select()
+ * @ingroup     posix
+ * @brief       Waits for several VFS file descriptors at once
+ *
+ * Both functions work on any file descriptor of @ref sys_vfs. A file waits
+ * without polling, if its driver implements vfs_file_ops::poll, which e.g.
+ * @ref posix_sockets does for UDP and raw IP sockets with `sock_async`.
+ * Files without it are always ready, like regular files.
+ *
+ * @note    Only GNRC implements `sock_async` so far. The readiness of sockets
+ *          on other stacks (e.g. lwIP) and of TCP sockets can not be tracked.
+ *          poll() reports them with @ref POLLNVAL and select() fails with
+ *          `EBADF`, instead of reporting them as ready and letting the next
+ *          read block.
+ *
+ * select() is provided with the `fd_set` of the C library's
+ * `<sys/select.h>`.
+ *
+ * @{
+ * @file
+ * @brief   Waiting for events on file descriptors
+ * @see     <a href="http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/poll.h.html">
+ *              The Open Group Base Specifications Issue 7, <poll.h>
+ *          </a>
+ */
+#ifndef POSIX_POLL_H
+#define POSIX_POLL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    Event flags for pollfd::events and pollfd::revents
+ * @{
+ */
+#define POLLIN      (0x0001)    /**< data other than high-priority may be read */
+#define POLLPRI     (0x0002)    /**< high-priority data may be read */
+#define POLLOUT     (0x0004)    /**< normal data may be written */
+#define POLLERR     (0x0008)    /**< an error occurred (revents only) */
+#define POLLHUP     (0x0010)    /**< device was disconnected (revents only) */
+#define POLLNVAL    (0x0020)    /**< invalid fd member (revents only) */
+#define POLLRDNORM  (0x0040)    /**< normal data may be read */
+#define POLLRDBAND  (0x0080)    /**< priority data may be read */
+#define POLLWRNORM  (0x0100)    /**< equivalent to POLLOUT */
+#define POLLWRBAND  (0x0200)    /**< priority data may be written */
+/** @} */
+
+/**
+ * @brief   Type for the number of file descriptors
+ */
+typedef unsigned int nfds_t;
+
+/**
+ * @brief   A file descriptor to wait for
+ */
+struct pollfd {
+    int fd;         /**< the file descriptor, ignored if negative */
+    short events;   /**< the events of interest */
+    short revents;  /**< the events that occurred */
+};
+
+/**
+ * @brief   Waits for events on several file descriptors
+ *
+ * @see <a href="http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html">
+ *          The Open Group Base Specification Issue 7, poll
+ *      </a>
+ *
+ * @param[in,out] fds   The file descriptors.
+ * @param[in] nfds      Number of elements in @p fds.
+ * @param[in] timeout   Timeout in milliseconds. 0 to return immediately,
+ *                      -1 to wait without timeout.
+ *
+ * @return  Number of elements of @p fds with a non-zero pollfd::revents.
+ * @return  0, if @p timeout expired.
+ * @return  -1 on error, errno is set to indicate the error.
+ */
+int poll(struct pollfd fds[], nfds_t nfds, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POSIX_POLL_H */
+/** @} */
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief   poll() and select() on top of vfs_poll()
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/select.h>
+
+#include "sched.h"
+#include "thread.h"
+#include "thread_flags.h"
+#include "timex.h"
+#include "vfs.h"
+#include "xtimer.h"
+
+#include "poll.h"
+
+#define _NO_TIMEOUT     (UINT32_MAX)
+/* largest timeout xtimer_set() takes with _NO_TIMEOUT still meaning "none" */
+#define _MAX_TIMEOUT    (UINT32_MAX - 1)
+
+static void _timeout_cb(void *arg)
+{
+    thread_flags_set(arg, THREAD_FLAG_TIMEOUT);
+}
+
+static unsigned _to_vfs(short events)
+{
+    unsigned res = 0;
+
+    if (events & (POLLIN | POLLRDNORM)) {
+        res |= VFS_POLLIN;
+    }
+    if (events & (POLLOUT | POLLWRNORM)) {
+        res |= VFS_POLLOUT;
+    }
+    return res;
+}
+
+static short _from_vfs(short events, int vfs_events)
+{
+    short res = 0;
+
+    if (vfs_events & VFS_POLLIN) {
+        res |= events & (POLLIN | POLLRDNORM);
+    }
+    if (vfs_events & VFS_POLLOUT) {
+        res |= events & (POLLOUT | POLLWRNORM);
+    }
+    return res;
+}
+
+/**
+ * @brief   Checks all file descriptors and arms their notification for
+ *          @p waiter
+ *
+ * @return  Number of file descriptors with events
+ */
+static int _check(struct pollfd fds[], nfds_t nfds, kernel_pid_t waiter)
+{
+    int ready = 0;
+
+    for (nfds_t i = 0; i < nfds; i++) {
+        int res;
+
+        fds[i].revents = 0;
+        if (fds[i].fd < 0) {
+            continue;
+        }
+        res = vfs_poll(fds[i].fd, _to_vfs(fds[i].events), waiter);
+        if (res < 0) {
+            /* a file that can not be polled is no valid member of fds */
+            fds[i].revents = ((res == -EBADF) || (res == -EOPNOTSUPP)) ?
+                             POLLNVAL : POLLERR;
+        }
+        else {
+            fds[i].revents = _from_vfs(fds[i].events, res);
+        }
+        if (fds[i].revents != 0) {
+            ready++;
+        }
+    }
+    return ready;
+}
+
+static int _poll(struct pollfd fds[], nfds_t nfds, uint32_t timeout)
+{
+    xtimer_t timer = { .callback = _timeout_cb,
+                       .arg = (thread_t *)sched_active_thread };
+    int ready;
+
+    if (timeout == 0) {
+        return _check(fds, nfds, KERNEL_PID_UNDEF);
+    }
+    thread_flags_clear(VFS_POLL_THREAD_FLAG | THREAD_FLAG_TIMEOUT);
+    if (timeout != _NO_TIMEOUT) {
+        xtimer_set(&timer, timeout);
+    }
+    /* the files are armed before they are checked, so an event between
+     * _check() and thread_flags_wait_any() is not lost */
+    while ((ready = _check(fds, nfds, sched_active_pid)) == 0) {
+        thread_flags_t flags = thread_flags_wait_any(VFS_POLL_THREAD_FLAG |
+                                                     THREAD_FLAG_TIMEOUT);
+        if (flags & THREAD_FLAG_TIMEOUT) {
+            break;
+        }
+    }
+    if (timeout != _NO_TIMEOUT) {
+        xtimer_remove(&timer);
+    }
+    for (nfds_t i = 0; i < nfds; i++) {
+        if (fds[i].fd >= 0) {
+            vfs_poll(fds[i].fd, 0, KERNEL_PID_UNDEF);
+        }
+    }
+    thread_flags_clear(VFS_POLL_THREAD_FLAG | THREAD_FLAG_TIMEOUT);
+    return ready;
+}
+
+int poll(struct pollfd fds[], nfds_t nfds, int timeout)
+{
+    uint32_t to;
+
+    if ((fds == NULL) && (nfds > 0)) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (timeout < 0) {
+        to = _NO_TIMEOUT;
+    }
+    else if ((unsigned)timeout > (_MAX_TIMEOUT / US_PER_MS)) {
+        to = _MAX_TIMEOUT;
+    }
+    else {
+        to = (uint32_t)timeout * US_PER_MS;
+    }
+    return _poll(fds, nfds, to);
+}
+
+int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *errorfds,
+           struct timeval *timeout)
+{
+    struct pollfd fds[VFS_MAX_OPEN_FILES];
+    nfds_t num = 0;
+    uint32_t to = _NO_TIMEOUT;
+    int res = 0;
+
+    if ((nfds < 0) || (nfds > FD_SETSIZE)) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (int fd = 0; fd < nfds; fd++) {
+        short events = 0;
+
+        if ((readfds != NULL) && FD_ISSET(fd, readfds)) {
+            events |= POLLIN;
+        }
+        if ((writefds != NULL) && FD_ISSET(fd, writefds)) {
+            events |= POLLOUT;
+        }
+        if ((events == 0) &&
+            ((errorfds == NULL) || !FD_ISSET(fd, errorfds))) {
+            continue;
+        }
+        if (fd >= VFS_MAX_OPEN_FILES) {
+            errno = EBADF;
+            return -1;
+        }
+        fds[num].fd = fd;
+        fds[num].events = events;
+        num++;
+    }
+    if (timeout != NULL) {
+        if ((timeout->tv_sec < 0) || (timeout->tv_usec < 0) ||
+            (timeout->tv_usec >= (long)US_PER_SEC)) {
+            errno = EINVAL;
+            return -1;
+        }
+        if ((uint64_t)timeout->tv_sec >= (_MAX_TIMEOUT / US_PER_SEC)) {
+            to = _MAX_TIMEOUT;
+        }
+        else {
+            to = (timeout->tv_sec * US_PER_SEC) + timeout->tv_usec;
+        }
+    }
+    _poll(fds, num, to);
+    for (nfds_t i = 0; i < num; i++) {
+        if (fds[i].revents & POLLNVAL) {
+            errno = EBADF;
+            return -1;
+        }
+    }
+    if (readfds != NULL) {
+        FD_ZERO(readfds);
+    }
+    if (writefds != NULL) {
+        FD_ZERO(writefds);
+    }
+    if (errorfds != NULL) {
+        /* no exceptional conditions are reported by the VFS */
+        FD_ZERO(errorfds);
+    }
+    for (nfds_t i = 0; i < num; i++) {
+        /* an error makes a file ready, so the next call reports it */
+        if ((fds[i].events & POLLIN) &&
+            (fds[i].revents & (POLLIN | POLLERR))) {
+            FD_SET(fds[i].fd, readfds);
+            res++;
+        }
+        if ((fds[i].events & POLLOUT) &&
+            (fds[i].revents & (POLLOUT | POLLERR))) {
+            FD_SET(fds[i].fd, writefds);
+            res++;
+        }
+    }
+    return res;
+}
+
+/** @} */
@@ -58,7 +58,10 @@ extern "C" {
  * @brief           If a thread attempts to acquire a held lock,
  *                  the holding thread gets its dynamic priority increased up to
  *                  the priority of the blocked thread
- * @note            Not implemented, yet.
+ * @note            The protocol attribute is not evaluated per mutex. All
+ *                  mutexes behave like #PTHREAD_PRIO_INHERIT if the module
+ *                  `core_mutex_priority_inheritance` is used, and like
+ *                  #PTHREAD_PRIO_NONE otherwise.
  */
 #define PTHREAD_PRIO_NONE        0
 #define PTHREAD_PRIO_INHERIT     1
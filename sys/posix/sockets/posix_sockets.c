@@ -23,10 +23,12 @@
 #include <string.h>
 
 #include "bitfield.h"
+#include "irq.h"
 #include "mutex.h"
 #include "net/ipv4/addr.h"
 #include "net/ipv6/addr.h"
 #include "random.h"
+#include "thread.h"
 #include "vfs.h"
 
 #include "sys/socket.h"
@@ -41,6 +43,12 @@
                                     (SOCKET_POOL_SIZE * SOCKET_TCP_QUEUE_SIZE))
 #define SOCKET_BLKSIZE             (512)
 
+#if defined(MODULE_POSIX_POLL) && defined(MODULE_SOCK_ASYNC)
+#include "thread_flags.h"
+
+#define SOCKET_POLL                /**< sockets can be waited for with poll() */
+#endif
+
 /**
  * @brief   Unitfied connection type.
  */
@@ -78,6 +86,10 @@ typedef struct {
     unsigned queue_array_len;
 #endif
     sock_tcp_ep_t local;        /* to store bind before connect/listen */
+#ifdef SOCKET_POLL
+    kernel_pid_t poll_waiter;   /* thread to notify on events */
+    unsigned recv_avail;        /* number of messages queued at sock */
+#endif
 } socket_t;
 
 static socket_t _socket_pool[_ACTUAL_SOCKET_POOL_SIZE];
@@ -98,6 +110,7 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
 static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
                              int flags, const struct sockaddr *address,
                              socklen_t address_len);
+static int socket_poll(vfs_file_t *filp, unsigned events, kernel_pid_t waiter);
 
 static socket_t *_get_free_socket(void)
 {
@@ -243,6 +256,59 @@ static int _sockaddr_to_ep(const struct sockaddr *address, socklen_t address_len
     return 0;
 }
 
+#ifdef SOCKET_POLL
+static void _socket_event(socket_t *s, sock_async_flags_t flags)
+{
+    kernel_pid_t waiter;
+    unsigned state;
+
+    if (!(flags & SOCK_ASYNC_MSG_RECV)) {
+        return;
+    }
+    state = irq_disable();
+    s->recv_avail++;
+    waiter = s->poll_waiter;
+    irq_restore(state);
+    if (waiter != KERNEL_PID_UNDEF) {
+        thread_t *thread = (thread_t *)thread_get(waiter);
+
+        if (thread != NULL) {
+            thread_flags_set(thread, VFS_POLL_THREAD_FLAG);
+        }
+    }
+}
+
+#ifdef MODULE_SOCK_IP
+static void _ip_cb(sock_ip_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _socket_event(arg, flags);
+}
+#endif
+
+#ifdef MODULE_SOCK_UDP
+static void _udp_cb(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    (void)sock;
+    _socket_event(arg, flags);
+}
+#endif
+
+static void _recv_done(socket_t *s, int res)
+{
+    /* every result but these consumed a message of the sock */
+    if ((res != -EAGAIN) && (res != -ETIMEDOUT) &&
+        (res != -EADDRNOTAVAIL) && (res != -EINTR)) {
+        unsigned state = irq_disable();
+
+        if (s->recv_avail > 0) {
+            s->recv_avail--;
+        }
+        irq_restore(state);
+    }
+}
+#endif
+
 static int socket_close(vfs_file_t *filp)
 {
     socket_t *s = filp->private_data.ptr;
@@ -322,6 +388,7 @@ static const vfs_file_ops_t socket_ops = {
     .lseek = socket_lseek,
     .read = socket_read,
     .write = socket_write,
+    .poll = socket_poll,
 };
 
 int socket(int domain, int type, int protocol)
@@ -360,6 +427,10 @@ int socket(int domain, int type, int protocol)
             }
             s->bound = false;
             s->sock = NULL;
+#ifdef SOCKET_POLL
+            s->poll_waiter = KERNEL_PID_UNDEF;
+            s->recv_avail = 0;
+#endif
 #ifdef POSIX_SETSOCKOPT
             s->recv_timeout = SOCK_NO_TIMEOUT;
 #endif
@@ -457,6 +528,10 @@ int accept(int socket, struct sockaddr *restrict address,
                 new_s->bound = true;
                 new_s->queue_array = NULL;
                 new_s->queue_array_len = 0;
+#ifdef SOCKET_POLL
+                new_s->poll_waiter = KERNEL_PID_UNDEF;
+                new_s->recv_avail = 0;
+#endif
                 memset(&s->local, 0, sizeof(sock_tcp_ep_t));
             }
             break;
@@ -590,6 +665,22 @@ static int _bind_connect(socket_t *s, const struct sockaddr *address,
         return -1;
     }
     s->sock = sock;
+#ifdef SOCKET_POLL
+    switch (s->type) {
+#ifdef MODULE_SOCK_IP
+        case SOCK_RAW:
+            sock_ip_set_cb(&sock->raw, _ip_cb, s);
+            break;
+#endif
+#ifdef MODULE_SOCK_UDP
+        case SOCK_DGRAM:
+            sock_udp_set_cb(&sock->udp, _udp_cb, s);
+            break;
+#endif
+        default:
+            break;
+    }
+#endif
     return 0;
 }
 
@@ -841,6 +932,9 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
         case SOCK_RAW:
             res = sock_ip_recv(&s->sock->raw, buffer, length, recv_timeout,
                                (sock_ip_ep_t *)&ep);
+#ifdef SOCKET_POLL
+            _recv_done(s, res);
+#endif
             break;
 #endif
 #ifdef MODULE_SOCK_TCP
@@ -853,6 +947,9 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
         case SOCK_DGRAM:
             res = sock_udp_recv(&s->sock->udp, buffer, length, recv_timeout,
                                 &ep);
+#ifdef SOCKET_POLL
+            _recv_done(s, res);
+#endif
             break;
 #endif
         default:
@@ -972,6 +1069,39 @@ static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
     return res;
 }
 
+#ifdef SOCKET_POLL
+static int socket_poll(vfs_file_t *filp, unsigned events, kernel_pid_t waiter)
+{
+    socket_t *s = filp->private_data.ptr;
+    int res = VFS_POLLOUT;  /* datagrams can always be sent */
+
+    if ((s->type != SOCK_DGRAM) && (s->type != SOCK_RAW)) {
+        return -EOPNOTSUPP;
+    }
+    if (s->sock == NULL) {
+        /* bind implicitly, like recvfrom() would, to be able to receive */
+        if (_bind_connect(s, NULL, 0) < 0) {
+            return -errno;
+        }
+    }
+    s->poll_waiter = waiter;
+    if (s->recv_avail > 0) {
+        res |= VFS_POLLIN;
+    }
+    return res & events;
+}
+#else
+static int socket_poll(vfs_file_t *filp, unsigned events, kernel_pid_t waiter)
+{
+    (void)filp;
+    (void)events;
+    (void)waiter;
+    /* without sock_async a received datagram is not noticed, so reporting
+     * the socket as ready would make the next recvfrom() block */
+    return -EOPNOTSUPP;
+}
+#endif
+
 ssize_t sendto(int socket, const void *buffer, size_t length, int flags,
                const struct sockaddr *address, socklen_t address_len)
 {
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_schedtrace
+ * @{
+ *
+ * @file
+ * @brief       Scheduler trace ring buffer
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "irq.h"
+#include "schedtrace.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#if (SCHEDTRACE_BUFSIZE & (SCHEDTRACE_BUFSIZE - 1))
+#error "SCHEDTRACE_BUFSIZE must be a power of 2"
+#endif
+
+/* number of events taken out of the buffer at once by schedtrace_dump() */
+#define DUMP_CHUNK      (8U)
+
+static schedtrace_event_t _buf[SCHEDTRACE_BUFSIZE];
+/* free running counters of written and read events, the buffer holds the
+ * events in [_tail, _head) */
+static uint32_t _head, _tail;
+static uint32_t _lost;
+static uint8_t _enabled;
+
+void schedtrace_add(uint8_t type, kernel_pid_t pid, uint32_t arg)
+{
+    unsigned state = irq_disable();
+
+    if (_enabled) {
+        schedtrace_event_t *event = &_buf[_head++ & (SCHEDTRACE_BUFSIZE - 1)];
+
+        event->time = xtimer_now_usec();
+        event->arg = arg;
+        event->pid = pid;
+        event->type = type;
+        if ((_head - _tail) > SCHEDTRACE_BUFSIZE) {
+            /* overwrote the oldest event */
+            _tail++;
+            _lost++;
+        }
+    }
+
+    irq_restore(state);
+}
+
+void schedtrace_start(void)
+{
+    _enabled = 1;
+}
+
+void schedtrace_stop(void)
+{
+    _enabled = 0;
+}
+
+void schedtrace_clear(void)
+{
+    unsigned state = irq_disable();
+
+    _tail = _head;
+    _lost = 0;
+    irq_restore(state);
+}
+
+unsigned schedtrace_read(schedtrace_event_t *events, unsigned numof)
+{
+    unsigned state = irq_disable();
+    unsigned res = 0;
+
+    while ((res < numof) && (_tail != _head)) {
+        events[res++] = _buf[_tail++ & (SCHEDTRACE_BUFSIZE - 1)];
+    }
+
+    irq_restore(state);
+    return res;
+}
+
+uint32_t schedtrace_lost(void)
+{
+    return _lost;
+}
+
+void schedtrace_dump(void)
+{
+    schedtrace_event_t events[DUMP_CHUNK];
+    /* printing may produce events itself, so only dump what is there now */
+    uint32_t left = _head - _tail;
+    unsigned numof;
+
+    printf("schedtrace: begin %" PRIu32 " %" PRIu32 " %" PRIkernel_pid "\n",
+           (uint32_t)SCHEDTRACE_BUFSIZE, _lost, (kernel_pid_t)KERNEL_PID_ISR);
+#ifdef DEVELHELP
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        const char *name = thread_getname(pid);
+
+        if (name != NULL) {
+            printf("schedtrace: thread %" PRIkernel_pid " %s\n", pid, name);
+        }
+    }
+#endif
+    while ((left > 0) &&
+           ((numof = schedtrace_read(events, (left < DUMP_CHUNK) ? left : DUMP_CHUNK)) > 0)) {
+        left -= numof;
+        for (unsigned i = 0; i < numof; i++) {
+            printf("schedtrace: e %" PRIu32 " %u %" PRIkernel_pid " %" PRIx32 "\n",
+                   events[i].time, (unsigned)events[i].type, events[i].pid,
+                   events[i].arg);
+        }
+    }
+    puts("schedtrace: end");
+}
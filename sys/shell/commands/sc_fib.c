@@ -30,6 +30,9 @@
 #endif
 #include "net/fib.h"
 #include "net/gnrc/ipv6.h"
+#ifdef MODULE_GNRC_IPV6_DCACHE
+#include "net/gnrc/ipv6/dcache.h"
+#endif
 
 #define INFO1_TXT "fibroute add <destination> via <next hop> [dev <device>]"
 #define INFO2_TXT " [lifetime <lifetime>]"
@@ -134,6 +137,12 @@ int _fib_route_handler(int argc, char **argv)
     /* e.g. fibroute right now dont care about the adress/protocol family */
     if (argc == 1) {
         fib_print_routes(&gnrc_ipv6_fib_table);
+#ifdef MODULE_GNRC_IPV6_DCACHE
+        gnrc_ipv6_dcache_stats_t stats;
+        gnrc_ipv6_dcache_get_stats(&stats);
+        printf("\nDestination cache: %" PRIu32 " hits, %" PRIu32 " misses\n",
+               stats.hits, stats.misses);
+#endif
         return 0;
     }
 
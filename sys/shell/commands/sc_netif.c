@@ -42,6 +42,9 @@
 #ifdef MODULE_L2FILTER
 #include "net/l2filter.h"
 #endif
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+#include "net/gnrc/sixlowpan/frag.h"
+#endif
 
 /**
  * @brief   The maximal expected link layer address length in byte
@@ -122,7 +125,8 @@ static int _netif_stats(kernel_pid_t dev, unsigned module, bool reset)
         printf("           Statistics for %s\n"
                "            RX packets %u  bytes %u\n"
                "            TX packets %u (Multicast: %u)  bytes %u\n"
-               "            TX succeeded %u errors %u\n",
+               "            TX succeeded %u errors %u\n"
+               "            TX bytes copied %u\n",
                _netstats_module_to_str(module),
                (unsigned) stats->rx_count,
                (unsigned) stats->rx_bytes,
@@ -130,7 +134,14 @@ static int _netif_stats(kernel_pid_t dev, unsigned module, bool reset)
                (unsigned) stats->tx_mcast_count,
                (unsigned) stats->tx_bytes,
                (unsigned) stats->tx_success,
-               (unsigned) stats->tx_failed);
+               (unsigned) stats->tx_failed,
+               (unsigned) stats->tx_copied_bytes);
+        if (stats->tx_frag_count > 0) {
+            printf("            TX fragmented %u  latency avg %lu us max %lu us\n",
+                   (unsigned) stats->tx_frag_count,
+                   (unsigned long) (stats->tx_frag_latency / stats->tx_frag_count),
+                   (unsigned long) stats->tx_frag_latency_max);
+        }
         res = 0;
     }
     return res;
@@ -535,6 +546,21 @@ static void _netif_list(kernel_pid_t dev)
 #endif
 #ifdef MODULE_NETSTATS_IPV6
     _netif_stats(dev, NETSTATS_IPV6, false);
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+    if (gnrc_sixlowpan_netif_get(dev) != NULL) {
+        gnrc_sixlowpan_frag_stats_t *frag_stats = gnrc_sixlowpan_frag_stats_get();
+
+        printf("           6LoWPAN fragmentation (all interfaces)\n"
+               "            forwarded fragments %u  datagrams %u\n"
+               "            reassembled fragments %u  datagrams %u\n"
+               "            virtual reassembly buffer full %u\n",
+               (unsigned) frag_stats->frags_forwarded,
+               (unsigned) frag_stats->datagrams_forwarded,
+               (unsigned) frag_stats->frags_reassembled,
+               (unsigned) frag_stats->datagrams_reassembled,
+               (unsigned) frag_stats->vrb_full);
+    }
 #endif
     puts("");
 }
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell command to control and dump the scheduler trace
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "schedtrace.h"
+
+static void _usage(const char *cmd)
+{
+    printf("usage: %s [start|stop|clear|dump]\n", cmd);
+}
+
+int _schedtrace_handler(int argc, char **argv)
+{
+    if ((argc < 2) || (strcmp(argv[1], "dump") == 0)) {
+        schedtrace_dump();
+    }
+    else if (strcmp(argv[1], "start") == 0) {
+        schedtrace_start();
+    }
+    else if (strcmp(argv[1], "stop") == 0) {
+        schedtrace_stop();
+    }
+    else if (strcmp(argv[1], "clear") == 0) {
+        schedtrace_clear();
+    }
+    else {
+        _usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
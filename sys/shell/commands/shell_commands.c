@@ -106,6 +106,14 @@ extern int _whitelist(int argc, char **argv);
 extern int _blacklist(int argc, char **argv);
 #endif
 
+#ifdef MODULE_GNRC_PKTBUF_SLAB
+extern int _gnrc_pktbuf_slab(int argc, char **argv);
+#endif
+
+#ifdef MODULE_SCHEDTRACE
+extern int _schedtrace_handler(int argc, char **argv);
+#endif
+
 #ifdef MODULE_GNRC_RPL
 extern int _gnrc_rpl(int argc, char **argv);
 #endif
@@ -197,6 +205,12 @@ const shell_command_t _shell_command_list[] = {
 #ifdef MODULE_GNRC_IPV6_BLACKLIST
     {"blacklist", "blacklists an address for receival ('blacklist [add|del|help]')", _blacklist },
 #endif
+#ifdef MODULE_GNRC_PKTBUF_SLAB
+    {"pktbuf", "prints usage statistics of the packet buffer size classes", _gnrc_pktbuf_slab },
+#endif
+#ifdef MODULE_SCHEDTRACE
+    {"schedtrace", "control and dump the scheduler trace", _schedtrace_handler },
+#endif
 #ifdef MODULE_GNRC_RPL
     {"rpl", "rpl configuration tool ('rpl help' for more information)", _gnrc_rpl },
 #endif
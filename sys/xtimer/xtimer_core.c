@@ -23,6 +23,7 @@
 
 #include "xtimer.h"
 #include "irq.h"
+#include "schedtrace.h"
 
 /* WARNING! enabling this will have side effects and can lead to timer underflows. */
 #define ENABLE_DEBUG 0
@@ -43,6 +44,7 @@ static xtimer_t *long_list_head = NULL;
 
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer);
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer);
+static xtimer_t *_pop_timer(xtimer_t **list_head);
 static void _shoot(xtimer_t *timer);
 static void _remove(xtimer_t *timer);
 static inline void _lltimer_set(uint32_t target);
@@ -156,6 +158,7 @@ static void _periph_timer_callback(void *arg, int chan)
 
 static void _shoot(xtimer_t *timer)
 {
+    schedtrace_event(SCHEDTRACE_TIMER, (uintptr_t)timer->callback);
     timer->callback(timer->arg);
 }
 
@@ -175,7 +178,9 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
 
     DEBUG("timer_set_absolute(): now=%" PRIu32 " target=%" PRIu32 "\n", now, target);
 
+#ifndef MODULE_XTIMER_HEAP
     timer->next = NULL;
+#endif
     if ((target >= now) && ((target - XTIMER_BACKOFF) < now)) {
         /* backoff */
         xtimer_spin_until(target + XTIMER_BACKOFF);
@@ -219,6 +224,7 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
     return res;
 }
 
+#ifndef MODULE_XTIMER_HEAP
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer)
 {
     while (*list_head && (*list_head)->target <= timer->target) {
@@ -254,11 +260,179 @@ static int _remove_timer_from_list(xtimer_t **list_head, xtimer_t *timer)
     return 0;
 }
 
+static xtimer_t *_pop_timer(xtimer_t **list_head)
+{
+    xtimer_t *timer = *list_head;
+
+    *list_head = timer->next;
+    return timer;
+}
+
+static void _remove_timer(xtimer_t *timer)
+{
+    if (!_remove_timer_from_list(&timer_list_head, timer)) {
+        if (!_remove_timer_from_list(&overflow_list_head, timer)) {
+            _remove_timer_from_list(&long_list_head, timer);
+        }
+    }
+}
+#else /* MODULE_XTIMER_HEAP */
+/*
+ * With xtimer_heap, timer_list_head, overflow_list_head and long_list_head
+ * are the roots of pairing heaps ordered by (long_target, target).
+ * `next` links siblings, `child` points to the first child and `prev` to the
+ * parent (for a first child) or to the previous sibling. Roots have
+ * prev == NULL.
+ */
+static inline int _is_before(const xtimer_t *a, const xtimer_t *b)
+{
+    if (a->long_target != b->long_target) {
+        return (a->long_target < b->long_target);
+    }
+    return (a->target < b->target);
+}
+
+/**
+ * @brief link two heap roots, return the new root
+ */
+static xtimer_t *_heap_link(xtimer_t *a, xtimer_t *b)
+{
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    if (_is_before(b, a)) {
+        xtimer_t *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    /* b becomes the first child of a */
+    b->prev = a;
+    b->next = a->child;
+    if (a->child) {
+        a->child->prev = b;
+    }
+    a->child = b;
+
+    return a;
+}
+
+/**
+ * @brief combine a list of siblings into one heap (two-pass pairing)
+ */
+static xtimer_t *_heap_combine(xtimer_t *first)
+{
+    xtimer_t *pairs = NULL;
+    xtimer_t *root = NULL;
+
+    /* first pass: link pairs left to right, collect them in reverse order */
+    while (first) {
+        xtimer_t *a = first;
+        xtimer_t *b = a->next;
+
+        first = (b) ? b->next : NULL;
+        a->next = a->prev = NULL;
+        if (b) {
+            b->next = b->prev = NULL;
+        }
+        a = _heap_link(a, b);
+        a->next = pairs;
+        pairs = a;
+    }
+
+    /* second pass: link the pairs right to left */
+    while (pairs) {
+        xtimer_t *next = pairs->next;
+
+        pairs->next = NULL;
+        root = _heap_link(root, pairs);
+        pairs = next;
+    }
+
+    return root;
+}
+
+static void _heap_insert(xtimer_t **heap, xtimer_t *timer)
+{
+    timer->next = timer->child = timer->prev = NULL;
+    *heap = _heap_link(*heap, timer);
+}
+
+/**
+ * @brief unlink a timer that is not a heap root from its heap
+ */
+static void _heap_cut(xtimer_t *timer)
+{
+    xtimer_t *prev = timer->prev;
+    xtimer_t *next = timer->next;
+    /* the children's subtree takes the place of the removed timer, this
+     * keeps the heap property as all of them expire after it */
+    xtimer_t *sub = _heap_combine(timer->child);
+
+    if (sub) {
+        sub->prev = prev;
+        sub->next = next;
+        if (next) {
+            next->prev = sub;
+        }
+    }
+    else {
+        if (next) {
+            next->prev = prev;
+        }
+        sub = next;
+    }
+
+    if (prev->child == timer) {
+        prev->child = sub;
+    }
+    else {
+        prev->next = sub;
+    }
+
+    timer->next = timer->child = timer->prev = NULL;
+}
+
+static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer)
+{
+    _heap_insert(list_head, timer);
+}
+
+static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer)
+{
+    _heap_insert(list_head, timer);
+}
+
+static xtimer_t *_pop_timer(xtimer_t **list_head)
+{
+    xtimer_t *timer = *list_head;
+
+    *list_head = _heap_combine(timer->child);
+    timer->child = NULL;
+    return timer;
+}
+
+static void _remove_timer(xtimer_t *timer)
+{
+    if (timer->prev) {
+        _heap_cut(timer);
+    }
+    else if (overflow_list_head == timer) {
+        _pop_timer(&overflow_list_head);
+    }
+    else if (long_list_head == timer) {
+        _pop_timer(&long_list_head);
+    }
+}
+#endif /* MODULE_XTIMER_HEAP */
+
 static void _remove(xtimer_t *timer)
 {
     if (timer_list_head == timer) {
         uint32_t next;
-        timer_list_head = timer->next;
+        _pop_timer(&timer_list_head);
         if (timer_list_head) {
             /* schedule callback on next timer target time */
             next = timer_list_head->target - XTIMER_OVERHEAD;
@@ -269,11 +443,7 @@ static void _remove(xtimer_t *timer)
         _lltimer_set(next);
     }
     else {
-        if (!_remove_timer_from_list(&timer_list_head, timer)) {
-            if (!_remove_timer_from_list(&overflow_list_head, timer)) {
-                _remove_timer_from_list(&long_list_head, timer);
-            }
-        }
+        _remove_timer(timer);
     }
 }
 
@@ -311,6 +481,7 @@ static inline int _this_high_period(uint32_t target) {
 #endif
 }
 
+#ifndef MODULE_XTIMER_HEAP
 /**
  * @brief compare two timers' target values, return the one with lower value.
  *
@@ -400,6 +571,19 @@ static void _select_long_timers(void)
         }
     }
 }
+#else /* MODULE_XTIMER_HEAP */
+/**
+ * @brief move timers from the long timer heap that will expire in the current
+ *        short timer period to the current timer heap
+ */
+static void _select_long_timers(void)
+{
+    while (long_list_head && (long_list_head->long_target <= _long_cnt)
+           && _this_high_period(long_list_head->target)) {
+        _heap_insert(&timer_list_head, _pop_timer(&long_list_head));
+    }
+}
+#endif /* MODULE_XTIMER_HEAP */
 
 /**
  * @brief handle low-level timer overflow, advance to next short timer period
@@ -468,11 +652,8 @@ overflow:
         /* make sure we don't fire too early */
         while (_time_left(_xtimer_lltimer_mask(timer_list_head->target), reference));
 
-        /* pick first timer in list */
-        xtimer_t *timer = timer_list_head;
-
-        /* advance list */
-        timer_list_head = timer->next;
+        /* pick first timer in list and advance list */
+        xtimer_t *timer = _pop_timer(&timer_list_head);
 
         /* make sure timer is recognized as being already fired */
         timer->target = 0;
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput test for pipelined QoS 1 publishing of emCute with
+ *              a stand-in MQTT-SN gateway on the loopback address
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/emcute.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define _GW_STACK_SIZE      (THREAD_STACKSIZE_DEFAULT)
+#define _EMCUTE_STACK_SIZE  (THREAD_STACKSIZE_DEFAULT)
+
+#define _GW_PORT            (10000U)
+#define _EMCUTE_PORT        (EMCUTE_DEFAULT_PORT)
+/* the gateway acknowledges messages after this time, i.e. the round trip
+ * time emCute sees */
+#define _GW_DELAY           (20U * US_PER_MS)
+#define _ACKS_MAX           (8U)
+#define _TOPICS_NUMOF       (6U)
+#define _PUB_NUMOF          (16U)
+#define _TEST_DATA          "telemetry"
+
+/* MQTT-SN message types */
+#define _CONNECT            (0x04)
+#define _CONNACK            (0x05)
+#define _REGISTER           (0x0a)
+#define _REGACK             (0x0b)
+#define _PUBLISH            (0x0c)
+#define _PUBACK             (0x0d)
+#define _DISCONNECT         (0x18)
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+typedef struct {
+    uint32_t due;
+    uint8_t buf[7];
+} _ack_t;
+
+static char _gw_stack[_GW_STACK_SIZE];
+static char _emcute_stack[_EMCUTE_STACK_SIZE];
+static sock_udp_t _gw_sock;
+static sock_udp_ep_t _client;
+
+/* delayed acknowledgments of the gateway, in order of their due time */
+static _ack_t _acks[_ACKS_MAX];
+static unsigned _acks_numof;
+static uint16_t _tid_next = 1;
+
+/* most messages the gateway had to acknowledge at the same time */
+static unsigned _inflight_max;
+/* number of PUBLISH messages received, with DUP flag, and still to ignore */
+static unsigned _pubs, _dups, _drop;
+
+static emcute_topic_t _topics[_TOPICS_NUMOF];
+static char _topic_names[_TOPICS_NUMOF][sizeof("test/0")];
+
+static void _gw_send(const uint8_t *buf, size_t len)
+{
+    assert(sock_udp_send(&_gw_sock, buf, len, &_client) == (ssize_t)len);
+}
+
+static void _gw_ack_later(uint8_t type, const uint8_t *ids)
+{
+    _ack_t *ack = &_acks[_acks_numof++];
+
+    assert(_acks_numof <= _ACKS_MAX);
+    ack->due = xtimer_now_usec() + _GW_DELAY;
+    ack->buf[0] = sizeof(ack->buf);
+    ack->buf[1] = type;
+    /* topic ID and message ID */
+    memcpy(&ack->buf[2], ids, 4);
+    ack->buf[6] = 0;
+    if (_acks_numof > _inflight_max) {
+        _inflight_max = _acks_numof;
+    }
+}
+
+static void _gw_handle(const uint8_t *buf)
+{
+    switch (buf[1]) {
+        case _CONNECT: {
+            uint8_t connack[] = { 3, _CONNACK, 0 };
+            _gw_send(connack, sizeof(connack));
+            break;
+        }
+        case _REGISTER: {
+            uint8_t ids[] = { _tid_next >> 8, _tid_next & 0xff, buf[4], buf[5] };
+            _tid_next++;
+            _gw_ack_later(_REGACK, ids);
+            break;
+        }
+        case _PUBLISH:
+            _pubs++;
+            if (buf[2] & EMCUTE_DUP) {
+                _dups++;
+            }
+            if (_drop > 0) {
+                _drop--;
+                break;
+            }
+            _gw_ack_later(_PUBACK, &buf[3]);
+            break;
+        case _DISCONNECT: {
+            uint8_t discon[] = { 2, _DISCONNECT };
+            _gw_send(discon, sizeof(discon));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void *_gw(void *arg)
+{
+    sock_udp_ep_t local = { .family = AF_INET6, .port = _GW_PORT,
+                            .netif = SOCK_ADDR_ANY_NETIF };
+    sock_udp_ep_t remote;
+    uint8_t buf[64];
+
+    (void)arg;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&local.addr.ipv6);
+    assert(sock_udp_create(&_gw_sock, &local, NULL, 0) == 0);
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+
+        if (_acks_numof > 0) {
+            int32_t diff = (int32_t)(_acks[0].due - xtimer_now_usec());
+            timeout = (diff > 0) ? (uint32_t)diff : 0;
+        }
+        ssize_t res = sock_udp_recv(&_gw_sock, buf, sizeof(buf), timeout,
+                                    &remote);
+        if (res >= 2) {
+            memcpy(&_client, &remote, sizeof(_client));
+            _gw_handle(buf);
+        }
+        while ((_acks_numof > 0) &&
+               ((int32_t)(_acks[0].due - xtimer_now_usec()) <= 0)) {
+            _gw_send(_acks[0].buf, sizeof(_acks[0].buf));
+            memmove(&_acks[0], &_acks[1], --_acks_numof * sizeof(_acks[0]));
+        }
+    }
+    return NULL;
+}
+
+static void *_emcute(void *arg)
+{
+    (void)arg;
+    emcute_run(_EMCUTE_PORT, "pipeline");
+    return NULL;
+}
+
+static void _reset_stats(void)
+{
+    _inflight_max = 0;
+    _pubs = 0;
+    _dups = 0;
+}
+
+static unsigned _rate(uint32_t start)
+{
+    return (unsigned)(((uint64_t)_PUB_NUMOF * US_PER_SEC) /
+                      (xtimer_now_usec() - start));
+}
+
+static void test_emcute__con(void)
+{
+    sock_udp_ep_t gw = { .family = AF_INET6, .port = _GW_PORT,
+                         .netif = SOCK_ADDR_ANY_NETIF };
+
+    ipv6_addr_set_loopback((ipv6_addr_t *)&gw.addr.ipv6);
+    assert(emcute_con(&gw, true, NULL, NULL, 0, 0) == EMCUTE_OK);
+    /* already connected */
+    assert(emcute_con(&gw, true, NULL, NULL, 0, 0) == EMCUTE_NOGW);
+}
+
+static void test_emcute__reg_batch(void)
+{
+    _reset_stats();
+    for (unsigned i = 0; i < _TOPICS_NUMOF; i++) {
+        snprintf(_topic_names[i], sizeof(_topic_names[i]), "test/%u", i);
+        _topics[i].name = _topic_names[i];
+        _topics[i].id = 0;
+    }
+    assert(emcute_reg_batch(_topics, _TOPICS_NUMOF) == EMCUTE_OK);
+    for (unsigned i = 0; i < _TOPICS_NUMOF; i++) {
+        assert(_topics[i].id != 0);
+        for (unsigned j = 0; j < i; j++) {
+            assert(_topics[i].id != _topics[j].id);
+        }
+    }
+    assert(_inflight_max == EMCUTE_INFLIGHT_MAX);
+}
+
+static void test_emcute__pub_sync(void)
+{
+    uint32_t start = xtimer_now_usec();
+
+    _reset_stats();
+    for (unsigned i = 0; i < _PUB_NUMOF; i++) {
+        assert(emcute_pub(&_topics[i % _TOPICS_NUMOF], _TEST_DATA,
+                          sizeof(_TEST_DATA), EMCUTE_QOS_1) == EMCUTE_OK);
+    }
+    printf("synchronous: %u msg/s\n", _rate(start));
+    assert(_pubs == _PUB_NUMOF);
+    assert(_inflight_max == 1);
+}
+
+static void test_emcute__pub_async(void)
+{
+    uint32_t start = xtimer_now_usec();
+
+    _reset_stats();
+    for (unsigned i = 0; i < _PUB_NUMOF; i++) {
+        assert(emcute_pub_async(&_topics[i % _TOPICS_NUMOF], _TEST_DATA,
+                                sizeof(_TEST_DATA), EMCUTE_QOS_1) == EMCUTE_OK);
+    }
+    assert(emcute_flush() == EMCUTE_OK);
+    printf("asynchronous: %u msg/s\n", _rate(start));
+    assert(_pubs == _PUB_NUMOF);
+    /* the throughput depends on the timing of the host, but more than one
+     * publish in flight proves that the round trips are overlapped */
+    assert(_inflight_max > 1);
+    assert(_inflight_max == EMCUTE_INFLIGHT_MAX);
+}
+
+static void test_emcute__retransmit(void)
+{
+    _reset_stats();
+    _drop = 1;
+    assert(emcute_pub(&_topics[0], _TEST_DATA, sizeof(_TEST_DATA),
+                      EMCUTE_QOS_1) == EMCUTE_OK);
+    assert(_pubs == 2);
+    assert(_dups == 1);
+}
+
+static void test_emcute__timeout(void)
+{
+    _reset_stats();
+    _drop = EMCUTE_N_RETRY;
+    assert(emcute_pub_async(&_topics[0], _TEST_DATA, sizeof(_TEST_DATA),
+                            EMCUTE_QOS_1) == EMCUTE_OK);
+    assert(emcute_flush() == EMCUTE_TIMEOUT);
+    assert(_pubs == EMCUTE_N_RETRY);
+    /* the error was reported already */
+    assert(emcute_flush() == EMCUTE_OK);
+}
+
+static void test_emcute__discon(void)
+{
+    assert(emcute_discon() == EMCUTE_OK);
+    assert(emcute_pub(&_topics[0], _TEST_DATA, sizeof(_TEST_DATA),
+                      EMCUTE_QOS_1) == EMCUTE_NOGW);
+}
+
+int main(void)
+{
+    thread_create(_gw_stack, sizeof(_gw_stack), THREAD_PRIORITY_MAIN - 2,
+                  THREAD_CREATE_STACKTEST, _gw, NULL, "gateway");
+    thread_create(_emcute_stack, sizeof(_emcute_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _emcute, NULL, "emcute");
+
+    CALL(test_emcute__con());
+    CALL(test_emcute__reg_batch());
+    CALL(test_emcute__pub_sync());
+    CALL(test_emcute__pub_async());
+    CALL(test_emcute__retransmit());
+    CALL(test_emcute__timeout());
+    CALL(test_emcute__discon());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    child.expect_exact("Calling test_emcute__con()")
+    child.expect_exact("Calling test_emcute__reg_batch()")
+    child.expect_exact("Calling test_emcute__pub_sync()")
+    child.expect(r"synchronous: \d+ msg/s")
+    child.expect_exact("Calling test_emcute__pub_async()")
+    child.expect(r"asynchronous: \d+ msg/s")
+    child.expect_exact("Calling test_emcute__retransmit()")
+    child.expect_exact("Calling test_emcute__timeout()")
+    child.expect_exact("Calling test_emcute__discon()")
+    child.expect_exact("ALL TESTS SUCCESSFUL", timeout=30)
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
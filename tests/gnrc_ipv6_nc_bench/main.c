@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the lookup time of the neighbor cache
+ *
+ * Fills the neighbor cache with 8, 64 and 512 entries (as far as
+ * @ref GNRC_IPV6_NC_SIZE allows) and measures the time of lookups for
+ * present and absent neighbors.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "byteorder.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "xtimer.h"
+
+#define LOOKUPS             (10000U)
+#define TEST_NETIF          (1)
+#define TEST_L2ADDR         { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+
+static const uint8_t _l2addr[] = TEST_L2ADDR;
+
+/* does LOOKUPS lookups cycling through entries addresses starting at first,
+ * returns the time taken and sets found to the number of hits */
+static uint32_t _lookup(ipv6_addr_t *addr, unsigned first, unsigned entries,
+                        unsigned *found)
+{
+    uint32_t start = xtimer_now_usec();
+
+    *found = 0;
+    for (unsigned i = 0; i < LOOKUPS; i++) {
+        addr->u16[7] = byteorder_htons(first + (i % entries));
+        if (gnrc_ipv6_nc_get(TEST_NETIF, addr) != NULL) {
+            (*found)++;
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+static int _lookup_time(unsigned entries)
+{
+    ipv6_addr_t addr = { .u8 = { 0xfe, 0x80 } };
+    uint32_t hit, miss;
+    unsigned hits, misses;
+
+    gnrc_ipv6_nc_init();
+    for (unsigned i = 0; i < entries; i++) {
+        addr.u16[7] = byteorder_htons(i);
+        if (gnrc_ipv6_nc_add(TEST_NETIF, &addr, _l2addr, sizeof(_l2addr),
+                             GNRC_IPV6_NC_STATE_REACHABLE) == NULL) {
+            puts("error: could not fill neighbor cache");
+            return -1;
+        }
+    }
+
+    hit = _lookup(&addr, 0, entries, &hits);
+    miss = _lookup(&addr, entries, entries, &misses);
+    if ((hits != LOOKUPS) || (misses != 0)) {
+        puts("error: unexpected lookup result");
+        return -1;
+    }
+
+    printf("%u entries: %" PRIu32 " ns per hit, %" PRIu32 " ns per miss\n",
+           entries, (uint32_t)(((uint64_t)hit * 1000) / LOOKUPS),
+           (uint32_t)(((uint64_t)miss * 1000) / LOOKUPS));
+    return 0;
+}
+
+int main(void)
+{
+    static const unsigned sizes[] = { 8, 64, 512 };
+
+    puts("gnrc_ipv6_nc lookup time benchmark");
+    for (unsigned i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+        if ((sizes[i] <= GNRC_IPV6_NC_SIZE) && (_lookup_time(sizes[i]) < 0)) {
+            return 1;
+        }
+    }
+    puts("[SUCCESS]");
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the IPv6 interface statistics
+ *
+ * Sends packets over two dummy interfaces and checks the counters of
+ * @ref netstats_t, in particular netstats_t::tx_copied_bytes, which needs
+ * more than one interface and can thus not be tested within the unittests
+ * application.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/netstats.h"
+#include "utlist.h"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+#define _IFACE_NUMOF        (2U)
+#define _IFACE_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define _IFACE_PRIO         (THREAD_PRIORITY_MAIN - 1)
+#define _IFACE_QUEUE_SIZE   (4U)
+#define _MAIN_QUEUE_SIZE    (4U)
+
+#define _TEST_PAYLOAD       "IZ4SSl8TadXPE4xi9yNg5kJYdPTz5XHqAJW5FjU5NjY"
+
+static char _iface_stacks[_IFACE_NUMOF][_IFACE_STACKSIZE];
+static kernel_pid_t _ifaces[_IFACE_NUMOF];
+static msg_t _main_msg_queue[_MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+/* dummy interface: hands every packet to be sent over to the main thread */
+static void *_iface_thread(void *arg)
+{
+    msg_t msg, reply, msg_queue[_IFACE_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, _IFACE_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = (uint32_t)(-ENOTSUP);
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                msg_send(&msg, _main_pid);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+/* waits for a packet of size bytes to be sent over iface */
+static void _expect_send(kernel_pid_t iface, size_t size)
+{
+    msg_t msg;
+    gnrc_pktsnip_t *pkt;
+
+    msg_receive(&msg);
+    assert(msg.type == GNRC_NETAPI_MSG_TYPE_SND);
+    assert(msg.sender_pid == iface);
+    pkt = msg.content.ptr;
+    assert(pkt->type == GNRC_NETTYPE_NETIF);
+    assert(((gnrc_netif_hdr_t *)pkt->data)->if_pid == iface);
+    assert(gnrc_pkt_len(pkt->next) == size);
+    gnrc_pktbuf_release(pkt);
+}
+
+static gnrc_pktsnip_t *_build_pkt(const ipv6_addr_t *dst)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, _TEST_PAYLOAD,
+                                          sizeof(_TEST_PAYLOAD),
+                                          GNRC_NETTYPE_UNDEF);
+
+    assert(pkt != NULL);
+    pkt = gnrc_ipv6_hdr_build(pkt, NULL, dst);
+    assert(pkt != NULL);
+    return pkt;
+}
+
+static void test_ipv6_netstats__send_iface(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(&ipv6_addr_all_nodes_link_local);
+    gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    netstats_t *stats = gnrc_ipv6_netif_get_stats(_ifaces[1]);
+    netstats_t before;
+
+    assert(netif != NULL);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _ifaces[1];
+    LL_PREPEND(pkt, netif);
+    memcpy(&before, stats, sizeof(before));
+    assert(gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6,
+                                     GNRC_NETREG_DEMUX_CTX_ALL, pkt) == 1);
+    _expect_send(_ifaces[1], sizeof(ipv6_hdr_t) + sizeof(_TEST_PAYLOAD));
+    assert(stats->tx_mcast_count == (before.tx_mcast_count + 1));
+    /* the packet is not shared: nothing to copy */
+    assert(stats->tx_copied_bytes == before.tx_copied_bytes);
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_ipv6_netstats__send_mcast_copy(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(&ipv6_addr_all_nodes_link_local);
+    netstats_t before[_IFACE_NUMOF];
+    uint32_t copied = 0;
+
+    for (unsigned i = 0; i < _IFACE_NUMOF; i++) {
+        memcpy(&before[i], gnrc_ipv6_netif_get_stats(_ifaces[i]),
+               sizeof(netstats_t));
+    }
+    assert(gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6,
+                                     GNRC_NETREG_DEMUX_CTX_ALL, pkt) == 1);
+    for (unsigned i = 0; i < _IFACE_NUMOF; i++) {
+        netstats_t *stats = gnrc_ipv6_netif_get_stats(_ifaces[i]);
+
+        _expect_send(_ifaces[i], sizeof(ipv6_hdr_t) + sizeof(_TEST_PAYLOAD));
+        assert(stats->tx_mcast_count == (before[i].tx_mcast_count + 1));
+        copied += stats->tx_copied_bytes - before[i].tx_copied_bytes;
+    }
+    /* the packet is duplicated for all but the last interface */
+    assert(copied == ((_IFACE_NUMOF - 1) *
+                      (sizeof(ipv6_hdr_t) + sizeof(_TEST_PAYLOAD))));
+    assert(gnrc_pktbuf_is_empty());
+}
+
+int main(void)
+{
+    _main_pid = sched_active_pid;
+    msg_init_queue(_main_msg_queue, _MAIN_QUEUE_SIZE);
+    for (unsigned i = 0; i < _IFACE_NUMOF; i++) {
+        _ifaces[i] = thread_create(_iface_stacks[i], sizeof(_iface_stacks[i]),
+                                   _IFACE_PRIO, THREAD_CREATE_STACKTEST,
+                                   _iface_thread, NULL, "iface");
+        assert(_ifaces[i] > KERNEL_PID_UNDEF);
+        gnrc_netif_add(_ifaces[i]);
+        gnrc_ipv6_netif_add(_ifaces[i]);
+    }
+
+    CALL(test_ipv6_netstats__send_iface());
+    CALL(test_ipv6_netstats__send_mcast_copy());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the receive throughput of the network device(s)
+ *              through GNRC
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "msg.h"
+#include "net/gnrc.h"
+#include "xtimer.h"
+
+#define INTERVAL            (1U * US_PER_SEC)
+#define MAIN_QUEUE_SIZE     (16U)
+
+#define MSG_TYPE_REPORT     (0x0f01)
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+
+int main(void)
+{
+    gnrc_netreg_entry_t entry = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                           sched_active_pid);
+    msg_t report = { .type = MSG_TYPE_REPORT };
+    xtimer_t timer;
+    uint32_t last = xtimer_now_usec();
+    uint32_t pkts = 0, bytes = 0;
+
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    /* without a network layer all frames are passed up as undefined type */
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &entry);
+    puts("gnrc_netdev receive benchmark");
+    xtimer_set_msg(&timer, INTERVAL, &report, sched_active_pid);
+
+    while (1) {
+        msg_t msg;
+
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_RCV: {
+                gnrc_pktsnip_t *pkt = msg.content.ptr;
+
+                /* first snip is the link-layer payload */
+                pkts++;
+                bytes += pkt->size;
+                gnrc_pktbuf_release(pkt);
+                break;
+            }
+            case MSG_TYPE_REPORT: {
+                uint32_t now = xtimer_now_usec();
+                uint32_t diff = now - last;
+
+                if (pkts > 0) {
+                    printf("%" PRIu32 " packets/s, %" PRIu32 " kbit/s\n",
+                           (uint32_t)(((uint64_t)pkts * US_PER_SEC) / diff),
+                           (uint32_t)(((uint64_t)bytes * 8 * 1000) / diff));
+                }
+                pkts = 0;
+                bytes = 0;
+                last = now;
+                xtimer_set_msg(&timer, INTERVAL, &report, sched_active_pid);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the size-class packet buffer backend
+ *
+ * The backend replaces gnrc_pktbuf_static, so it can not be tested within
+ * the unittests application.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/pktbuf_slab.h"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+#define _SNIP_CLASS         (0U)
+#define _DATA_CLASSES       (GNRC_PKTBUF_SLAB_CLASSES - 1)
+
+static gnrc_pktsnip_t *_pkts[GNRC_PKTBUF_SLAB_NUMOF_3 + GNRC_PKTBUF_SLAB_NUMOF_4];
+
+static gnrc_pktbuf_slab_stats_t _stats(unsigned cls)
+{
+    gnrc_pktbuf_slab_stats_t stats;
+
+    assert(gnrc_pktbuf_slab_get_stats(cls, &stats) == 0);
+    return stats;
+}
+
+static inline uint16_t _size(unsigned cls)
+{
+    return _stats(cls).size;
+}
+
+static inline uint16_t _used(unsigned cls)
+{
+    return _stats(cls).used;
+}
+
+/* returns the data class an object of the packet was taken from */
+static unsigned _class_of_add(size_t size)
+{
+    uint16_t used[GNRC_PKTBUF_SLAB_CLASSES];
+    gnrc_pktsnip_t *pkt;
+    unsigned cls = 0;
+
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        used[i] = _used(i);
+    }
+    pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+    assert(pkt != NULL);
+    assert(_used(_SNIP_CLASS) == (used[_SNIP_CLASS] + 1));
+    for (unsigned i = 1; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        if (_used(i) != used[i]) {
+            assert(cls == 0);
+            assert(_used(i) == (used[i] + 1));
+            cls = i;
+        }
+    }
+    gnrc_pktbuf_release(pkt);
+    return cls;
+}
+
+static void _assert_empty(void)
+{
+    assert(gnrc_pktbuf_is_sane());
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_slab__class_selection(void)
+{
+    assert(gnrc_pktbuf_slab_get_stats(GNRC_PKTBUF_SLAB_CLASSES, NULL) == -EINVAL);
+    /* all objects are aligned */
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        assert((_size(i) % sizeof(void *)) == 0);
+    }
+    /* the smallest class that fits is used */
+    assert(_class_of_add(1) == 1);
+    for (unsigned i = 1; i < _DATA_CLASSES; i++) {
+        assert(_class_of_add(_size(i)) == i);
+        assert(_class_of_add(_size(i) + 1) == (i + 1));
+    }
+    assert(_class_of_add(_size(_DATA_CLASSES)) == _DATA_CLASSES);
+    /* too large for any class */
+    assert(gnrc_pktbuf_add(NULL, NULL, _size(_DATA_CLASSES) + 1,
+                           GNRC_NETTYPE_UNDEF) == NULL);
+    _assert_empty();
+}
+
+static void test_pktbuf_slab__exhaustion(void)
+{
+    const unsigned numof_3 = _stats(3).numof, numof_4 = _stats(4).numof;
+    const uint16_t size = _size(3);
+    gnrc_pktbuf_slab_stats_t before = _stats(3);
+    unsigned i;
+
+    for (i = 0; i < numof_3; i++) {
+        _pkts[i] = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+        assert(_pkts[i] != NULL);
+    }
+    assert(_used(3) == numof_3);
+    assert(_used(4) == 0);
+    /* exhausted class falls back to the next larger one */
+    for (; i < (numof_3 + numof_4); i++) {
+        _pkts[i] = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+        assert(_pkts[i] != NULL);
+    }
+    assert(_used(4) == numof_4);
+    assert(_stats(3).fallbacks == (before.fallbacks + numof_4));
+    /* no larger class left */
+    assert(gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF) == NULL);
+    assert(_stats(3).fails == (before.fails + 1));
+    assert(_stats(3).max_used == numof_3);
+    /* failed allocations do not leak the snip */
+    assert(_used(_SNIP_CLASS) == (numof_3 + numof_4));
+    for (i = 0; i < (numof_3 + numof_4); i++) {
+        gnrc_pktbuf_release(_pkts[i]);
+    }
+    _assert_empty();
+}
+
+static void test_pktbuf_slab__realloc(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, "abcdefg", sizeof("abcdefg"),
+                                          GNRC_NETTYPE_UNDEF);
+
+    assert(pkt != NULL);
+    assert(_used(1) == 1);
+    /* grows into a larger class and keeps the data */
+    assert(gnrc_pktbuf_realloc_data(pkt, _size(2) + 1) == 0);
+    assert(pkt->size == (_size(2) + 1U));
+    assert(_used(1) == 0);
+    assert(_used(2) == 0);
+    assert(_used(3) == 1);
+    assert(strcmp(pkt->data, "abcdefg") == 0);
+    /* shrinks in place */
+    void *data = pkt->data;
+    assert(gnrc_pktbuf_realloc_data(pkt, sizeof("abcdefg")) == 0);
+    assert(pkt->data == data);
+    assert(_used(3) == 1);
+    /* grows in place within its object */
+    assert(gnrc_pktbuf_realloc_data(pkt, _size(3)) == 0);
+    assert(pkt->data == data);
+    /* too large for any class */
+    assert(gnrc_pktbuf_realloc_data(pkt, _size(_DATA_CLASSES) + 1) == ENOMEM);
+    assert(pkt->data == data);
+    /* releases the data */
+    assert(gnrc_pktbuf_realloc_data(pkt, 0) == 0);
+    assert(pkt->data == NULL);
+    assert(_used(3) == 0);
+    gnrc_pktbuf_release(pkt);
+    _assert_empty();
+}
+
+static void test_pktbuf_slab__mark_release(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, 100, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *hdr;
+    uint8_t *data;
+
+    assert(pkt != NULL);
+    data = pkt->data;
+    hdr = gnrc_pktbuf_mark(pkt, 40, GNRC_NETTYPE_UNDEF);
+    assert(hdr != NULL);
+    /* split in place: both parts reference the same object */
+    assert(hdr->data == data);
+    assert(pkt->data == (data + 40));
+    assert(_used(3) == 1);
+    assert(_used(_SNIP_CLASS) == 2);
+    /* a shared object is not grown in place */
+    assert(gnrc_pktbuf_realloc_data(pkt, 70) == 0);
+    assert(pkt->data != (data + 40));
+    assert(_used(3) == 2);
+    /* the object is freed with its last user */
+    assert(gnrc_pktbuf_realloc_data(hdr, 0) == 0);
+    assert(_used(3) == 1);
+    gnrc_pktbuf_release(pkt);
+    _assert_empty();
+}
+
+static void test_pktbuf_slab__hold_release(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, 100, GNRC_NETTYPE_UNDEF);
+
+    assert(pkt != NULL);
+    pkt = gnrc_pktbuf_add(pkt, NULL, 8, GNRC_NETTYPE_UNDEF);
+    assert(pkt != NULL);
+    gnrc_pktbuf_hold(pkt, 1);
+    gnrc_pktbuf_release(pkt);
+    assert(_used(_SNIP_CLASS) == 2);
+    assert(_used(1) == 1);
+    assert(_used(3) == 1);
+    gnrc_pktbuf_release(pkt);
+    _assert_empty();
+}
+
+int main(void)
+{
+    gnrc_pktbuf_init();
+
+    CALL(test_pktbuf_slab__class_selection());
+    CALL(test_pktbuf_slab__exhaustion());
+    CALL(test_pktbuf_slab__realloc());
+    CALL(test_pktbuf_slab__mark_release());
+    CALL(test_pktbuf_slab__hold_release());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    child.expect_exact("Calling test_pktbuf_slab__class_selection()")
+    child.expect_exact("Calling test_pktbuf_slab__exhaustion()")
+    child.expect_exact("Calling test_pktbuf_slab__realloc()")
+    child.expect_exact("Calling test_pktbuf_slab__mark_release()")
+    child.expect_exact("Calling test_pktbuf_slab__hold_release()")
+    child.expect_exact("ALL TESTS SUCCESSFUL")
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
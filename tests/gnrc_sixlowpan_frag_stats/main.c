@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the fragmentation statistics of 6LoWPAN
+ *
+ * Sends packets over a dummy 6LoWPAN interface and checks the fragmentation
+ * counters in the interface's @ref netstats_t.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "byteorder.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+#include "net/sixlowpan.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/netstats.h"
+#include "utlist.h"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+#define _IFACE_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define _IFACE_PRIO         (THREAD_PRIORITY_MAIN - 1)
+#define _IFACE_QUEUE_SIZE   (4U)
+#define _MAIN_QUEUE_SIZE    (4U)
+#define _MAX_FRAG_SIZE      (64U)
+#define _SMALL_SIZE         (8U)
+#define _LARGE_SIZE         (200U)
+
+static char _iface_stack[_IFACE_STACKSIZE];
+static kernel_pid_t _iface;
+static msg_t _main_msg_queue[_MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+/* dummy interface: hands every packet to be sent over to the main thread */
+static void *_iface_thread(void *arg)
+{
+    msg_t msg, reply, msg_queue[_IFACE_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, _IFACE_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = (uint32_t)(-ENOTSUP);
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                msg_send(&msg, _main_pid);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+/* waits for a packet to be sent over the interface and returns its
+ * 6LoWPAN part */
+static gnrc_pktsnip_t *_recv_frame(void)
+{
+    msg_t msg;
+    gnrc_pktsnip_t *pkt;
+
+    msg_receive(&msg);
+    assert(msg.type == GNRC_NETAPI_MSG_TYPE_SND);
+    pkt = msg.content.ptr;
+    assert(pkt->type == GNRC_NETTYPE_NETIF);
+    assert(((gnrc_netif_hdr_t *)pkt->data)->if_pid == _iface);
+    assert(pkt->next != NULL);
+    return pkt;
+}
+
+/* receives all fragments of a datagram and returns their number */
+static unsigned _recv_fragments(void)
+{
+    unsigned frags = 0;
+    bool last = false;
+
+    while (!last) {
+        gnrc_pktsnip_t *pkt = _recv_frame();
+        sixlowpan_frag_n_t *hdr = pkt->next->data;
+        uint16_t datagram_size = byteorder_ntohs(hdr->disp_size) &
+                                 SIXLOWPAN_FRAG_SIZE_MASK;
+
+        assert(sixlowpan_frag_is((sixlowpan_frag_t *)hdr));
+        if ((hdr->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK) ==
+            SIXLOWPAN_FRAG_N_DISP) {
+            size_t len = pkt->next->size - sizeof(sixlowpan_frag_n_t);
+
+            last = (((hdr->offset * 8U) + len) == datagram_size);
+        }
+        frags++;
+        gnrc_pktbuf_release(pkt);
+    }
+    return frags;
+}
+
+static void _send(size_t size)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *netif;
+
+    assert(pkt != NULL);
+    memset(pkt->data, 0x5a, size);
+    pkt = gnrc_ipv6_hdr_build(pkt, NULL, &ipv6_addr_all_nodes_link_local);
+    assert(pkt != NULL);
+    netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    assert(netif != NULL);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _iface;
+    LL_PREPEND(pkt, netif);
+    assert(gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6,
+                                     GNRC_NETREG_DEMUX_CTX_ALL, pkt) == 1);
+}
+
+static void test_sixlowpan_frag_stats__unfragmented(void)
+{
+    netstats_t *stats = gnrc_ipv6_netif_get_stats(_iface);
+    netstats_t before;
+    gnrc_pktsnip_t *pkt;
+
+    memcpy(&before, stats, sizeof(before));
+    _send(_SMALL_SIZE);
+    pkt = _recv_frame();
+    assert(!sixlowpan_frag_is(pkt->next->data));
+    gnrc_pktbuf_release(pkt);
+    assert(stats->tx_frag_count == before.tx_frag_count);
+    assert(stats->tx_frag_latency == before.tx_frag_latency);
+    assert(stats->tx_copied_bytes == before.tx_copied_bytes);
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_sixlowpan_frag_stats__fragmented(void)
+{
+    netstats_t *stats = gnrc_ipv6_netif_get_stats(_iface);
+    netstats_t before;
+    uint32_t latency;
+    unsigned frags;
+
+    /* the sum of the latencies must not wrap around at 32 bit */
+    stats->tx_frag_latency = UINT32_MAX;
+    memcpy(&before, stats, sizeof(before));
+    _send(_LARGE_SIZE);
+    frags = _recv_fragments();
+    assert(frags > 1);
+    assert(stats->tx_frag_count == (before.tx_frag_count + 1));
+    assert(stats->tx_frag_latency > UINT32_MAX);
+    latency = (uint32_t)(stats->tx_frag_latency - before.tx_frag_latency);
+    /* fragments are paced */
+    assert(latency >= ((frags - 1) * GNRC_SIXLOWPAN_FRAG_PACING));
+    assert(stats->tx_frag_latency_max >= latency);
+    /* the uncompressed datagram and its dispatch are copied into fragments */
+    assert(stats->tx_copied_bytes == (before.tx_copied_bytes +
+                                      sizeof(ipv6_hdr_t) + _LARGE_SIZE + 1));
+    assert(gnrc_pktbuf_is_empty());
+}
+
+int main(void)
+{
+    _main_pid = sched_active_pid;
+    msg_init_queue(_main_msg_queue, _MAIN_QUEUE_SIZE);
+    _iface = thread_create(_iface_stack, sizeof(_iface_stack), _IFACE_PRIO,
+                           THREAD_CREATE_STACKTEST, _iface_thread, NULL,
+                           "iface");
+    assert(_iface > KERNEL_PID_UNDEF);
+    gnrc_netif_add(_iface);
+    gnrc_ipv6_netif_add(_iface);
+    gnrc_ipv6_netif_get(_iface)->flags |= GNRC_IPV6_NETIF_FLAGS_SIXLOWPAN;
+    gnrc_sixlowpan_netif_add(_iface, _MAX_FRAG_SIZE);
+
+    CALL(test_sixlowpan_frag_stats__unfragmented());
+    CALL(test_sixlowpan_frag_stats__fragmented());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
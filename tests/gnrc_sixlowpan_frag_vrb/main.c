@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the 6LoWPAN virtual reassembly buffer
+ *
+ * Relaying fragments needs a router and an interface to relay them over, so
+ * the virtual reassembly buffer can not be tested within the unittests
+ * application.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "byteorder.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/sixlowpan.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/dcache.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "xtimer.h"
+
+#include "vrb.h"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+#define _IFACE_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define _IFACE_PRIO         (THREAD_PRIORITY_MAIN - 1)
+#define _IFACE_QUEUE_SIZE   (4U)
+#define _MAIN_QUEUE_SIZE    (4U)
+#define _MAX_FRAG_SIZE      (96U)
+
+#define _TAG                (0x1234U)
+#define _HL                 (64U)
+#define _PAYLOAD_SIZE       (80U)
+#define _DATAGRAM_SIZE      (sizeof(ipv6_hdr_t) + _PAYLOAD_SIZE)
+/* bytes of the datagram in the first fragment */
+#define _FRAG1_SIZE         (sizeof(ipv6_hdr_t) + 40U)
+
+#define _SRC_L2ADDR         { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+#define _NEXT_HOP_L2ADDR    { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+#define _OWN_L2ADDR         { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }
+#define _SRC                { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 \
+        } \
+    }
+#define _DST                { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x01, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 \
+        } \
+    }
+#define _NEXT_HOP           { { \
+            0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 \
+        } \
+    }
+
+static uint8_t _src_l2addr[] = _SRC_L2ADDR;
+static const uint8_t _next_hop_l2addr[] = _NEXT_HOP_L2ADDR;
+static uint8_t _own_l2addr[] = _OWN_L2ADDR;
+static const ipv6_addr_t _src = _SRC;
+static const ipv6_addr_t _dst = _DST;
+static const ipv6_addr_t _next_hop = _NEXT_HOP;
+static uint8_t _payload[_PAYLOAD_SIZE];
+
+static char _iface_stack[_IFACE_STACKSIZE];
+static kernel_pid_t _iface;
+static msg_t _main_msg_queue[_MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+/* dummy interface: hands every packet to be sent over to the main thread */
+static void *_iface_thread(void *arg)
+{
+    msg_t msg, reply, msg_queue[_IFACE_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, _IFACE_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = (uint32_t)(-ENOTSUP);
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                msg_send(&msg, _main_pid);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+/* waits for a fragment relayed over the interface to the next hop and returns
+ * it */
+static gnrc_pktsnip_t *_recv_frag(void)
+{
+    msg_t msg;
+    gnrc_pktsnip_t *pkt;
+    gnrc_netif_hdr_t *netif_hdr;
+
+    msg_receive(&msg);
+    assert(msg.type == GNRC_NETAPI_MSG_TYPE_SND);
+    pkt = msg.content.ptr;
+    assert(pkt->type == GNRC_NETTYPE_NETIF);
+    netif_hdr = pkt->data;
+    assert(netif_hdr->if_pid == _iface);
+    assert(netif_hdr->dst_l2addr_len == sizeof(_next_hop_l2addr));
+    assert(memcmp(gnrc_netif_hdr_get_dst_addr(netif_hdr), _next_hop_l2addr,
+                  sizeof(_next_hop_l2addr)) == 0);
+    assert(pkt->next != NULL);
+    assert(sixlowpan_frag_is(pkt->next->data));
+    return pkt;
+}
+
+/* builds a received fragment of the datagram with data as its content */
+static gnrc_pktsnip_t *_build_frag(uint16_t offset, const void *data,
+                                   size_t data_len)
+{
+    size_t hdr_len = (offset == 0) ? sizeof(sixlowpan_frag_t)
+                                   : sizeof(sixlowpan_frag_n_t);
+    gnrc_pktsnip_t *netif, *pkt;
+    sixlowpan_frag_n_t *hdr;
+
+    netif = gnrc_netif_hdr_build(_src_l2addr, sizeof(_src_l2addr),
+                                 _own_l2addr, sizeof(_own_l2addr));
+    assert(netif != NULL);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _iface;
+    pkt = gnrc_pktbuf_add(netif, NULL, hdr_len + data_len,
+                          GNRC_NETTYPE_SIXLOWPAN);
+    assert(pkt != NULL);
+    hdr = pkt->data;
+    hdr->disp_size = byteorder_htons(_DATAGRAM_SIZE);
+    hdr->disp_size.u8[0] |= (offset == 0) ? SIXLOWPAN_FRAG_1_DISP
+                                          : SIXLOWPAN_FRAG_N_DISP;
+    hdr->tag = byteorder_htons(_TAG);
+    if (offset != 0) {
+        hdr->offset = offset / 8;
+    }
+    memcpy(((uint8_t *)pkt->data) + hdr_len, data, data_len);
+    return pkt;
+}
+
+/* builds the first fragment of the datagram, uncompressed */
+static gnrc_pktsnip_t *_build_frag1(const ipv6_addr_t *dst)
+{
+    uint8_t data[1 + _FRAG1_SIZE];
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)&data[1];
+
+    data[0] = SIXLOWPAN_UNCOMP;
+    memset(hdr, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(hdr);
+    hdr->len = byteorder_htons(_PAYLOAD_SIZE);
+    hdr->nh = PROTNUM_IPV6_NONXT;
+    hdr->hl = _HL;
+    memcpy(&hdr->src, &_src, sizeof(ipv6_addr_t));
+    memcpy(&hdr->dst, dst, sizeof(ipv6_addr_t));
+    memcpy(hdr + 1, _payload, _FRAG1_SIZE - sizeof(ipv6_hdr_t));
+    return _build_frag(0, data, sizeof(data));
+}
+
+/* relays the subsequent fragment of the datagram */
+static bool _forward_nth(void)
+{
+    gnrc_pktsnip_t *pkt = _build_frag(_FRAG1_SIZE,
+                                      &_payload[_FRAG1_SIZE - sizeof(ipv6_hdr_t)],
+                                      _DATAGRAM_SIZE - _FRAG1_SIZE);
+    bool res = vrb_forward(pkt->next->data, pkt, _DATAGRAM_SIZE - _FRAG1_SIZE,
+                           _FRAG1_SIZE);
+
+    if (!res) {
+        gnrc_pktbuf_release(pkt);
+    }
+    return res;
+}
+
+static vrb_t *_add(uint16_t tag)
+{
+    return vrb_add(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE, tag,
+                   _iface, _next_hop_l2addr, sizeof(_next_hop_l2addr));
+}
+
+static void test_vrb_add__full(void)
+{
+    vrb_t *entries[VRB_SIZE];
+
+    for (unsigned i = 0; i < VRB_SIZE; i++) {
+        entries[i] = _add(_TAG + i);
+        assert(entries[i] != NULL);
+        assert(entries[i]->out_iface == _iface);
+        /* every relayed datagram gets its own tag towards the next hop */
+        for (unsigned j = 0; j < i; j++) {
+            assert(entries[i] != entries[j]);
+            assert(entries[i]->out_tag != entries[j]->out_tag);
+        }
+    }
+    assert(_add(_TAG + VRB_SIZE) == NULL);
+    for (unsigned i = 0; i < VRB_SIZE; i++) {
+        vrb_rm(entries[i]);
+    }
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_vrb_get(void)
+{
+    vrb_t *entry = _add(_TAG);
+
+    assert(entry != NULL);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == entry);
+    /* the datagram is identified by previous hop, size and tag */
+    assert(vrb_get(_next_hop_l2addr, sizeof(_next_hop_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr) - 1, _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE + 8,
+                   _TAG) == NULL);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG + 1) == NULL);
+    vrb_rm(entry);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+}
+
+static void test_vrb_forward__nth_unknown(void)
+{
+    /* first fragment was not relayed: the fragment is left to reassembly */
+    assert(!_forward_nth());
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_vrb_forward__1st_not_routed(void)
+{
+    gnrc_pktsnip_t *pkt = _build_frag1(&_next_hop);
+
+    /* link-local destination */
+    assert(!vrb_forward(pkt->next->data, pkt, pkt->size - sizeof(sixlowpan_frag_t), 0));
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    gnrc_pktbuf_release(pkt);
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_vrb_forward(void)
+{
+    gnrc_pktsnip_t *pkt = _build_frag1(&_dst);
+    sixlowpan_frag_n_t *frag;
+    ipv6_hdr_t *hdr;
+    vrb_t *entry;
+    uint16_t out_tag;
+
+    assert(vrb_forward(pkt->next->data, pkt, pkt->size - sizeof(sixlowpan_frag_t), 0));
+    entry = vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE, _TAG);
+    assert(entry != NULL);
+    assert(entry->cur_size == _FRAG1_SIZE);
+    out_tag = entry->out_tag;
+
+    /* first fragment: new tag, hop limit decremented, payload unchanged */
+    pkt = _recv_frag();
+    frag = pkt->next->data;
+    assert((frag->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_1_DISP);
+    assert((byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK) == _DATAGRAM_SIZE);
+    assert(byteorder_ntohs(frag->tag) == out_tag);
+    assert(gnrc_pkt_len(pkt->next) == (sizeof(sixlowpan_frag_t) + 1 + _FRAG1_SIZE));
+    assert(*((uint8_t *)pkt->next->next->data) == SIXLOWPAN_UNCOMP);
+    hdr = pkt->next->next->next->data;
+    assert(hdr->hl == (_HL - 1));
+    assert(ipv6_addr_equal(&hdr->dst, &_dst));
+    assert(memcmp(pkt->next->next->next->next->data, _payload,
+                  _FRAG1_SIZE - sizeof(ipv6_hdr_t)) == 0);
+    gnrc_pktbuf_release(pkt);
+
+    /* subsequent fragment: only the tag is replaced */
+    assert(_forward_nth());
+    pkt = _recv_frag();
+    frag = pkt->next->data;
+    assert((frag->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_N_DISP);
+    assert(byteorder_ntohs(frag->tag) == out_tag);
+    assert(frag->offset == (_FRAG1_SIZE / 8));
+    assert(pkt->next->size == (sizeof(sixlowpan_frag_n_t) +
+                               _DATAGRAM_SIZE - _FRAG1_SIZE));
+    assert(memcmp(frag + 1, &_payload[_FRAG1_SIZE - sizeof(ipv6_hdr_t)],
+                  _DATAGRAM_SIZE - _FRAG1_SIZE) == 0);
+    gnrc_pktbuf_release(pkt);
+
+    /* all fragments relayed: entry is removed */
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_vrb_forward__timeout(void)
+{
+    vrb_t *entry = _add(_TAG);
+
+    assert(entry != NULL);
+    entry->arrival = xtimer_now_usec() - VRB_TIMEOUT - 1;
+    /* timed out entries are removed before relaying */
+    assert(!_forward_nth());
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    assert(gnrc_pktbuf_is_empty());
+}
+
+static void test_vrb_gc(void)
+{
+    vrb_t *old = _add(_TAG), *young = _add(_TAG + 1);
+
+    assert((old != NULL) && (young != NULL));
+    old->arrival = xtimer_now_usec() - VRB_TIMEOUT - 1;
+    vrb_gc();
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG) == NULL);
+    assert(vrb_get(_src_l2addr, sizeof(_src_l2addr), _DATAGRAM_SIZE,
+                   _TAG + 1) == young);
+    vrb_rm(young);
+}
+
+int main(void)
+{
+    gnrc_ipv6_nc_t *nc;
+
+    _main_pid = sched_active_pid;
+    msg_init_queue(_main_msg_queue, _MAIN_QUEUE_SIZE);
+    for (unsigned i = 0; i < sizeof(_payload); i++) {
+        _payload[i] = i;
+    }
+    _iface = thread_create(_iface_stack, sizeof(_iface_stack), _IFACE_PRIO,
+                           THREAD_CREATE_STACKTEST, _iface_thread, NULL,
+                           "iface");
+    assert(_iface > KERNEL_PID_UNDEF);
+    gnrc_sixlowpan_netif_add(_iface, _MAX_FRAG_SIZE);
+    /* route _dst via _next_hop over the interface */
+    nc = gnrc_ipv6_nc_add(_iface, &_next_hop, _next_hop_l2addr,
+                          sizeof(_next_hop_l2addr),
+                          GNRC_IPV6_NC_STATE_REACHABLE);
+    assert(nc != NULL);
+    gnrc_ipv6_dcache_add(KERNEL_PID_UNDEF, &_dst, nc,
+                         gnrc_ipv6_dcache_get_version());
+
+    CALL(test_vrb_add__full());
+    CALL(test_vrb_get());
+    CALL(test_vrb_forward__nth_unknown());
+    CALL(test_vrb_forward__1st_not_routed());
+    CALL(test_vrb_forward());
+    CALL(test_vrb_forward__timeout());
+    CALL(test_vrb_gc());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    child.expect_exact("Calling test_vrb_add__full()")
+    child.expect_exact("Calling test_vrb_get()")
+    child.expect_exact("Calling test_vrb_forward__nth_unknown()")
+    child.expect_exact("Calling test_vrb_forward__1st_not_routed()")
+    child.expect_exact("Calling test_vrb_forward()")
+    child.expect_exact("Calling test_vrb_forward__timeout()")
+    child.expect_exact("Calling test_vrb_gc()")
+    child.expect_exact("ALL TESTS SUCCESSFUL")
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the compression cache of 6LoWPAN IPHC
+ *
+ * The cache is an optional part of gnrc_sixlowpan_iphc, so it can not be
+ * tested within the unittests application without changing the IPHC
+ * implementation for all other tests.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "xtimer.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+#define _L2ADDR_SRC         { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 }
+#define _L2ADDR_DST         { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02 }
+#define _PAYLOAD_LEN        (8U)
+#define _PACKETS            (1000U)
+
+static uint8_t _l2src[] = _L2ADDR_SRC;
+static uint8_t _l2dst[] = _L2ADDR_DST;
+
+static gnrc_pktsnip_t *_build_udp(const char *src, const char *dst,
+                                  uint16_t checksum)
+{
+    gnrc_pktsnip_t *netif, *ipv6, *udp;
+    ipv6_hdr_t *ipv6_hdr;
+    udp_hdr_t *udp_hdr;
+
+    netif = gnrc_netif_hdr_build(_l2src, sizeof(_l2src), _l2dst, sizeof(_l2dst));
+    assert(netif != NULL);
+    udp = gnrc_pktbuf_add(NULL, NULL, sizeof(udp_hdr_t) + _PAYLOAD_LEN,
+                          GNRC_NETTYPE_UNDEF);
+    assert(udp != NULL);
+    ipv6 = gnrc_pktbuf_add(udp, NULL, sizeof(ipv6_hdr_t), GNRC_NETTYPE_IPV6);
+    assert(ipv6 != NULL);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = 1;
+    memset(udp->data, 0xaa, udp->size);
+    udp_hdr = udp->data;
+    udp_hdr->src_port = byteorder_htons(0xf0b1);
+    udp_hdr->dst_port = byteorder_htons(5683);
+    udp_hdr->length = byteorder_htons(udp->size);
+    udp_hdr->checksum = byteorder_htons(checksum);
+    ipv6_hdr = ipv6->data;
+    memset(ipv6_hdr, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ipv6_hdr);
+    ipv6_hdr->len = byteorder_htons(udp->size);
+    ipv6_hdr->nh = PROTNUM_UDP;
+    ipv6_hdr->hl = 64;
+    ipv6_addr_from_str(&ipv6_hdr->src, src);
+    ipv6_addr_from_str(&ipv6_hdr->dst, dst);
+    netif->next = ipv6;
+    return netif;
+}
+
+/* encodes pkt, copies the result to buf, and releases pkt */
+static size_t _encode(gnrc_pktsnip_t *pkt, uint8_t *buf)
+{
+    size_t len = 0;
+
+    assert(gnrc_sixlowpan_iphc_encode(pkt));
+    for (gnrc_pktsnip_t *snip = pkt->next; snip != NULL; snip = snip->next) {
+        memcpy(buf + len, snip->data, snip->size);
+        len += snip->size;
+    }
+    gnrc_pktbuf_release(pkt);
+    return len;
+}
+
+static void test_sixlowpan_iphc_cache__hit(void)
+{
+    uint8_t miss[64], hit[64], ref[64];
+    size_t miss_len, hit_len, ref_len;
+
+    gnrc_sixlowpan_iphc_cache_flush();
+    miss_len = _encode(_build_udp("fe80::1", "fe80::ff:fe00:2", 0x1234), miss);
+    hit_len = _encode(_build_udp("fe80::1", "fe80::ff:fe00:2", 0xabcd), hit);
+    gnrc_sixlowpan_iphc_cache_flush();
+    ref_len = _encode(_build_udp("fe80::1", "fe80::ff:fe00:2", 0xabcd), ref);
+    assert(gnrc_pktbuf_is_empty());
+
+    /* cached encoding is the same as the full one */
+    assert(ref_len == hit_len);
+    assert(memcmp(ref, hit, hit_len) == 0);
+    /* only the checksum in front of the payload differs from the first
+     * packet */
+    assert(miss_len == hit_len);
+    assert(memcmp(miss, hit, hit_len) != 0);
+    assert(memcmp(miss, hit, hit_len - _PAYLOAD_LEN - 2) == 0);
+    assert(memcmp(miss + miss_len - _PAYLOAD_LEN, hit + hit_len - _PAYLOAD_LEN,
+                  _PAYLOAD_LEN) == 0);
+}
+
+static void test_sixlowpan_iphc_cache__ctx_update(void)
+{
+    ipv6_addr_t prefix = { .u8 = { 0x20, 0x01, 0x0d, 0xb8 } };
+    uint8_t before[64], after[64], ref[64];
+    size_t before_len, after_len, ref_len;
+
+    gnrc_sixlowpan_iphc_cache_flush();
+    before_len = _encode(_build_udp("2001:db8::1", "2001:db8::2", 0), before);
+    assert(gnrc_sixlowpan_ctx_update(0, &prefix, 64, 1, true) != NULL);
+    after_len = _encode(_build_udp("2001:db8::1", "2001:db8::2", 0), after);
+    gnrc_sixlowpan_iphc_cache_flush();
+    ref_len = _encode(_build_udp("2001:db8::1", "2001:db8::2", 0), ref);
+    assert(gnrc_pktbuf_is_empty());
+
+    /* addresses are now compressed with the context */
+    assert(after_len < before_len);
+    assert(ref_len == after_len);
+    assert(memcmp(ref, after, after_len) == 0);
+    gnrc_sixlowpan_ctx_reset();
+}
+
+/* benchmark of the header compression of a flow, with and without the
+ * compression cache */
+static void test_sixlowpan_iphc_cache__encode_time(void)
+{
+    uint32_t start, cached = 0, uncached = 0;
+
+    for (unsigned i = 0; i < _PACKETS; i++) {
+        gnrc_pktsnip_t *pkt = _build_udp("2001:db8::1", "2001:db8::2", i);
+
+        start = xtimer_now_usec();
+        assert(gnrc_sixlowpan_iphc_encode(pkt));
+        cached += xtimer_now_usec() - start;
+        gnrc_pktbuf_release(pkt);
+    }
+    for (unsigned i = 0; i < _PACKETS; i++) {
+        gnrc_pktsnip_t *pkt = _build_udp("2001:db8::1", "2001:db8::2", i);
+
+        gnrc_sixlowpan_iphc_cache_flush();
+        start = xtimer_now_usec();
+        assert(gnrc_sixlowpan_iphc_encode(pkt));
+        uncached += xtimer_now_usec() - start;
+        gnrc_pktbuf_release(pkt);
+    }
+    assert(gnrc_pktbuf_is_empty());
+
+    printf("[sixlowpan_iphc_encode_time] %" PRIu32 " ns per packet cached, %"
+           PRIu32 " ns per packet uncached\n",
+           (uint32_t)(((uint64_t)cached * 1000) / _PACKETS),
+           (uint32_t)(((uint64_t)uncached * 1000) / _PACKETS));
+}
+
+int main(void)
+{
+    CALL(test_sixlowpan_iphc_cache__hit());
+    CALL(test_sixlowpan_iphc_cache__ctx_update());
+    CALL(test_sixlowpan_iphc_cache__encode_time());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
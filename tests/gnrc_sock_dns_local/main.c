@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the DNS client with a stand-in server on the
+ *              loopback address
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/dns.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define _SERVER_STACK_SIZE  (THREAD_STACKSIZE_DEFAULT + 512)
+#define _CLIENT_STACK_SIZE  (THREAD_STACKSIZE_DEFAULT + 512)
+
+#define _FLAGS_ANSWER       (0x8180)    /* QR, RD, RA */
+#define _FLAGS_NXDOMAIN     (0x8183)
+#define _DNS_TYPE_SOA       (6)
+#define _NEG_TTL            (300U)
+#define _SHORT_TTL          (2U)
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+typedef struct {
+    const char *name;
+    uint16_t type;
+    uint32_t ttl;
+    const uint8_t *addr;
+} _record_t;
+
+static const uint8_t _example_aaaa[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                         0, 0, 0, 0, 0, 0, 0, 0x01 };
+static const uint8_t _short_aaaa[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                       0, 0, 0, 0, 0, 0, 0, 0x05 };
+static const uint8_t _example_a[] = { 192, 0, 2, 1 };
+static const uint8_t _v4_a[] = { 192, 0, 2, 4 };
+static const uint8_t _a_a[] = { 192, 0, 2, 10 };
+static const uint8_t _b_a[] = { 192, 0, 2, 11 };
+static const uint8_t _c_a[] = { 192, 0, 2, 12 };
+
+static const _record_t _records[] = {
+    { "example.org", DNS_TYPE_AAAA, 300, _example_aaaa },
+    { "example.org", DNS_TYPE_A, 300, _example_a },
+    { "v4.example.org", DNS_TYPE_A, 300, _v4_a },
+    { "short.example.org", DNS_TYPE_AAAA, _SHORT_TTL, _short_aaaa },
+    { "a.example.org", DNS_TYPE_A, 300, _a_a },
+    { "b.example.org", DNS_TYPE_A, 300, _b_a },
+    { "c.example.org", DNS_TYPE_A, 300, _c_a },
+};
+
+sock_udp_ep_t sock_dns_server;
+
+static char _server_stack[_SERVER_STACK_SIZE];
+static char _client_stack[_CLIENT_STACK_SIZE];
+static sock_udp_t _server_sock;
+/* number of queries the server received */
+static unsigned _queries;
+/* the server holds back the next query until it received another one */
+static bool _defer;
+/* the server answers other questions with the ID of the next query first */
+static bool _forge;
+
+static mutex_t _client_done = MUTEX_INIT_LOCKED;
+static int _client_res;
+static uint8_t _client_addr[16];
+
+static size_t _dec_name(const uint8_t *buf, size_t len, char *name)
+{
+    size_t pos = 0;
+
+    while ((pos < len) && (buf[pos] != 0) &&
+           ((pos + buf[pos] + 1) <= SOCK_DNS_MAX_NAME_LEN)) {
+        if (pos > 0) {
+            name[pos - 1] = '.';
+        }
+        memcpy(&name[pos], &buf[pos + 1], buf[pos]);
+        pos += buf[pos] + 1;
+    }
+    name[(pos > 0) ? pos - 1 : 0] = '\0';
+    return pos + 1;
+}
+
+static size_t _put_rr(uint8_t *buf, uint16_t type, uint32_t ttl,
+                      const uint8_t *data, uint16_t len)
+{
+    network_uint16_t tmp16;
+    network_uint32_t tmp32;
+
+    /* name: pointer to the name of the question */
+    buf[0] = 0xc0;
+    buf[1] = sizeof(sock_dns_hdr_t);
+    tmp16 = byteorder_htons(type);
+    memcpy(&buf[2], &tmp16, 2);
+    tmp16 = byteorder_htons(DNS_CLASS_IN);
+    memcpy(&buf[4], &tmp16, 2);
+    tmp32 = byteorder_htonl(ttl);
+    memcpy(&buf[6], &tmp32, 4);
+    tmp16 = byteorder_htons(len);
+    memcpy(&buf[10], &tmp16, 2);
+    memcpy(&buf[12], data, len);
+    return 12 + len;
+}
+
+static size_t _put_soa(uint8_t *buf)
+{
+    /* root as MNAME and RNAME, then serial, refresh, retry, expire and
+     * minimum */
+    uint8_t soa[22] = { 0 };
+    network_uint32_t minimum = byteorder_htonl(_NEG_TTL);
+
+    memcpy(&soa[18], &minimum, 4);
+    return _put_rr(buf, _DNS_TYPE_SOA, _NEG_TTL, soa, sizeof(soa));
+}
+
+static void _reply(uint8_t *buf, size_t len, const sock_udp_ep_t *remote)
+{
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t *)buf;
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    size_t pos = sizeof(sock_dns_hdr_t);
+    const _record_t *answer = NULL;
+    bool known = false;
+    uint16_t type;
+
+    pos += _dec_name(&buf[pos], len - pos, name);
+    type = (buf[pos] << 8) | buf[pos + 1];
+    pos += 4;
+    for (unsigned i = 0; i < (sizeof(_records) / sizeof(_records[0])); i++) {
+        if (strcmp(_records[i].name, name) == 0) {
+            known = true;
+            if (_records[i].type == type) {
+                answer = &_records[i];
+            }
+        }
+    }
+    hdr->flags = htons(known ? _FLAGS_ANSWER : _FLAGS_NXDOMAIN);
+    hdr->ancount = htons(answer != NULL);
+    hdr->nscount = htons(answer == NULL);
+    hdr->arcount = 0;
+    if (answer != NULL) {
+        pos += _put_rr(&buf[pos], type, answer->ttl, answer->addr,
+                       (type == DNS_TYPE_AAAA) ? 16 : 4);
+    }
+    else {
+        pos += _put_soa(&buf[pos]);
+    }
+    assert(sock_udp_send(&_server_sock, buf, pos, remote) == (ssize_t)pos);
+}
+
+static void *_server(void *arg)
+{
+    static uint8_t held[128];
+    static sock_udp_ep_t held_remote;
+    static size_t held_len = 0;
+    uint8_t buf[128];
+    sock_udp_ep_t local = { .family = AF_INET6, .port = SOCK_DNS_PORT,
+                            .netif = SOCK_ADDR_ANY_NETIF };
+    sock_udp_ep_t remote;
+
+    (void)arg;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&local.addr.ipv6);
+    assert(sock_udp_create(&_server_sock, &local, NULL, 0) == 0);
+    while (1) {
+        /* room for the answer */
+        ssize_t res = sock_udp_recv(&_server_sock, buf, sizeof(buf) - 40,
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        if (res <= (ssize_t)sizeof(sock_dns_hdr_t)) {
+            continue;
+        }
+        _queries++;
+        if (_defer && (held_len == 0)) {
+            memcpy(held, buf, res);
+            memcpy(&held_remote, &remote, sizeof(remote));
+            held_len = res;
+            continue;
+        }
+        if (_forge) {
+            char name[SOCK_DNS_MAX_NAME_LEN + 1];
+            uint8_t other[sizeof(buf)];
+            /* position of the low byte of the type of the question */
+            size_t type_pos = sizeof(sock_dns_hdr_t) + 1 +
+                              _dec_name(&buf[sizeof(sock_dns_hdr_t)],
+                                        res - sizeof(sock_dns_hdr_t), name);
+
+            /* c.example.org becomes b.example.org */
+            memcpy(other, buf, res);
+            other[sizeof(sock_dns_hdr_t) + 1]--;
+            _reply(other, res, &remote);
+            /* A becomes AAAA */
+            memcpy(other, buf, res);
+            other[type_pos] = DNS_TYPE_AAAA;
+            _reply(other, res, &remote);
+            _forge = false;
+        }
+        /* the held query is answered last */
+        _reply(buf, res, &remote);
+        if (held_len > 0) {
+            _reply(held, held_len, &held_remote);
+            held_len = 0;
+            _defer = false;
+        }
+    }
+    return NULL;
+}
+
+static void *_client(void *arg)
+{
+    _client_res = sock_dns_query(arg, _client_addr, AF_INET);
+    mutex_unlock(&_client_done);
+    return NULL;
+}
+
+static void test_sock_dns__query(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    assert(sock_dns_query("example.org", addr, AF_INET6) == 16);
+    assert(memcmp(addr, _example_aaaa, sizeof(_example_aaaa)) == 0);
+    assert(_queries == (queries + 1));
+    assert(sock_dns_query("example.org", addr, AF_INET) == 4);
+    assert(memcmp(addr, _example_a, sizeof(_example_a)) == 0);
+    assert(_queries == (queries + 2));
+}
+
+static void test_sock_dns__cached(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    assert(sock_dns_query("example.org", addr, AF_INET6) == 16);
+    assert(memcmp(addr, _example_aaaa, sizeof(_example_aaaa)) == 0);
+    assert(sock_dns_query("example.org", addr, AF_UNSPEC) == 16);
+    assert(memcmp(addr, _example_aaaa, sizeof(_example_aaaa)) == 0);
+    assert(sock_dns_query("example.org", addr, AF_INET) == 4);
+    assert(memcmp(addr, _example_a, sizeof(_example_a)) == 0);
+    assert(_queries == queries);
+}
+
+static void test_sock_dns__parallel(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    /* the server only replies to the AAAA query after it got the A query,
+     * so both must be outstanding at the same time */
+    _defer = true;
+    assert(sock_dns_query("v4.example.org", addr, AF_UNSPEC) == 4);
+    assert(memcmp(addr, _v4_a, sizeof(_v4_a)) == 0);
+    assert(_queries == (queries + 2));
+    assert(!_defer);
+}
+
+static void test_sock_dns__negative_cached(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    assert(sock_dns_query("nx.example.org", addr, AF_INET) == -EHOSTUNREACH);
+    assert(_queries == (queries + 1));
+    assert(sock_dns_query("nx.example.org", addr, AF_INET) == -EHOSTUNREACH);
+    /* the missing AAAA record of v4.example.org is cached as well */
+    assert(sock_dns_query("v4.example.org", addr, AF_UNSPEC) == 4);
+    assert(sock_dns_query("v4.example.org", addr, AF_INET6) == -EHOSTUNREACH);
+    assert(_queries == (queries + 1));
+}
+
+static void test_sock_dns__ttl(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    assert(sock_dns_query("short.example.org", addr, AF_INET6) == 16);
+    assert(sock_dns_query("short.example.org", addr, AF_INET6) == 16);
+    assert(_queries == (queries + 1));
+    xtimer_usleep((_SHORT_TTL * US_PER_SEC) + (100U * US_PER_MS));
+    assert(sock_dns_query("short.example.org", addr, AF_INET6) == 16);
+    assert(memcmp(addr, _short_aaaa, sizeof(_short_aaaa)) == 0);
+    assert(_queries == (queries + 2));
+}
+
+static void test_sock_dns__concurrent(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    /* the server replies to the query of the client thread last, so its
+     * thread receives the reply of this one */
+    _defer = true;
+    thread_create(_client_stack, sizeof(_client_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _client, "a.example.org", "client");
+    assert(sock_dns_query("b.example.org", addr, AF_INET) == 4);
+    assert(memcmp(addr, _b_a, sizeof(_b_a)) == 0);
+    mutex_lock(&_client_done);
+    assert(_client_res == 4);
+    assert(memcmp(_client_addr, _a_a, sizeof(_a_a)) == 0);
+    assert(_queries == (queries + 2));
+}
+
+static void test_sock_dns__question_mismatch(void)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+
+    /* replies to another name or type are dropped, even with the ID of the
+     * query */
+    _forge = true;
+    assert(sock_dns_query("c.example.org", addr, AF_INET) == 4);
+    assert(memcmp(addr, _c_a, sizeof(_c_a)) == 0);
+    assert(!_forge);
+    assert(_queries == (queries + 1));
+    /* and not cached for the query either */
+    assert(sock_dns_query("c.example.org", addr, AF_INET) == 4);
+    assert(memcmp(addr, _c_a, sizeof(_c_a)) == 0);
+    assert(_queries == (queries + 1));
+}
+
+int main(void)
+{
+    sock_dns_server.family = AF_INET6;
+    sock_dns_server.netif = SOCK_ADDR_ANY_NETIF;
+    sock_dns_server.port = SOCK_DNS_PORT;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&sock_dns_server.addr.ipv6);
+    thread_create(_server_stack, sizeof(_server_stack),
+                  THREAD_PRIORITY_MAIN - 2, THREAD_CREATE_STACKTEST,
+                  _server, NULL, "dns_server");
+
+    CALL(test_sock_dns__query());
+    CALL(test_sock_dns__cached());
+    CALL(test_sock_dns__parallel());
+    CALL(test_sock_dns__negative_cached());
+    CALL(test_sock_dns__ttl());
+    CALL(test_sock_dns__concurrent());
+    CALL(test_sock_dns__question_mismatch());
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
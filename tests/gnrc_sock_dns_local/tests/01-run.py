@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    child.expect_exact("Calling test_sock_dns__query()")
+    child.expect_exact("Calling test_sock_dns__cached()")
+    child.expect_exact("Calling test_sock_dns__parallel()")
+    child.expect_exact("Calling test_sock_dns__negative_cached()")
+    child.expect_exact("Calling test_sock_dns__ttl()")
+    child.expect_exact("Calling test_sock_dns__concurrent()")
+    child.expect_exact("Calling test_sock_dns__question_mismatch()")
+    child.expect_exact("ALL TESTS SUCCESSFUL", timeout=10)
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
@@ -379,6 +379,67 @@ static void test_sock_udp_recv__non_blocking(void)
     assert(_check_net());
 }
 
+static void test_sock_udp_recv_batch(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const sock_udp_ep_t local = { .family = AF_INET6,
+                                         .port = _TEST_PORT_LOCAL };
+    sock_udp_ep_t result[2];
+    sock_udp_dgram_t dgrams[] = {
+        { .data = _test_buffer, .len = sizeof(_test_buffer) / 3,
+          .remote = &result[0] },
+        { .data = _test_buffer + (sizeof(_test_buffer) / 3),
+          .len = sizeof(_test_buffer) / 3, .remote = &result[1] },
+        { .data = _test_buffer + (2 * (sizeof(_test_buffer) / 3)),
+          .len = sizeof(_test_buffer) / 3, .remote = NULL },
+    };
+
+    assert(0 == sock_udp_create(&_sock, &local, NULL, SOCK_FLAGS_REUSE_EP));
+    assert(-EAGAIN == sock_udp_recv_batch(&_sock, dgrams, 3, 0));
+    assert(_inject_packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE,
+                          _TEST_PORT_LOCAL, "ABCD", sizeof("ABCD"),
+                          _TEST_NETIF));
+    assert(_inject_packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE + 1,
+                          _TEST_PORT_LOCAL, "EFGHIJ", sizeof("EFGHIJ"),
+                          _TEST_NETIF));
+    assert(2 == sock_udp_recv_batch(&_sock, dgrams, 3, SOCK_NO_TIMEOUT));
+    assert(sizeof("ABCD") == dgrams[0].len);
+    assert(memcmp(dgrams[0].data, "ABCD", sizeof("ABCD")) == 0);
+    assert(_TEST_PORT_REMOTE == result[0].port);
+    assert(sizeof("EFGHIJ") == dgrams[1].len);
+    assert(memcmp(dgrams[1].data, "EFGHIJ", sizeof("EFGHIJ")) == 0);
+    assert(memcmp(&result[1].addr, &src_addr, sizeof(result[1].addr)) == 0);
+    assert((_TEST_PORT_REMOTE + 1) == result[1].port);
+    assert(_check_net());
+}
+
+static void test_sock_udp_recv_buf(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const sock_udp_ep_t local = { .family = AF_INET6,
+                                         .port = _TEST_PORT_LOCAL };
+    sock_udp_ep_t result;
+    void *data, *ctx;
+
+    assert(0 == sock_udp_create(&_sock, &local, NULL, SOCK_FLAGS_REUSE_EP));
+    assert(_inject_packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE,
+                          _TEST_PORT_LOCAL, "ABCD", sizeof("ABCD"),
+                          _TEST_NETIF));
+    assert(sizeof("ABCD") == sock_udp_recv_buf(&_sock, &data, &ctx,
+                                               SOCK_NO_TIMEOUT, &result));
+    assert(memcmp(data, "ABCD", sizeof("ABCD")) == 0);
+    assert(AF_INET6 == result.family);
+    assert(memcmp(&result.addr, &src_addr, sizeof(result.addr)) == 0);
+    assert(_TEST_PORT_REMOTE == result.port);
+    assert(_TEST_NETIF == result.netif);
+    /* buffer is lent until freed */
+    assert(!_check_net());
+    sock_udp_recv_buf_free(&_sock, ctx);
+    assert(_check_net());
+}
+
 static void test_sock_udp_send__EAFNOSUPPORT(void)
 {
     static const sock_udp_ep_t remote = { .addr = { .ipv6 = _TEST_ADDR_REMOTE },
@@ -651,6 +712,37 @@ static void test_sock_udp_send__no_sock(void)
     assert(_check_net());
 }
 
+static void test_sock_udp_send_batch(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const sock_udp_ep_t local = { .addr = { .ipv6 = _TEST_ADDR_LOCAL },
+                                         .family = AF_INET6,
+                                         .netif = _TEST_NETIF,
+                                         .port = _TEST_PORT_LOCAL };
+    static sock_udp_ep_t remote = { .addr = { .ipv6 = _TEST_ADDR_REMOTE },
+                                    .family = AF_INET6,
+                                    .port = _TEST_PORT_REMOTE };
+    static sock_udp_ep_t other = { .addr = { .ipv6 = _TEST_ADDR_REMOTE },
+                                   .family = AF_INET6,
+                                   .port = _TEST_PORT_REMOTE + 1 };
+    const sock_udp_dgram_t dgrams[] = {
+        { .data = "ABCD", .len = sizeof("ABCD"), .remote = NULL },
+        { .data = "EFGHIJ", .len = sizeof("EFGHIJ"), .remote = &other },
+    };
+
+    assert(0 == sock_udp_create(&_sock, &local, &remote, SOCK_FLAGS_REUSE_EP));
+    assert(2 == sock_udp_send_batch(&_sock, dgrams, 2));
+    assert(_check_packet(&src_addr, &dst_addr, _TEST_PORT_LOCAL,
+                         _TEST_PORT_REMOTE, "ABCD", sizeof("ABCD"),
+                         _TEST_NETIF, false));
+    assert(_check_packet(&src_addr, &dst_addr, _TEST_PORT_LOCAL,
+                         _TEST_PORT_REMOTE + 1, "EFGHIJ", sizeof("EFGHIJ"),
+                         _TEST_NETIF, false));
+    xtimer_usleep(1000);    /* let GNRC stack finish */
+    assert(_check_net());
+}
+
 int main(void)
 {
     _net_init();
@@ -680,6 +772,8 @@ int main(void)
     CALL(test_sock_udp_recv__unsocketed_with_remote());
     CALL(test_sock_udp_recv__with_timeout());
     CALL(test_sock_udp_recv__non_blocking());
+    CALL(test_sock_udp_recv_batch());
+    CALL(test_sock_udp_recv_buf());
     _prepare_send_checks();
     CALL(test_sock_udp_send__EAFNOSUPPORT());
     CALL(test_sock_udp_send__EINVAL_addr());
@@ -697,6 +791,7 @@ int main(void)
     CALL(test_sock_udp_send__unsocketed());
     CALL(test_sock_udp_send__no_sock_no_netif());
     CALL(test_sock_udp_send__no_sock());
+    CALL(test_sock_udp_send_batch());
 
     puts("ALL TESTS SUCCESSFUL");
 
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include "thread.h"
+#include "xtimer.h"
+#include "net/af.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/tcp.h"
+
+/* Size of the buffer passed to a single gnrc_tcp_send() or gnrc_tcp_recv() call */
+#ifndef CHUNK
+#define CHUNK (2048)
+#endif
+
+/* Test pattern sent by the sender */
+#ifndef TEST_PATERN
+#define TEST_PATERN (0xF0)
+#endif
+
+/* The sink stops receiving if no data arrived for this long */
+#ifndef SINK_IDLE
+#define SINK_IDLE (1U * US_PER_SEC)
+#endif
+
+uint8_t buf[CHUNK];
+
+/* "ifconfig" shell command */
+extern int _netif_config(int argc, char **argv);
+
+static void _print_result(const char *what, uint32_t nbyte, uint32_t duration)
+{
+    uint32_t kbit = 0;
+
+    if (duration > 0) {
+        kbit = (uint32_t) (((uint64_t) nbyte * 8 * 1000) / duration);
+    }
+    printf("%s: %" PRIu32 " byte in %" PRIu32 " us: %" PRIu32 " kbit/s\n",
+           what, nbyte, duration, kbit);
+}
+
+#ifdef TCP_SINK
+static void _run(gnrc_tcp_tcb_t *tcb)
+{
+    int ret = gnrc_tcp_tcb_set_rcv_buf_size(tcb, RCV_BUF_SIZE);
+    if (ret < 0) {
+        printf("gnrc_tcp_tcb_set_rcv_buf_size() : %d\n", ret);
+        return;
+    }
+
+    ret = gnrc_tcp_open_passive(tcb, AF_INET6, NULL, TARGET_PORT);
+    if (ret < 0) {
+        printf("gnrc_tcp_open_passive() : %d\n", ret);
+        return;
+    }
+
+    /* Receive until the peer stops sending. The rate is measured from the */
+    /* first to the last received chunk. */
+    uint32_t rcvd = 0;
+    uint32_t start = 0;
+    uint32_t end = 0;
+    do {
+        ret = gnrc_tcp_recv(tcb, buf, sizeof(buf),
+                            (rcvd == 0) ? GNRC_TCP_CONNECTION_TIMEOUT_DURATION : SINK_IDLE);
+        if (ret > 0) {
+            end = xtimer_now_usec();
+            if (rcvd == 0) {
+                start = end;
+            }
+            rcvd += ret;
+        }
+    } while (ret > 0);
+    _print_result("received", rcvd, end - start);
+    gnrc_tcp_close(tcb);
+}
+#else
+static void _run(gnrc_tcp_tcb_t *tcb)
+{
+    ipv6_addr_t target_addr;
+
+    ipv6_addr_from_str(&target_addr, TARGET_ADDR);
+    int ret = gnrc_tcp_open_active(tcb, AF_INET6, (uint8_t *) &target_addr, TARGET_PORT, 0);
+    if (ret < 0) {
+        printf("gnrc_tcp_open_active() : %d : retry after 10sec\n", ret);
+        xtimer_sleep(10);
+        return;
+    }
+
+    /* Send NBYTE byte, stop if errors were found */
+    uint32_t sent = 0;
+    uint32_t start = xtimer_now_usec();
+    while (sent < NBYTE) {
+        size_t len = (NBYTE - sent < sizeof(buf)) ? NBYTE - sent : sizeof(buf);
+        ret = gnrc_tcp_send(tcb, buf, len, 0);
+        if (ret < 0) {
+            printf("gnrc_tcp_send() : %d\n", ret);
+            break;
+        }
+        sent += ret;
+    }
+    uint32_t queued = xtimer_now_usec() - start;
+
+    /* Closing the connection waits until all data was acknowledged */
+    gnrc_tcp_close(tcb);
+    _print_result("queued", sent, queued);
+    _print_result("sent", sent, xtimer_now_usec() - start);
+}
+#endif
+
+int main(void)
+{
+    /* Transmission control block */
+    gnrc_tcp_tcb_t tcb;
+
+#ifdef TCP_SINK
+    /* Set pre-configured IP address */
+    kernel_pid_t ifs[GNRC_NETIF_NUMOF];
+    size_t numof = gnrc_netif_get(ifs);
+    if (numof == 0) {
+        printf("No valid network interface found\n");
+        return -1;
+    }
+    char if_pid[] = {ifs[0] + '0', '\0'};
+    char *cmd[] = {"ifconfig", if_pid, "add", "unicast", LOCAL_ADDR};
+    _netif_config(5, cmd);
+
+    printf("\nStarting sink: LOCAL_ADDR=%s, LOCAL_PORT=%d, CYCLES=%d\n\n",
+           LOCAL_ADDR, TARGET_PORT, CYCLES);
+    printf("RCV_BUF_SIZE=%u, GNRC_TCP_RCV_BUF_POOL_SIZE=%u\n",
+           (unsigned) RCV_BUF_SIZE, (unsigned) GNRC_TCP_RCV_BUF_POOL_SIZE);
+#else
+    printf("\nStarting sender: TARGET_ADDR=%s, TARGET_PORT=%d, NBYTE=%d, CYCLES=%d\n\n",
+           TARGET_ADDR, TARGET_PORT, NBYTE, CYCLES);
+    printf("GNRC_TCP_SND_QUEUE_SIZE=%u, GNRC_TCP_MSS=%u\n",
+           (unsigned) GNRC_TCP_SND_QUEUE_SIZE, (unsigned) GNRC_TCP_MSS);
+#endif
+
+    for (unsigned i = 0; i < sizeof(buf); i++) {
+        buf[i] = TEST_PATERN;
+    }
+
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        gnrc_tcp_tcb_init(&tcb);
+        _run(&tcb);
+    }
+    puts("done");
+    return 0;
+}
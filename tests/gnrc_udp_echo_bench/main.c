@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the round-trip time of UDP datagrams echoed over
+ *              the loopback address through GNRC
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ECHO_PORT       (7U)
+#define RUNS            (1000U)
+#define PAYLOAD_SIZE    (64U)
+#define TIMEOUT         (1U * US_PER_SEC)
+
+static char _server_stack[THREAD_STACKSIZE_DEFAULT];
+static uint8_t _server_buf[PAYLOAD_SIZE];
+static uint8_t _client_buf[PAYLOAD_SIZE];
+
+static void *_server(void *arg)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t sock;
+
+    (void)arg;
+    local.port = ECHO_PORT;
+    if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
+        puts("Error creating echo sock");
+        return NULL;
+    }
+    while (1) {
+        sock_udp_ep_t remote;
+        ssize_t res = sock_udp_recv(&sock, _server_buf, sizeof(_server_buf),
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        if (res >= 0) {
+            sock_udp_send(&sock, _server_buf, res, &remote);
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    sock_udp_ep_t remote = SOCK_IPV6_EP_ANY;
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t sock;
+    uint32_t min = UINT32_MAX, max = 0;
+    uint64_t sum = 0;
+    unsigned lost = 0;
+
+    puts("gnrc UDP echo benchmark");
+    thread_create(_server_stack, sizeof(_server_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _server, NULL, "echo");
+
+    ipv6_addr_set_loopback((ipv6_addr_t *)&remote.addr.ipv6);
+    remote.port = ECHO_PORT;
+    local.port = ECHO_PORT + 1;
+    if (sock_udp_create(&sock, &local, &remote, 0) < 0) {
+        puts("Error creating client sock");
+        return 1;
+    }
+    for (unsigned i = 0; i < RUNS; i++) {
+        uint32_t start, rtt;
+
+        _client_buf[0] = (uint8_t)i;
+        start = xtimer_now_usec();
+        if ((sock_udp_send(&sock, _client_buf, sizeof(_client_buf), NULL) < 0) ||
+            (sock_udp_recv(&sock, _client_buf, sizeof(_client_buf), TIMEOUT,
+                           NULL) < 0) ||
+            (_client_buf[0] != (uint8_t)i)) {
+            lost++;
+            continue;
+        }
+        rtt = xtimer_now_usec() - start;
+        sum += rtt;
+        if (rtt < min) {
+            min = rtt;
+        }
+        if (rtt > max) {
+            max = rtt;
+        }
+    }
+    if (lost < RUNS) {
+        printf("%u datagrams of %u byte: RTT min %" PRIu32 " us, avg %" PRIu32
+               " us, max %" PRIu32 " us\n", RUNS - lost, PAYLOAD_SIZE, min,
+               (uint32_t)(sum / (RUNS - lost)), max);
+    }
+    printf("%u datagrams lost\n", lost);
+    puts("SUCCESS");
+    return 0;
+}
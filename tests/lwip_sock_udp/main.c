@@ -947,6 +947,64 @@ static void test_sock_udp_recv6__non_blocking(void)
     assert(_check_net());
 }
 
+static void test_sock_udp_recv6_batch(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR6_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR6_LOCAL };
+    static const sock_udp_ep_t local = { .family = AF_INET6,
+                                         .port = _TEST_PORT_LOCAL };
+    sock_udp_ep_t result;
+    sock_udp_dgram_t dgrams[] = {
+        { .data = _test_buffer, .len = sizeof(_test_buffer) / 3,
+          .remote = &result },
+        { .data = _test_buffer + (sizeof(_test_buffer) / 3),
+          .len = sizeof(_test_buffer) / 3, .remote = NULL },
+        { .data = _test_buffer + (2 * (sizeof(_test_buffer) / 3)),
+          .len = sizeof(_test_buffer) / 3, .remote = NULL },
+    };
+
+    assert(0 == sock_udp_create(&_sock, &local, NULL, SOCK_FLAGS_REUSE_EP));
+    assert(-EAGAIN == sock_udp_recv_batch(&_sock, dgrams, 3, 0));
+    assert(_inject_6packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE,
+                           _TEST_PORT_LOCAL, "ABCD", sizeof("ABCD"),
+                           _TEST_NETIF));
+    assert(_inject_6packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE,
+                           _TEST_PORT_LOCAL, "EFGHIJ", sizeof("EFGHIJ"),
+                           _TEST_NETIF));
+    xtimer_usleep(1000);    /* let lwIP stack finish */
+    assert(2 == sock_udp_recv_batch(&_sock, dgrams, 3, SOCK_NO_TIMEOUT));
+    assert(sizeof("ABCD") == dgrams[0].len);
+    assert(memcmp(dgrams[0].data, "ABCD", sizeof("ABCD")) == 0);
+    assert(AF_INET6 == result.family);
+    assert(_TEST_PORT_REMOTE == result.port);
+    assert(sizeof("EFGHIJ") == dgrams[1].len);
+    assert(memcmp(dgrams[1].data, "EFGHIJ", sizeof("EFGHIJ")) == 0);
+    assert(_check_net());
+}
+
+static void test_sock_udp_recv6_buf(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR6_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR6_LOCAL };
+    static const sock_udp_ep_t local = { .family = AF_INET6,
+                                         .port = _TEST_PORT_LOCAL };
+    sock_udp_ep_t result;
+    void *data, *ctx;
+
+    assert(0 == sock_udp_create(&_sock, &local, NULL, SOCK_FLAGS_REUSE_EP));
+    assert(_inject_6packet(&src_addr, &dst_addr, _TEST_PORT_REMOTE,
+                           _TEST_PORT_LOCAL, "ABCD", sizeof("ABCD"),
+                           _TEST_NETIF));
+    assert(sizeof("ABCD") == sock_udp_recv_buf(&_sock, &data, &ctx,
+                                               SOCK_NO_TIMEOUT, &result));
+    assert(memcmp(data, "ABCD", sizeof("ABCD")) == 0);
+    assert(AF_INET6 == result.family);
+    assert(memcmp(&result.addr, &src_addr, sizeof(result.addr)) == 0);
+    assert(_TEST_PORT_REMOTE == result.port);
+    sock_udp_recv_buf_free(&_sock, ctx);
+    assert(_check_net());
+}
+
 static void test_sock_udp_send6__EAFNOSUPPORT(void)
 {
     static const sock_udp_ep_t remote = { .addr = { .ipv6 = _TEST_ADDR6_REMOTE },
@@ -1318,6 +1376,8 @@ int main(void)
     CALL(test_sock_udp_recv6__unsocketed_with_remote());
     CALL(test_sock_udp_recv6__with_timeout());
     CALL(test_sock_udp_recv6__non_blocking());
+    CALL(test_sock_udp_recv6_batch());
+    CALL(test_sock_udp_recv6_buf());
     _prepare_send_checks();
     CALL(test_sock_udp_send6__EAFNOSUPPORT());
     CALL(test_sock_udp_send6__EINVAL_addr());
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares the message throughput of msg_send()/msg_receive()
+ *              with msg_send_bulk()/msg_receive_bulk()
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MSG_NUMOF       (10000U)
+#define BULK_SIZE       (8U)
+#define QUEUE_SIZE      (16U)
+
+#define TYPE_DONE       (0xdddd)
+
+static char stack[THREAD_STACKSIZE_MAIN];
+static msg_t queue[QUEUE_SIZE];
+static kernel_pid_t main_pid;
+static volatile int use_bulk;
+
+static void *receiver(void *arg)
+{
+    (void)arg;
+    msg_t msgs[BULK_SIZE];
+    unsigned count = 0;
+
+    msg_init_queue(queue, QUEUE_SIZE);
+
+    while (1) {
+        if (use_bulk) {
+            count += msg_receive_bulk(msgs, BULK_SIZE);
+        }
+        else {
+            msg_receive(msgs);
+            count++;
+        }
+
+        if (count >= MSG_NUMOF) {
+            msg_t done = { .type = TYPE_DONE, .content = { .value = count } };
+
+            count = 0;
+            msg_send(&done, main_pid);
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t run_single(kernel_pid_t pid)
+{
+    msg_t m = { .type = 0 };
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        m.content.value = i;
+        msg_send(&m, pid);
+    }
+    msg_receive(&m);
+
+    return xtimer_now_usec() - start;
+}
+
+static uint32_t run_bulk(kernel_pid_t pid)
+{
+    msg_t msgs[BULK_SIZE];
+    unsigned i = 0;
+    uint32_t start = xtimer_now_usec();
+
+    while (i < MSG_NUMOF) {
+        unsigned num = ((MSG_NUMOF - i) < BULK_SIZE) ? (MSG_NUMOF - i) : BULK_SIZE;
+
+        for (unsigned j = 0; j < num; j++) {
+            msgs[j].type = 0;
+            msgs[j].content.value = i + j;
+        }
+        int res = msg_send_bulk(msgs, num, pid);
+        if (res <= 0) {
+            /* queue of the receiver is full, let it catch up */
+            thread_yield();
+            continue;
+        }
+        i += res;
+    }
+    msg_receive(msgs);
+
+    return xtimer_now_usec() - start;
+}
+
+static void print_result(const char *name, uint32_t usec)
+{
+    printf("%s: %u messages in %" PRIu32 " us (%" PRIu32 " msg/s)\n", name,
+           MSG_NUMOF, usec, (uint32_t)(((uint64_t)MSG_NUMOF * US_PER_SEC) / usec));
+}
+
+int main(void)
+{
+    puts("msg_send_bulk() benchmark");
+    main_pid = thread_getpid();
+
+    kernel_pid_t pid = thread_create(stack, sizeof(stack),
+                                     THREAD_PRIORITY_MAIN - 1, 0,
+                                     receiver, NULL, "receiver");
+
+    use_bulk = 0;
+    print_result("single", run_single(pid));
+
+    use_bulk = 1;
+    print_result("bulk", run_bulk(pid));
+
+    puts("SUCCESS");
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for mutex priority inheritance
+ *
+ * A low priority thread holds a mutex for @ref CRIT_SECTION_US while a high
+ * priority thread tries to lock it and a medium priority thread becomes
+ * runnable at the same time. Without priority inheritance the high priority
+ * thread has to wait for the medium priority thread as well. The test reports
+ * the worst-case latency the high priority thread experienced when acquiring
+ * the mutex.
+ *
+ * The low priority thread alternates between three ways of locking: the
+ * mutex alone, the mutex with a second one nested inside, and the second one
+ * taken while the mutex is held and released after it. Unlocking the second
+ * mutex must neither drop the inherited priority while the first one is still
+ * held, nor keep it after both are released.
+ *
+ * In a fourth mode the mutex is held by another thread that is itself blocked
+ * on the second mutex held by the low priority thread, so the priority of the
+ * high priority thread has to be passed along the chain of owners.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ITERATIONS          (20U)
+#define CRIT_SECTION_US     (2000U)
+#define MID_BUSY_US         (20000U)
+#define SETTLE_US           (500U)
+
+#define PRIO_HIGH           (THREAD_PRIORITY_MAIN - 4)
+#define PRIO_MID            (THREAD_PRIORITY_MAIN - 3)
+#define PRIO_CHAIN          (THREAD_PRIORITY_MAIN - 2)
+#define PRIO_LOW            (THREAD_PRIORITY_MAIN - 1)
+
+static char stack_low[THREAD_STACKSIZE_MAIN];
+static char stack_mid[THREAD_STACKSIZE_MAIN];
+static char stack_chain[THREAD_STACKSIZE_MAIN];
+static char stack_high[THREAD_STACKSIZE_MAIN];
+
+enum {
+    MODE_SINGLE = 0,    /**< testlock only */
+    MODE_NESTED,        /**< innerlock locked and unlocked within testlock */
+    MODE_CROSSED,       /**< innerlock locked within, unlocked after testlock */
+    MODE_CHAINED,       /**< testlock held by chain, blocked on innerlock */
+    MODE_NUMOF,
+};
+
+static const char *mode_names[] = { "single", "nested", "crossed",
+                                   "chained" };
+
+static mutex_t testlock = MUTEX_INIT;
+static mutex_t innerlock = MUTEX_INIT;
+static mutex_t done = MUTEX_INIT_LOCKED;
+static kernel_pid_t pid_low, pid_mid, pid_chain;
+static unsigned mode;
+static uint32_t max_latency;
+static unsigned prio_errors;
+
+static inline void spin(uint32_t us)
+{
+    xtimer_spin(xtimer_ticks_from_usec(us));
+}
+
+static void *low(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        thread_sleep();
+        if (mode == MODE_CHAINED) {
+            mutex_lock(&innerlock);
+            /* preempted by chain, which takes testlock and blocks on
+             * innerlock */
+            thread_wakeup(pid_chain);
+            spin(CRIT_SECTION_US);
+            mutex_unlock(&innerlock);
+            continue;
+        }
+        mutex_lock(&testlock);
+        switch (mode) {
+            case MODE_NESTED:
+                mutex_lock(&innerlock);
+                spin(CRIT_SECTION_US / 2);
+                mutex_unlock(&innerlock);
+                spin(CRIT_SECTION_US / 2);
+                mutex_unlock(&testlock);
+                break;
+            case MODE_CROSSED:
+                spin(CRIT_SECTION_US / 2);
+                mutex_lock(&innerlock);
+                mutex_unlock(&testlock);
+                spin(CRIT_SECTION_US / 2);
+                mutex_unlock(&innerlock);
+                break;
+            default:
+                spin(CRIT_SECTION_US);
+                mutex_unlock(&testlock);
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static void *chain(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        thread_sleep();
+        mutex_lock(&testlock);
+        mutex_lock(&innerlock);
+        mutex_unlock(&innerlock);
+        mutex_unlock(&testlock);
+    }
+
+    return NULL;
+}
+
+static void *mid(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        thread_sleep();
+        spin(MID_BUSY_US);
+    }
+
+    return NULL;
+}
+
+static void *high(void *arg)
+{
+    (void)arg;
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        mode = i % MODE_NUMOF;
+        /* let the low priority thread enter its critical section */
+        thread_wakeup(pid_low);
+        xtimer_usleep(SETTLE_US);
+        /* make the medium priority thread runnable while low holds the lock */
+        thread_wakeup(pid_mid);
+
+        uint32_t start = xtimer_now_usec();
+        mutex_lock(&testlock);
+        uint32_t latency = xtimer_now_usec() - start;
+        mutex_unlock(&testlock);
+
+        if (latency > max_latency) {
+            max_latency = latency;
+        }
+        printf("iteration %u: latency %" PRIu32 " us (%s)\n", i, latency,
+               mode_names[mode]);
+
+        /* wait until the other threads are sleeping again */
+        xtimer_usleep(MID_BUSY_US + CRIT_SECTION_US);
+        /* no inherited priority must be left over */
+        if (thread_get(pid_low)->priority != PRIO_LOW) {
+            printf("iteration %u: low priority thread kept priority %u\n", i,
+                   (unsigned)thread_get(pid_low)->priority);
+            prio_errors++;
+        }
+        if (thread_get(pid_chain)->priority != PRIO_CHAIN) {
+            printf("iteration %u: chain thread kept priority %u\n", i,
+                   (unsigned)thread_get(pid_chain)->priority);
+            prio_errors++;
+        }
+    }
+
+    mutex_unlock(&done);
+    return NULL;
+}
+
+int main(void)
+{
+    puts("Mutex priority inheritance test");
+    puts("Please refer to the README.md for more information\n");
+
+    pid_low = thread_create(stack_low, sizeof(stack_low), PRIO_LOW, 0,
+                            low, NULL, "low");
+    pid_mid = thread_create(stack_mid, sizeof(stack_mid), PRIO_MID, 0,
+                            mid, NULL, "mid");
+    pid_chain = thread_create(stack_chain, sizeof(stack_chain), PRIO_CHAIN, 0,
+                              chain, NULL, "chain");
+    thread_create(stack_high, sizeof(stack_high), PRIO_HIGH, 0,
+                  high, NULL, "high");
+
+    mutex_lock(&done);
+
+    printf("worst-case latency: %" PRIu32 " us\n", max_latency);
+#ifdef MODULE_CORE_MUTEX_PRIORITY_INHERITANCE
+    if (max_latency >= (CRIT_SECTION_US + (MID_BUSY_US / 2))) {
+        puts("FAILURE: high priority thread was blocked by medium priority thread");
+    }
+    else if (prio_errors > 0) {
+        puts("FAILURE: inherited priority was not restored");
+    }
+    else {
+        puts("SUCCESS");
+    }
+#else
+    puts("priority inheritance disabled, compare with the value above");
+#endif
+
+    return 0;
+}
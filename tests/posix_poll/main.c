@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for poll() and select() on UDP sockets
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "net/ipv6/addr.h"
+#include "poll.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define _TEST_PORT_A        (0x2c94)
+#define _TEST_PORT_B        (0xa615)
+#define _TEST_TIMEOUT_MS    (100)
+#define _SEND_DELAY         (10U * US_PER_MS)
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+static char _sender_stack[THREAD_STACKSIZE_DEFAULT];
+static struct sockaddr_in6 _addr_a, _addr_b;
+static int _sock_a, _sock_b;
+
+static void _init_addr(struct sockaddr_in6 *addr, uint16_t port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sin6_family = AF_INET6;
+    addr->sin6_port = htons(port);
+    ipv6_addr_set_loopback((ipv6_addr_t *)&addr->sin6_addr);
+}
+
+static int _open(struct sockaddr_in6 *addr)
+{
+    int s = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+
+    assert(s >= 0);
+    assert(bind(s, (struct sockaddr *)addr, sizeof(*addr)) == 0);
+    return s;
+}
+
+static void _send_a_to_b(void)
+{
+    assert(sendto(_sock_a, "ABCD", sizeof("ABCD"), 0,
+                  (struct sockaddr *)&_addr_b, sizeof(_addr_b)) ==
+           sizeof("ABCD"));
+}
+
+static void _recv_b(void)
+{
+    char buf[8];
+
+    assert(recvfrom(_sock_b, buf, sizeof(buf), 0, NULL, NULL) ==
+           sizeof("ABCD"));
+    assert(memcmp(buf, "ABCD", sizeof("ABCD")) == 0);
+}
+
+static void *_sender(void *arg)
+{
+    (void)arg;
+    xtimer_usleep(_SEND_DELAY);
+    _send_a_to_b();
+    return NULL;
+}
+
+static void test_poll__timeout(void)
+{
+    struct pollfd fds[] = { { .fd = _sock_a, .events = POLLIN },
+                            { .fd = _sock_b, .events = POLLIN },
+                            { .fd = -1, .events = POLLIN } };
+
+    assert(poll(fds, 3, 0) == 0);
+    assert(poll(fds, 3, _TEST_TIMEOUT_MS) == 0);
+    assert((fds[0].revents == 0) && (fds[1].revents == 0) &&
+           (fds[2].revents == 0));
+    /* UDP sockets are always writable */
+    fds[0].events = POLLIN | POLLOUT;
+    assert(poll(fds, 3, -1) == 1);
+    assert(fds[0].revents == POLLOUT);
+}
+
+static void test_poll__readable(void)
+{
+    struct pollfd fds[] = { { .fd = _sock_a, .events = POLLIN },
+                            { .fd = _sock_b, .events = POLLIN } };
+
+    _send_a_to_b();
+    assert(poll(fds, 2, _TEST_TIMEOUT_MS) == 1);
+    assert((fds[0].revents == 0) && (fds[1].revents == POLLIN));
+    _recv_b();
+    assert(poll(fds, 2, 0) == 0);
+}
+
+static void test_poll__wakeup(void)
+{
+    struct pollfd fds[] = { { .fd = _sock_a, .events = POLLIN },
+                            { .fd = _sock_b, .events = POLLIN } };
+
+    thread_create(_sender_stack, sizeof(_sender_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _sender, NULL, "sender");
+    assert(poll(fds, 2, -1) == 1);
+    assert((fds[0].revents == 0) && (fds[1].revents == POLLIN));
+    _recv_b();
+}
+
+static void test_select__readable(void)
+{
+    struct timeval timeout = { .tv_sec = 0,
+                               .tv_usec = _TEST_TIMEOUT_MS * US_PER_MS };
+    int nfds = ((_sock_a > _sock_b) ? _sock_a : _sock_b) + 1;
+    fd_set readfds;
+
+    FD_ZERO(&readfds);
+    FD_SET(_sock_a, &readfds);
+    FD_SET(_sock_b, &readfds);
+    assert(select(nfds, &readfds, NULL, NULL, &timeout) == 0);
+    _send_a_to_b();
+    FD_SET(_sock_a, &readfds);
+    FD_SET(_sock_b, &readfds);
+    assert(select(nfds, &readfds, NULL, NULL, NULL) == 1);
+    assert(!FD_ISSET(_sock_a, &readfds) && FD_ISSET(_sock_b, &readfds));
+    _recv_b();
+}
+
+int main(void)
+{
+    _init_addr(&_addr_a, _TEST_PORT_A);
+    _init_addr(&_addr_b, _TEST_PORT_B);
+    _sock_a = _open(&_addr_a);
+    _sock_b = _open(&_addr_b);
+    CALL(test_poll__timeout());
+    CALL(test_poll__readable());
+    CALL(test_poll__wakeup());
+    CALL(test_select__readable());
+    close(_sock_a);
+    close(_sock_b);
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
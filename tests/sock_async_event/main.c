@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the shared event thread of asynchronous sock
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/async/event.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+
+#define _TEST_PORT_A        (0x2c94)
+#define _TEST_PORT_B        (0xa615)
+#define _TEST_DATA          "ABCD"
+
+#define CALL(fn)            puts("Calling " # fn); fn
+
+static sock_udp_t _sock_a, _sock_b;
+static sock_udp_event_t _sock_b_event;
+static sock_udp_ep_t _ep_b;
+static kernel_pid_t _event_pid;
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static sock_event_t _event_a, _event_b;
+static unsigned _handled;
+static kernel_pid_t _handler_pid;
+static char _recv_buf[sizeof(_TEST_DATA)];
+static ssize_t _recv_res;
+
+static void _init_ep(sock_udp_ep_t *ep, uint16_t port)
+{
+    memset(ep, 0, sizeof(*ep));
+    ep->family = AF_INET6;
+    ep->netif = SOCK_ADDR_ANY_NETIF;
+    ep->port = port;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&ep->addr.ipv6);
+}
+
+static void _count_handler(sock_event_t *event)
+{
+    (void)event;
+    _handler_pid = thread_getpid();
+    _handled++;
+}
+
+static void _post_twice_handler(sock_event_t *event)
+{
+    (void)event;
+    /* not handled before this handler returns */
+    sock_event_post(&_event_b);
+    sock_event_post(&_event_b);
+    _handler_pid = thread_getpid();
+    mutex_unlock(&_done);
+}
+
+static void _recv_cb(sock_udp_t *sock, sock_async_flags_t flags, void *arg)
+{
+    sock_udp_ep_t remote;
+    ssize_t res;
+
+    assert(arg == &_sock_b);
+    assert(sock == &_sock_b);
+    if (!(flags & SOCK_ASYNC_MSG_RECV)) {
+        return;
+    }
+    while ((res = sock_udp_recv(sock, _recv_buf, sizeof(_recv_buf), 0,
+                                &remote)) != -EAGAIN) {
+        assert(remote.port == _TEST_PORT_A);
+        _recv_res = res;
+        _handler_pid = thread_getpid();
+        _handled++;
+    }
+    mutex_unlock(&_done);
+}
+
+static void _send_a_to_b(void)
+{
+    assert(sock_udp_send(&_sock_a, _TEST_DATA, sizeof(_TEST_DATA), &_ep_b) ==
+           sizeof(_TEST_DATA));
+}
+
+static void test_event__post(void)
+{
+    _handled = 0;
+    _handler_pid = KERNEL_PID_UNDEF;
+    sock_event_init_event(&_event_a, _count_handler);
+    sock_event_post(&_event_a);
+    /* the event thread has a higher priority, so it is handled already */
+    assert(_handled == 1);
+    assert(_handler_pid == _event_pid);
+}
+
+static void test_event__post_queued(void)
+{
+    _handled = 0;
+    sock_event_init_event(&_event_a, _post_twice_handler);
+    sock_event_init_event(&_event_b, _count_handler);
+    sock_event_post(&_event_a);
+    mutex_lock(&_done);
+    assert(_handled == 1);
+    assert(_handler_pid == _event_pid);
+}
+
+static void test_udp_event__recv(void)
+{
+    _handled = 0;
+    _recv_res = 0;
+    memset(_recv_buf, 0, sizeof(_recv_buf));
+    sock_udp_event_init(&_sock_b_event, &_sock_b, _recv_cb, &_sock_b);
+    _send_a_to_b();
+    mutex_lock(&_done);
+    assert(_handled == 1);
+    assert(_handler_pid == _event_pid);
+    assert(_recv_res == sizeof(_TEST_DATA));
+    assert(memcmp(_recv_buf, _TEST_DATA, sizeof(_TEST_DATA)) == 0);
+    sock_udp_event_deinit(&_sock_b_event);
+}
+
+static void test_udp_event__recv_queued(void)
+{
+    _handled = 0;
+    _recv_res = 0;
+    /* messages received before the callback is set are reported as well */
+    _send_a_to_b();
+    _send_a_to_b();
+    sock_udp_event_init(&_sock_b_event, &_sock_b, _recv_cb, &_sock_b);
+    mutex_lock(&_done);
+    assert(_handled == 2);
+    assert(_recv_res == sizeof(_TEST_DATA));
+    sock_udp_event_deinit(&_sock_b_event);
+}
+
+int main(void)
+{
+    sock_udp_ep_t ep_a;
+
+    _init_ep(&ep_a, _TEST_PORT_A);
+    _init_ep(&_ep_b, _TEST_PORT_B);
+    assert(sock_udp_create(&_sock_a, &ep_a, NULL, 0) == 0);
+    assert(sock_udp_create(&_sock_b, &_ep_b, NULL, 0) == 0);
+    _event_pid = sock_event_init();
+    assert(_event_pid > KERNEL_PID_UNDEF);
+    CALL(test_event__post());
+    CALL(test_event__post_queued());
+    CALL(test_udp_event__recv());
+    CALL(test_udp_event__recv_queued());
+    sock_udp_close(&_sock_a);
+    sock_udp_close(&_sock_b);
+
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
@@ -11,6 +11,7 @@
 #include <stdio.h> /**< required for snprintf() */
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
 #include "embUnit.h"
 #include "tests-fib.h"
 #include "xtimer.h"
@@ -978,6 +979,164 @@ static void test_fib_20_replace_prefix(void)
     fib_deinit(&test_fib_table);
 }
 
+/*
+* @brief testing the removal of expired entries
+* It is expected that an entry is gone after its lifetime passed
+* while entries without lifetime stay
+*/
+static void test_fib_21_expire_entry(void)
+{
+    size_t add_buf_size = 16;
+    char addr_dst[] = "Test address211";
+    char addr_nxt[] = "Test address212";
+    char addr_keep[] = "Test address213";
+    uint64_t lifetime;
+
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                           (uint8_t *)addr_dst, add_buf_size - 1, 0,
+                                           (uint8_t *)addr_nxt, add_buf_size - 1, 0,
+                                           1));
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                           (uint8_t *)addr_keep, add_buf_size - 1, 0,
+                                           (uint8_t *)addr_nxt, add_buf_size - 1, 0,
+                                           (uint32_t)FIB_LIFETIME_NO_EXPIRE));
+    TEST_ASSERT_EQUAL_INT(2, fib_get_num_used_entries(&test_fib_table));
+
+    xtimer_usleep(2 * US_PER_MS);
+
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH,
+                          fib_devel_get_lifetime(&test_fib_table, &lifetime,
+                                                 (uint8_t *)addr_dst,
+                                                 add_buf_size - 1));
+    TEST_ASSERT_EQUAL_INT(0, fib_devel_get_lifetime(&test_fib_table, &lifetime,
+                                                    (uint8_t *)addr_keep,
+                                                    add_buf_size - 1));
+    TEST_ASSERT_EQUAL_INT(1, fib_get_num_used_entries(&test_fib_table));
+
+    fib_deinit(&test_fib_table);
+}
+
+/*
+* @brief benchmark of the longest prefix match lookup
+* The FIB is filled with prefixes of different lengths and the number of
+* lookups per second is printed
+*/
+static void test_fib_22_lookup_rate(void)
+{
+    enum { addr_buf_size = 16, lookups = 10000 };
+    char addr_dst[addr_buf_size];
+    char addr_nxt[addr_buf_size];
+    char addr_lookup[addr_buf_size];
+    kernel_pid_t iface_id = KERNEL_PID_UNDEF;
+    uint32_t next_hop_flags = 0;
+    size_t nxt_size;
+
+    memset(addr_dst, 0, addr_buf_size);
+    memset(addr_nxt, 0, addr_buf_size);
+
+    /* prefixes of 64 to 102 bits sharing the first 7 bytes */
+    for (size_t i = 0; i < TEST_FIB_TABLE_SIZE; ++i) {
+        snprintf(addr_dst, addr_buf_size, "Prefix_%02d", (int)i);
+        snprintf(addr_nxt, addr_buf_size, "Next hop %02d", (int)i);
+        uint32_t prefix_len = 64 + (2 * i);
+        TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                               (uint8_t *)addr_dst, addr_buf_size,
+                                               (prefix_len << FIB_FLAG_NET_PREFIX_SHIFT),
+                                               (uint8_t *)addr_nxt, addr_buf_size, 0,
+                                               100000));
+    }
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < lookups; ++i) {
+        memset(addr_lookup, 0, addr_buf_size);
+        snprintf(addr_lookup, addr_buf_size, "Prefix_%02u", i % TEST_FIB_TABLE_SIZE);
+        /* vary the host part */
+        addr_lookup[addr_buf_size - 1] = (char)i;
+        nxt_size = addr_buf_size;
+        TEST_ASSERT_EQUAL_INT(0, fib_get_next_hop(&test_fib_table, &iface_id,
+                                                  (uint8_t *)addr_nxt, &nxt_size,
+                                                  &next_hop_flags,
+                                                  (uint8_t *)addr_lookup,
+                                                  addr_buf_size, 0));
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    snprintf(addr_dst, addr_buf_size, "Next hop %02u",
+             (unsigned)((lookups - 1) % TEST_FIB_TABLE_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(addr_dst, addr_nxt, addr_buf_size));
+
+    printf("\n[fib_lookup_rate] %u lookups in %" PRIu32 " us (%" PRIu32 " lookups/s)\n",
+           (unsigned)lookups, duration,
+           (uint32_t)(((uint64_t)lookups * US_PER_SEC) / (duration ? duration : 1)));
+
+    fib_deinit(&test_fib_table);
+}
+
+/*
+* @brief testing the removal of expired entries without a prior lookup
+* It is expected that neither the destination set nor the number of used
+* entries contain an entry after its lifetime passed
+*/
+static void test_fib_23_expire_destination_set(void)
+{
+    size_t add_buf_size = 16;
+    char addr_dst[] = "Test address231";
+    char addr_nxt[] = "Test address232";
+    char addr_keep[] = "Test address233";
+    /* zero padded to the size of the addresses */
+    char prefix[] = "Test address23";
+    size_t arr_size = 2;
+    fib_destination_set_entry_t arr_dst[arr_size];
+
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                           (uint8_t *)addr_dst, add_buf_size - 1, 0,
+                                           (uint8_t *)addr_nxt, add_buf_size - 1, 0,
+                                           1));
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                           (uint8_t *)addr_keep, add_buf_size - 1, 0,
+                                           (uint8_t *)addr_nxt, add_buf_size - 1, 0,
+                                           (uint32_t)FIB_LIFETIME_NO_EXPIRE));
+
+    xtimer_usleep(2 * US_PER_MS);
+
+    TEST_ASSERT_EQUAL_INT(0, fib_get_destination_set(&test_fib_table,
+                                                     (uint8_t *)prefix,
+                                                     add_buf_size - 1,
+                                                     &arr_dst[0], &arr_size));
+    TEST_ASSERT_EQUAL_INT(1, arr_size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(addr_keep, arr_dst[0].dest,
+                                    add_buf_size - 1));
+    TEST_ASSERT_EQUAL_INT(1, fib_get_num_used_entries(&test_fib_table));
+
+    fib_deinit(&test_fib_table);
+}
+
+/*
+* @brief testing the version of the table
+* It is expected that the version changes on every change of the entries and
+* as soon as an entry expires, without a prior lookup
+*/
+static void test_fib_24_version(void)
+{
+    size_t add_buf_size = 16;
+    char addr_dst[] = "Test address241";
+    char addr_nxt[] = "Test address242";
+    uint32_t version = fib_get_version(&test_fib_table);
+
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42,
+                                           (uint8_t *)addr_dst, add_buf_size - 1, 0,
+                                           (uint8_t *)addr_nxt, add_buf_size - 1, 0,
+                                           1));
+    TEST_ASSERT(version != fib_get_version(&test_fib_table));
+    version = fib_get_version(&test_fib_table);
+
+    xtimer_usleep(2 * US_PER_MS);
+
+    TEST_ASSERT(version != fib_get_version(&test_fib_table));
+
+    fib_deinit(&test_fib_table);
+}
+
 Test *tests_fib_tests(void)
 {
     fib_init(&test_fib_table);
@@ -1002,6 +1161,10 @@ Test *tests_fib_tests(void)
                         new_TestFixture(test_fib_18_get_next_hop_invalid_parameters),
                         new_TestFixture(test_fib_19_default_gateway),
                         new_TestFixture(test_fib_20_replace_prefix),
+                        new_TestFixture(test_fib_21_expire_entry),
+                        new_TestFixture(test_fib_22_lookup_rate),
+                        new_TestFixture(test_fib_23_expire_destination_set),
+                        new_TestFixture(test_fib_24_version),
     };
 
     EMB_UNIT_TESTCALLER(fib_tests, NULL, NULL, fixtures);
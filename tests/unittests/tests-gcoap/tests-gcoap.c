@@ -12,12 +12,16 @@
  * @file
  */
 #include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "embUnit.h"
 
 #include "net/gcoap.h"
+#include "xtimer.h"
 
 #include "unittests-constants.h"
 #include "tests-gcoap.h"
@@ -169,6 +173,97 @@ static void test_gcoap__server_get_resp(void)
     }
 }
 
+#define TEST_LISTENERS_NUMOF        (3U)
+#define TEST_LISTENER_RESOURCES     (50U)
+#define TEST_RESOURCES_NUMOF        (TEST_LISTENERS_NUMOF * TEST_LISTENER_RESOURCES)
+
+static char _paths[TEST_RESOURCES_NUMOF][sizeof("/r/000")];
+static coap_resource_t _resources[TEST_RESOURCES_NUMOF];
+static gcoap_listener_t _listeners[TEST_LISTENERS_NUMOF];
+
+static ssize_t _dummy_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len)
+{
+    (void)pdu;
+    (void)buf;
+    (void)len;
+    return -1;
+}
+
+/* Registers TEST_RESOURCES_NUMOF resources, split over several listeners. */
+static void _register_resources(void)
+{
+    static bool registered = false;
+
+    if (registered) {
+        return;
+    }
+    for (unsigned i = 0; i < TEST_RESOURCES_NUMOF; i++) {
+        /* zero-padded, so the paths of a listener are sorted */
+        snprintf(_paths[i], sizeof(_paths[i]), "/r/%03u", i);
+        _resources[i].path = _paths[i];
+        _resources[i].methods = COAP_GET;
+        _resources[i].handler = _dummy_handler;
+    }
+    for (unsigned i = 0; i < TEST_LISTENERS_NUMOF; i++) {
+        _listeners[i].resources = &_resources[i * TEST_LISTENER_RESOURCES];
+        _listeners[i].resources_len = TEST_LISTENER_RESOURCES;
+        gcoap_register_listener(&_listeners[i]);
+    }
+    registered = true;
+}
+
+/* Server resource lookup among the resources of several listeners. */
+static void test_gcoap__server_find_resource(void)
+{
+    _register_resources();
+
+    TEST_ASSERT_NOT_NULL(gcoap_find_resource("/.well-known/core", COAP_GET));
+    for (unsigned i = 0; i < TEST_RESOURCES_NUMOF; i++) {
+        TEST_ASSERT(gcoap_find_resource(_paths[i], COAP_GET) == &_resources[i]);
+    }
+    TEST_ASSERT_NULL(gcoap_find_resource("/r/150", COAP_GET));
+    TEST_ASSERT_NULL(gcoap_find_resource("/r/00", COAP_GET));
+    TEST_ASSERT_NULL(gcoap_find_resource("/r", COAP_GET));
+    TEST_ASSERT_NULL(gcoap_find_resource("", COAP_GET));
+    /* path registered, but not for the method */
+    TEST_ASSERT_NULL(gcoap_find_resource("/r/042", COAP_POST));
+}
+
+/*
+ * Server request dispatch rate: parses a GET request for the last resource
+ * registered and looks up its resource.
+ */
+static void test_gcoap__server_request_rate(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    uint8_t req[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    const coap_resource_t *resource = NULL;
+    unsigned requests = 10000;
+
+    _register_resources();
+
+    size_t len = gcoap_request(&pdu, &req[0], sizeof(req), COAP_METHOD_GET,
+                               _paths[TEST_RESOURCES_NUMOF - 1]);
+    TEST_ASSERT(len > 0);
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < requests; i++) {
+        /* coap_parse() works on the buffer received */
+        memcpy(buf, req, len);
+        TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, &buf[0], len));
+        resource = gcoap_find_resource((char *)&pdu.url[0],
+                                       coap_method2flag(coap_get_code_detail(&pdu)));
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    TEST_ASSERT(resource == &_resources[TEST_RESOURCES_NUMOF - 1]);
+
+    printf("\n[gcoap_request_rate] %u requests in %" PRIu32 " us (%" PRIu32 " requests/s)\n",
+           requests, duration,
+           (uint32_t)(((uint64_t)requests * US_PER_SEC) / (duration ? duration : 1)));
+}
+
 Test *tests_gcoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -176,6 +271,8 @@ Test *tests_gcoap_tests(void)
         new_TestFixture(test_gcoap__client_get_resp),
         new_TestFixture(test_gcoap__server_get_req),
         new_TestFixture(test_gcoap__server_get_resp),
+        new_TestFixture(test_gcoap__server_find_resource),
+        new_TestFixture(test_gcoap__server_request_rate),
     };
 
     EMB_UNIT_TESTCALLER(gcoap_tests, NULL, NULL, fixtures);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "byteorder.h"
+
+#include "net/ipv6.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/dcache.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/ipv6/netif.h"
+
+#include "unittests-constants.h"
+#include "tests-gnrc_ipv6_dcache.h"
+
+#define TEST_NETIF          (TEST_UINT16)
+#define TEST_DST            { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x01, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 \
+        } \
+    }
+#define TEST_NEXT_HOP       { { \
+            0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 \
+        } \
+    }
+#define TEST_L2ADDR         { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+
+static const ipv6_addr_t dst = TEST_DST;
+static const ipv6_addr_t next_hop = TEST_NEXT_HOP;
+static const uint8_t l2addr[] = TEST_L2ADDR;
+static gnrc_ipv6_nc_t *nc;
+
+static void set_up(void)
+{
+    gnrc_ipv6_nc_init();
+    gnrc_ipv6_dcache_flush();
+    nc = gnrc_ipv6_nc_add(TEST_NETIF, &next_hop, l2addr, sizeof(l2addr),
+                          GNRC_IPV6_NC_STATE_REACHABLE);
+}
+
+static void tear_down(void)
+{
+    gnrc_ipv6_nc_init();
+    gnrc_ipv6_dcache_flush();
+}
+
+static uint8_t res[GNRC_IPV6_NC_L2_ADDR_MAX];
+static uint8_t res_len;
+
+/* caches entry as next hop for dst */
+static void _add(gnrc_ipv6_nc_t *entry)
+{
+    gnrc_ipv6_dcache_add(KERNEL_PID_UNDEF, &dst, entry,
+                         gnrc_ipv6_dcache_get_version());
+}
+
+/* returns the interface of a lookup for dst */
+static kernel_pid_t _get(kernel_pid_t iface)
+{
+    res_len = 0;
+    return gnrc_ipv6_dcache_get(res, &res_len, iface, &dst);
+}
+
+static void test_dcache_get__empty(void)
+{
+    gnrc_ipv6_dcache_stats_t before, after;
+
+    gnrc_ipv6_dcache_get_stats(&before);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+    gnrc_ipv6_dcache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(before.hits, after.hits);
+    TEST_ASSERT_EQUAL_INT(before.misses + 1, after.misses);
+}
+
+static void test_dcache_get__success(void)
+{
+    gnrc_ipv6_dcache_stats_t before, after;
+
+    TEST_ASSERT_NOT_NULL(nc);
+    _add(nc);
+    gnrc_ipv6_dcache_get_stats(&before);
+    TEST_ASSERT_EQUAL_INT(TEST_NETIF, _get(KERNEL_PID_UNDEF));
+    TEST_ASSERT_EQUAL_INT(sizeof(l2addr), res_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(l2addr, res, sizeof(l2addr)));
+    gnrc_ipv6_dcache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(before.hits + 1, after.hits);
+    TEST_ASSERT_EQUAL_INT(before.misses, after.misses);
+}
+
+static void test_dcache_get__different_iface(void)
+{
+    _add(nc);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(TEST_NETIF));
+}
+
+static void test_dcache_add__no_neighbor(void)
+{
+    _add(NULL);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_add__unreachable(void)
+{
+    nc->flags = (nc->flags & ~GNRC_IPV6_NC_STATE_MASK) |
+                GNRC_IPV6_NC_STATE_INCOMPLETE;
+    _add(nc);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_add__same_l2addr(void)
+{
+    /* dst is a global address of the neighbor with the link-local next_hop */
+    gnrc_ipv6_nc_t *global_nc = gnrc_ipv6_nc_add(TEST_NETIF, &dst, l2addr,
+                                                 sizeof(l2addr),
+                                                 GNRC_IPV6_NC_STATE_REACHABLE);
+
+    TEST_ASSERT_NOT_NULL(global_nc);
+    _add(global_nc);
+    /* a change to the link-local entry does not invalidate the cached one */
+    nc->flags = (nc->flags & ~GNRC_IPV6_NC_STATE_MASK) |
+                GNRC_IPV6_NC_STATE_STALE;
+    TEST_ASSERT_EQUAL_INT(TEST_NETIF, _get(KERNEL_PID_UNDEF));
+    global_nc->flags = (global_nc->flags & ~GNRC_IPV6_NC_STATE_MASK) |
+                       GNRC_IPV6_NC_STATE_STALE;
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_get__version_changed(void)
+{
+    /* next hop determined before the routing state changed */
+    gnrc_ipv6_dcache_add(KERNEL_PID_UNDEF, &dst, nc,
+                         gnrc_ipv6_dcache_get_version() - 1);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_get__nc_state_changed(void)
+{
+    _add(nc);
+    nc->flags = (nc->flags & ~GNRC_IPV6_NC_STATE_MASK) |
+                GNRC_IPV6_NC_STATE_STALE;
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_get__nc_removed(void)
+{
+    _add(nc);
+    gnrc_ipv6_nc_remove(TEST_NETIF, &next_hop);
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_get__nc_readded(void)
+{
+    _add(nc);
+    gnrc_ipv6_nc_remove(TEST_NETIF, &next_hop);
+    /* reuses the entry of the removed neighbor */
+    TEST_ASSERT(nc == gnrc_ipv6_nc_add(TEST_NETIF, &next_hop, l2addr,
+                                       sizeof(l2addr),
+                                       GNRC_IPV6_NC_STATE_REACHABLE));
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_get__nc_evicted(void)
+{
+    ipv6_addr_t addr = TEST_DST;
+
+    _add(nc);
+    /* fill the neighbor cache, the last entry evicts the least recently used
+     * one: nc */
+    for (unsigned i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        gnrc_ipv6_nc_t *entry;
+
+        addr.u16[7] = byteorder_htons(i + 2);
+        entry = gnrc_ipv6_nc_add(TEST_NETIF, &addr, l2addr, sizeof(l2addr),
+                                 GNRC_IPV6_NC_STATE_REACHABLE);
+        TEST_ASSERT_NOT_NULL(entry);
+        if (i == (GNRC_IPV6_NC_SIZE - 1)) {
+            TEST_ASSERT(nc == entry);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_flush(void)
+{
+    _add(nc);
+    gnrc_ipv6_dcache_flush();
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _get(KERNEL_PID_UNDEF));
+}
+
+static void test_dcache_pmtu(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_dcache_get_pmtu(KERNEL_PID_UNDEF, &dst));
+    gnrc_ipv6_netif_add(TEST_NETIF);
+    gnrc_ipv6_netif_get(TEST_NETIF)->mtu = 1500;
+    _add(nc);
+    /* starts with the MTU of the interface of the next hop */
+    TEST_ASSERT_EQUAL_INT(1500, gnrc_ipv6_dcache_get_pmtu(KERNEL_PID_UNDEF,
+                                                          &dst));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_dcache_get_pmtu(TEST_NETIF, &dst));
+    gnrc_ipv6_dcache_update_pmtu(&dst, 1400);
+    TEST_ASSERT_EQUAL_INT(1400, gnrc_ipv6_dcache_get_pmtu(KERNEL_PID_UNDEF,
+                                                          &dst));
+    /* is never raised */
+    gnrc_ipv6_dcache_update_pmtu(&dst, 1450);
+    TEST_ASSERT_EQUAL_INT(1400, gnrc_ipv6_dcache_get_pmtu(KERNEL_PID_UNDEF,
+                                                          &dst));
+    /* and never lowered below the minimum MTU of IPv6 */
+    gnrc_ipv6_dcache_update_pmtu(&dst, IPV6_MIN_MTU - 1);
+    TEST_ASSERT_EQUAL_INT(IPV6_MIN_MTU,
+                          gnrc_ipv6_dcache_get_pmtu(KERNEL_PID_UNDEF, &dst));
+    gnrc_ipv6_netif_remove(TEST_NETIF);
+}
+
+Test *tests_gnrc_ipv6_dcache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_dcache_get__empty),
+        new_TestFixture(test_dcache_get__success),
+        new_TestFixture(test_dcache_get__different_iface),
+        new_TestFixture(test_dcache_add__no_neighbor),
+        new_TestFixture(test_dcache_add__unreachable),
+        new_TestFixture(test_dcache_add__same_l2addr),
+        new_TestFixture(test_dcache_get__version_changed),
+        new_TestFixture(test_dcache_get__nc_state_changed),
+        new_TestFixture(test_dcache_get__nc_removed),
+        new_TestFixture(test_dcache_get__nc_readded),
+        new_TestFixture(test_dcache_get__nc_evicted),
+        new_TestFixture(test_dcache_flush),
+        new_TestFixture(test_dcache_pmtu),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_ipv6_dcache_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_ipv6_dcache_tests;
+}
+
+void tests_gnrc_ipv6_dcache(void)
+{
+    TESTS_RUN(tests_gnrc_ipv6_dcache_tests());
+}
+/** @} */
@@ -12,11 +12,16 @@
  * @file
  */
 #include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "embUnit.h"
 
+#include "board.h"
 #include "net/inet_csum.h"
+#include "xtimer.h"
 
 #include "unittests-constants.h"
 #include "tests-inet_csum.h"
@@ -165,6 +170,143 @@ static void test_inet_csum__empty_app_buffer(void)
     TEST_ASSERT_EQUAL_INT(hdr_expected, pyld_sum);
 }
 
+/* byte-by-byte reference implementation (RFC 1071, section 4.1) */
+static uint16_t _ref_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                                size_t accum_len)
+{
+    uint32_t csum = sum;
+
+    if (len == 0) {
+        return csum;
+    }
+    if (accum_len & 1) {
+        csum += *(buf++);
+        len--;
+    }
+    for (; len > 1; buf += 2, len -= 2) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1);
+    }
+    if (len > 0) {
+        csum += (uint16_t)(*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+    return csum;
+}
+
+static void test_inet_csum__unaligned(void)
+{
+    /* 0xff bytes in the second half let the 32-bit words carry */
+    uint32_t words[36];
+    uint8_t *data = (uint8_t *)words;
+
+    for (unsigned i = 0; i < sizeof(words); i++) {
+        data[i] = (i < (sizeof(words) / 2)) ? (uint8_t)(i * 37) : 0xff;
+    }
+    for (unsigned offset = 0; offset < 4; offset++) {
+        for (unsigned len = 0; len < (sizeof(words) - offset); len++) {
+            for (unsigned accum_len = 0; accum_len < 2; accum_len++) {
+                TEST_ASSERT_EQUAL_INT(
+                    _ref_csum_slice(0x1234, data + offset, len, accum_len),
+                    inet_csum_slice(0x1234, data + offset, len, accum_len));
+            }
+        }
+    }
+}
+
+static void test_inet_csum__update16(void)
+{
+    /* IPv4 header, see test_inet_csum__calculate_csum() */
+    uint8_t data[] = {
+        0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00,
+        0x40, 0x11, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+        0xc0, 0xa8, 0x00, 0xc7,
+    };
+    uint16_t csum = ~inet_csum(0, data, sizeof(data));
+    uint16_t old_word = (data[8] << 8) | data[9];
+
+    /* decrement TTL */
+    data[8]--;
+    csum = inet_csum_update16(csum, old_word, (data[8] << 8) | data[9]);
+    TEST_ASSERT_EQUAL_INT(0xb961, csum);
+    TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(0, data, sizeof(data)), csum);
+}
+
+static void test_inet_csum__update(void)
+{
+    /* UDP pseudo header and payload, see test_inet_csum__odd_len() */
+    uint8_t data[] = {
+        0xc0, 0xa8, 0x01, 0x91, 0x4b, 0x4b, 0x4b, 0x4b, /* IPv4 source + dest*/
+        0xf6, 0xfb, 0x00, 0x35, 0x00, 0x27, 0xd1, 0xa2, /* UDP header */
+        0xa5, 0x6f, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, /* DNS payload */
+        0x00, 0x00, 0x00, 0x00, 0x09, 0x74, 0x65, 0x73,
+        0x74, 0x2d, 0x69, 0x70, 0x76, 0x36, 0x03, 0x63,
+        0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01,
+    };
+    const uint8_t new_dst[] = { 0x08, 0x08, 0x04, 0x04 };
+    const uint8_t new_name[] = { 'r', 'i', 'o', 't', '-' };
+    uint8_t old[sizeof(new_name)];
+    uint16_t csum = ~inet_csum(17 + 39, data, sizeof(data));
+
+    /* rewrite destination address */
+    memcpy(old, &data[4], sizeof(new_dst));
+    memcpy(&data[4], new_dst, sizeof(new_dst));
+    csum = inet_csum_update(csum, old, new_dst, sizeof(new_dst), 4);
+    TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(17 + 39, data, sizeof(data)),
+                          csum);
+
+    /* rewrite payload at odd offset */
+    memcpy(old, &data[29], sizeof(new_name));
+    memcpy(&data[29], new_name, sizeof(new_name));
+    csum = inet_csum_update(csum, old, new_name, sizeof(new_name), 29);
+    TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(17 + 39, data, sizeof(data)),
+                          csum);
+}
+
+/**
+ * @brief benchmark of inet_csum_slice() against the byte-by-byte reference
+ *        implementation
+ */
+static void test_inet_csum__speed(void)
+{
+    enum { runs = 1000, len = 1280 };
+    static uint32_t words[len / sizeof(uint32_t)];
+    uint8_t *data = (uint8_t *)words;
+    uint32_t start, ref_time, time;
+    uint16_t ref_sum = 0, sum = 0;
+
+    for (unsigned i = 0; i < len; i++) {
+        data[i] = (uint8_t)i;
+    }
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < runs; i++) {
+        ref_sum = _ref_csum_slice(ref_sum, data, len, 0);
+    }
+    ref_time = xtimer_now_usec() - start;
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < runs; i++) {
+        sum = inet_csum_slice(sum, data, len, 0);
+    }
+    time = xtimer_now_usec() - start;
+    TEST_ASSERT_EQUAL_INT(ref_sum, sum);
+    /* avoid division by zero on fast machines */
+    ref_time += !ref_time;
+    time += !time;
+
+    printf("\n[inet_csum_speed] %" PRIu32 " bytes/ms (reference %" PRIu32
+           " bytes/ms)", (uint32_t)(((uint64_t)runs * len * 1000) / time),
+           (uint32_t)(((uint64_t)runs * len * 1000) / ref_time));
+#ifdef CLOCK_CORECLOCK
+    printf(", %" PRIu32 " bytes/kcycle (reference %" PRIu32 " bytes/kcycle)",
+           (uint32_t)(((uint64_t)runs * len * 1000000000) /
+                      ((uint64_t)time * CLOCK_CORECLOCK)),
+           (uint32_t)(((uint64_t)runs * len * 1000000000) /
+                      ((uint64_t)ref_time * CLOCK_CORECLOCK)));
+#endif
+    puts("");
+}
+
 Test *tests_inet_csum_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -176,6 +318,10 @@ Test *tests_inet_csum_tests(void)
         new_TestFixture(test_inet_csum__odd_len),
         new_TestFixture(test_inet_csum__two_app_snips),
         new_TestFixture(test_inet_csum__empty_app_buffer),
+        new_TestFixture(test_inet_csum__unaligned),
+        new_TestFixture(test_inet_csum__update16),
+        new_TestFixture(test_inet_csum__update),
+        new_TestFixture(test_inet_csum__speed),
     };
 
     EMB_UNIT_TESTCALLER(inet_csum_tests, NULL, NULL, fixtures);
@@ -118,6 +118,56 @@ static void test_ipv6_nc_add__full(void)
                                       sizeof(TEST_STRING4), 0));
 }
 
+static void test_ipv6_nc_add__full_evict_lru(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t lru_addr = DEFAULT_TEST_IPV6_ADDR;
+    gnrc_ipv6_nc_t *entry, *lru = NULL;
+    uint16_t lru_gen = 0;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr,
+                                                       TEST_STRING4,
+                                                       sizeof(TEST_STRING4),
+                                                       GNRC_IPV6_NC_STATE_STALE)));
+        if (i == 1) {
+            lru = entry;
+            lru_gen = entry->gen;
+        }
+        addr.u16[7].u16++;
+    }
+    /* use the first entry so the second one becomes the least recently used */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &lru_addr));
+    lru_addr.u16[7].u16++;
+
+    TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                                   sizeof(TEST_STRING4),
+                                                   GNRC_IPV6_NC_STATE_STALE)));
+    TEST_ASSERT(entry == gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &addr));
+    /* the evicted entry is reused, holders of it can tell by its generation */
+    TEST_ASSERT(entry == lru);
+    TEST_ASSERT(entry->gen != lru_gen);
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &lru_addr));
+    lru_addr.u16[7].u16--;
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &lru_addr));
+}
+
+static void test_ipv6_nc_add__full_no_evict_router(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                              sizeof(TEST_STRING4),
+                                              GNRC_IPV6_NC_STATE_STALE |
+                                              GNRC_IPV6_NC_IS_ROUTER));
+        addr.u16[7].u16++;
+    }
+
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                      sizeof(TEST_STRING4), GNRC_IPV6_NC_STATE_STALE));
+}
+
 static void test_ipv6_nc_add__success(void)
 {
     ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
@@ -449,6 +499,8 @@ Test *tests_ipv6_nc_tests(void)
         new_TestFixture(test_ipv6_nc_add__addr_unspecified),
         new_TestFixture(test_ipv6_nc_add__l2addr_too_long),
         new_TestFixture(test_ipv6_nc_add__full),
+        new_TestFixture(test_ipv6_nc_add__full_evict_lru),
+        new_TestFixture(test_ipv6_nc_add__full_no_evict_router),
         new_TestFixture(test_ipv6_nc_add__success),
         new_TestFixture(test_ipv6_nc_add__address_update_despite_free_entry),
         new_TestFixture(test_ipv6_nc_remove__no_entry_pid),
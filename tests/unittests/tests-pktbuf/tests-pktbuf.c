@@ -492,6 +492,61 @@ static void test_pktbuf_mark__success_equally_sized(void)
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
 
+static void test_pktbuf_reserve__size_0(void)
+{
+    TEST_ASSERT_NULL(gnrc_pktbuf_reserve(0, 14, GNRC_NETTYPE_TEST));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_reserve__memfull(void)
+{
+    TEST_ASSERT_NULL(gnrc_pktbuf_reserve(GNRC_PKTBUF_SIZE + 1, 0,
+                                         GNRC_NETTYPE_TEST));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_reserve__mark_in_place(void)
+{
+    gnrc_pktsnip_t *pkt1, *pkt2;
+    uint8_t *data;
+
+    /* header size that is not a multiple of the alignment */
+    TEST_ASSERT_NOT_NULL((pkt1 = gnrc_pktbuf_reserve(64, 14, GNRC_NETTYPE_TEST)));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT_NOT_NULL(pkt1->data);
+    TEST_ASSERT_EQUAL_INT(64, pkt1->size);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_TEST, pkt1->type);
+    data = pkt1->data;
+    memcpy(data, TEST_STRING64, 14 + sizeof(TEST_STRING16));
+
+    /* commit the received length */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktbuf_realloc_data(pkt1, 14 + sizeof(TEST_STRING16)));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT(data == pkt1->data);
+
+    TEST_ASSERT_NOT_NULL((pkt2 = gnrc_pktbuf_mark(pkt1, 14, GNRC_NETTYPE_UNDEF)));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT(pkt1->next == pkt2);
+    /* nothing was moved */
+    TEST_ASSERT(data == pkt2->data);
+    TEST_ASSERT(data + 14 == pkt1->data);
+    TEST_ASSERT_EQUAL_INT(14, pkt2->size);
+    TEST_ASSERT_EQUAL_INT(sizeof(TEST_STRING16), pkt1->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING64, pkt2->data, pkt2->size));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING64 + 14, pkt1->data, pkt1->size));
+
+    /* check if header can be released separately and everything cleaned up */
+    gnrc_pktbuf_remove_snip(pkt1, pkt2);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT_NOT_NULL((pkt2 = gnrc_pktbuf_add(NULL, TEST_STRING16, 16,
+                                                 GNRC_NETTYPE_TEST)));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING64 + 14, pkt1->data, pkt1->size));
+    gnrc_pktbuf_release(pkt1);
+    gnrc_pktbuf_release(pkt2);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
 static void test_pktbuf_realloc_data__size_0(void)
 {
     gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, NULL, sizeof(TEST_STRING8), GNRC_NETTYPE_TEST);
@@ -837,6 +892,9 @@ Test *tests_pktbuf_tests(void)
         new_TestFixture(test_pktbuf_mark__success_aligned),
         new_TestFixture(test_pktbuf_mark__success_small),
         new_TestFixture(test_pktbuf_mark__success_equally_sized),
+        new_TestFixture(test_pktbuf_reserve__size_0),
+        new_TestFixture(test_pktbuf_reserve__memfull),
+        new_TestFixture(test_pktbuf_reserve__mark_in_place),
         new_TestFixture(test_pktbuf_realloc_data__size_0),
         new_TestFixture(test_pktbuf_realloc_data__memfull),
         new_TestFixture(test_pktbuf_realloc_data__nomemenough),
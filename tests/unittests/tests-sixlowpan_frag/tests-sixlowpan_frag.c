@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/sixlowpan.h"
+
+#include "rbuf.h"
+
+#include "unittests-constants.h"
+#include "tests-sixlowpan_frag.h"
+
+#define TEST_NETIF          (TEST_UINT16)
+#define TEST_TAG            (TEST_UINT16)
+#define TEST_MSG_QUEUE_SIZE (8U)
+#define TEST_DATAGRAM_SIZE  (sizeof(ipv6_hdr_t) + 64U)
+/* bytes of the datagram in the first fragment, a multiple of 8 */
+#define TEST_FRAG1_SIZE     (sizeof(ipv6_hdr_t) + 8U)
+#define TEST_L2ADDR_SRC     { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 }
+#define TEST_L2ADDR_SRC2    { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x03 }
+#define TEST_L2ADDR_DST     { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02 }
+
+static uint8_t _src[] = TEST_L2ADDR_SRC;
+static uint8_t _src2[] = TEST_L2ADDR_SRC2;
+static uint8_t _dst[] = TEST_L2ADDR_DST;
+static uint8_t _datagram[TEST_DATAGRAM_SIZE];
+static msg_t _msg_queue[TEST_MSG_QUEUE_SIZE];
+static gnrc_netreg_entry_t _ipv6 = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                              KERNEL_PID_UNDEF);
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    for (unsigned i = 0; i < sizeof(_datagram); i++) {
+        _datagram[i] = i;
+    }
+    _ipv6.target.pid = sched_active_pid;
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_ipv6);
+}
+
+static void tear_down(void)
+{
+    gnrc_netreg_unregister(GNRC_NETTYPE_IPV6, &_ipv6);
+}
+
+/* hands len bytes of a datagram starting at offset as a received fragment to
+ * gnrc_sixlowpan_frag */
+static void _frag(uint8_t *src, size_t size, uint16_t tag, uint16_t offset,
+                  size_t len)
+{
+    size_t hdr_len = (offset == 0) ? (sizeof(sixlowpan_frag_t) + 1)
+                                   : sizeof(sixlowpan_frag_n_t);
+    gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(src, sizeof(_src),
+                                                 _dst, sizeof(_dst));
+    gnrc_pktsnip_t *pkt;
+    sixlowpan_frag_n_t *hdr;
+
+    TEST_ASSERT_NOT_NULL(netif);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = TEST_NETIF;
+    pkt = gnrc_pktbuf_add(netif, NULL, hdr_len + len, GNRC_NETTYPE_SIXLOWPAN);
+    TEST_ASSERT_NOT_NULL(pkt);
+    hdr = pkt->data;
+    hdr->disp_size = byteorder_htons(size);
+    hdr->tag = byteorder_htons(tag);
+    if (offset == 0) {
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+        ((uint8_t *)pkt->data)[hdr_len - 1] = SIXLOWPAN_UNCOMP;
+    }
+    else {
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+        hdr->offset = offset / 8;
+    }
+    memcpy(((uint8_t *)pkt->data) + hdr_len, &_datagram[offset], len);
+    gnrc_sixlowpan_frag_handle_pkt(pkt);
+}
+
+static void _frag1(uint8_t *src, size_t size, uint16_t tag)
+{
+    _frag(src, size, tag, 0, TEST_FRAG1_SIZE);
+}
+
+static void _fragn(uint8_t *src, size_t size, uint16_t tag)
+{
+    _frag(src, size, tag, TEST_FRAG1_SIZE, size - TEST_FRAG1_SIZE);
+}
+
+static bool _has(uint8_t *src, size_t size, uint16_t tag)
+{
+    uint8_t buf[sizeof(gnrc_netif_hdr_t) + sizeof(_src) + sizeof(_dst)];
+    gnrc_netif_hdr_t *hdr = (gnrc_netif_hdr_t *)buf;
+
+    gnrc_netif_hdr_init(hdr, sizeof(_src), sizeof(_dst));
+    gnrc_netif_hdr_set_src_addr(hdr, src, sizeof(_src));
+    gnrc_netif_hdr_set_dst_addr(hdr, _dst, sizeof(_dst));
+    return rbuf_has(hdr, size, tag);
+}
+
+/* receives the next message that is not for garbage collection, if any.
+ * Garbage collection is triggered the way the 6LoWPAN thread would */
+static bool _recv(msg_t *msg)
+{
+    while (msg_try_receive(msg) >= 0) {
+        if (msg->type != GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF) {
+            return true;
+        }
+        gnrc_sixlowpan_frag_gc_rbuf();
+    }
+    return false;
+}
+
+/* checks that no datagram was reassembled */
+static void _expect_nothing(void)
+{
+    msg_t msg;
+
+    TEST_ASSERT(!_recv(&msg));
+}
+
+static void _expect_datagram(uint8_t *src, size_t size)
+{
+    gnrc_pktsnip_t *pkt;
+    gnrc_netif_hdr_t *hdr;
+    msg_t msg;
+
+    TEST_ASSERT(_recv(&msg));
+    TEST_ASSERT_EQUAL_INT(GNRC_NETAPI_MSG_TYPE_RCV, msg.type);
+    pkt = msg.content.ptr;
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6, pkt->type);
+    TEST_ASSERT_EQUAL_INT(size, pkt->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_datagram, pkt->data, size));
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_NETIF, pkt->next->type);
+    hdr = pkt->next->data;
+    TEST_ASSERT_EQUAL_INT(TEST_NETIF, hdr->if_pid);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(src, gnrc_netif_hdr_get_src_addr(hdr),
+                                    sizeof(_src)));
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_rbuf_add__complete(void)
+{
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    TEST_ASSERT(_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG));
+    _expect_nothing();
+    _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    TEST_ASSERT(!_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_add__out_of_order(void)
+{
+    _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    TEST_ASSERT(_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG));
+    _expect_nothing();
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_add__duplicate(void)
+{
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE, 8);
+    /* a fragment spanning parts of two received fragments is a duplicate */
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE - 8, 16);
+    _expect_nothing();
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE + 8,
+          TEST_DATAGRAM_SIZE - TEST_FRAG1_SIZE - 8);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    _expect_nothing();
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_add__overlap(void)
+{
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    /* partially overlapping fragment: reassembly starts over with it */
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE - 8, 16);
+    TEST_ASSERT(_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG));
+    /* ... and again with the subsequent fragment */
+    _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_nothing();
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_add__datagram_identity(void)
+{
+    /* fragments only complete a datagram with the same source, size and tag */
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _fragn(_src2, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _fragn(_src, TEST_DATAGRAM_SIZE - 8, TEST_TAG);
+    _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG + 1);
+    _expect_nothing();
+    TEST_ASSERT(!_has(_src2, TEST_DATAGRAM_SIZE, TEST_TAG + 1));
+    TEST_ASSERT(!_has(_src, TEST_DATAGRAM_SIZE - 8, TEST_TAG + 1));
+
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG + 1);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    _frag1(_src, TEST_DATAGRAM_SIZE - 8, TEST_TAG);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE - 8);
+    _frag1(_src2, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_datagram(_src2, TEST_DATAGRAM_SIZE);
+    _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_add__full(void)
+{
+    for (unsigned i = 0; i < RBUF_SIZE; i++) {
+        _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG + i);
+    }
+    /* a new fragment of the first datagram makes it the most recent one */
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE, 8);
+    /* buffer is full: the least recently updated entry is evicted */
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG + RBUF_SIZE);
+    TEST_ASSERT(_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG));
+    TEST_ASSERT(!_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG + 1));
+    for (unsigned i = 2; i <= RBUF_SIZE; i++) {
+        TEST_ASSERT(_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG + i));
+    }
+    _expect_nothing();
+
+    _frag(_src, TEST_DATAGRAM_SIZE, TEST_TAG, TEST_FRAG1_SIZE + 8,
+          TEST_DATAGRAM_SIZE - TEST_FRAG1_SIZE - 8);
+    _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    for (unsigned i = 2; i <= RBUF_SIZE; i++) {
+        _fragn(_src, TEST_DATAGRAM_SIZE, TEST_TAG + i);
+        _expect_datagram(_src, TEST_DATAGRAM_SIZE);
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_rbuf_gc__timeout(void)
+{
+    uint32_t start = xtimer_now_usec();
+    msg_t msg;
+
+    _frag1(_src, TEST_DATAGRAM_SIZE, TEST_TAG);
+    /* the timer removes the entry without any further fragments arriving */
+    while (_has(_src, TEST_DATAGRAM_SIZE, TEST_TAG)) {
+        msg_receive(&msg);
+        TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, msg.type);
+        gnrc_sixlowpan_frag_gc_rbuf();
+    }
+    TEST_ASSERT((xtimer_now_usec() - start) > RBUF_TIMEOUT);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_sixlowpan_frag_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_rbuf_add__complete),
+        new_TestFixture(test_rbuf_add__out_of_order),
+        new_TestFixture(test_rbuf_add__duplicate),
+        new_TestFixture(test_rbuf_add__overlap),
+        new_TestFixture(test_rbuf_add__datagram_identity),
+        new_TestFixture(test_rbuf_add__full),
+        new_TestFixture(test_rbuf_gc__timeout),
+    };
+
+    EMB_UNIT_TESTCALLER(sixlowpan_frag_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&sixlowpan_frag_tests;
+}
+
+void tests_sixlowpan_frag(void)
+{
+    /* receives reassembled datagrams and garbage collection messages */
+    msg_init_queue(_msg_queue, TEST_MSG_QUEUE_SIZE);
+    TESTS_RUN(tests_sixlowpan_frag_tests());
+}
+/** @} */
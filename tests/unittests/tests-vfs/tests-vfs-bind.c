@@ -34,15 +34,23 @@ static const uint8_t str_data[] = "This is a test file";
 
 static ssize_t _mock_write(vfs_file_t *filp, const void *src, size_t nbytes);
 static ssize_t _mock_read(vfs_file_t *filp, void *dest, size_t nbytes);
+static int _mock_poll(vfs_file_t *filp, unsigned events, kernel_pid_t waiter);
 
 static volatile int _mock_write_calls = 0;
 static volatile int _mock_read_calls = 0;
+static kernel_pid_t _mock_poll_waiter = KERNEL_PID_UNDEF;
 
 static vfs_file_ops_t _test_bind_ops = {
     .read = _mock_read,
     .write = _mock_write,
 };
 
+static vfs_file_ops_t _test_bind_poll_ops = {
+    .read = _mock_read,
+    .write = _mock_write,
+    .poll = _mock_poll,
+};
+
 static ssize_t _mock_write(vfs_file_t *filp, const void *src, size_t nbytes)
 {
     void *dest = filp->private_data.ptr;
@@ -65,6 +73,14 @@ static ssize_t _mock_read(vfs_file_t *filp, void *dest, size_t nbytes)
     return nbytes;
 }
 
+static int _mock_poll(vfs_file_t *filp, unsigned events, kernel_pid_t waiter)
+{
+    (void)filp;
+    _mock_poll_waiter = waiter;
+    /* never readable */
+    return events & VFS_POLLOUT;
+}
+
 static void test_vfs_bind(void)
 {
     int fd;
@@ -107,11 +123,42 @@ static void test_vfs_bind__leak_fds(void)
     test_vfs_bind();
 }
 
+static void test_vfs_bind__poll(void)
+{
+    uint8_t buf[_VFS_TEST_BIND_BUFSIZE];
+    int fd = vfs_bind(VFS_ANY_FD, O_RDWR, &_test_bind_ops, &buf[0]);
+
+    TEST_ASSERT(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    /* no poll operation: always ready */
+    TEST_ASSERT_EQUAL_INT(VFS_POLLIN | VFS_POLLOUT,
+                          vfs_poll(fd, VFS_POLLIN | VFS_POLLOUT, 7));
+    TEST_ASSERT_EQUAL_INT(VFS_POLLIN, vfs_poll(fd, VFS_POLLIN, 7));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+    TEST_ASSERT_EQUAL_INT(-EBADF, vfs_poll(fd, VFS_POLLIN, 7));
+
+    fd = vfs_bind(VFS_ANY_FD, O_RDWR, &_test_bind_poll_ops, &buf[0]);
+    TEST_ASSERT(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    TEST_ASSERT_EQUAL_INT(0, vfs_poll(fd, VFS_POLLIN, 7));
+    TEST_ASSERT_EQUAL_INT(7, _mock_poll_waiter);
+    TEST_ASSERT_EQUAL_INT(VFS_POLLOUT,
+                          vfs_poll(fd, VFS_POLLIN | VFS_POLLOUT,
+                                   KERNEL_PID_UNDEF));
+    TEST_ASSERT_EQUAL_INT(KERNEL_PID_UNDEF, _mock_poll_waiter);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
 Test *tests_vfs_bind_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_vfs_bind),
         new_TestFixture(test_vfs_bind__leak_fds),
+        new_TestFixture(test_vfs_bind__poll),
     };
 
     EMB_UNIT_TESTCALLER(vfs_bind_tests, NULL, NULL, fixtures);
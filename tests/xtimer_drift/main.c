@@ -46,6 +46,14 @@
 #define TEST_MSG_RX_USLEEP  (200LU)
 #define TEST_MSG_QUEUE_SIZE (4U)
 
+/* TEST_BG_TIMERS additional timers are kept active in the background to see
+ * how a long timer list influences drift and jitter. They are spread over
+ * TEST_BG_INTERVAL and re-armed from their own callbacks. */
+#ifndef TEST_BG_TIMERS
+#define TEST_BG_TIMERS      (0U)
+#endif
+#define TEST_BG_INTERVAL    (US_PER_SEC / 2)
+
 char slacker_stack1[THREAD_STACKSIZE_DEFAULT];
 char slacker_stack2[THREAD_STACKSIZE_DEFAULT];
 char worker_stack[THREAD_STACKSIZE_MAIN];
@@ -61,6 +69,15 @@ struct timer_msg msg_b = { .interval = (TEST_INTERVAL / 3) };
 struct timer_msg msg_c = { .interval = (TEST_INTERVAL * 5) };
 struct timer_msg msg_d = { .interval = (TEST_INTERVAL * 2) };
 
+#if TEST_BG_TIMERS
+static xtimer_t bg_timers[TEST_BG_TIMERS];
+
+static void bg_callback(void *arg)
+{
+    xtimer_set((xtimer_t *)arg, TEST_BG_INTERVAL);
+}
+#endif
+
 /* This thread is only here to give the kernel some extra load */
 void *slacker_thread(void *arg)
 {
@@ -163,6 +180,16 @@ int main(void)
                                       THREAD_CREATE_STACKTEST,
                                       worker_thread, NULL, "worker");
 
+#if TEST_BG_TIMERS
+    LOG_DEBUG("+ %u background timers\n", TEST_BG_TIMERS);
+    for (unsigned i = 0; i < TEST_BG_TIMERS; i++) {
+        bg_timers[i].callback = bg_callback;
+        bg_timers[i].arg = &bg_timers[i];
+        xtimer_set(&bg_timers[i], TEST_BG_INTERVAL +
+                   (i * (TEST_BG_INTERVAL / TEST_BG_TIMERS)));
+    }
+#endif
+
     puts("[START]\n");
     xtimer_ticks32_t last_wakeup = xtimer_now();
     while (1) {
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup   tests
+ * @{
+ *
+ * @file
+ * @brief     Measure the cost of setting and removing xtimers depending on
+ *            the number of active timers
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "xtimer.h"
+
+#define TIMERS_MAX      (200U)
+#define REPETITIONS     (1000U)
+/* all background timers are set in this range, so that none of them fires
+ * while the test is running */
+#define OFFSET_MIN      (10U * US_PER_SEC)
+#define OFFSET_RANGE    (US_PER_SEC)
+
+static xtimer_t timers[TIMERS_MAX];
+static const unsigned timer_counts[] = { 0, 10, 25, 50, 100, 150, 200 };
+static uint32_t rand_state = 1;
+
+static void callback(void *arg)
+{
+    (void)arg;
+}
+
+static uint32_t _rand_offset(void)
+{
+    /* simple LCG, this only needs to be cheap and reproducible */
+    rand_state = (rand_state * 1103515245U) + 12345U;
+    return OFFSET_MIN + ((rand_state >> 8) % OFFSET_RANGE);
+}
+
+static void run_test(unsigned count)
+{
+    xtimer_t probe = { .callback = callback };
+    uint32_t set_time = 0;
+    uint32_t remove_time = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        timers[i].callback = callback;
+        xtimer_set(&timers[i], _rand_offset());
+    }
+
+    for (unsigned i = 0; i < REPETITIONS; i++) {
+        uint32_t offset = _rand_offset();
+        uint32_t start = xtimer_now_usec();
+        xtimer_set(&probe, offset);
+        uint32_t mid = xtimer_now_usec();
+        xtimer_remove(&probe);
+        uint32_t end = xtimer_now_usec();
+
+        set_time += mid - start;
+        remove_time += end - mid;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        xtimer_remove(&timers[i]);
+    }
+
+    printf("+ %3u timers: set %5" PRIu32 " ns, remove %5" PRIu32 " ns\n",
+           count, (set_time * 1000) / REPETITIONS,
+           (remove_time * 1000) / REPETITIONS);
+}
+
+int main(void)
+{
+    puts("xtimer set/remove timings");
+#ifdef MODULE_XTIMER_HEAP
+    puts("backend: pairing heap");
+#else
+    puts("backend: sorted lists");
+#endif
+
+    for (unsigned i = 0; i < (sizeof(timer_counts) / sizeof(timer_counts[0])); i++) {
+        run_test(timer_counts[i]);
+    }
+
+    puts("Done.");
+    return 0;
+}